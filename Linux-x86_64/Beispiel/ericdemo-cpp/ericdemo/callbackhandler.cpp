@@ -56,12 +56,30 @@ void CallbackHandler::globalerFortschritt(uint32_t id, uint32_t pos, uint32_t ma
     std::cout << pos << "/" << max << ": " << mapId(id) << std::endl;
 }
 
+void CallbackHandler::beginneMessung(EricPhasenzeiten& phasenzeiten, const std::string& datenartVersion) {
+    messung.reset(new EricPhasenzeiten::Messung(phasenzeiten, datenartVersion));
+}
+
+void CallbackHandler::beendeMessung() {
+    if (messung) {
+        // Weitere Callbacks ignoriert die abgeschlossene Messung
+        messung->abschliessen();
+    }
+}
+
 void CallbackHandler::fortschritt(uint32_t id, uint32_t pos, uint32_t max) {
+    if (messung) {
+        messung->fortschritt(id, pos, max);
+    }
+    zeigeFortschritt(id, pos, max);
+}
+
+void CallbackHandler::zeigeFortschritt(uint32_t id, uint32_t pos, uint32_t max) {
     if (letzteId != 0 && letzteId != id) {
         std::cout << std::string(78 - letzteSpalte, '#') << ']' << std::endl;
         letzteId = 0;
         letzteSpalte = 0;
-        fortschritt(id, pos, max);
+        zeigeFortschritt(id, pos, max);
     } else {
         if (pos == 0) {
             std::cout << '[';
@@ -1,8 +1,12 @@
 #ifndef _ERIC_CALLBACKHANDLER_H_
 #define _ERIC_CALLBACKHANDLER_H_
 
+#include <memory>
+#include <string>
 #include <eric_types.h>
 
+#include "ericphasenzeiten.h"
+
 class Eric;
 
 /** @brief Stellt Callback-Funktionen mit Konsolenausgabe fuer den Einsatz mit ERiC bereit. */
@@ -17,9 +21,26 @@ public:
 
     void fortschritt(uint32_t id, uint32_t pos, uint32_t max);
 
+    /** @brief Reicht die Fortschrittcallbacks bis zu beendeMessung() zusaetzlich an eine Messung weiter
+      *
+      * Das uebergebene Objekt phasenzeiten muss mindestens so lange leben, wie
+      * die Instanz der Klasse CallbackHandler, da diese eine Referenz darauf haelt!
+      */
+    void beginneMessung(EricPhasenzeiten& phasenzeiten, const std::string& datenartVersion);
+
+    /** @brief Schliesst die Messung ab, sie bleibt bis zur naechsten beginneMessung() abrufbar */
+    void beendeMessung();
+
+    /** @brief Die zuletzt begonnene Messung oder nullptr */
+    const EricPhasenzeiten::Messung *letzteMessung() const { return messung.get(); }
+
 private:
+    void zeigeFortschritt(uint32_t id, uint32_t pos, uint32_t max);
+
     const Eric& eric;
 
+    std::unique_ptr<EricPhasenzeiten::Messung> messung;
+
     unsigned int letzteId;
     unsigned int letzteSpalte;
 };
@@ -0,0 +1,117 @@
+#include "datenartversionserkennung.h"
+
+#include "xmltagleser.h"
+
+
+namespace
+{
+
+bool istZiffernfolge(const std::string &text, size_t anfang, size_t laenge)
+{
+    if (text.size() != anfang + laenge)
+        return false;
+    for (size_t i = anfang; i < text.size(); ++i)
+    {
+        if (text[i] < '0' || text[i] > '9')
+            return false;
+    }
+    return true;
+}
+
+/** @brief Jahr aus Elementname oder version-Attribut, falls der Datensatz kein Element Jahr hat */
+std::string ersatzJahr(const XmlTagLeser &leser, const std::string &datenArt)
+{
+    const std::string name = leser.name();
+    if (0 == name.compare(0, 6, "UStVA_") && name.size() > 6 && istZiffernfolge(name, 6, name.size() - 6))
+        return name.substr(6);
+
+    std::string version;
+    if (!leser.attribut("version", version))
+        return std::string();
+
+    if ("EUER" == datenArt && "E77" == name && !version.empty() && 'v' == version[0] && istZiffernfolge(version, 1, 4))
+        return version.substr(1);
+
+    if (istZiffernfolge(version, 0, 4))
+        return version;
+
+    return std::string();
+}
+
+} // anonymous namespace
+
+
+bool Datenartversionserkennung::erkenne(const std::string& xmlDatensatz, std::string& datenartVersion) const
+{
+    XmlTagLeser leser(xmlDatensatz);
+    if (!leser.weiter())
+        return false;
+
+    // ZM-Datensaetze haben keinen TransferHeader
+    if (leser.hatName("zm"))
+    {
+        std::string version;
+        const bool hatVersion = leser.attribut("version", version);
+        std::string jahr;
+        bool inMzr = false;
+        while (leser.weiter())
+        {
+            if (leser.hatName("mzr"))
+            {
+                inMzr = !leser.istEndeTag() && !leser.istLeeresElement();
+            }
+            else if (inMzr && !leser.istEndeTag() && leser.hatName("jahr") && leser.textinhalt(jahr) && !jahr.empty())
+            {
+                datenartVersion = "ZM_" + jahr;
+                return true;
+            }
+        }
+        if (hatVersion)
+        {
+            datenartVersion = "ZM";
+            return true;
+        }
+        return false;
+    }
+
+    std::string datenArt, jahr, ersatz;
+    bool inTransferHeader = false;
+    do
+    {
+        if (leser.istEndeTag())
+        {
+            if (leser.hatName("TransferHeader"))
+                inTransferHeader = false;
+            continue;
+        }
+
+        if (leser.hatName("TransferHeader"))
+        {
+            inTransferHeader = !leser.istLeeresElement();
+        }
+        else if (inTransferHeader && leser.hatName("DatenArt"))
+        {
+            leser.textinhalt(datenArt);
+        }
+        else if (jahr.empty() && leser.hatName("Jahr"))
+        {
+            leser.textinhalt(jahr);
+        }
+
+        if (ersatz.empty())
+        {
+            ersatz = ersatzJahr(leser, datenArt);
+        }
+
+        if (!datenArt.empty() && !jahr.empty())
+            break;
+    }
+    while (leser.weiter());
+
+    if (datenArt.empty())
+        return false;
+
+    const std::string &gefundenesJahr = jahr.empty() ? ersatz : jahr;
+    datenartVersion = gefundenesJahr.empty() ? datenArt : datenArt + "_" + gefundenesJahr;
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef _DATENARTVERSIONSERKENNUNG_H_
+#define _DATENARTVERSIONSERKENNUNG_H_
+
+#include <string>
+
+/** @brief Ermittelt die Datenartversion eines Datensatzes aus dessen XML-Text
+ *
+ * Der Text wird mit XmlTagLeser ohne Aufbau eines Dokumentbaums gelesen.
+ * Die Regeln entsprechen extract_datenart_version() des Python-Clients:
+ *
+ * - ZM-Datensaetze (Wurzelelement zm): "ZM_" und der Inhalt von mzr/jahr,
+ *   ersatzweise "ZM", wenn das Wurzelelement ein version-Attribut hat.
+ * - Sonst TransferHeader/DatenArt und das Jahr aus dem ersten Element Jahr.
+ *   Gibt es kein solches Element, bestimmt das erste Element mit einem Namen
+ *   wie UStVA_2025, ein E77 mit version="2025" oder "v2025" bei der Datenart
+ *   EUER oder ein beliebiges version-Attribut mit vier Ziffern das Jahr.
+ *   Ohne Jahr wird die Datenart allein geliefert.
+ *
+ * Das Lesen endet, sobald Datenart und Jahr feststehen.
+ */
+class Datenartversionserkennung
+{
+public:
+    Datenartversionserkennung() {};
+    ~Datenartversionserkennung() {};
+
+    /** @brief Ermittelt die Datenartversion, z. B. "UStVA_2025", "EUER_2025" oder "ZM_2025"
+      *
+      * @return false, wenn die Datenartversion nicht ermittelt werden konnte
+      */
+    bool erkenne(const std::string& xmlDatensatz, std::string& datenartVersion) const;
+};
+
+#endif //_DATENARTVERSIONSERKENNUNG_H_
@@ -4,6 +4,7 @@
 #include "eric.h"
 #include "anwendungsfehler.h"
 #include "resolve.h"
+#include "ericmetriken.h"
 #include "ericsystemsteuerung.h"
 #include "system.h"
 
@@ -67,6 +68,32 @@ namespace {
         int fehlerkode, EricRueckgabepufferHandle rueckgabePuffer);
     EricHoleFehlerTextFun EricHoleFehlerTextPtr;
 
+    typedef int (STDCALL *EricHoleFinanzamtLandNummernFun)(
+        EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricHoleFinanzamtLandNummernFun EricHoleFinanzamtLandNummernPtr;
+
+    typedef int (STDCALL *EricHoleFinanzaemterFun)(
+        const char *finanzamtLandNummer,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricHoleFinanzaemterFun EricHoleFinanzaemterPtr;
+
+    typedef int (STDCALL *EricHoleFinanzamtsdatenFun)(
+        const char bufaNr[5],
+        EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricHoleFinanzamtsdatenFun EricHoleFinanzamtsdatenPtr;
+
+    typedef int (STDCALL *EricGetPinStatusFun)(
+        EricZertifikatHandle hToken,
+        uint32_t *pinStatus,
+        uint32_t keyType);
+    EricGetPinStatusFun EricGetPinStatusPtr;
+
+    typedef int (STDCALL *EricPruefeZertifikatPinFun)(
+        const char *pathToKeystore,
+        const char *pin,
+        uint32_t keyType);
+    EricPruefeZertifikatPinFun EricPruefeZertifikatPinPtr;
+
     typedef int (STDCALL *EricPruefeSteuernummerFun)(
         const char *Steuernummer);
     EricPruefeSteuernummerFun EricPruefeSteuernummerPtr;
@@ -74,6 +101,24 @@ namespace {
     typedef int (STDCALL *EricSystemCheckFun)();
     EricSystemCheckFun EricSystemCheckPtr;
 
+    typedef int (STDCALL *EricCheckXMLFun)(
+        const char *xml,
+        const char *datenartVersion,
+        EricRueckgabepufferHandle fehlertextPuffer);
+    EricCheckXMLFun EricCheckXMLPtr;
+
+    typedef int (STDCALL *EricGetErrormessagesFromXMLAnswerFun)(
+        const char *xml,
+        EricRueckgabepufferHandle transferticketPuffer,
+        EricRueckgabepufferHandle returncodeTHPuffer,
+        EricRueckgabepufferHandle fehlertextTHPuffer,
+        EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer);
+    EricGetErrormessagesFromXMLAnswerFun EricGetErrormessagesFromXMLAnswerPtr;
+
+    typedef int (STDCALL *EricVersionFun)(
+        EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricVersionFun EricVersionPtr;
+
     typedef int (STDCALL *EricRegistriereGlobalenFortschrittCallbackFun)(
         EricFortschrittCallback func,
         void *userData);
@@ -141,8 +186,16 @@ bool Eric::ladeEricApi(const std::string &apiVerzeichnis)
                 EricGetHandleToCertificatePtr                 = ladeFunktion<EricGetHandleToCertificateFun>("EricGetHandleToCertificate", libEricApi);
                 EricCloseHandleToCertificatePtr               = ladeFunktion<EricCloseHandleToCertificateFun>("EricCloseHandleToCertificate", libEricApi);
                 EricHoleFehlerTextPtr                         = ladeFunktion<EricHoleFehlerTextFun>("EricHoleFehlerText", libEricApi);
+                EricHoleFinanzamtLandNummernPtr               = ladeFunktion<EricHoleFinanzamtLandNummernFun>("EricHoleFinanzamtLandNummern", libEricApi);
+                EricHoleFinanzaemterPtr                       = ladeFunktion<EricHoleFinanzaemterFun>("EricHoleFinanzaemter", libEricApi);
+                EricHoleFinanzamtsdatenPtr                    = ladeFunktion<EricHoleFinanzamtsdatenFun>("EricHoleFinanzamtsdaten", libEricApi);
+                EricGetPinStatusPtr                           = ladeFunktion<EricGetPinStatusFun>("EricGetPinStatus", libEricApi);
+                EricPruefeZertifikatPinPtr                    = ladeFunktion<EricPruefeZertifikatPinFun>("EricPruefeZertifikatPin", libEricApi);
                 EricPruefeSteuernummerPtr                     = ladeFunktion<EricPruefeSteuernummerFun>("EricPruefeSteuernummer", libEricApi);
                 EricSystemCheckPtr                            = ladeFunktion<EricSystemCheckFun>("EricSystemCheck", libEricApi);
+                EricVersionPtr                                = ladeFunktion<EricVersionFun>("EricVersion", libEricApi);
+                EricCheckXMLPtr                               = ladeFunktion<EricCheckXMLFun>("EricCheckXML", libEricApi);
+                EricGetErrormessagesFromXMLAnswerPtr          = ladeFunktion<EricGetErrormessagesFromXMLAnswerFun>("EricGetErrormessagesFromXMLAnswer", libEricApi);
                 EricEinstellungSetzenPtr                      = ladeFunktion<EricEinstellungSetzenFun>("EricEinstellungSetzen", libEricApi);
                 EricEinstellungAlleZuruecksetzenPtr           = ladeFunktion<EricEinstellungAlleZuruecksetzenFun>("EricEinstellungAlleZuruecksetzen", libEricApi);
                 EricRegistriereGlobalenFortschrittCallbackPtr = ladeFunktion<EricRegistriereGlobalenFortschrittCallbackFun>("EricRegistriereGlobalenFortschrittCallback", libEricApi);
@@ -176,13 +229,8 @@ void Eric::entladeEricApi()
     }
 }
 
-// ERiC Initialisieren
-Eric::Eric(const std::string &argHomeDir, const std::string &argLogDir) : libEricApi(nullptr)
+std::string Eric::ermittleHeimverzeichnis(const std::string &argHomeDir)
 {
-    static const int STATUS_OK = 0;
-    int statusCode = STATUS_OK;
-    bool initialisierungsFehler = false;
-    std::stringstream statusMeldung;
     std::string homeDir;
     const std::string DIR_UP("..");
 
@@ -203,6 +251,35 @@ Eric::Eric(const std::string &argHomeDir, const std::string &argLogDir) : libEri
     {
         homeDir = argHomeDir;
     }
+    return homeDir;
+}
+
+std::string Eric::ermittleLogverzeichnis(const std::string &argLogDir)
+{
+    std::string logDir;
+
+    if (argLogDir.empty() || System::istPfadRelativ(argLogDir.c_str()))
+    {
+        if (!System::getArbeitsverzeichnis(logDir))
+        {
+            throw Anwendungsfehler("Das Arbeitsverzeichnis konnte nicht ermittelt werden.");
+        }
+    }
+    else
+    {
+        logDir = argLogDir;
+    }
+    return logDir;
+}
+
+// ERiC Initialisieren
+Eric::Eric(const std::string &argHomeDir, const std::string &argLogDir) : libEricApi(nullptr)
+{
+    static const int STATUS_OK = 0;
+    int statusCode = STATUS_OK;
+    bool initialisierungsFehler = false;
+    std::stringstream statusMeldung;
+    const std::string homeDir = ermittleHeimverzeichnis(argHomeDir);
 
     // 1.  Lade ericapi
     if (!ladeEricApi(homeDir))
@@ -214,19 +291,7 @@ Eric::Eric(const std::string &argHomeDir, const std::string &argLogDir) : libEri
     // 2.  Pfad fuer Protokolldateien und Druckdateien setzen
     if (istGeladen())
     {
-        std::string logDir;
-
-        if (argLogDir.empty() || System::istPfadRelativ(argLogDir.c_str()))
-        {
-            if (!System::getArbeitsverzeichnis(logDir))
-            {
-                throw Anwendungsfehler("Das Arbeitsverzeichnis konnte nicht ermittelt werden.");
-            }
-        }
-        else
-        {
-            logDir = argLogDir;
-        }
+        const std::string logDir = ermittleLogverzeichnis(argLogDir);
 
         statusCode = EricInitialisiere(
 #ifdef WINDOWS_MSVC
@@ -265,11 +330,13 @@ bool Eric::istGeladen() const {
 // Implementierungen der Proxy-Methoden fuer Funktionen der ericapi
 
 int Eric::EricInitialisiere(const char *pluginPfad, const char *logPfad) {
-    return EricInitialisierePtr(pluginPfad, logPfad);
+    const EricMetriken::Aufruf aufruf("EricInitialisiere");
+    return aufruf.ende(EricInitialisierePtr(pluginPfad, logPfad));
 }
 
 int Eric::EricBeende() {
-    return EricBeendePtr();
+    const EricMetriken::Aufruf aufruf("EricBeende");
+    return aufruf.ende(EricBeendePtr());
 }
 
 int Eric::EricBearbeiteVorgang(const char* datenpuffer,
@@ -281,20 +348,23 @@ int Eric::EricBearbeiteVorgang(const char* datenpuffer,
                                EricRueckgabepufferHandle rueckgabeXmlPuffer,
                                EricRueckgabepufferHandle serverantwortXmlPuffer) const
 {
-    return EricBearbeiteVorgangPtr(datenpuffer, datenartVersion,
-        bearbeitungsFlags, druckParameter, cryptoParameter, transferHandle, rueckgabeXmlPuffer, serverantwortXmlPuffer);
+    const EricMetriken::Aufruf aufruf("EricBearbeiteVorgang");
+    return aufruf.ende(EricBearbeiteVorgangPtr(datenpuffer, datenartVersion,
+        bearbeitungsFlags, druckParameter, cryptoParameter, transferHandle, rueckgabeXmlPuffer, serverantwortXmlPuffer));
 }
 
 int Eric::EricGetHandleToCertificate(EricZertifikatHandle * hToken,
                                      uint32_t *iInfoPinSupport,
                                      const char *pathToKeystore) const
 {
-    return EricGetHandleToCertificatePtr(hToken, iInfoPinSupport, pathToKeystore);
+    const EricMetriken::Aufruf aufruf("EricGetHandleToCertificate");
+    return aufruf.ende(EricGetHandleToCertificatePtr(hToken, iInfoPinSupport, pathToKeystore));
 }
 
 int Eric::EricCloseHandleToCertificate(EricZertifikatHandle hToken) const
 {
-    return EricCloseHandleToCertificatePtr(hToken);
+    const EricMetriken::Aufruf aufruf("EricCloseHandleToCertificate");
+    return aufruf.ende(EricCloseHandleToCertificatePtr(hToken));
 }
 
 int Eric::EricDekodiereDaten(EricZertifikatHandle zertifikatHandle,
@@ -302,22 +372,77 @@ int Eric::EricDekodiereDaten(EricZertifikatHandle zertifikatHandle,
                              const char * base64Eingabe,
                              EricRueckgabepufferHandle rueckgabeXmlPuffer) const
 {
-    return EricDekodiereDatenPtr(zertifikatHandle, pin, base64Eingabe, rueckgabeXmlPuffer);
+    const EricMetriken::Aufruf aufruf("EricDekodiereDaten");
+    return aufruf.ende(EricDekodiereDatenPtr(zertifikatHandle, pin, base64Eingabe, rueckgabeXmlPuffer));
 }
 
 int Eric::EricHoleFehlerText(int fehlerkode, EricRueckgabepufferHandle rueckgabePuffer) const
 {
-    return EricHoleFehlerTextPtr(fehlerkode, rueckgabePuffer);
+    const EricMetriken::Aufruf aufruf("EricHoleFehlerText");
+    return aufruf.ende(EricHoleFehlerTextPtr(fehlerkode, rueckgabePuffer));
+}
+
+int Eric::EricHoleFinanzamtLandNummern(EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricHoleFinanzamtLandNummern");
+    return aufruf.ende(EricHoleFinanzamtLandNummernPtr(rueckgabeXmlPuffer));
+}
+
+int Eric::EricHoleFinanzaemter(const char *finanzamtLandNummer, EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricHoleFinanzaemter");
+    return aufruf.ende(EricHoleFinanzaemterPtr(finanzamtLandNummer, rueckgabeXmlPuffer));
+}
+
+int Eric::EricHoleFinanzamtsdaten(const char bufaNr[5], EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricHoleFinanzamtsdaten");
+    return aufruf.ende(EricHoleFinanzamtsdatenPtr(bufaNr, rueckgabeXmlPuffer));
+}
+
+int Eric::EricGetPinStatus(EricZertifikatHandle hToken, uint32_t *pinStatus, uint32_t keyType) const
+{
+    const EricMetriken::Aufruf aufruf("EricGetPinStatus");
+    return aufruf.ende(EricGetPinStatusPtr(hToken, pinStatus, keyType));
+}
+
+int Eric::EricPruefeZertifikatPin(const char *pathToKeystore, const char *pin, uint32_t keyType) const
+{
+    const EricMetriken::Aufruf aufruf("EricPruefeZertifikatPin");
+    return aufruf.ende(EricPruefeZertifikatPinPtr(pathToKeystore, pin, keyType));
 }
 
 int Eric::EricPruefeSteuernummer(const char *steuernummer) const
 {
-    return EricPruefeSteuernummerPtr(steuernummer);
+    const EricMetriken::Aufruf aufruf("EricPruefeSteuernummer");
+    return aufruf.ende(EricPruefeSteuernummerPtr(steuernummer));
 }
 
 int Eric::EricSystemCheck() const
 {
-    return EricSystemCheckPtr();
+    const EricMetriken::Aufruf aufruf("EricSystemCheck");
+    return aufruf.ende(EricSystemCheckPtr());
+}
+
+int Eric::EricVersion(EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricVersion");
+    return aufruf.ende(EricVersionPtr(rueckgabeXmlPuffer));
+}
+
+int Eric::EricCheckXML(const char *xml, const char *datenartVersion, EricRueckgabepufferHandle fehlertextPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricCheckXML");
+    return aufruf.ende(EricCheckXMLPtr(xml, datenartVersion, fehlertextPuffer));
+}
+
+int Eric::EricGetErrormessagesFromXMLAnswer(const char *xml, EricRueckgabepufferHandle transferticketPuffer,
+    EricRueckgabepufferHandle returncodeTHPuffer, EricRueckgabepufferHandle fehlertextTHPuffer,
+    EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricGetErrormessagesFromXMLAnswer");
+    return aufruf.ende(EricGetErrormessagesFromXMLAnswerPtr(xml, transferticketPuffer, returncodeTHPuffer,
+                                                fehlertextTHPuffer, returncodesUndFehlertexteNDHXmlPuffer));
 }
 
 int Eric::EricRegistriereGlobalenFortschrittCallback(
@@ -367,13 +492,15 @@ int Eric::EricCreateTH(const char * xml,
                        const char * publicKey,
                        EricRueckgabepufferHandle handle) const
 {
-    return EricCreateTHPtr(xml, verfahren, datenart, vorgang, testmerker, herstellerId,
-        datenLieferant, versionClient, publicKey, handle);
+    const EricMetriken::Aufruf aufruf("EricCreateTH");
+    return aufruf.ende(EricCreateTHPtr(xml, verfahren, datenart, vorgang, testmerker, herstellerId,
+        datenLieferant, versionClient, publicKey, handle));
 }
 
 int Eric::EricHoleZertifikatEigenschaften(EricZertifikatHandle hToken,
                                           const char* pin,
                                           EricRueckgabepufferHandle rueckgabeXmlPuffer) const
 {
-    return EricHoleZertifikatEigenschaftenPtr(hToken, pin, rueckgabeXmlPuffer);
+    const EricMetriken::Aufruf aufruf("EricHoleZertifikatEigenschaften");
+    return aufruf.ende(EricHoleZertifikatEigenschaftenPtr(hToken, pin, rueckgabeXmlPuffer));
 }
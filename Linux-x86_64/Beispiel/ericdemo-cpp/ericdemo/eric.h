@@ -27,6 +27,21 @@ public:
     explicit Eric(const std::string &argHomeDir, const std::string &argLogDir);
     virtual ~Eric();
 
+    /** @brief Ermittelt das Verzeichnis der ERiC-Bibliotheken aus dem Programmparameter.
+     *         Ohne Angabe wird <Arbeitsverzeichnis>/../../lib verwendet,
+     *         relative Angaben werden an das Arbeitsverzeichnis angehaengt.
+     *
+     * @throw Anwendungsfehler, falls das Arbeitsverzeichnis nicht ermittelt werden kann
+     */
+    static std::string ermittleHeimverzeichnis(const std::string &argHomeDir);
+
+    /** @brief Ermittelt das Protokollverzeichnis aus dem Programmparameter.
+     *         Ohne Angabe oder bei relativer Angabe wird das Arbeitsverzeichnis verwendet.
+     *
+     * @throw Anwendungsfehler, falls das Arbeitsverzeichnis nicht ermittelt werden kann
+     */
+    static std::string ermittleLogverzeichnis(const std::string &argLogDir);
+
     /** @brief Entlaedt die ericapi. Alle weiteren Programmbibliotheken
      *         werden von der ericapi vorher automatisch mit Systemmitteln entladen.
      */
@@ -81,6 +96,32 @@ public:
         int fehlerkode,
         EricRueckgabepufferHandle rueckgabePuffer) const;
 
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricHoleFinanzamtLandNummern(
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricHoleFinanzaemter(
+        const char *finanzamtLandNummer,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricHoleFinanzamtsdaten(
+        const char bufaNr[5],
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricGetPinStatus(
+        EricZertifikatHandle hToken,
+        uint32_t *pinStatus,
+        uint32_t keyType) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricPruefeZertifikatPin(
+        const char *pathToKeystore,
+        const char *pin,
+        uint32_t keyType) const;
+
     /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
     int EricPruefeSteuernummer(
         const char *steuernummer) const;
@@ -88,6 +129,24 @@ public:
     /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
     int EricSystemCheck() const;
 
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricVersion(
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricCheckXML(
+        const char *xml,
+        const char *datenartVersion,
+        EricRueckgabepufferHandle fehlertextPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricGetErrormessagesFromXMLAnswer(
+        const char *xml,
+        EricRueckgabepufferHandle transferticketPuffer,
+        EricRueckgabepufferHandle returncodeTHPuffer,
+        EricRueckgabepufferHandle fehlertextTHPuffer,
+        EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer) const;
+
     int EricEinstellungAlleZuruecksetzen(void) const;
 
     /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
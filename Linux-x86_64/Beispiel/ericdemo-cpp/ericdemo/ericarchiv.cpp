@@ -0,0 +1,793 @@
+#include "ericarchiv.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <zlib.h>
+
+#include "anwendungsfehler.h"
+#include "system.h"
+
+
+namespace
+{
+
+// Kennung am Anfang von inhalte.dat; bei Formataenderungen hochzaehlen
+const char DATEIKENNUNG[8] = { 'E', 'R', 'I', 'C', 'A', 'R', '0', '2' };
+
+// Kennung am Anfang von woerterbuch.dat
+const char WOERTERBUCHKENNUNG[8] = { 'E', 'R', 'I', 'C', 'W', 'B', '0', '1' };
+
+// Woerterbuchkopf: Zahl der Beispiele, Laenge
+const size_t WOERTERBUCHKOPF_LAENGE = 2 * sizeof(uint32_t);
+
+// Satzkopf: Schluessel, Kodierung, Nummer des Woerterbuchs, Laenge entpackt, Laenge gespeichert
+const size_t KODIERUNG_VERSATZ = sizeof(EricArchiv::Schluessel);
+const size_t WOERTERBUCH_VERSATZ = KODIERUNG_VERSATZ + sizeof(uint8_t);
+const size_t ROHLAENGE_VERSATZ = WOERTERBUCH_VERSATZ + sizeof(uint16_t);
+const size_t LAENGE_VERSATZ = ROHLAENGE_VERSATZ + sizeof(uint32_t);
+const size_t SATZKOPF_LAENGE = LAENGE_VERSATZ + sizeof(uint32_t);
+
+// Die Nummer des Woerterbuchs belegt im Satzkopf zwei Bytes
+const size_t MAX_WOERTERBUECHER = 0x10000;
+
+enum Kodierung
+{
+    UNKOMPRIMIERT = 0,
+    DEFLATE_WOERTERBUCH = 1
+};
+
+// zlib nutzt hoechstens die letzten 32 KiB des Woerterbuchs
+const size_t MAX_WOERTERBUCH = 32 * 1024;
+
+// Tags, die laenger sind, sind selten wiederholt
+const size_t MAX_TAGLAENGE = 64;
+
+/** @brief FNV-1a ueber einen Speicherbereich */
+uint64_t fnv1a(uint64_t hash, const void *daten, size_t laenge)
+{
+    const unsigned char *zeichen = static_cast<const unsigned char *>(daten);
+    for (size_t i = 0; i < laenge; ++i)
+    {
+        hash ^= zeichen[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/** @brief Haengt einen Text samt Laenge an den Hash an, damit Feldgrenzen eindeutig sind */
+uint64_t fnv1a(uint64_t hash, const std::string &text)
+{
+    const uint64_t laenge = text.size();
+    hash = fnv1a(hash, &laenge, sizeof(laenge));
+    return fnv1a(hash, text.data(), text.size());
+}
+
+/** @brief Zwei FNV-1a mit verschiedenen Startwerten ueber Praefix, Folgenummer und Inhalt
+ *
+ * Ergibt fuer leeres Praefix und Folgenummer 0 dieselben Werte wie der
+ * fruehere Schluessel des Validierungscaches, bestehende Archive bleiben lesbar.
+ */
+EricArchiv::Schluessel berechneSchluessel(const std::string &praefix, const std::string &inhalt, uint32_t folge)
+{
+    EricArchiv::Schluessel ergebnis;
+    const uint64_t startwerte[2] = { 0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        uint64_t hash = fnv1a(startwerte[i], praefix);
+        hash = fnv1a(hash, std::string());      // Frueher die Datenartversion
+        hash = fnv1a(hash, &folge, sizeof(folge));
+        ergebnis.teil[i] = fnv1a(hash, inhalt);
+    }
+    return ergebnis;
+}
+
+/** @brief Schluessel eines Inhalts, unabhaengig von ERiC-Version und Vorgang */
+EricArchiv::Schluessel inhaltsSchluessel(const std::string &inhalt)
+{
+    return berechneSchluessel(std::string(), inhalt, 0);
+}
+
+std::string alsText(const EricArchiv::Schluessel &schluessel)
+{
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx",
+                  static_cast<unsigned long long>(schluessel.teil[0]), static_cast<unsigned long long>(schluessel.teil[1]));
+    return text;
+}
+
+/** @brief Schluessel fuer einen Inhalt, dessen bisheriger Schluessel schon einen anderen Inhalt bezeichnet
+ *
+ * Die Folge haengt nur vom Inhalt ab, ein gleicher Inhalt findet also
+ * spaeter ueber dieselben Schluessel zu seinem Satz.
+ */
+EricArchiv::Schluessel folgeSchluessel(const EricArchiv::Schluessel &schluessel, const std::string &inhalt, uint32_t folge)
+{
+    return berechneSchluessel(alsText(schluessel), inhalt, folge);
+}
+
+bool ausText(const std::string &text, EricArchiv::Schluessel &schluessel)
+{
+    if (text.size() != 32 || text.find_first_not_of("0123456789abcdef") != std::string::npos)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < 2; ++i)
+    {
+        schluessel.teil[i] = std::stoull(text.substr(16 * i, 16), nullptr, 16);
+    }
+    return true;
+}
+
+/** @brief Tabulatoren und Zeilenwechsel wuerden die Zeilen von index.dat zerstoeren */
+std::string alsIndexfeld(const std::string &text)
+{
+    std::string feld(text);
+    std::replace(feld.begin(), feld.end(), '\t', ' ');
+    std::replace(feld.begin(), feld.end(), '\n', ' ');
+    std::replace(feld.begin(), feld.end(), '\r', ' ');
+    return feld;
+}
+
+/** @brief Haengt Daten hinter den ersten gueltigeLaenge Bytes einer vorhandenen Datei an
+ *
+ * Reste eines frueheren, fehlgeschlagenen Schreibzugriffs werden vorher
+ * abgeschnitten. Ein fehlgeschlagener Versuch wird einmal wiederholt,
+ * danach endet die Datei wieder bei gueltigeLaenge.
+ */
+bool haengeAn(const std::string &dateiName, uint64_t gueltigeLaenge, const std::string &daten)
+{
+    for (int versuch = 0; versuch < 2; ++versuch)
+    {
+        if (!System::kuerzeDatei(dateiName, gueltigeLaenge))
+        {
+            continue;
+        }
+        std::ofstream datei(dateiName.c_str(), std::ios_base::binary | std::ios_base::app);
+        datei.write(daten.data(), daten.size());
+        datei.close();
+        if (!datei.fail())
+        {
+            return true;
+        }
+    }
+    System::kuerzeDatei(dateiName, gueltigeLaenge);
+    return false;
+}
+
+/** @brief Komprimiert mit dem Woerterbuch; false, wenn das Ergebnis nicht kleiner wird */
+bool komprimiere(const std::string &woerterbuch, const std::string &inhalt, std::string &gepackt)
+{
+    z_stream strom;
+    std::memset(&strom, 0, sizeof(strom));
+    if (deflateInit(&strom, Z_BEST_COMPRESSION) != Z_OK)
+    {
+        return false;
+    }
+
+    bool ok = deflateSetDictionary(&strom, reinterpret_cast<const Bytef *>(woerterbuch.data()),
+                                   static_cast<uInt>(woerterbuch.size())) == Z_OK;
+    if (ok)
+    {
+        gepackt.resize(deflateBound(&strom, static_cast<uLong>(inhalt.size())));
+        strom.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(inhalt.data()));
+        strom.avail_in = static_cast<uInt>(inhalt.size());
+        strom.next_out = reinterpret_cast<Bytef *>(&gepackt[0]);
+        strom.avail_out = static_cast<uInt>(gepackt.size());
+        ok = deflate(&strom, Z_FINISH) == Z_STREAM_END && strom.total_out < inhalt.size();
+        gepackt.resize(strom.total_out);
+    }
+    deflateEnd(&strom);
+    return ok;
+}
+
+bool entpacke(const std::string &woerterbuch, const char *gepackt, size_t laenge, size_t rohLaenge, std::string &inhalt)
+{
+    z_stream strom;
+    std::memset(&strom, 0, sizeof(strom));
+    if (inflateInit(&strom) != Z_OK)
+    {
+        return false;
+    }
+
+    inhalt.resize(rohLaenge);
+    strom.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(gepackt));
+    strom.avail_in = static_cast<uInt>(laenge);
+    strom.next_out = reinterpret_cast<Bytef *>(rohLaenge > 0 ? &inhalt[0] : nullptr);
+    strom.avail_out = static_cast<uInt>(rohLaenge);
+
+    // zlib prueft anhand der Adler-32-Pruefsumme, ob das Woerterbuch passt
+    int rc = inflate(&strom, Z_FINISH);
+    if (rc == Z_NEED_DICT)
+    {
+        rc = inflateSetDictionary(&strom, reinterpret_cast<const Bytef *>(woerterbuch.data()), static_cast<uInt>(woerterbuch.size()));
+        if (rc == Z_OK)
+        {
+            rc = inflate(&strom, Z_FINISH);
+        }
+    }
+    const bool ok = rc == Z_STREAM_END && strom.total_out == rohLaenge;
+    inflateEnd(&strom);
+    return ok;
+}
+
+} // anonymous namespace
+
+
+const size_t EricArchiv::MAX_BEISPIELE;
+
+EricArchiv::EricArchiv(const std::string &verzeichnis_, const std::vector<std::string> &beispiele)
+    : verzeichnis(verzeichnis_),
+      schreibtStapel(false),
+      beenden(false),
+      trainiertMit(0),
+      woerterbuchLaenge(0),
+      inhalteLaenge(0),
+      indexLaenge(0),
+      statistik()
+{
+    if (!System::erzeugeGeschuetztesVerzeichnis(verzeichnis))
+    {
+        throw Anwendungsfehler("Das Archivverzeichnis \"" + verzeichnis + "\" konnte nicht angelegt werden.");
+    }
+    oeffneWoerterbuecher(beispiele);
+    oeffneInhalte();
+    oeffneIndex();
+
+    // Ein Woerterbuch aus wenigen Datensaetzen wird ersetzt, sobald sich ihre Zahl verdoppelt hat.
+    // Schlaegt das fehl, bleibt das bisherige in Gebrauch.
+    if (trainiertMit < MAX_BEISPIELE)
+    {
+        const std::vector<uint64_t> positionen = datensatzPositionen();
+        if (positionen.size() > trainiertMit && positionen.size() >= std::min<size_t>(MAX_BEISPIELE, 2 * trainiertMit))
+        {
+            haengeWoerterbuchAn(leseDatensaetze(positionen));
+        }
+    }
+
+    schreiber = std::thread(&EricArchiv::schreibe, this);
+}
+
+EricArchiv::~EricArchiv()
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    auftragVorhanden.notify_all();
+    schreiber.join();
+}
+
+void EricArchiv::archiviere(const std::string &transferticket, std::vector<Artefakt> artefakte)
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        warteschlange.push_back(Auftrag());
+        warteschlange.back().transferticket = transferticket;
+        warteschlange.back().artefakte.swap(artefakte);
+    }
+    auftragVorhanden.notify_one();
+}
+
+void EricArchiv::warteAufSchreiben()
+{
+    std::unique_lock<std::mutex> lock(sperre);
+    while (!warteschlange.empty() || schreibtStapel)
+    {
+        stapelGeschrieben.wait(lock);
+    }
+}
+
+std::vector<EricArchiv::Verweis> EricArchiv::artefakte(const std::string &transferticket) const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    std::vector<Verweis> verweise;
+    const std::pair<std::multimap<std::string, Verweis>::const_iterator, std::multimap<std::string, Verweis>::const_iterator>
+        bereich = ticketIndex.equal_range(transferticket);
+    for (std::multimap<std::string, Verweis>::const_iterator it = bereich.first; it != bereich.second; ++it)
+    {
+        verweise.push_back(it->second);
+    }
+    return verweise;
+}
+
+bool EricArchiv::lese(const Schluessel &schluessel, std::string &inhalt) const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    const std::map<Schluessel, uint64_t>::const_iterator fund = inhaltsIndex.find(schluessel);
+    return fund != inhaltsIndex.end() && leseSatz(fund->second, inhalt);
+}
+
+EricArchiv::Kennzahlen EricArchiv::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.inhalte = inhaltsIndex.size();
+    momentaufnahme.woerterbuecher = woerterbuecher.size();
+    momentaufnahme.wartend = warteschlange.size();
+    return momentaufnahme;
+}
+
+bool EricArchiv::trainiereNeu(const std::vector<std::string> &beispiele)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    return haengeWoerterbuchAn(beispiele.empty() ? leseDatensaetze(datensatzPositionen()) : beispiele);
+}
+
+std::string EricArchiv::trainiereWoerterbuch(const std::vector<std::string> &beispiele)
+{
+    std::map<std::string, uint64_t> haeufigkeit;
+    for (size_t b = 0; b < beispiele.size(); ++b)
+    {
+        const std::string &xml = beispiele[b];
+        for (size_t anfang = xml.find('<'); anfang != std::string::npos; anfang = xml.find('<', anfang + 1))
+        {
+            // Attribute wiederholen sich kaum, gezaehlt wird nur der Tag bis zum Ende seines Namens
+            const size_t name = anfang + (anfang + 1 < xml.size() && xml[anfang + 1] == '/' ? 2 : 1);
+            const size_t nameEnde = xml.find_first_of("<>/ \t\r\n", name);
+            if (nameEnde == std::string::npos || nameEnde == name || xml[name] == '?' || xml[name] == '!' || xml[nameEnde] == '<')
+            {
+                continue;
+            }
+
+            std::string tag = xml.substr(anfang, nameEnde - anfang);
+            if (xml[nameEnde] == '>')
+            {
+                tag += '>';
+            }
+            else if (xml[nameEnde] == '/')
+            {
+                if (name == anfang + 2 || nameEnde + 1 >= xml.size() || xml[nameEnde + 1] != '>')
+                {
+                    continue;
+                }
+                tag += "/>";
+            }
+            else if (name == anfang + 1)
+            {
+                tag += ' ';
+            }
+            else
+            {
+                tag += '>';
+            }
+            if (tag.size() <= MAX_TAGLAENGE)
+            {
+                ++haeufigkeit[tag];
+            }
+        }
+    }
+
+    std::vector<std::pair<uint64_t, std::string> > wert;
+    for (std::map<std::string, uint64_t>::const_iterator it = haeufigkeit.begin(); it != haeufigkeit.end(); ++it)
+    {
+        wert.push_back(std::make_pair(it->second * it->first.size(), it->first));
+    }
+    std::sort(wert.rbegin(), wert.rend());
+
+    // Die wertvollsten Tags passen sicher hinein und stehen zuletzt
+    size_t laenge = 0;
+    size_t anzahl = 0;
+    while (anzahl < wert.size() && laenge + wert[anzahl].second.size() <= MAX_WOERTERBUCH)
+    {
+        laenge += wert[anzahl++].second.size();
+    }
+    std::string woerterbuch;
+    woerterbuch.reserve(laenge);
+    for (size_t i = anzahl; i > 0; --i)
+    {
+        woerterbuch += wert[i - 1].second;
+    }
+    return woerterbuch;
+}
+
+void EricArchiv::oeffneWoerterbuecher(const std::vector<std::string> &beispiele)
+{
+    const std::string dateiName = System::dateiPfad(verzeichnis, "woerterbuch.dat");
+    {
+        const System::Dateiabbild vorhanden(dateiName);
+        const char *daten = vorhanden.daten();
+        const size_t groesse = vorhanden.groesse();
+        if (groesse > 0)
+        {
+            if (groesse < sizeof(WOERTERBUCHKENNUNG) || 0 != std::memcmp(daten, WOERTERBUCHKENNUNG, sizeof(WOERTERBUCHKENNUNG)))
+            {
+                throw Anwendungsfehler("Die Datei \"" + dateiName + "\" ist kein Woerterbuch.");
+            }
+
+            // Ein unvollstaendiges letztes Woerterbuch wird beim naechsten Anhaengen abgeschnitten
+            size_t position = sizeof(WOERTERBUCHKENNUNG);
+            while (position + WOERTERBUCHKOPF_LAENGE <= groesse)
+            {
+                uint32_t anzahl = 0;
+                uint32_t laenge = 0;
+                std::memcpy(&anzahl, daten + position, sizeof(anzahl));
+                std::memcpy(&laenge, daten + position + sizeof(anzahl), sizeof(laenge));
+                if (position + WOERTERBUCHKOPF_LAENGE + laenge > groesse)
+                {
+                    break;
+                }
+                woerterbuecher.push_back(std::shared_ptr<const std::string>(
+                    new std::string(daten + position + WOERTERBUCHKOPF_LAENGE, laenge)));
+                trainiertMit = anzahl;
+                position += WOERTERBUCHKOPF_LAENGE + laenge;
+            }
+            woerterbuchLaenge = position;
+        }
+    }
+
+    if (0 == woerterbuchLaenge)
+    {
+        if (!System::schreibeDatei(std::string(WOERTERBUCHKENNUNG, sizeof(WOERTERBUCHKENNUNG)), dateiName))
+        {
+            throw Anwendungsfehler("Das Woerterbuch \"" + dateiName + "\" konnte nicht geschrieben werden.");
+        }
+        woerterbuchLaenge = sizeof(WOERTERBUCHKENNUNG);
+    }
+    if (woerterbuecher.empty() && !haengeWoerterbuchAn(beispiele))
+    {
+        throw Anwendungsfehler("Das Woerterbuch \"" + dateiName + "\" konnte nicht geschrieben werden.");
+    }
+}
+
+void EricArchiv::oeffneInhalte()
+{
+    const std::string dateiName = System::dateiPfad(verzeichnis, "inhalte.dat");
+    abbild.reset(new System::Dateiabbild(dateiName));
+
+    const char *daten = abbild->daten();
+    const size_t groesse = abbild->groesse();
+    size_t position = 0;
+
+    if (groesse >= sizeof(DATEIKENNUNG) && 0 == std::memcmp(daten, DATEIKENNUNG, sizeof(DATEIKENNUNG)))
+    {
+        position = sizeof(DATEIKENNUNG);
+        while (position + SATZKOPF_LAENGE <= groesse)
+        {
+            Schluessel schluessel;
+            uint32_t laenge = 0;
+            std::memcpy(&schluessel, daten + position, sizeof(schluessel));
+            std::memcpy(&laenge, daten + position + LAENGE_VERSATZ, sizeof(laenge));
+            if (position + SATZKOPF_LAENGE + laenge > groesse)
+            {
+                break;
+            }
+            inhaltsIndex[schluessel] = position;
+            position += SATZKOPF_LAENGE + laenge;
+        }
+        if (position == groesse)
+        {
+            inhalteLaenge = groesse;
+            return;
+        }
+    }
+    else if (groesse > 0)
+    {
+        throw Anwendungsfehler("Die Datei \"" + dateiName + "\" ist kein Archiv.");
+    }
+
+    // Die Datei ist neu oder endet mit einem unvollstaendigen Satz, z. B. nach
+    // einem Absturz beim Schreiben. Nur die vollstaendigen Saetze werden uebernommen.
+    std::string gueltigeSaetze;
+    if (position > 0)
+    {
+        gueltigeSaetze.assign(daten, position);
+    }
+    else
+    {
+        gueltigeSaetze.assign(DATEIKENNUNG, sizeof(DATEIKENNUNG));
+    }
+    abbild.reset();
+    if (!System::schreibeDatei(gueltigeSaetze, dateiName))
+    {
+        throw Anwendungsfehler("Das Archiv \"" + dateiName + "\" konnte nicht geschrieben werden.");
+    }
+    inhalteLaenge = gueltigeSaetze.size();
+}
+
+void EricArchiv::oeffneIndex()
+{
+    const std::string dateiName = System::dateiPfad(verzeichnis, "index.dat");
+    std::ifstream datei(dateiName.c_str(), std::ios_base::binary);
+    if (!datei.is_open())
+    {
+        if (!System::schreibeDatei(std::string(), dateiName))
+        {
+            throw Anwendungsfehler("Der Index \"" + dateiName + "\" konnte nicht angelegt werden.");
+        }
+        return;
+    }
+
+    std::string zeile;
+    while (std::getline(datei, zeile) && !datei.eof())
+    {
+        // Eine unvollstaendige letzte Zeile wird beim naechsten Anhaengen abgeschnitten
+        indexLaenge += zeile.size() + 1;
+
+        const size_t trenner1 = zeile.find('\t');
+        const size_t trenner2 = trenner1 == std::string::npos ? std::string::npos : zeile.find('\t', trenner1 + 1);
+        Verweis verweis;
+        if (trenner2 == std::string::npos || !ausText(zeile.substr(trenner2 + 1), verweis.schluessel))
+        {
+            continue;
+        }
+        // Verweise auf Inhalte, die beim Absturz nicht mehr geschrieben wurden, werden verworfen
+        if (inhaltsIndex.count(verweis.schluessel) != 0)
+        {
+            verweis.art = zeile.substr(trenner1 + 1, trenner2 - trenner1 - 1);
+            ticketIndex.insert(std::make_pair(zeile.substr(0, trenner1), verweis));
+        }
+    }
+}
+
+bool EricArchiv::haengeWoerterbuchAn(const std::vector<std::string> &beispiele)
+{
+    if (woerterbuecher.size() >= MAX_WOERTERBUECHER)
+    {
+        return false;
+    }
+
+    std::string woerterbuch = trainiereWoerterbuch(beispiele);
+    if (woerterbuch.empty())
+    {
+        // Ohne Beispiele traegt das Woerterbuch nur die XML-Deklaration
+        woerterbuch = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+    }
+    const uint32_t anzahl = static_cast<uint32_t>(beispiele.size());
+    const uint32_t laenge = static_cast<uint32_t>(woerterbuch.size());
+    std::string satz;
+    satz.append(reinterpret_cast<const char *>(&anzahl), sizeof(anzahl));
+    satz.append(reinterpret_cast<const char *>(&laenge), sizeof(laenge));
+    satz.append(woerterbuch);
+    if (!haengeAn(System::dateiPfad(verzeichnis, "woerterbuch.dat"), woerterbuchLaenge, satz))
+    {
+        return false;
+    }
+
+    woerterbuchLaenge += satz.size();
+    woerterbuecher.push_back(std::shared_ptr<const std::string>(new std::string(MOVE_NO_XLC(woerterbuch))));
+    trainiertMit = anzahl;
+    return true;
+}
+
+std::vector<uint64_t> EricArchiv::datensatzPositionen() const
+{
+    std::vector<uint64_t> positionen;
+    for (std::multimap<std::string, Verweis>::const_iterator it = ticketIndex.begin(); it != ticketIndex.end(); ++it)
+    {
+        const std::map<Schluessel, uint64_t>::const_iterator fund = inhaltsIndex.find(it->second.schluessel);
+        if (it->second.art == "datensatz" && fund != inhaltsIndex.end())
+        {
+            positionen.push_back(fund->second);
+        }
+    }
+    // Spaeter abgelegte Inhalte stehen weiter hinten in inhalte.dat
+    std::sort(positionen.rbegin(), positionen.rend());
+    positionen.erase(std::unique(positionen.begin(), positionen.end()), positionen.end());
+    return positionen;
+}
+
+std::vector<std::string> EricArchiv::leseDatensaetze(const std::vector<uint64_t> &positionen) const
+{
+    std::vector<std::string> datensaetze;
+    for (size_t i = 0; i < positionen.size() && datensaetze.size() < MAX_BEISPIELE; ++i)
+    {
+        std::string datensatz;
+        if (leseSatz(positionen[i], datensatz))
+        {
+            datensaetze.push_back(MOVE_NO_XLC(datensatz));
+        }
+    }
+    return datensaetze;
+}
+
+bool EricArchiv::leseSatz(uint64_t position, std::string &inhalt) const
+{
+    bool neuEingeblendet = false;
+    if (!abbild || position + SATZKOPF_LAENGE > abbild->groesse())
+    {
+        // Seit dem Einblenden angehaengt
+        abbild.reset(new System::Dateiabbild(System::dateiPfad(verzeichnis, "inhalte.dat")));
+        neuEingeblendet = true;
+        if (position + SATZKOPF_LAENGE > abbild->groesse())
+        {
+            return false;
+        }
+    }
+
+    uint32_t laenge = 0;
+    std::memcpy(&laenge, abbild->daten() + position + LAENGE_VERSATZ, sizeof(laenge));
+    if (position + SATZKOPF_LAENGE + laenge > abbild->groesse())
+    {
+        // Beim Einblenden war der Satz erst teilweise geschrieben
+        if (neuEingeblendet)
+        {
+            return false;
+        }
+        abbild.reset(new System::Dateiabbild(System::dateiPfad(verzeichnis, "inhalte.dat")));
+        if (position + SATZKOPF_LAENGE + laenge > abbild->groesse())
+        {
+            return false;
+        }
+    }
+
+    const char *satz = abbild->daten() + position;
+    uint8_t kodierung = 0;
+    uint16_t nummer = 0;
+    uint32_t rohLaenge = 0;
+    std::memcpy(&kodierung, satz + KODIERUNG_VERSATZ, sizeof(kodierung));
+    std::memcpy(&nummer, satz + WOERTERBUCH_VERSATZ, sizeof(nummer));
+    std::memcpy(&rohLaenge, satz + ROHLAENGE_VERSATZ, sizeof(rohLaenge));
+
+    const char *daten = satz + SATZKOPF_LAENGE;
+    if (kodierung == UNKOMPRIMIERT)
+    {
+        inhalt.assign(daten, laenge);
+        return true;
+    }
+    return kodierung == DEFLATE_WOERTERBUCH && nummer < woerterbuecher.size()
+        && entpacke(*woerterbuecher[nummer], daten, laenge, rohLaenge, inhalt);
+}
+
+void EricArchiv::schreibe()
+{
+    System::senkeThreadPrioritaet();
+
+    std::unique_lock<std::mutex> lock(sperre);
+    for (;;)
+    {
+        while (warteschlange.empty() && !beenden)
+        {
+            auftragVorhanden.wait(lock);
+        }
+        if (warteschlange.empty())
+        {
+            return;
+        }
+
+        // Alle bis jetzt eingegangenen Auftraege bilden einen Stapel
+        std::deque<Auftrag> stapel;
+        stapel.swap(warteschlange);
+        schreibtStapel = true;
+        lock.unlock();
+
+        schreibeStapel(stapel);
+
+        lock.lock();
+        schreibtStapel = false;
+        stapelGeschrieben.notify_all();
+    }
+}
+
+void EricArchiv::schreibeStapel(std::deque<Auftrag> &stapel)
+{
+    // Nur dieser Thread schreibt, Inhaltsindex und Dateilaengen werden also nur hier veraendert
+    uint64_t position;
+    uint64_t indexPosition;
+    uint16_t woerterbuchNummer;
+    std::shared_ptr<const std::string> woerterbuch;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        position = inhalteLaenge;
+        indexPosition = indexLaenge;
+        woerterbuchNummer = static_cast<uint16_t>(woerterbuecher.size() - 1);
+        woerterbuch = woerterbuecher.back();
+    }
+    const uint64_t inhalteAnfang = position;
+
+    std::map<Schluessel, uint64_t> neueInhalte;
+    std::map<Schluessel, const std::string *> neueTexte;
+    std::vector<std::pair<std::string, Verweis> > neueVerweise;
+    std::string inhalte;
+    std::ostringstream index;
+    Kennzahlen zuwachs = Kennzahlen();
+
+    for (size_t a = 0; a < stapel.size(); ++a)
+    {
+        const Auftrag &auftrag = stapel[a];
+        for (size_t i = 0; i < auftrag.artefakte.size(); ++i)
+        {
+            const Artefakt &artefakt = auftrag.artefakte[i];
+            Verweis verweis;
+            verweis.art = alsIndexfeld(artefakt.art);
+            verweis.schluessel = inhaltsSchluessel(artefakt.inhalt);
+            ++zuwachs.artefakte;
+
+            // Ein gleicher Schluessel zaehlt erst als Treffer, wenn auch die Bytes gleich sind
+            bool vorhanden = false;
+            for (uint32_t folge = 1; ; ++folge)
+            {
+                bool belegt = false;
+                const std::map<Schluessel, const std::string *>::const_iterator imStapel = neueTexte.find(verweis.schluessel);
+                if (imStapel != neueTexte.end())
+                {
+                    belegt = true;
+                    vorhanden = *imStapel->second == artefakt.inhalt;
+                }
+                else
+                {
+                    std::lock_guard<std::mutex> lock(sperre);
+                    const std::map<Schluessel, uint64_t>::const_iterator imArchiv = inhaltsIndex.find(verweis.schluessel);
+                    if (imArchiv != inhaltsIndex.end())
+                    {
+                        std::string abgelegt;
+                        belegt = true;
+                        vorhanden = leseSatz(imArchiv->second, abgelegt) && abgelegt == artefakt.inhalt;
+                    }
+                }
+                if (!belegt || vorhanden)
+                {
+                    break;
+                }
+                ++zuwachs.kollisionen;
+                verweis.schluessel = folgeSchluessel(verweis.schluessel, artefakt.inhalt, folge);
+            }
+
+            if (vorhanden)
+            {
+                ++zuwachs.doppelt;
+            }
+            else
+            {
+                std::string gepackt;
+                const uint8_t kodierung = komprimiere(*woerterbuch, artefakt.inhalt, gepackt) ? DEFLATE_WOERTERBUCH : UNKOMPRIMIERT;
+                const std::string &daten = kodierung == DEFLATE_WOERTERBUCH ? gepackt : artefakt.inhalt;
+                const uint32_t rohLaenge = static_cast<uint32_t>(artefakt.inhalt.size());
+                const uint32_t laenge = static_cast<uint32_t>(daten.size());
+
+                inhalte.append(reinterpret_cast<const char *>(&verweis.schluessel), sizeof(verweis.schluessel));
+                inhalte.append(reinterpret_cast<const char *>(&kodierung), sizeof(kodierung));
+                inhalte.append(reinterpret_cast<const char *>(&woerterbuchNummer), sizeof(woerterbuchNummer));
+                inhalte.append(reinterpret_cast<const char *>(&rohLaenge), sizeof(rohLaenge));
+                inhalte.append(reinterpret_cast<const char *>(&laenge), sizeof(laenge));
+                inhalte.append(daten);
+
+                neueInhalte[verweis.schluessel] = position;
+                neueTexte[verweis.schluessel] = &artefakt.inhalt;
+                position += SATZKOPF_LAENGE + laenge;
+                ++zuwachs.neu;
+                zuwachs.rohBytes += rohLaenge;
+                zuwachs.gespeichertBytes += laenge;
+            }
+
+            const std::string ticket = alsIndexfeld(auftrag.transferticket);
+            index << ticket << '\t' << verweis.art << '\t' << alsText(verweis.schluessel) << '\n';
+            neueVerweise.push_back(std::make_pair(ticket, verweis));
+        }
+    }
+
+    // Inhalte vor dem Index, damit kein Indexeintrag auf einen fehlenden Inhalt zeigt.
+    // Nach einem Fehler enden beide Dateien wieder beim letzten vollstaendigen Satz,
+    // der naechste Stapel kann also normal angehaengt werden.
+    if (!inhalte.empty() && !::haengeAn(System::dateiPfad(verzeichnis, "inhalte.dat"), inhalteAnfang, inhalte))
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.stapel;
+        ++statistik.schreibfehler;
+        return;
+    }
+
+    const std::string indexText = index.str();
+    const bool indexGeschrieben = ::haengeAn(System::dateiPfad(verzeichnis, "index.dat"), indexPosition, indexText);
+
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.stapel;
+    inhaltsIndex.insert(neueInhalte.begin(), neueInhalte.end());
+    inhalteLaenge = position;
+    if (!indexGeschrieben)
+    {
+        ++statistik.schreibfehler;
+        return;
+    }
+    indexLaenge += indexText.size();
+    ticketIndex.insert(neueVerweise.begin(), neueVerweise.end());
+    statistik.artefakte += zuwachs.artefakte;
+    statistik.neu += zuwachs.neu;
+    statistik.doppelt += zuwachs.doppelt;
+    statistik.kollisionen += zuwachs.kollisionen;
+    statistik.rohBytes += zuwachs.rohBytes;
+    statistik.gespeichertBytes += zuwachs.gespeichertBytes;
+}
@@ -0,0 +1,196 @@
+#ifndef _ERICARCHIV_H_
+#define _ERICARCHIV_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Vorwaertsdeklarationen
+namespace System { class Dateiabbild; }
+
+
+/** @brief Archiv fuer Datensaetze, Serverantworten und PDFs versendeter Vorgaenge
+ *
+ * Jedes Artefakt wird ueber einen Hashwert seines Inhalts nur einmal
+ * abgelegt, gleiche Inhalte verschiedener Vorgaenge teilen sich einen
+ * Eintrag. Ein Inhalt gilt erst dann als bereits vorhanden, wenn auch seine
+ * Bytes mit dem abgelegten Inhalt uebereinstimmen; ist der Hashwert schon
+ * fuer einen anderen Inhalt vergeben, wird ein Folgeschluessel abgeleitet.
+ *
+ * Die Inhalte werden mit zlib und einem Woerterbuch aus den Tagnamen von
+ * ELSTER-XML komprimiert. Das erste Woerterbuch wird beim Anlegen des
+ * Archivs trainiert. Solange weniger als MAX_BEISPIELE Datensaetze
+ * eingeflossen sind, wird beim Oeffnen ein neues Woerterbuch aus den
+ * juengsten archivierten Datensaetzen trainiert, sobald sich ihre Zahl
+ * verdoppelt hat; trainiereNeu() erzwingt das. Jeder Satz nennt sein
+ * Woerterbuch, bereits abgelegte Inhalte behalten also ihres.
+ * Ein Index ordnet jedem Transferticket seine Artefakte zu.
+ *
+ * Verzeichnisinhalt:
+ * - woerterbuch.dat: Kennung, dann je Woerterbuch die Zahl seiner Beispiele, seine Laenge und sein Text
+ * - inhalte.dat:     Kennung, dann je Inhalt ein Satz aus Schluessel, Kodierung, Nummer des
+ *                    Woerterbuchs, Laenge vor und nach der Komprimierung
+ * - index.dat:       Je Artefakt eine Zeile "Transferticket<TAB>Art<TAB>Schluessel"
+ *
+ * archiviere() kehrt sofort zurueck. Hashen, Komprimieren und Schreiben
+ * erledigt ein Hintergrundthread, der alle bis dahin eingegangenen
+ * Auftraege in einem Stapel mit je einem Schreibzugriff pro Datei ablegt.
+ * Scheitert ein Schreibzugriff, wird die Datei auf den letzten
+ * vollstaendigen Satz gekuerzt und der Zugriff einmal wiederholt. Scheitert
+ * auch das, wird nur dieser Stapel verworfen und in kennzahlen() gezaehlt.
+ * Ein Verzeichnis darf nur von einem Prozess gleichzeitig verwendet werden.
+ */
+class EricArchiv
+{
+public:
+    /** @brief FNV-1a-Hashwert eines Inhalts; nur zusammen mit einem Vergleich der Bytes eindeutig */
+    struct Schluessel
+    {
+        uint64_t teil[2];
+
+        bool operator<(const Schluessel &rechts) const
+        {
+            return teil[0] != rechts.teil[0] ? teil[0] < rechts.teil[0] : teil[1] < rechts.teil[1];
+        }
+    };
+
+    /** @brief Hoechstzahl der Datensaetze, aus denen ein Woerterbuch trainiert wird */
+    static const size_t MAX_BEISPIELE = 32;
+
+    /** @brief Zu archivierender Inhalt */
+    struct Artefakt
+    {
+        std::string art;            // z. B. "datensatz", "serverantwort", "pdf:<Bezeichner>"
+        std::string inhalt;
+    };
+
+    /** @brief Indexeintrag eines archivierten Artefakts */
+    struct Verweis
+    {
+        std::string art;
+        Schluessel  schluessel;
+    };
+
+    /** @brief Kennzahlen seit dem Oeffnen des Archivs */
+    struct Kennzahlen
+    {
+        uint64_t artefakte;         // Archivierte Artefakte
+        uint64_t neu;               // Davon neu abgelegte Inhalte
+        uint64_t doppelt;           // Davon bereits vorhandene Inhalte
+        uint64_t kollisionen;       // Hashwerte, die schon fuer einen anderen Inhalt vergeben waren
+        uint64_t rohBytes;          // Groesse der neuen Inhalte
+        uint64_t gespeichertBytes;  // Deren Groesse nach der Komprimierung
+        uint64_t stapel;            // Schreibvorgaenge des Hintergrundthreads
+        uint64_t schreibfehler;     // Verworfene Stapel
+        size_t   inhalte;           // Inhalte im Archiv
+        size_t   woerterbuecher;    // Woerterbuecher im Archiv
+        size_t   wartend;           // Noch nicht geschriebene Auftraege
+    };
+
+    /** @brief Oeffnet oder erzeugt das Archiv
+      *
+      * @param verzeichnis Verzeichnis des Archivs, wird bei Bedarf angelegt
+      * @param beispiele   ELSTER-XML, aus dem das erste Woerterbuch eines neuen Archivs trainiert wird;
+      *                    bei einem bestehenden Archiv ohne Bedeutung
+      *
+      * @throw Anwendungsfehler, wenn das Verzeichnis nicht angelegt oder das Archiv nicht gelesen werden kann
+      */
+    EricArchiv(const std::string &verzeichnis, const std::vector<std::string> &beispiele);
+
+    /** @brief Schreibt alle ausstehenden Auftraege und beendet den Hintergrundthread */
+    virtual ~EricArchiv();
+
+    /** @brief Uebergibt die Artefakte eines Vorgangs an den Hintergrundthread */
+    void archiviere(const std::string &transferticket, std::vector<Artefakt> artefakte);
+
+    /** @brief Wartet, bis alle bisher uebergebenen Auftraege geschrieben sind */
+    void warteAufSchreiben();
+
+    /** @brief Liefert die Artefakte zu einem Transferticket in der Reihenfolge ihrer Archivierung */
+    std::vector<Verweis> artefakte(const std::string &transferticket) const;
+
+    /** @brief Liest und entpackt einen archivierten Inhalt
+      *
+      * @return false, wenn der Inhalt nicht (mehr) gelesen werden kann
+      */
+    bool lese(const Schluessel &schluessel, std::string &inhalt) const;
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+    /** @brief Trainiert ein neues Woerterbuch, mit dem ab sofort neue Inhalte komprimiert werden
+      *
+      * @param beispiele ELSTER-XML; ist die Liste leer, die juengsten bis zu
+      *        MAX_BEISPIELE archivierten Datensaetze
+      *
+      * @return false, wenn das Woerterbuch nicht geschrieben werden konnte; das bisherige bleibt dann in Gebrauch
+      */
+    bool trainiereNeu(const std::vector<std::string> &beispiele);
+
+    /** @brief Stellt ein Woerterbuch aus den haeufigsten Tags der Beispiele zusammen
+      *
+      * Beruecksichtigt werden nur Tagnamen ohne Attribute, also "<Name>",
+      * "</Name>" und bei Tags mit Attributen "<Name ". Die wertvollsten Tags
+      * (Haeufigkeit mal Laenge) stehen am Ende, wo zlib sie mit den kuerzesten
+      * Abstaenden erreicht.
+      */
+    static std::string trainiereWoerterbuch(const std::vector<std::string> &beispiele);
+
+private:
+    EricArchiv(const EricArchiv &); // Kopien verboten
+    EricArchiv &operator=(const EricArchiv &); // Zuweisungen verboten
+
+    struct Auftrag
+    {
+        std::string           transferticket;
+        std::vector<Artefakt> artefakte;
+    };
+
+    void oeffneWoerterbuecher(const std::vector<std::string> &beispiele);
+    void oeffneInhalte();
+    void oeffneIndex();
+    void schreibe();
+    void schreibeStapel(std::deque<Auftrag> &stapel);
+
+    /** @brief Legt ein Woerterbuch ab; nur mit gehaltener Sperre oder aus dem Konstruktor aufrufen */
+    bool haengeWoerterbuchAn(const std::vector<std::string> &beispiele);
+
+    /** @brief Positionen der archivierten Datensaetze in inhalte.dat, die juengsten zuerst;
+      *        nur mit gehaltener Sperre oder aus dem Konstruktor aufrufen */
+    std::vector<uint64_t> datensatzPositionen() const;
+
+    /** @brief Liest bis zu MAX_BEISPIELE Datensaetze; nur mit gehaltener Sperre oder aus dem Konstruktor aufrufen */
+    std::vector<std::string> leseDatensaetze(const std::vector<uint64_t> &positionen) const;
+
+    /** @brief Liest den Satz an einer Position in inhalte.dat; nur mit gehaltener Sperre aufrufen */
+    bool leseSatz(uint64_t position, std::string &inhalt) const;
+
+    const std::string                             verzeichnis;
+
+    mutable std::mutex                            sperre;
+    std::condition_variable                       auftragVorhanden;
+    std::condition_variable                       stapelGeschrieben;
+    std::deque<Auftrag>                           warteschlange;
+    bool                                          schreibtStapel;
+    bool                                          beenden;
+
+    std::vector<std::shared_ptr<const std::string> > woerterbuecher; // Index ist die Nummer im Satzkopf
+    uint32_t                                      trainiertMit;   // Beispiele des juengsten Woerterbuchs
+    uint64_t                                      woerterbuchLaenge;
+    std::map<Schluessel, uint64_t>                inhaltsIndex;   // Position des Satzes in inhalte.dat
+    std::multimap<std::string, Verweis>           ticketIndex;
+    uint64_t                                      inhalteLaenge;  // Ende des letzten vollstaendigen Satzes
+    uint64_t                                      indexLaenge;    // Ende der letzten vollstaendigen Zeile
+    mutable std::unique_ptr<System::Dateiabbild>  abbild;
+    Kennzahlen                                    statistik;
+
+    std::thread                                   schreiber;
+};
+
+#endif
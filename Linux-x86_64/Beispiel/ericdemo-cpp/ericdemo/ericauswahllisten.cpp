@@ -0,0 +1,174 @@
+#include "ericauswahllisten.h"
+
+#include <chrono>
+#include <eric_fehlercodes.h>
+
+#include "ericmt.h"
+#include "jsontext.h"
+#include "xmltagleser.h"
+
+
+namespace
+{
+
+/** @brief Liest die Auswahllisten aus dem Ergebnis-XML von EricMtGetAuswahlListen() */
+void leseAuswahllisten(const char *xml, size_t laenge, std::vector<EricAuswahllisten::Auswahlliste> &listen)
+{
+    XmlTagLeser leser(xml, laenge);
+    Textausschnitt wert;
+    while (leser.weiter())
+    {
+        if (leser.istEndeTag())
+            continue;
+        if (leser.hatName("AuswahlListe"))
+            listen.push_back(EricAuswahllisten::Auswahlliste());
+        else if (!listen.empty() && leser.hatName("Feldkennung") && leser.textinhalt(wert))
+            listen.back().feldkennung = XmlTagLeser::dekodiere(wert);
+        else if (!listen.empty() && leser.hatName("ListenElement"))
+            listen.back().elemente.push_back(leser.textinhalt(wert) ? XmlTagLeser::dekodiere(wert) : std::string());
+    }
+}
+
+std::string alsJson(const EricAuswahllisten::Auswahlliste &liste)
+{
+    std::string json("{\"feldkennung\":");
+    JsonText::haengeAn(json, liste.feldkennung);
+    json += ",\"elemente\":[";
+    for (size_t i = 0; i < liste.elemente.size(); ++i)
+    {
+        if (i > 0)
+            json += ',';
+        JsonText::haengeAn(json, liste.elemente[i]);
+    }
+    json += "]}";
+    return json;
+}
+
+} // anonymous namespace
+
+
+const std::string *EricAuswahllisten::Antwort::alsJson(const std::string &feldkennung) const
+{
+    const std::map<std::string, size_t>::const_iterator fund = index.find(feldkennung);
+    return fund != index.end() ? &listenJson[fund->second] : nullptr;
+}
+
+
+EricAuswahllisten::EricAuswahllisten(const EricMt &ericMt_, const std::string &ericVersion_)
+    : ericMt(ericMt_),
+      ericVersion(ericVersion_),
+      statistik()
+{ }
+
+EricAuswahllisten::~EricAuswahllisten()
+{ }
+
+int EricAuswahllisten::liefere(const std::string &datenartVersion, std::shared_ptr<const Antwort> &antwort)
+{
+    const Schluessel schluessel(ericVersion, datenartVersion);
+    if (finde(schluessel, antwort))
+    {
+        return ERIC_OK;
+    }
+
+    bool gebuendelt = false;
+    const Buendelung::Ergebnis ergebnis = buendelung.ausfuehren(schluessel, [&]() -> Buendelung::Ergebnis
+    {
+        // Ein gerade beendeter Aufbau kann die Antwort schon abgelegt haben
+        Buendelung::Ergebnis aufbau = { ERIC_OK, std::string() };
+        std::shared_ptr<const Antwort> neu;
+        if (finde(schluessel, neu))
+        {
+            return aufbau;
+        }
+
+        aufbau.rc = baueAuf(datenartVersion, neu);
+
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.aufbauten;
+        if (aufbau.rc == ERIC_OK)
+        {
+            antworten[schluessel] = neu;
+        }
+        else
+        {
+            ++statistik.fehlgeschlagen;
+        }
+        return aufbau;
+    }, gebuendelt);
+
+    if (gebuendelt)
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.gebuendelt;
+    }
+    if (ergebnis.rc != ERIC_OK)
+    {
+        return ergebnis.rc;
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    antwort = antworten[schluessel];
+    return ERIC_OK;
+}
+
+EricAuswahllisten::Kennzahlen EricAuswahllisten::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.datenartVersionen = antworten.size();
+    return momentaufnahme;
+}
+
+bool EricAuswahllisten::finde(const Schluessel &schluessel, std::shared_ptr<const Antwort> &antwort)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    const std::map<Schluessel, std::shared_ptr<const Antwort> >::const_iterator fund = antworten.find(schluessel);
+    if (fund == antworten.end())
+    {
+        return false;
+    }
+    ++statistik.treffer;
+    antwort = fund->second;
+    return true;
+}
+
+int EricAuswahllisten::baueAuf(const std::string &datenartVersion, std::shared_ptr<const Antwort> &antwort) const
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::shared_ptr<Antwort> neu(new Antwort());
+    neu->version = datenartVersion;
+    {
+        EricMtInstanz instanz(ericMt);
+        EricMtPuffer puffer(instanz);
+        const int rc = ericMt.EricMtGetAuswahlListen(instanz.handle(), datenartVersion.c_str(), nullptr, puffer.handle());
+        if (rc == ERIC_OK)
+        {
+            neu->xml.assign(puffer.inhalt(), puffer.laenge());
+        }
+        else if (rc != ERIC_GLOBAL_KEINE_DATEN_VORHANDEN)
+        {
+            return rc;
+        }
+    }
+    leseAuswahllisten(neu->xml.data(), neu->xml.size(), neu->listenFeld);
+
+    neu->listenJson.reserve(neu->listenFeld.size());
+    neu->json = "{\"datenartVersion\":";
+    JsonText::haengeAn(neu->json, datenartVersion);
+    neu->json += ",\"auswahlListen\":[";
+    for (size_t i = 0; i < neu->listenFeld.size(); ++i)
+    {
+        neu->listenJson.push_back(alsJson(neu->listenFeld[i]));
+        neu->index.insert(std::make_pair(neu->listenFeld[i].feldkennung, i));
+        if (i > 0)
+            neu->json += ',';
+        neu->json += neu->listenJson.back();
+    }
+    neu->json += "]}";
+
+    neu->aufbauMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    antwort = neu;
+    return ERIC_OK;
+}
@@ -0,0 +1,137 @@
+#ifndef _ERICAUSWAHLLISTEN_H_
+#define _ERICAUSWAHLLISTEN_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ericbuendelung.h"
+
+// Vorwaertsdeklarationen
+class EricMt;
+
+
+/** @brief Zwischenspeicher fuer die Auswahllisten einer Datenartversion
+ *
+ * EricMtGetAuswahlListen() liefert zu einer Datenartversion stets dieselben
+ * Auswahllisten, bis eine andere ERiC-Version eingesetzt wird. Die Listen
+ * werden daher je ERiC-Version und Datenartversion nur einmal geholt,
+ * ausgewertet und als fertig serialisierte Antworten abgelegt. Spaetere
+ * Anfragen werden ausschliesslich aus dem Hauptspeicher bedient, ohne eine
+ * ERiC-Instanz zu verwenden.
+ *
+ * Der Aufbau laeuft auf einer eigenen ERiC-Instanz der Multithreading-API.
+ * Gleichzeitige Anfragen zur selben Datenartversion werden zu einem
+ * einzigen Aufbau gebuendelt, siehe EricBuendelung.
+ */
+class EricAuswahllisten
+{
+public:
+    /** @brief Eine Auswahlliste mit ihren Listenelementen in der Reihenfolge des ERiC */
+    struct Auswahlliste
+    {
+        std::string              feldkennung;
+        std::vector<std::string> elemente;
+    };
+
+    /** @brief Unveraenderliche Auswahllisten einer Datenartversion samt serialisierter Antworten */
+    class Antwort
+    {
+    public:
+        const std::string               &datenartVersion() const { return version; }
+        const std::vector<Auswahlliste> &listen()          const { return listenFeld; }
+
+        /** @brief Ergebnis-XML von EricMtGetAuswahlListen() ueber alle Auswahllisten */
+        const std::string &alsXml()  const { return xml; }
+
+        /** @brief Alle Auswahllisten als JSON */
+        const std::string &alsJson() const { return json; }
+
+        /** @brief Eine einzelne Auswahlliste als JSON
+          *
+          * @return JSON-Text oder nullptr, wenn es zur Feldkennung keine Auswahlliste gibt
+          */
+        const std::string *alsJson(const std::string &feldkennung) const;
+
+        /** @brief Dauer des Aufbaus in Millisekunden */
+        double aufbauDauerMs() const { return aufbauMs; }
+
+    private:
+        friend class EricAuswahllisten;
+
+        std::string                    version;
+        std::vector<Auswahlliste>      listenFeld;
+        std::map<std::string, size_t>  index;       // Feldkennung -> Index in listenFeld und listenJson
+        std::vector<std::string>       listenJson;
+        std::string                    xml;
+        std::string                    json;
+        double                         aufbauMs;
+    };
+
+    /** @brief Kennzahlen zur Trefferquote */
+    struct Kennzahlen
+    {
+        uint64_t treffer;             // Aus dem Hauptspeicher bediente Anfragen
+        uint64_t aufbauten;           // Aufrufe von EricMtGetAuswahlListen()
+        uint64_t gebuendelt;          // Anfragen, die auf einen laufenden Aufbau gewartet haben
+        uint64_t fehlgeschlagen;      // Aufbauten mit einem Fehlercode des ERiC
+        size_t   datenartVersionen;   // Abgelegte Datenartversionen
+    };
+
+    /** @brief Erzeugt einen leeren Zwischenspeicher
+      *
+      * @param ericMt
+      *        Schnittstellenobjekt der Multithreading-API.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricAuswahllisten, da diese eine Referenz darauf haelt!
+      * @param ericVersion
+      *        Versionsangabe des ERiC, z. B. das Ergebnis von EricMtVersion().
+      *        Sie ist Teil des Schluessels aller abgelegten Antworten.
+      */
+    EricAuswahllisten(const EricMt &ericMt, const std::string &ericVersion);
+
+    virtual ~EricAuswahllisten();
+
+    /** @brief Liefert die Auswahllisten einer Datenartversion, beim ersten Bedarf ueber EricMtGetAuswahlListen()
+      *
+      * @param datenartVersion Datenartversion, z. B. "ESt_2020"
+      * @param antwort         Erhaelt die abgelegten Auswahllisten
+      *
+      * @return
+      *         - ERIC_OK
+      *         - Fehlercode des ERiC, z. B. ERIC_GLOBAL_DATENARTVERSION_UNBEKANNT; es wird nichts abgelegt
+      *
+      * @throw Anwendungsfehler, wenn die ERiC-Instanz fuer den Aufbau nicht erzeugt werden kann
+      */
+    int liefere(const std::string &datenartVersion, std::shared_ptr<const Antwort> &antwort);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricAuswahllisten(const EricAuswahllisten &); // Kopien verboten
+    EricAuswahllisten &operator=(const EricAuswahllisten &); // Zuweisungen verboten
+
+    // ERiC-Version und Datenartversion
+    typedef std::pair<std::string, std::string> Schluessel;
+
+    typedef EricBuendelung<Schluessel> Buendelung;
+
+    bool finde(const Schluessel &schluessel, std::shared_ptr<const Antwort> &antwort);
+    int  baueAuf(const std::string &datenartVersion, std::shared_ptr<const Antwort> &antwort) const;
+
+    const EricMt                                          &ericMt;
+    const std::string                                      ericVersion;
+
+    mutable std::mutex                                     sperre;
+    std::map<Schluessel, std::shared_ptr<const Antwort> >  antworten;
+    Kennzahlen                                             statistik;
+
+    Buendelung                                             buendelung;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef _ERICBUENDELUNG_H_
+#define _ERICBUENDELUNG_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+
+/** @brief Buendelt gleichzeitige, inhaltsgleiche Vorgaenge zu einem einzigen Aufruf
+ *
+ * Treffen mehrere Anfragen mit demselben Schluessel ein, waehrend der
+ * zugehoerige Vorgang noch laeuft, fuehrt nur die erste Anfrage den Vorgang
+ * aus. Alle weiteren warten auf dessen Ende und erhalten dasselbe Ergebnis
+ * bzw. dieselbe Ausnahme. Anfragen mit unterschiedlichen Schluesseln laufen
+ * unabhaengig voneinander. Nach Ende eines Vorgangs wird der Schluessel
+ * vergessen; spaetere Anfragen fuehren den Vorgang erneut aus.
+ *
+ * @tparam Schluessel Inhaltsschluessel mit operator<
+ */
+template <typename Schluessel>
+class EricBuendelung
+{
+public:
+    /** @brief Ergebnis eines Vorgangs: Rueckgabewert und Ergebnis-XML */
+    struct Ergebnis
+    {
+        int         rc;
+        std::string ergebnis;
+    };
+
+    /** @brief Kennzahlen zur Buendelung */
+    struct Kennzahlen
+    {
+        uint64_t ausgefuehrt;     // Tatsaechlich ausgefuehrte Vorgaenge
+        uint64_t gebuendelt;      // Anfragen, die das Ergebnis eines laufenden Vorgangs uebernommen haben
+        size_t   laufend;         // Derzeit laufende Vorgaenge
+    };
+
+    EricBuendelung() : statistik() { }
+
+    /** @brief Fuehrt den Vorgang aus oder wartet auf einen laufenden Vorgang mit demselben Schluessel
+      *
+      * @param schluessel Inhaltsschluessel des Vorgangs
+      * @param vorgang    Fuehrt den Vorgang aus; wird hoechstens einmal je laufendem Schluessel aufgerufen
+      * @param gebuendelt Erhaelt true, wenn das Ergebnis eines anderen Aufrufers uebernommen wurde
+      */
+    Ergebnis ausfuehren(const Schluessel &schluessel, const std::function<Ergebnis()> &vorgang, bool &gebuendelt)
+    {
+        std::unique_lock<std::mutex> lock(sperre);
+
+        typename Fluege::iterator laufenderFlug = fluege.find(schluessel);
+        if (laufenderFlug != fluege.end())
+        {
+            const std::shared_ptr<Flug> flug = laufenderFlug->second;
+            ++statistik.gebuendelt;
+            while (!flug->fertig)
+            {
+                flug->beendet.wait(lock);
+            }
+            gebuendelt = true;
+            if (flug->fehler)
+            {
+                std::rethrow_exception(flug->fehler);
+            }
+            return flug->ergebnis;
+        }
+
+        const std::shared_ptr<Flug> flug(new Flug());
+        fluege[schluessel] = flug;
+        ++statistik.ausgefuehrt;
+        lock.unlock();
+
+        try
+        {
+            flug->ergebnis = vorgang();
+        }
+        catch (...)
+        {
+            flug->fehler = std::current_exception();
+        }
+
+        lock.lock();
+        flug->fertig = true;
+        fluege.erase(schluessel);
+        lock.unlock();
+        flug->beendet.notify_all();
+
+        gebuendelt = false;
+        if (flug->fehler)
+        {
+            std::rethrow_exception(flug->fehler);
+        }
+        return flug->ergebnis;
+    }
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        Kennzahlen momentaufnahme = statistik;
+        momentaufnahme.laufend = fluege.size();
+        return momentaufnahme;
+    }
+
+private:
+    EricBuendelung(const EricBuendelung &); // Kopien verboten
+    EricBuendelung &operator=(const EricBuendelung &); // Zuweisungen verboten
+
+    struct Flug
+    {
+        Flug() : fertig(false), ergebnis() { }
+
+        bool                    fertig;
+        Ergebnis                ergebnis;
+        std::exception_ptr      fehler;
+        std::condition_variable beendet;
+    };
+
+    typedef std::map<Schluessel, std::shared_ptr<Flug> > Fluege;
+
+    mutable std::mutex sperre;
+    Fluege             fluege;
+    Kennzahlen         statistik;
+};
+
+#endif
@@ -1,22 +1,53 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstdio>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <stdlib.h>
 #include <utility>
 #include <string.h>
+#include <thread>
 #include <vector>
 
 #include "ericsystemsteuerung.h"
 #include "ericdekodierung.h"
 #include "ericvorgang.h"
 #include "ericzertifikat.h"
+#include "ericzertifikatspruefung.h"
 #include "system.h"
 #include <ericapi.h>
 #include <eric_fehlercodes.h>
+#include "datenartversionserkennung.h"
+#include "datensatzleser.h"
 #include "eric.h"
+#include "ericarchiv.h"
+#include "ericauswahllisten.h"
+#include "erictoolkitadapter.h"
+#include "ericergebnis.h"
+#include "ericfehlertabelle.h"
+#include "ericfinanzamtsverzeichnis.h"
+#include "ericlogprotokoll.h"
+#include "ericmt.h"
+#include "ericnachdruck.h"
+#include "ericpdfsammler.h"
+#include "ericphasenzeiten.h"
+#include "ericpruefsummen.h"
 #include "ericpuffer.h"
+#include "ericfeldpruefung.h"
+#include "ericmetriken.h"
+#include "ericmitschnitt.h"
+#include "ericschemavorpruefung.h"
+#include "ericschluesselvorrat.h"
+#include "ericspuren.h"
+#include "ericsteuernummernstapel.h"
+#include "ericvalidierungscache.h"
+#include "ericvorschau.h"
 #include "callbackhandler.h"
+#include "metrikexport.h"
 
 
 namespace
@@ -53,19 +84,18 @@ std::string angabeFormat(const std::string& daten) {
 }
 
 /** @brief Gib den Antwort-Text einer Eric-Funktion aus. */
-static void protokolliere(const System::KommandozeilenParser &argParser, int fehlerkode, const std::string& ergebnis, std::string& antwort, const EricTransferHandle &transferHandle, const Eric& eric)
+static void protokolliere(const System::KommandozeilenParser &argParser, int fehlerkode, const std::string& ergebnis, std::string& antwort, const EricTransferHandle &transferHandle, EricFehlertabelle& fehlertabelle)
 {
     std::string fehlerText;
     if (fehlerkode != ERIC_OK)
-    {   // Genaue Fehlerbeschreibung herausfinden
-        EricPuffer antwortPuffer(eric);
-        if (ERIC_OK == eric.EricHoleFehlerText(fehlerkode, antwortPuffer.handle()))
-        {
-            fehlerText = antwortPuffer.inhalt();
-        }
-        else
+    {   // Genaue Fehlerbeschreibung herausfinden, jeder Text wird nur einmal vom ERiC geholt
+        fehlerText = fehlertabelle.fehlertext(fehlerkode);
+
+        const EricFehlertabelle::Eintrag *eintrag = EricFehlertabelle::suche(fehlerkode);
+        if (eintrag != nullptr)
         {
-            fehlerText = "<Kein Fehlertext verfügbar>";
+            fehlerText += std::string(" [") + eintrag->name + ", " + EricFehlertabelle::kategorieName(eintrag->kategorie)
+                        + (eintrag->wiederholbar ? ", Wiederholung moeglich]" : "]");
         }
     }
     else
@@ -117,6 +147,848 @@ static void protokolliere(const System::KommandozeilenParser &argParser, int feh
     }
 }
 
+/** @brief Schreibe Fehler, Hinweise, Transferticket und Returncodes strukturiert in die angegebene Datei. */
+static void schreibeStrukturiertesErgebnis(const System::KommandozeilenParser &argParser, int fehlerkode, const std::string& ergebnis, const std::string& antwort, const Eric& eric)
+{
+    EricErgebnis strukturiert(eric);
+    strukturiert.leseErgebnis(fehlerkode, ergebnis.data(), ergebnis.size());
+    if (!antwort.empty())
+    {
+        const int rc = strukturiert.leseServerantwort(antwort);
+        if (rc != ERIC_OK)
+        {
+            std::cerr << "Die Serverantwort konnte nicht ausgewertet werden (" << rc << ")" << std::endl;
+        }
+    }
+
+    const std::string &datei = argParser.getStrukturDatei();
+    const bool binaer = datei.size() > 4 && 0 == datei.compare(datei.size() - 4, 4, ".bin");
+    if (System::schreibeDatei(binaer ? strukturiert.alsBinaerformat() : strukturiert.alsJson(), datei))
+    {
+        std::cout << std::endl << "Das strukturierte Ergebnis wurde in die Datei \"" << datei << "\" geschrieben." << std::endl;
+    }
+    else
+    {
+        std::cout << std::endl << "FEHLER: Die Datei \"" << datei << "\" konnte nicht geschrieben werden." << std::endl;
+    }
+}
+
+/** @brief Erzeuge ein CEZ-Schluesselpaar ueber den Schluesselvorrat und gib dessen Kennzahlen aus. */
+static int erzeugeCez(const System::KommandozeilenParser &argParser, EricLogProtokoll *logProtokoll)
+{
+    int fehlerkode = ERIC_GLOBAL_UNKNOWN;
+    try
+    {
+        EricMt ericMt(argParser.getHomeDir(), argParser.getLogDir(), logProtokoll);
+
+        EricSchluesselvorrat::Zertifikatsvorlage vorlage;
+        vorlage.name = "ericdemo";
+
+        // Der Prozess endet nach dieser einen Entnahme, ein Nachschub im Hintergrund
+        // wuerde nur die Laufzeit beim Beenden verdoppeln: Zielbestand 0
+        EricSchluesselvorrat vorrat(ericMt, System::dateiPfad(argParser.getCezVerzeichnis(), "cez-vorrat"), vorlage, 0, 0);
+        fehlerkode = vorrat.entnehmen(argParser.getCezVerzeichnis(), argParser.getZertifikatPin());
+
+        const EricSchluesselvorrat::Kennzahlen kennzahlen = vorrat.kennzahlen();
+        System::titelZeile("CEZ-Schluesselvorrat");
+        std::cout << "Erzeugt:        " << kennzahlen.erzeugt << std::endl
+                  << "Fehlgeschlagen: " << kennzahlen.fehlgeschlagen << std::endl
+                  << "Aus Vorrat:     " << kennzahlen.entnommenVorrat << std::endl
+                  << "Synchron:       " << kennzahlen.entnommenSynchron << std::endl
+                  << "Mittlere Dauer: " << kennzahlen.mittlereDauerMs << " ms" << std::endl;
+
+        std::cout << std::endl << "Schluesselerzeugung in \"" << argParser.getCezVerzeichnis() << "\": "
+                  << (fehlerkode == ERIC_OK ? std::string("erfolgreich") : "Fehler " + System::toString(fehlerkode)) << std::endl;
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr<< "Fehler: " << stdException.what() << std::endl;
+    }
+    return fehlerkode;
+}
+
+/** @brief Gibt eine Anschrift in einer Zeile aus, sofern sie Angaben enthaelt */
+static void zeigeAnschrift(const char *bezeichnung, const EricFinanzamtsverzeichnis::Anschrift &anschrift)
+{
+    if (anschrift.strasse.leer() && anschrift.postfach.leer() && anschrift.plz.leer() && anschrift.ort.leer())
+    {
+        return;
+    }
+    std::cout << bezeichnung;
+    if (!anschrift.strasse.leer())
+    {
+        std::cout << anschrift.strasse.text() << ", ";
+    }
+    if (!anschrift.postfach.leer())
+    {
+        std::cout << "Postfach " << anschrift.postfach.text() << ", ";
+    }
+    std::cout << anschrift.plz.text() << " " << anschrift.ort.text() << std::endl;
+}
+
+/** @brief Frage das Finanzamt zur angegebenen Bundesfinanzamtsnummer direkt beim ERiC ab und gib es aus. */
+static int zeigeFinanzamt(const System::KommandozeilenParser &argParser)
+{
+    int fehlerkode = ERIC_GLOBAL_UNKNOWN;
+    try
+    {
+        Eric eric(argParser.getHomeDir(), argParser.getLogDir());
+
+        std::shared_ptr<const EricFinanzamtsverzeichnis::Stand> einzeln;
+        const std::string &bufaNummer = argParser.getBufaNummer();
+        fehlerkode = bufaNummer.size() != 4 || bufaNummer.find_first_not_of("0123456789") != std::string::npos
+                   ? static_cast<int>(ERIC_GLOBAL_PRUEF_FEHLER)
+                   : EricFinanzamtsverzeichnis::frageEinzeln(eric, static_cast<unsigned>(strtoul(bufaNummer.c_str(), nullptr, 10)), einzeln);
+        if (fehlerkode != ERIC_OK)
+        {
+            std::cout << std::endl << "Zur Bundesfinanzamtsnummer \"" << bufaNummer << "\" liegen keine Finanzamtsdaten vor ("
+                      << fehlerkode << ")." << std::endl;
+            return fehlerkode;
+        }
+
+        const EricFinanzamtsverzeichnis::Finanzamt &finanzamt = einzeln->finanzaemter().front();
+        System::titelZeile("Finanzamt " + bufaNummer);
+        std::cout << finanzamt.name.text() << " (Finanzamtlandnummer " << einzeln->laender().front().nummer.text() << ")" << std::endl;
+        zeigeAnschrift("Hausanschrift:  ", finanzamt.hausanschrift);
+        zeigeAnschrift("Postanschrift:  ", finanzamt.postanschrift);
+        if (!finanzamt.telefon.leer())
+        {
+            std::cout << "Telefon:        " << finanzamt.telefon.text() << std::endl;
+        }
+        if (!finanzamt.fax.leer())
+        {
+            std::cout << "Fax:            " << finanzamt.fax.text() << std::endl;
+        }
+        if (!finanzamt.mail.leer())
+        {
+            std::cout << "E-Mail:         " << finanzamt.mail.text() << std::endl;
+        }
+        for (uint32_t i = 0; i < finanzamt.anzahlBankverbindungen; ++i)
+        {
+            const EricFinanzamtsverzeichnis::Bankverbindung &bank = einzeln->bankverbindungen()[finanzamt.ersteBankverbindung + i];
+            std::cout << "Bankverbindung: " << bank.bank.text() << ", IBAN " << bank.iban.text() << ", BIC " << bank.bic.text() << std::endl;
+        }
+        std::cout << "Abfragedauer:   " << einzeln->aufbauDauerMs() << " ms" << std::endl;
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr<< "Fehler: " << stdException.what() << std::endl;
+    }
+    return fehlerkode;
+}
+
+/** @brief Ermittle die Versionsangabe des ERiC ueber eine eigene Instanz der Multithreading-API. */
+static int ermittleEricVersion(const EricMt &ericMt, std::string &ericVersion)
+{
+    EricMtInstanz instanz(ericMt);
+    EricMtPuffer versionPuffer(instanz);
+    const int rc = ericMt.EricMtVersion(instanz.handle(), versionPuffer.handle());
+    if (rc != ERIC_OK)
+    {
+        std::cerr << "Die ERiC-Version konnte nicht ermittelt werden (" << rc << ")" << std::endl;
+        return rc;
+    }
+    ericVersion.assign(versionPuffer.inhalt(), versionPuffer.laenge());
+    return ERIC_OK;
+}
+
+/** @brief Hole die Auswahllisten zur Datenartversion ueber den Zwischenspeicher und gib sie als JSON aus. */
+static int zeigeAuswahllisten(const System::KommandozeilenParser &argParser, EricLogProtokoll *logProtokoll)
+{
+    int fehlerkode = ERIC_GLOBAL_UNKNOWN;
+    try
+    {
+        EricMt ericMt(argParser.getHomeDir(), argParser.getLogDir(), logProtokoll);
+
+        // Die ERiC-Version ist Teil des Schluessels der abgelegten Auswahllisten
+        std::string ericVersion;
+        fehlerkode = ermittleEricVersion(ericMt, ericVersion);
+        if (fehlerkode != ERIC_OK)
+        {
+            return fehlerkode;
+        }
+
+        EricAuswahllisten auswahllisten(ericMt, ericVersion);
+        std::shared_ptr<const EricAuswahllisten::Antwort> antwort;
+        fehlerkode = auswahllisten.liefere(argParser.getDatenartVersion(), antwort);
+        if (fehlerkode != ERIC_OK)
+        {
+            std::cerr << "Die Auswahllisten zu \"" << argParser.getDatenartVersion() << "\" konnten nicht geholt werden ("
+                      << fehlerkode << ")" << std::endl;
+            return fehlerkode;
+        }
+
+        // Die zweite Anfrage wird ohne ERiC-Instanz aus dem Zwischenspeicher bedient
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        fehlerkode = auswahllisten.liefere(argParser.getDatenartVersion(), antwort);
+        const double trefferUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        const EricAuswahllisten::Kennzahlen kennzahlen = auswahllisten.kennzahlen();
+        System::titelZeile("Auswahllisten " + antwort->datenartVersion());
+        std::cout << "Auswahllisten:  " << antwort->listen().size() << std::endl
+                  << "Aufbaudauer:    " << antwort->aufbauDauerMs() << " ms" << std::endl
+                  << "Treffer:        " << kennzahlen.treffer << " (" << trefferUs << " us)" << std::endl
+                  << "Aufbauten:      " << kennzahlen.aufbauten << std::endl;
+
+        std::cout << std::endl << antwort->alsJson() << std::endl;
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr<< "Fehler: " << stdException.what() << std::endl;
+    }
+    return fehlerkode;
+}
+
+/** @brief Lies die Zeilen "Steuernummer;Landesnummer oder Bundesfinanzamtsnummer" einer Steuernummerndatei. */
+static bool leseSteuernummern(const std::string &dateiName, std::vector<EricSteuernummernStapel::Zeile> &zeilen)
+{
+    std::ifstream datei(dateiName.c_str());
+    if (!datei)
+    {
+        return false;
+    }
+
+    const char *const LEERRAUM = " \t\r";
+    std::string text;
+    while (std::getline(datei, text))
+    {
+        const size_t anfang = text.find_first_not_of(LEERRAUM);
+        if (anfang == std::string::npos || '#' == text[anfang])
+        {
+            continue;
+        }
+
+        const size_t trenner = text.find(';', anfang);
+        EricSteuernummernStapel::Zeile zeile;
+        zeile.steuernummer = text.substr(anfang, trenner == std::string::npos ? std::string::npos : trenner - anfang);
+        zeile.steuernummer.erase(zeile.steuernummer.find_last_not_of(LEERRAUM) + 1);
+        if (trenner != std::string::npos)
+        {
+            zeile.land = text.substr(trenner + 1);
+            zeile.land.erase(0, zeile.land.find_first_not_of(LEERRAUM));
+            zeile.land.erase(zeile.land.find_last_not_of(LEERRAUM) + 1);
+        }
+        zeilen.push_back(zeile);
+    }
+    return true;
+}
+
+/** @brief Normalisiere die Steuernummern einer Datei parallel.
+ *
+ * Mit der Option --steuernummern-vergleich werden die Zeilen zum Vergleich der Dauer ein zweites Mal auf einer
+ * einzelnen ERiC-Instanz verarbeitet.
+ */
+static int normalisiereSteuernummern(const System::KommandozeilenParser &argParser, EricLogProtokoll *logProtokoll)
+{
+    int fehlerkode = ERIC_GLOBAL_UNKNOWN;
+    try
+    {
+        std::vector<EricSteuernummernStapel::Zeile> zeilen;
+        if (!leseSteuernummern(argParser.getSteuernummernDatei(), zeilen))
+        {
+            std::cerr << "Die Datei \"" << argParser.getSteuernummernDatei() << "\" konnte nicht gelesen werden." << std::endl;
+            return ERIC_IO_DATEI_INKORREKT;
+        }
+
+        std::ofstream ausgabeDatei;
+        if (!argParser.getAusgabeDatei().empty())
+        {
+            ausgabeDatei.open(argParser.getAusgabeDatei().c_str());
+            if (!ausgabeDatei)
+            {
+                std::cerr << "Die Datei \"" << argParser.getAusgabeDatei() << "\" konnte nicht geschrieben werden." << std::endl;
+                return ERIC_IO_DATEI_INKORREKT;
+            }
+        }
+        std::ostream &ausgabe = ausgabeDatei.is_open() ? ausgabeDatei : std::cout;
+        // Die Statistik darf die Zeilen auf der Standardausgabe nicht unterbrechen
+        std::ostream &statistik = ausgabeDatei.is_open() ? std::cout : std::cerr;
+
+        EricMt ericMt(argParser.getHomeDir(), argParser.getLogDir(), logProtokoll);
+        const size_t anzahlArbeiter = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+
+        // Steuernummer;Land;ELSTER-Format;Bescheidformat;Fehlercode in der Reihenfolge der Datei
+        const EricSteuernummernStapel::Kennzahlen parallel = EricSteuernummernStapel(ericMt, anzahlArbeiter).verarbeite(zeilen,
+            [&ausgabe](size_t, const EricSteuernummernStapel::Zeile &zeile, const EricSteuernummernStapel::Ergebnis &ergebnis)
+            {
+                ausgabe << zeile.steuernummer << ';' << zeile.land << ';' << ergebnis.elster << ';'
+                        << ergebnis.bescheid << ';' << ergebnis.rc << '\n';
+            });
+        ausgabe.flush();
+
+        statistik << std::endl << "*** Steuernummern ***" << std::endl << std::endl
+                  << "Zeilen:          " << parallel.zeilen << std::endl
+                  << "Fehlerhaft:      " << parallel.fehlerhaft << std::endl
+                  << "ERiC-Aufrufe:    " << parallel.aufrufe << std::endl
+                  << "Parallel:        " << parallel.dauerMs << " ms mit " << parallel.arbeiter << " Instanz(en)" << std::endl;
+
+        if (argParser.getSteuernummernVergleich())
+        {
+            // Zum Vergleich dieselben Zeilen nacheinander auf einer einzigen Instanz
+            const EricSteuernummernStapel::Kennzahlen einzeln =
+                EricSteuernummernStapel(ericMt, 1).verarbeite(zeilen, EricSteuernummernStapel::Ausgabe());
+            statistik << "Einzeln:         " << einzeln.dauerMs << " ms mit " << einzeln.arbeiter << " Instanz" << std::endl;
+            if (parallel.dauerMs > 0)
+            {
+                statistik << "Beschleunigung:  " << einzeln.dauerMs / parallel.dauerMs << std::endl;
+            }
+        }
+        fehlerkode = ERIC_OK;
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr<< "Fehler: " << stdException.what() << std::endl;
+    }
+    return fehlerkode;
+}
+
+/** @brief Zerlege eine Zeile einer CSV-Datei mit Semikolon als Trenner und entferne umgebenden Leerraum. */
+static void zerlegeCsvZeile(const std::string &text, std::vector<std::string> &felder)
+{
+    const char *const LEERRAUM = " \t\r";
+    felder.clear();
+    size_t anfang = 0;
+    for (;;)
+    {
+        const size_t trenner = text.find(';', anfang);
+        std::string feld = text.substr(anfang, trenner == std::string::npos ? std::string::npos : trenner - anfang);
+        feld.erase(0, feld.find_first_not_of(LEERRAUM));
+        feld.erase(feld.find_last_not_of(LEERRAUM) + 1);
+        felder.push_back(feld);
+        if (trenner == std::string::npos)
+        {
+            return;
+        }
+        anfang = trenner + 1;
+    }
+}
+
+/** @brief Pruefe die Spalten IBAN, IdNr und StNr einer CSV-Datei gesammelt und vergleiche Ergebnis und Durchsatz mit dem ERiC-Toolkit. */
+static int pruefeSpalten(const System::KommandozeilenParser &argParser)
+{
+    typedef void (*Massenpruefung)(const EricPruefsummen::Spalte &, int *);
+    typedef int (EricToolkit::*Einzelpruefung)(const char *) const;
+    struct Spaltenart
+    {
+        const char     *titel;
+        const char     *name;
+        const char     *alternativName;
+        Massenpruefung  massenpruefung;
+        Einzelpruefung  einzelpruefung;
+    };
+    static const Spaltenart ARTEN[] =
+    {
+        { "IBAN", "iban", "iban",         &EricPruefsummen::pruefeIBAN,                   &EricToolkit::EtkPruefeIBAN },
+        { "IdNr", "idnr", "steuerid",     &EricPruefsummen::pruefeIdentifikationsMerkmal, &EricToolkit::EtkPruefeIdentifikationsMerkmal },
+        { "StNr", "stnr", "steuernummer", &EricPruefsummen::pruefeSteuernummer,           &EricToolkit::EtkPruefeSteuernummer }
+    };
+    const size_t ANZAHL_ARTEN = sizeof(ARTEN) / sizeof(ARTEN[0]);
+
+    std::ifstream datei(argParser.getSpaltenDatei().c_str());
+    if (!datei)
+    {
+        std::cerr << "Die Datei \"" << argParser.getSpaltenDatei() << "\" konnte nicht gelesen werden." << std::endl;
+        return ERIC_IO_DATEI_INKORREKT;
+    }
+
+    // Zuordnung der CSV-Spalten zu den Pruefungen aus der Kopfzeile
+    std::string text;
+    std::vector<std::string> felder;
+    std::vector<size_t> csvSpalte(ANZAHL_ARTEN, std::string::npos);
+    if (std::getline(datei, text))
+    {
+        zerlegeCsvZeile(text, felder);
+        for (size_t f = 0; f < felder.size(); ++f)
+        {
+            std::string name(felder[f]);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            for (size_t a = 0; a < ANZAHL_ARTEN; ++a)
+            {
+                if (name == ARTEN[a].name || name == ARTEN[a].alternativName)
+                {
+                    csvSpalte[a] = f;
+                }
+            }
+        }
+    }
+
+    std::vector<EricPruefsummen::Spalte> spalten(ANZAHL_ARTEN);
+    while (std::getline(datei, text))
+    {
+        zerlegeCsvZeile(text, felder);
+        for (size_t a = 0; a < ANZAHL_ARTEN; ++a)
+        {
+            if (csvSpalte[a] < felder.size() && !felder[csvSpalte[a]].empty())
+            {
+                spalten[a].haengeAn(felder[csvSpalte[a]].data(), felder[csvSpalte[a]].size());
+            }
+        }
+    }
+
+    EricToolkit toolkit(argParser.getHomeDir());
+    int fehlerkode = ERIC_OK;
+    for (size_t a = 0; a < ANZAHL_ARTEN; ++a)
+    {
+        const EricPruefsummen::Spalte &spalte = spalten[a];
+        if (0 == spalte.zeilen())
+        {
+            continue;
+        }
+
+        std::vector<int> gesammelt(spalte.zeilen());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ARTEN[a].massenpruefung(spalte, gesammelt.data());
+        const double gesammeltMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<std::string> werte(spalte.zeilen());
+        for (size_t i = 0; i < spalte.zeilen(); ++i)
+        {
+            werte[i] = spalte.text(i);
+        }
+        std::vector<int> einzeln(spalte.zeilen());
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < werte.size(); ++i)
+        {
+            einzeln[i] = (toolkit.*ARTEN[a].einzelpruefung)(werte[i].c_str());
+        }
+        const double einzelnMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const EricPruefsummen::Vergleich vergleich = EricPruefsummen::vergleiche(gesammelt, einzeln);
+        const size_t ungueltig = spalte.zeilen() - std::count(gesammelt.begin(), gesammelt.end(), static_cast<int>(ERIC_OK));
+
+        System::titelZeile(std::string("Spalte ") + ARTEN[a].titel);
+        std::cout << "Zeilen:                " << spalte.zeilen() << std::endl
+                  << "Ungueltig:             " << ungueltig << std::endl
+                  << "Gesammelt:             " << gesammeltMs << " ms (" << (gesammeltMs > 0 ? spalte.zeilen() / gesammeltMs * 1000 : 0) << " Zeilen/s)" << std::endl
+                  << "Toolkit:               " << einzelnMs << " ms (" << (einzelnMs > 0 ? spalte.zeilen() / einzelnMs * 1000 : 0) << " Zeilen/s)" << std::endl
+                  << "Uebereinstimmend:      " << vergleich.uebereinstimmend << std::endl
+                  << "Anderer Fehlercode:    " << vergleich.andererFehlercode << std::endl
+                  << "Nur Toolkit abweisend: " << vergleich.nurToolkitAbgewiesen << std::endl
+                  << "Nur hier abweisend:    " << vergleich.nurHierAbgewiesen << std::endl;
+        if (vergleich.nurHierAbgewiesen > 0)
+        {
+            const size_t i = vergleich.ersteAbweichung;
+            std::cout << std::endl << "Erste Abweichung: \"" << werte[i] << "\" (hier " << gesammelt[i] << ", Toolkit " << einzeln[i] << ")" << std::endl;
+            fehlerkode = ERIC_GLOBAL_UNKNOWN;
+        }
+    }
+    return fehlerkode;
+}
+
+/** @brief Lege den Validierungscache an, falls ein Cacheverzeichnis angegeben ist. */
+static std::unique_ptr<EricValidierungsCache> erzeugeValidierungsCache(const System::KommandozeilenParser &argParser, const Eric &eric)
+{
+    std::unique_ptr<EricValidierungsCache> cache;
+    if (argParser.getCacheVerzeichnis().empty())
+    {
+        return cache;
+    }
+
+    // Die Versionsangaben aller ERiC-Bibliotheken gehen in den Cacheschluessel ein
+    EricPuffer versionPuffer(eric);
+    const int rc = eric.EricVersion(versionPuffer.handle());
+    if (rc != ERIC_OK)
+    {
+        std::cerr << "Die ERiC-Version konnte nicht ermittelt werden (" << rc << "), der Validierungscache bleibt ausgeschaltet." << std::endl;
+        return cache;
+    }
+
+    cache.reset(new EricValidierungsCache(std::string(versionPuffer.inhalt(), versionPuffer.laenge()), argParser.getCacheVerzeichnis(), 256));
+    return cache;
+}
+
+/** @brief Gib die Kennzahlen des Validierungscaches aus. */
+static void protokolliereCache(const EricValidierungsCache &cache)
+{
+    const EricValidierungsCache::Kennzahlen kennzahlen = cache.kennzahlen();
+    System::titelZeile("Validierungscache");
+    std::cout << "Treffer (Speicher): " << kennzahlen.trefferSpeicher << std::endl
+              << "Treffer (Datei):    " << kennzahlen.trefferDatei << std::endl
+              << "Fehlgriffe:         " << kennzahlen.fehlgriffe << std::endl
+              << "Gebuendelt:         " << kennzahlen.gebuendelt << std::endl
+              << "Eintraege:          " << kennzahlen.eintraegeSpeicher << " im Speicher, "
+                                        << kennzahlen.eintraegeDatei << " in der Datei" << std::endl;
+}
+
+/** @brief Gibt die im Speicher erhaltenen PDFs aus und schreibt sie auf Wunsch neben die Ausgabedatei */
+static void protokolliereDruck(const System::KommandozeilenParser &argParser, const std::vector<EricPdfSammler::Pdf> &pdfs)
+{
+    if (pdfs.empty())
+    {
+        return;
+    }
+
+    uint64_t bytes = 0;
+    for (size_t i = 0; i < pdfs.size(); ++i)
+    {
+        bytes += pdfs[i].daten.size();
+    }
+    System::titelZeile("PDFs");
+    std::cout << "Anzahl:             " << pdfs.size() << std::endl
+              << "Bytes:              " << bytes << std::endl;
+    for (size_t i = 0; i < pdfs.size(); ++i)
+    {
+        const EricPdfSammler::Pdf &pdf = pdfs[i];
+        std::cout << "  " << pdf.bezeichner << ": " << pdf.daten.size() << " Bytes";
+        if (!argParser.getAusgabeDatei().empty())
+        {
+            const std::string dateiName = argParser.getAusgabeDatei() + "." + std::to_string(i + 1) + ".pdf";
+            std::cout << (System::schreibeDatei(pdf.daten, dateiName) ? " -> " : " nicht geschrieben: ") << dateiName;
+        }
+        std::cout << std::endl;
+    }
+}
+
+/** @brief Liefert das Transferticket der Serverantwort oder einen leeren Text */
+static std::string ermittleTransferticket(const Eric &eric, const std::string &antwort)
+{
+    EricErgebnis serverantwort(eric);
+    if (antwort.empty() || serverantwort.leseServerantwort(antwort) != ERIC_OK || serverantwort.transferticket().leer())
+    {
+        std::cerr << "Die Serverantwort enthaelt kein Transferticket." << std::endl;
+        return std::string();
+    }
+    return serverantwort.transferticket().text();
+}
+
+/** @brief Beauftragt den Druck des versendeten Datensatzes mit dem Transferticket der Serverantwort */
+static bool beauftrageNachdruck(const System::KommandozeilenParser &argParser, const EricVorgang &vorgang,
+                                const std::string &transferticket, EricNachdruck &nachdruck)
+{
+    try
+    {
+        return nachdruck.beauftrage(transferticket, vorgang.datensatz(), argParser.getDatenartVersion(), argParser.getMandant());
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr << "Der Druck konnte nicht beauftragt werden: " << stdException.what() << std::endl;
+        return false;
+    }
+}
+
+/** @brief Uebergibt PDFs an das Archiv */
+static void archivierePdfs(EricArchiv &archiv, const std::string &transferticket, const std::vector<EricPdfSammler::Pdf> &pdfs)
+{
+    std::vector<EricArchiv::Artefakt> artefakte(pdfs.size());
+    for (size_t i = 0; i < pdfs.size(); ++i)
+    {
+        artefakte[i].art = "pdf:" + pdfs[i].bezeichner;
+        artefakte[i].inhalt = pdfs[i].daten;
+    }
+    archiv.archiviere(transferticket, MOVE_NO_XLC(artefakte));
+}
+
+/** @brief Wartet auf das Archiv und gibt die zum Transferticket archivierten Artefakte aus */
+static void protokolliereArchiv(EricArchiv &archiv, const std::string &transferticket)
+{
+    archiv.warteAufSchreiben();
+    const EricArchiv::Kennzahlen kennzahlen = archiv.kennzahlen();
+    System::titelZeile("Archiv zum Transferticket " + transferticket);
+    const std::vector<EricArchiv::Verweis> verweise = archiv.artefakte(transferticket);
+    for (size_t i = 0; i < verweise.size(); ++i)
+    {
+        std::string inhalt;
+        std::cout << "  " << verweise[i].art << ": ";
+        if (archiv.lese(verweise[i].schluessel, inhalt))
+            std::cout << inhalt.size() << " Bytes" << std::endl;
+        else
+            std::cout << "nicht lesbar" << std::endl;
+    }
+    std::cout << "Artefakte:          " << kennzahlen.artefakte << " (" << kennzahlen.doppelt << " bereits vorhanden)" << std::endl
+              << "Neue Inhalte:       " << kennzahlen.neu << ", " << kennzahlen.rohBytes << " Bytes, gespeichert "
+                                        << kennzahlen.gespeichertBytes << " Bytes" << std::endl
+              << "Inhalte im Archiv:  " << kennzahlen.inhalte << std::endl
+              << "Woerterbuecher:     " << kennzahlen.woerterbuecher << std::endl
+              << "Schreibstapel:      " << kennzahlen.stapel << std::endl;
+    if (kennzahlen.kollisionen > 0)
+    {
+        std::cout << "Hashkollisionen:    " << kennzahlen.kollisionen << std::endl;
+    }
+    if (kennzahlen.schreibfehler > 0)
+    {
+        std::cout << "Schreibfehler:      " << kennzahlen.schreibfehler << std::endl;
+    }
+}
+
+/** @brief Wartet auf den nachgelagerten Druck und gibt dessen PDFs aus */
+static void protokolliereNachdruck(const System::KommandozeilenParser &argParser, const EricNachdruck &nachdruck,
+                                   const std::string &transferticket, EricFehlertabelle &fehlertabelle, EricArchiv *archiv)
+{
+    std::shared_ptr<const EricNachdruck::Beleg> beleg;
+    if (nachdruck.warte(transferticket, beleg) == EricNachdruck::UNBEKANNT)
+    {
+        return;
+    }
+
+    System::titelZeile("Nachgelagerter Druck zum Transferticket " + transferticket);
+    std::cout << "Dauer ab Versand:   " << beleg->dauerMs << " ms" << std::endl;
+    if (beleg->rc != ERIC_OK)
+    {
+        std::cout << "Fehler:             " << beleg->rc << " " << fehlertabelle.fehlertext(beleg->rc) << std::endl
+                  << beleg->ergebnis << std::endl;
+    }
+    ::protokolliereDruck(argParser, beleg->pdfs);
+    if (archiv != nullptr)
+    {
+        ::archivierePdfs(*archiv, transferticket, beleg->pdfs);
+    }
+}
+
+/** @brief Gibt je Datenart die Histogrammwerte der Bearbeitungsphasen aus */
+static void protokollierePhasenzeiten(const EricPhasenzeiten &phasenzeiten)
+{
+    const EricPhasenzeiten::Kennzahlen kennzahlen = phasenzeiten.kennzahlen();
+    for (std::map<std::string, EricPhasenzeiten::Verteilung>::const_iterator it = kennzahlen.datenarten.begin();
+         it != kennzahlen.datenarten.end(); ++it)
+    {
+        System::titelZeile("Phasenzeiten " + it->first);
+        for (int phase = EricPhasenzeiten::EINLESEN; phase < EricPhasenzeiten::ANZAHL_PHASEN; ++phase)
+        {
+            const EricPhasenzeiten::Histogramm &histogramm = it->second.phasen[phase];
+            if (histogramm.anzahl == 0)
+            {
+                continue;
+            }
+            const std::string bezeichnung = EricPhasenzeiten::bezeichnung(static_cast<EricPhasenzeiten::Phase>(phase));
+            std::cout << bezeichnung << ":" << std::string(bezeichnung.size() < 20 ? 20 - bezeichnung.size() : 1, ' ')
+                      << histogramm.anzahl << "x, Mittel " << histogramm.mittelMs() << " ms, p50 " << histogramm.quantilMs(0.5)
+                      << " ms, p95 " << histogramm.quantilMs(0.95) << " ms, Max " << histogramm.maxMs << " ms" << std::endl;
+        }
+        // Nur der Versand wartet auf die ELSTER-Annahmeserver
+        const double gesamtMs = it->second.phasen[EricPhasenzeiten::GESAMT].summeMs;
+        if (gesamtMs > 0.0)
+        {
+            std::cout << "Anteil Versand:      " << 100.0 * it->second.phasen[EricPhasenzeiten::SENDEN].summeMs / gesamtMs << " %" << std::endl;
+        }
+    }
+    if (kennzahlen.unbekannteIds > 0)
+    {
+        std::cout << "Unbekannte IDs:      " << kennzahlen.unbekannteIds << std::endl;
+    }
+}
+
+/** @brief Gibt aus, wie viele Lognachrichten geschrieben, gefiltert und verworfen wurden */
+static void protokolliereLog(const EricLogProtokoll &logProtokoll)
+{
+    const EricLogProtokoll::Kennzahlen kennzahlen = logProtokoll.kennzahlen();
+    System::titelZeile("JSON-Log eric.jsonl");
+    std::cout << "Geschrieben:         " << kennzahlen.geschrieben << std::endl
+              << "Unter Mindestebene:  " << kennzahlen.gefiltert << std::endl
+              << "Gedrosselt:          " << kennzahlen.gedrosselt << std::endl
+              << "Ring voll:           " << kennzahlen.uebergelaufen << std::endl
+              << "Gekuerzt:            " << kennzahlen.gekuerzt << std::endl;
+}
+
+/** @brief Schreibt die Spuren der ausgewaehlten Anfragen, falls die Option --spuren angegeben ist */
+static void schreibeSpuren(const std::string &spurDatei)
+{
+    if (spurDatei.empty())
+    {
+        return;
+    }
+    const EricSpuren::Kennzahlen kennzahlen = EricSpuren::instanz().kennzahlen();
+    System::titelZeile("Spuren " + spurDatei);
+    if (!EricSpuren::instanz().schreibe(spurDatei))
+    {
+        std::cerr << "Die Spuren konnten nicht geschrieben werden" << std::endl;
+        return;
+    }
+    std::cout << "Anfragen:            " << kennzahlen.anfragen << std::endl
+              << "Aufgezeichnet:       " << kennzahlen.ausgewaehlt << std::endl
+              << "Spannen:             " << kennzahlen.spannen << std::endl
+              << "Puffer voll:         " << kennzahlen.verworfen << std::endl;
+}
+
+/** @brief Erzeugt den Mitschnitt langsamer Vorgaenge, falls die Option --mitschnitt angegeben ist */
+static std::unique_ptr<EricMitschnitt> erzeugeMitschnitt(const System::KommandozeilenParser &argParser)
+{
+    std::unique_ptr<EricMitschnitt> mitschnitt;
+    if (argParser.getMitschnittVerzeichnis().empty())
+    {
+        return mitschnitt;
+    }
+    if (!argParser.getMitschnittSchwaerzen())
+    {
+        std::cerr << "Warnung: Der Mitschnitt in \"" << argParser.getMitschnittVerzeichnis()
+                  << "\" enthaelt die Datensaetze ungeschwaerzt, also personenbezogene Steuerdaten." << std::endl;
+    }
+
+    // Die Wiederholung kann aus einem anderen Arbeitsverzeichnis gestartet werden
+    std::string arbeitsverzeichnis;
+    const bool arbeitsverzeichnisBekannt = System::getArbeitsverzeichnis(arbeitsverzeichnis);
+    const auto absolut = [&](const std::string &pfad) -> std::string
+    {
+        const bool relativ = !pfad.empty() && pfad[0] != PFAD_SEPARATOR && pfad.find(':') == std::string::npos;
+        return relativ && arbeitsverzeichnisBekannt ? arbeitsverzeichnis + pfad : pfad;
+    };
+    // Ohne Pfadangabe wurde ericdemo ueber PATH gefunden
+    const std::string ericdemoPfad = argParser.getAufrufPfad().find(PFAD_SEPARATOR) == std::string::npos
+        ? argParser.getAufrufPfad() : absolut(argParser.getAufrufPfad());
+
+    mitschnitt.reset(new EricMitschnitt(argParser.getMitschnittVerzeichnis(),
+                                        argParser.getMitschnittSchwelleMs(),
+                                        argParser.getMitschnittAnzahl(),
+                                        argParser.getMitschnittSchwaerzen(),
+                                        ericdemoPfad, absolut(argParser.getHomeDir()), absolut(argParser.getLogDir())));
+    return mitschnitt;
+}
+
+/** @brief Gibt die Kennzahlen des Mitschnitts langsamer Vorgaenge aus */
+static void protokolliereMitschnitt(const EricMitschnitt &mitschnitt)
+{
+    const EricMitschnitt::Kennzahlen kennzahlen = mitschnitt.kennzahlen();
+    System::titelZeile("Mitschnitt " + mitschnitt.getVerzeichnis());
+    std::cout << "Langsame Vorgaenge:  " << kennzahlen.langsam << std::endl
+              << "Gespeichert:         " << kennzahlen.gespeichert << std::endl
+              << "Fehlgeschlagen:      " << kennzahlen.fehlgeschlagen << std::endl;
+}
+
+/** @brief Erzeuge die Vorschau des Datensatzes mehrfach gleichzeitig und dann erneut aus dem Zwischenspeicher. */
+static int zeigeVorschau(const System::KommandozeilenParser &argParser, EricLogProtokoll *logProtokoll)
+{
+    const size_t ANZAHL_ANFRAGEN = 4;
+
+    int fehlerkode = ERIC_GLOBAL_UNKNOWN;
+    try
+    {
+        std::string xmlDaten;
+        Datensatzleser leser;
+        leser.lese(argParser.getDatensatzDatei(), xmlDaten);
+
+        EricMt ericMt(argParser.getHomeDir(), argParser.getLogDir(), logProtokoll);
+        std::string ericVersion;
+        fehlerkode = ermittleEricVersion(ericMt, ericVersion);
+        if (fehlerkode != ERIC_OK)
+        {
+            return fehlerkode;
+        }
+
+        EricVorschau vorschauen(ericMt, ericVersion, 2, 64);
+
+        // Gleichzeitige Anfragen fuer denselben Entwurf werden zu einem Druck gebuendelt
+        std::vector<std::thread> anfragen;
+        std::vector<int> rueckgabewerte(ANZAHL_ANFRAGEN, ERIC_GLOBAL_UNKNOWN);
+        std::vector<std::string> fehler(ANZAHL_ANFRAGEN);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ANZAHL_ANFRAGEN; ++i)
+        {
+            anfragen.push_back(std::thread([&, i]()
+            {
+                try
+                {
+                    std::shared_ptr<const EricVorschau::Vorschau> vorschau;
+                    EricValidierungsCache::Herkunft herkunft = EricValidierungsCache::BERECHNET;
+                    rueckgabewerte[i] = vorschauen.erzeuge(xmlDaten, argParser.getDatenartVersion(), argParser.getMandant(), vorschau, herkunft);
+                }
+                catch(const std::exception& stdException)
+                {
+                    fehler[i] = stdException.what();
+                }
+            }));
+        }
+        for (size_t i = 0; i < anfragen.size(); ++i)
+        {
+            anfragen[i].join();
+        }
+        const double gleichzeitigMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (size_t i = 0; i < fehler.size(); ++i)
+        {
+            if (!fehler[i].empty())
+            {
+                std::cerr << "Fehler: " << fehler[i] << std::endl;
+                return ERIC_GLOBAL_UNKNOWN;
+            }
+        }
+
+        // Der unveraenderte Entwurf kommt aus dem Zwischenspeicher
+        std::shared_ptr<const EricVorschau::Vorschau> vorschau;
+        EricValidierungsCache::Herkunft herkunft = EricValidierungsCache::BERECHNET;
+        const std::chrono::steady_clock::time_point erneut = std::chrono::steady_clock::now();
+        fehlerkode = vorschauen.erzeuge(xmlDaten, argParser.getDatenartVersion(), argParser.getMandant(), vorschau, herkunft);
+        const double trefferUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - erneut).count();
+
+        const EricVorschau::Kennzahlen kennzahlen = vorschauen.kennzahlen();
+        System::titelZeile("Vorschau von \"" + argParser.getDatensatzDatei() + "\"");
+        std::cout << "Rueckgabewert:      " << fehlerkode << std::endl
+                  << "Druckdauer:         " << vorschau->dauerMs << " ms" << std::endl
+                  << "Gleichzeitig:       " << ANZAHL_ANFRAGEN << " Anfragen in " << gleichzeitigMs << " ms" << std::endl
+                  << "Erneut:             " << trefferUs << " us"
+                                            << (herkunft == EricValidierungsCache::ZWISCHENSPEICHER ? " aus dem Zwischenspeicher" : "") << std::endl
+                  << "Gedruckt:           " << kennzahlen.erzeugt << std::endl
+                  << "Gebuendelt:         " << kennzahlen.gebuendelt << std::endl
+                  << "Treffer:            " << kennzahlen.treffer << std::endl
+                  << "ERiC-Instanzen:     " << kennzahlen.instanzen << std::endl;
+        if (fehlerkode != ERIC_OK)
+        {
+            std::cout << std::endl << vorschau->ergebnis << std::endl;
+        }
+        ::protokolliereDruck(argParser, vorschau->pdfs);
+    }
+    catch(const std::exception& stdException)
+    {
+        std::cerr<< "Fehler: " << stdException.what() << std::endl;
+    }
+    return fehlerkode;
+}
+
+/** @brief Ermittle die Datenartversion aus dem Datensatz, falls sie nicht angegeben wurde. */
+static void ergaenzeDatenartVersion(System::KommandozeilenParser &argParser)
+{
+    if (argParser.getHatDatenartVersion() || argParser.getDatenEntschluesseln())
+    {
+        return;
+    }
+
+    try
+    {
+        std::string xmlDaten, datenartVersion;
+        Datensatzleser leser;
+        leser.lese(argParser.getDatensatzDatei(), xmlDaten);
+        if (Datenartversionserkennung().erkenne(xmlDaten, datenartVersion))
+        {
+            argParser.setDatenartVersion(datenartVersion);
+            std::cout << "Aus dem Datensatz ermittelte Datenartversion: " << datenartVersion << std::endl;
+        }
+    }
+    catch (const std::exception &)
+    {
+        // Der Lesefehler wird bei der Verarbeitung des Datensatzes gemeldet
+    }
+}
+
+/** @brief Pruefe die Kennungen des Datensatzes mit dem ERiC-Toolkit, ohne den ERiC zu laden. */
+static int pruefeFelder(const System::KommandozeilenParser &argParser)
+{
+    EricToolkit toolkit(argParser.getHomeDir());
+    EricFeldpruefung feldpruefung(toolkit);
+
+    std::string xmlDaten;
+    Datensatzleser leser;
+    leser.lese(argParser.getDatensatzDatei(), xmlDaten);
+
+    EricFeldpruefung::Befund befund;
+    const int rc = feldpruefung.pruefe(xmlDaten, befund);
+    if (rc != ERIC_OK)
+    {
+        System::titelZeile("Feldpruefung des Datensatzes \"" + argParser.getDatensatzDatei() + "\" fehlgeschlagen");
+        std::cout << "Element <" << befund.element << "> mit Inhalt \"" << befund.wert
+                  << "\" ist ungueltig (Fehlerkode " << rc << ")" << std::endl;
+    }
+    return rc;
+}
+
+/** @brief Gib die Kennzahlen der Schemavorpruefung aus. */
+static void protokolliereVorpruefung(const EricSchemaVorpruefung &vorpruefung)
+{
+    const EricSchemaVorpruefung::Kennzahlen kennzahlen = vorpruefung.kennzahlen();
+    System::titelZeile("Schemavorpruefung");
+    std::cout << "Vorpruefungen:        " << kennzahlen.vorpruefungen << " (" << kennzahlen.vorpruefungMs << " ms)" << std::endl
+              << "Abgewiesen:           " << kennzahlen.abgewiesen << std::endl
+              << "Ohne Schemapruefung:  " << kennzahlen.nichtUnterstuetzt << std::endl
+              << "Vollverarbeitungen:   " << kennzahlen.vollverarbeitungen << " (" << kennzahlen.vollverarbeitungMs << " ms)" << std::endl
+              << "Geschaetzte Ersparnis: " << kennzahlen.geschaetzteErsparnisMs() << " ms" << std::endl;
+}
+
 #ifdef WINDOWS_MSVC
 int wmain(int argc, wchar_t* argv[]){
     // Setze das Windows-Console-Encoding auf UTF-8
@@ -163,49 +1035,280 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    // Die Metriken bleiben bis zum Programmende abrufbar, die Datei wird zuletzt im Destruktor geschrieben
+    std::unique_ptr<MetrikExport> metrikExport;
+    if (argParser.getMetrikPort() != 0 || !argParser.getMetrikDatei().empty())
+    {
+        try
+        {
+            metrikExport.reset(new MetrikExport(EricMetriken::instanz(), argParser.getMetrikPort(), argParser.getMetrikDatei(), 10));
+        }
+        catch(const std::exception& stdException)
+        {
+            std::cerr<< "Fehler: " << stdException.what() << std::endl;
+            warteAufEingabe();
+            return EXIT_FAILURE;
+        }
+        if (argParser.getMetrikPort() != 0)
+        {
+            std::cout << "Metriken unter http://127.0.0.1:" << argParser.getMetrikPort() << "/metrics" << std::endl;
+        }
+    }
+
+    // Die Instanzen der Multithreading-API schreiben ihre Lognachrichten nach eric.jsonl statt nach eric.log
+    std::unique_ptr<EricLogProtokoll> logProtokoll;
+    if (!argParser.getLogEbene().empty())
+    {
+        eric_log_level_t logEbene = ERIC_LOG_INFO;
+        if (!EricLogProtokoll::leseEbene(argParser.getLogEbene(), logEbene))
+        {
+            std::cerr << "Ungueltige Logebene \"" << argParser.getLogEbene() << "\"" << std::endl;
+            argParser.zeigeHilfe(std::cerr);
+            warteAufEingabe();
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            logProtokoll.reset(new EricLogProtokoll(System::dateiPfad(Eric::ermittleLogverzeichnis(argParser.getLogDir()), "eric.jsonl"), logEbene, 200));
+        }
+        catch(const std::exception& stdException)
+        {
+            std::cerr<< "Fehler: " << stdException.what() << std::endl;
+            warteAufEingabe();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Zeitspannen eines Anteils der Anfragen im Chrome-Trace-Format aufzeichnen
+    const std::string &spurDatei = argParser.getSpurDatei();
+    if (!spurDatei.empty())
+    {
+        EricSpuren::instanz().aktiviere(argParser.getSpurAnteil());
+    }
+
+    if (!argParser.getCezVerzeichnis().empty())
+    {    // Nur ein Schluesselpaar fuer ein clientseitig erzeugtes Zertifikat anlegen
+        const int rc = erzeugeCez(argParser, logProtokoll.get());
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!argParser.getBufaNummer().empty())
+    {    // Nur das Finanzamtsverzeichnis befragen
+        const int rc = zeigeFinanzamt(argParser);
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!argParser.getSpaltenDatei().empty())
+    {    // Nur die Spalten der Datei gesammelt pruefen
+        int rc = ERIC_GLOBAL_UNKNOWN;
+        try
+        {
+            rc = pruefeSpalten(argParser);
+        }
+        catch(const std::exception& stdException)
+        {
+            std::cerr<< "Fehler: " << stdException.what() << std::endl;
+        }
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!argParser.getSteuernummernDatei().empty())
+    {    // Nur die Steuernummern der Datei normalisieren
+        const int rc = normalisiereSteuernummern(argParser, logProtokoll.get());
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    ::ergaenzeDatenartVersion(argParser);
+
+    if (argParser.getAuswahllistenAnzeigen())
+    {    // Nur die Auswahllisten zur Datenartversion ausgeben
+        const int rc = zeigeAuswahllisten(argParser, logProtokoll.get());
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (argParser.getVorschau())
+    {    // Nur die Vorschau-PDFs des Datensatzes erzeugen
+        const int rc = zeigeVorschau(argParser, logProtokoll.get());
+        ::schreibeSpuren(spurDatei);
+        warteAufEingabe();
+        return rc == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     int fehlerkode = ERIC_GLOBAL_UNKNOWN;
 
+    if (argParser.getFeldpruefung() && !argParser.getDatenEntschluesseln())
+    {    // Datensaetze mit ungueltigen Kennungen abweisen, bevor der ERiC geladen wird
+        int feldpruefungsStatus = ERIC_GLOBAL_UNKNOWN;
+        try
+        {
+            feldpruefungsStatus = ::pruefeFelder(argParser);
+        }
+        catch(const std::exception& stdException)
+        {
+            std::cerr<< "Fehler: " << stdException.what() << std::endl;
+        }
+        if (feldpruefungsStatus != ERIC_OK)
+        {
+            warteAufEingabe();
+            return EXIT_FAILURE;
+        }
+    }
+
     try
     {
         Eric eric(argParser.getHomeDir(), argParser.getLogDir());
 
+        // Sammelt die Phasendauern des Vorgangs und des nachgelagerten Drucks
+        EricPhasenzeiten phasenzeiten;
+
+        // Schneidet Vorgang und nachgelagerten Druck mit, falls sie die Schwelle ueberschreiten
+        std::unique_ptr<EricMitschnitt> mitschnitt = ::erzeugeMitschnitt(argParser);
+
         // Callbacks anmelden, diese werden im Dekonstruktor des Objekts wieder abgemeldet
         CallbackHandler callbackHandler(eric);
 
-        // Zertifikateigenschaften ausgeben
+        EricFehlertabelle fehlertabelle(eric);
 
-#if defined(__xlC__) && !defined(__clang__) // Der IBM AIX-Compiler xlC Legacy unterstützt unique_ptr nicht
-        System::FreePtr<EricZertifikat> zertifikat;
-#else
-        std::unique_ptr<EricZertifikat> zertifikat;
-#endif
+        // Die Anfrage umfasst Zertifikatspruefung und Vorgang
+        std::unique_ptr<EricSpuren::Anfrage> anfrage(new EricSpuren::Anfrage("Vorgang", argParser.getDatenartVersion()));
+
+        // Zertifikat und PIN vorab pruefen und Zertifikateigenschaften ausgeben.
+        // Eine falsche PIN oder ein abgelaufenes Zertifikat faellt so auf, bevor
+        // der Datensatz eingelesen, validiert und fuer den Versand vorbereitet wird.
+        EricZertifikatsPruefung zertifikatsPruefung(eric);
+        const EricZertifikat *zertifikat = nullptr;
+        int zertifikatsStatus = ERIC_OK;
         if (argParser.getZertifikatPfad().compare("_NULL") != 0)
         {
-            zertifikat.reset(new EricZertifikat(eric,argParser.getZertifikatPfad(),argParser.getZertifikatPin()));
-            System::titelZeile("Zertifikatseigenschaften von \"" + argParser.getZertifikatPfad() + "\"");
-            std::cout << zertifikat->getEigenschaften() << std::endl;
+            zertifikatsStatus = zertifikatsPruefung.pruefe(argParser.getZertifikatPfad(), argParser.getZertifikatPin(), zertifikat);
+            if (zertifikat != nullptr)
+            {
+                System::titelZeile("Zertifikatseigenschaften von \"" + argParser.getZertifikatPfad() + "\"");
+                std::cout << zertifikat->getEigenschaften() << std::endl;
+            }
         }
 
         std::string ergebnis, antwort;
         EricTransferHandle transferHandle = 0;
+        EricPdfSammler pdfSammler;
+        // Nur fuer den nachgelagerten Druck, siehe Option -g
+        std::unique_ptr<EricMt> ericMt;
+        std::unique_ptr<EricNachdruck> nachdruck;
+        // Nur fuer das Archiv, siehe Option -y
+        std::unique_ptr<EricArchiv> archiv;
+        std::string transferticket;
+        const bool zertifikatErforderlich = argParser.getDatensatzSenden() || argParser.getDatenEntschluesseln();
 
-        // Entweder Daten dekodieren ...
+        // Ein unbrauchbares Zertifikat fuehrt zur sofortigen Ablehnung ...
+        if (zertifikatsStatus != ERIC_OK && zertifikatErforderlich)
+        {
+            System::titelZeile("Vorabpruefung des Zertifikats \"" + argParser.getZertifikatPfad() + "\" fehlgeschlagen");
+            fehlerkode = zertifikatsStatus;
+        } else
+
+        // ... ansonsten entweder Daten dekodieren ...
         if (argParser.getDatenEntschluesseln())
         {
             EricDekodierung dekodierung(eric);
             dekodierung.leseDatensatz(argParser.getDatensatzDatei());
-            fehlerkode = dekodierung.ausfuehren(argParser, zertifikat.get(),ergebnis);
+            fehlerkode = dekodierung.ausfuehren(argParser, zertifikat,ergebnis);
         } else
 
         // ... oder den Datensatz validieren und falls gewünscht versenden
         if (!argParser.getDatenartVersion().empty())
         {
-            EricVorgang vorgang(eric);
+            std::unique_ptr<EricValidierungsCache> validierungsCache = ::erzeugeValidierungsCache(argParser, eric);
+            std::unique_ptr<EricSchemaVorpruefung> schemaVorpruefung(argParser.getSchemaVorpruefung() ? new EricSchemaVorpruefung(eric) : nullptr);
+            EricVorgang vorgang(eric, validierungsCache.get(), schemaVorpruefung.get());
             vorgang.leseDatensatz(argParser.getDatensatzDatei());
-            fehlerkode = vorgang.ausfuehren(argParser,zertifikat.get(),ergebnis,antwort,transferHandle);
+            if (argParser.getDruckNachgelagert() && argParser.getDatensatzSenden() && !argParser.getHatTransferHandle())
+            {   // Der Druckthread laeuft schon, wenn der Versand zurueckkehrt
+                ericMt.reset(new EricMt(argParser.getHomeDir(), argParser.getLogDir(), logProtokoll.get()));
+                nachdruck.reset(new EricNachdruck(*ericMt, 1, &phasenzeiten, mitschnitt.get()));
+            }
+            if (!argParser.getArchivVerzeichnis().empty() && argParser.getDatensatzSenden())
+            {   // Ein neues Archiv trainiert sein erstes Woerterbuch am Datensatz, spaetere an den archivierten Datensaetzen
+                archiv.reset(new EricArchiv(argParser.getArchivVerzeichnis(), std::vector<std::string>(1, vorgang.datensatz())));
+            }
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            callbackHandler.beginneMessung(phasenzeiten,argParser.getDatenartVersion());
+            fehlerkode = vorgang.ausfuehren(argParser,zertifikat,ergebnis,antwort,transferHandle,pdfSammler);
+            callbackHandler.beendeMessung();
+            if (mitschnitt)
+            {
+                EricMitschnitt::Vorgang mitgeschnitten;
+                mitgeschnitten.datenartVersion = argParser.getDatenartVersion();
+                mitgeschnitten.bearbeitungsFlags = EricVorgang::ermittleBearbeitungsFlags(argParser);
+                mitgeschnitten.rc = fehlerkode;
+                mitgeschnitten.instanz = "Singlethreading-API";
+                mitgeschnitten.vorgaengeDerInstanz = 1;
+                mitgeschnitten.uebernehmePhasen(*callbackHandler.letzteMessung());
+                const std::string datei = mitschnitt->erfasse(mitgeschnitten, vorgang.datensatz());
+                if (!datei.empty())
+                {
+                    std::cout << "Langsamer Vorgang mitgeschnitten: " << datei << std::endl;
+                }
+            }
+            if (nachdruck)
+            {
+                std::cout << "Versand ohne Druck nach " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                          << " ms abgeschlossen" << std::endl;
+            }
+            if ((nachdruck || archiv) && fehlerkode == ERIC_OK)
+            {
+                transferticket = ::ermittleTransferticket(eric,antwort);
+            }
+            if (nachdruck && !transferticket.empty() && !::beauftrageNachdruck(argParser,vorgang,transferticket,*nachdruck))
+            {
+                nachdruck.reset();
+            }
+            if (archiv && !transferticket.empty())
+            {
+                std::vector<EricArchiv::Artefakt> artefakte(3);
+                artefakte[0].art = "datensatz";
+                artefakte[0].inhalt = vorgang.datensatz();
+                artefakte[1].art = "serverantwort";
+                artefakte[1].inhalt = antwort;
+                artefakte[2].art = "ergebnis";
+                artefakte[2].inhalt = ergebnis;
+                archiv->archiviere(transferticket, MOVE_NO_XLC(artefakte));
+                ::archivierePdfs(*archiv,transferticket,pdfSammler.pdfs());
+            }
+            if (validierungsCache)
+            {
+                ::protokolliereCache(*validierungsCache);
+            }
+            if (schemaVorpruefung)
+            {
+                ::protokolliereVorpruefung(*schemaVorpruefung);
+            }
         }
+        anfrage.reset();
 
-        ::protokolliere(argParser,fehlerkode,ergebnis,antwort,transferHandle,eric);
+        ::protokolliere(argParser,fehlerkode,ergebnis,antwort,transferHandle,fehlertabelle);
+        ::protokolliereDruck(argParser,pdfSammler.pdfs());
+        if (nachdruck && !transferticket.empty())
+        {
+            ::protokolliereNachdruck(argParser,*nachdruck,transferticket,fehlertabelle,archiv.get());
+        }
+        if (archiv && !transferticket.empty())
+        {
+            ::protokolliereArchiv(*archiv,transferticket);
+        }
+        ::protokollierePhasenzeiten(phasenzeiten);
+        if (mitschnitt)
+        {
+            ::protokolliereMitschnitt(*mitschnitt);
+        }
+        if (!argParser.getStrukturDatei().empty() && !argParser.getDatenEntschluesseln())
+        {
+            ::schreibeStrukturiertesErgebnis(argParser,fehlerkode,ergebnis,antwort,eric);
+        }
     }
     catch(const std::exception& stdException)
     {
@@ -216,6 +1319,12 @@ int main(int argc, char* argv[]) {
         std::cerr << "Unbekannter Fehler" << std::endl;
     }
 
+    if (logProtokoll)
+    {
+        logProtokoll->beende();
+        ::protokolliereLog(*logProtokoll);
+    }
+    ::schreibeSpuren(spurDatei);
     warteAufEingabe();
     return fehlerkode == ERIC_OK ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,303 @@
+#include "ericergebnis.h"
+
+#include <cstdio>
+#include <cstring>
+#include <eric_fehlercodes.h>
+
+#include "eric.h"
+#include "ericpuffer.h"
+#include "jsontext.h"
+
+
+namespace
+{
+
+/** @brief Zuordnung der Kindelemente von <FehlerRegelpruefung> und <Hinweis> zu den Feldern einer Meldung */
+struct Meldungsfeld
+{
+    const char                            *element;
+    Textausschnitt EricErgebnis::Meldung::*feld;
+};
+
+const Meldungsfeld MELDUNGSFELDER[] =
+{
+    { "Nutzdatenticket",      &EricErgebnis::Meldung::nutzdatenticket },
+    { "Feldidentifikator",    &EricErgebnis::Meldung::feldidentifikator },
+    { "Mehrfachzeilenindex",  &EricErgebnis::Meldung::mehrfachzeilenindex },
+    { "LfdNrVordruck",        &EricErgebnis::Meldung::lfdNrVordruck },
+    { "VordruckZeilennummer", &EricErgebnis::Meldung::vordruckZeilennummer },
+    { "SemantischerIndex",    &EricErgebnis::Meldung::semantischerIndex },
+    { "Untersachbereich",     &EricErgebnis::Meldung::untersachbereich },
+    { "RegelName",            &EricErgebnis::Meldung::regelName },
+    { "FachlicheFehlerId",    &EricErgebnis::Meldung::fachlicheId },
+    { "FachlicheHinweisId",   &EricErgebnis::Meldung::fachlicheId },
+    { "Text",                 &EricErgebnis::Meldung::text }
+};
+
+// Ausgabenamen der Meldungsfelder fuer JSON und Binaerformat, in Deklarationsreihenfolge
+const Meldungsfeld AUSGABEFELDER[] =
+{
+    { "nutzdatenticket",      &EricErgebnis::Meldung::nutzdatenticket },
+    { "feldidentifikator",    &EricErgebnis::Meldung::feldidentifikator },
+    { "mehrfachzeilenindex",  &EricErgebnis::Meldung::mehrfachzeilenindex },
+    { "lfdNrVordruck",        &EricErgebnis::Meldung::lfdNrVordruck },
+    { "vordruckZeilennummer", &EricErgebnis::Meldung::vordruckZeilennummer },
+    { "semantischerIndex",    &EricErgebnis::Meldung::semantischerIndex },
+    { "untersachbereich",     &EricErgebnis::Meldung::untersachbereich },
+    { "regelName",            &EricErgebnis::Meldung::regelName },
+    { "fachlicheId",          &EricErgebnis::Meldung::fachlicheId },
+    { "text",                 &EricErgebnis::Meldung::text }
+};
+
+Textausschnitt ausschnitt(const EricPuffer &puffer)
+{
+    return Textausschnitt(puffer.inhalt(), puffer.laenge());
+}
+
+/** @brief Haengt einen Text aus dem Ergebnis-XML mit aufgeloesten Entitaeten als JSON-Zeichenkette an */
+void haengeJsonTextAn(std::string &json, const Textausschnitt &text)
+{
+    JsonText::haengeAn(json, XmlTagLeser::dekodiere(text));
+}
+
+void haengeJsonListeAn(std::string &json, const char *schluessel, const std::vector<Textausschnitt> &liste)
+{
+    json += ",\"";
+    json += schluessel;
+    json += "\":[";
+    for (size_t i = 0; i < liste.size(); ++i)
+    {
+        if (i > 0)
+            json += ',';
+        haengeJsonTextAn(json, liste[i]);
+    }
+    json += ']';
+}
+
+void haengeJsonMeldungenAn(std::string &json, const char *schluessel, const std::vector<EricErgebnis::Meldung> &meldungen,
+                           EricErgebnis::Meldungsart art)
+{
+    json += ",\"";
+    json += schluessel;
+    json += "\":[";
+    bool erste = true;
+    for (std::vector<EricErgebnis::Meldung>::const_iterator meldung = meldungen.begin(); meldung != meldungen.end(); ++meldung)
+    {
+        if (meldung->art != art)
+            continue;
+        json += erste ? "{" : ",{";
+        erste = false;
+
+        bool ersterWert = true;
+        for (size_t f = 0; f < sizeof(AUSGABEFELDER) / sizeof(AUSGABEFELDER[0]); ++f)
+        {
+            const Textausschnitt &wert = (*meldung).*AUSGABEFELDER[f].feld;
+            if (wert.leer())
+                continue;
+            json += ersterWert ? "\"" : ",\"";
+            ersterWert = false;
+            json += AUSGABEFELDER[f].element;
+            json += "\":";
+            haengeJsonTextAn(json, wert);
+        }
+        json += '}';
+    }
+    json += ']';
+}
+
+void haengeZahlAn(std::string &daten, uint32_t zahl)
+{
+    daten.append(reinterpret_cast<const char *>(&zahl), sizeof(zahl));
+}
+
+void haengeTextAn(std::string &daten, const Textausschnitt &text)
+{
+    const std::string klartext = XmlTagLeser::dekodiere(text);
+    haengeZahlAn(daten, static_cast<uint32_t>(klartext.size()));
+    daten += klartext;
+}
+
+} // anonymous namespace
+
+
+EricErgebnis::EricErgebnis(const Eric &eric_) : eric(eric_), ergebnisRc(ERIC_OK)
+{ }
+
+EricErgebnis::~EricErgebnis()
+{ }
+
+void EricErgebnis::leseErgebnis(int rueckgabewert, const char *xml, size_t laenge)
+{
+    ergebnisRc = rueckgabewert;
+    meldungsListe.clear();
+    telenummerListe.clear();
+    ordnungsbegriffListe.clear();
+
+    XmlTagLeser leser(xml, laenge);
+    Meldung *meldung = nullptr;
+    bool inErfolg = false;
+    while (leser.weiter())
+    {
+        if (leser.istEndeTag())
+        {
+            if (leser.hatName("FehlerRegelpruefung") || leser.hatName("Hinweis"))
+                meldung = nullptr;
+            else if (leser.hatName("Erfolg"))
+                inErfolg = false;
+            continue;
+        }
+
+        if (leser.hatName("FehlerRegelpruefung") || leser.hatName("Hinweis"))
+        {
+            meldungsListe.push_back(Meldung());
+            meldung = &meldungsListe.back();
+            meldung->art = leser.hatName("Hinweis") ? HINWEIS : FEHLER;
+            if (leser.istLeeresElement())
+                meldung = nullptr;
+        }
+        else if (meldung != nullptr)
+        {
+            for (size_t f = 0; f < sizeof(MELDUNGSFELDER) / sizeof(MELDUNGSFELDER[0]); ++f)
+            {
+                if (leser.hatName(MELDUNGSFELDER[f].element))
+                {
+                    leser.textinhalt(meldung->*MELDUNGSFELDER[f].feld);
+                    break;
+                }
+            }
+        }
+        else if (leser.hatName("Erfolg"))
+        {
+            inErfolg = !leser.istLeeresElement();
+        }
+        else if (inErfolg)
+        {
+            Textausschnitt wert;
+            if (leser.hatName("Telenummer") && leser.textinhalt(wert))
+                telenummerListe.push_back(wert);
+            else if (leser.hatName("Ordnungsbegriff") && leser.textinhalt(wert))
+                ordnungsbegriffListe.push_back(wert);
+        }
+    }
+}
+
+int EricErgebnis::leseServerantwort(const std::string &antwort)
+{
+    transferticketPuffer.reset(new EricPuffer(eric));
+    returncodeTHPuffer.reset(new EricPuffer(eric));
+    fehlertextTHPuffer.reset(new EricPuffer(eric));
+    nutzdatenheaderPuffer.reset(new EricPuffer(eric));
+    ticket = returncodeTransferheader = fehlertextTransferheader = Textausschnitt();
+    serverfehlerListe.clear();
+
+    const int rc = eric.EricGetErrormessagesFromXMLAnswer(antwort.c_str(),
+        transferticketPuffer->handle(), returncodeTHPuffer->handle(),
+        fehlertextTHPuffer->handle(), nutzdatenheaderPuffer->handle());
+    if (rc != ERIC_OK)
+    {
+        return rc;
+    }
+
+    ticket = ausschnitt(*transferticketPuffer);
+    returncodeTransferheader = ausschnitt(*returncodeTHPuffer);
+    fehlertextTransferheader = ausschnitt(*fehlertextTHPuffer);
+
+    XmlTagLeser leser(nutzdatenheaderPuffer->inhalt(), nutzdatenheaderPuffer->laenge());
+    Serverfehler *fehler = nullptr;
+    while (leser.weiter())
+    {
+        if (leser.hatName("Fehler"))
+        {
+            if (!leser.istEndeTag() && !leser.istLeeresElement())
+            {
+                serverfehlerListe.push_back(Serverfehler());
+                fehler = &serverfehlerListe.back();
+            }
+            else
+            {
+                fehler = nullptr;
+            }
+        }
+        else if (fehler != nullptr && !leser.istEndeTag())
+        {
+            if (leser.hatName("Code"))
+                leser.textinhalt(fehler->code);
+            else if (leser.hatName("Meldung"))
+                leser.textinhalt(fehler->meldung);
+        }
+    }
+    return rc;
+}
+
+std::string EricErgebnis::alsJson() const
+{
+    std::string json;
+    json.reserve(256 + meldungsListe.size() * 256);
+
+    char rueckgabe[32];
+    std::snprintf(rueckgabe, sizeof(rueckgabe), "{\"rueckgabewert\":%d", ergebnisRc);
+    json += rueckgabe;
+
+    haengeJsonListeAn(json, "telenummern", telenummerListe);
+    haengeJsonListeAn(json, "ordnungsbegriffe", ordnungsbegriffListe);
+    haengeJsonMeldungenAn(json, "fehler", meldungsListe, FEHLER);
+    haengeJsonMeldungenAn(json, "hinweise", meldungsListe, HINWEIS);
+
+    if (transferticketPuffer)
+    {
+        json += ",\"transferticket\":";
+        haengeJsonTextAn(json, ticket);
+        json += ",\"transferheader\":{\"returncode\":";
+        haengeJsonTextAn(json, returncodeTransferheader);
+        json += ",\"fehlertext\":";
+        haengeJsonTextAn(json, fehlertextTransferheader);
+        json += "},\"nutzdatenheader\":[";
+        for (size_t i = 0; i < serverfehlerListe.size(); ++i)
+        {
+            json += i > 0 ? ",{\"code\":" : "{\"code\":";
+            haengeJsonTextAn(json, serverfehlerListe[i].code);
+            json += ",\"meldung\":";
+            haengeJsonTextAn(json, serverfehlerListe[i].meldung);
+            json += '}';
+        }
+        json += ']';
+    }
+
+    json += '}';
+    return json;
+}
+
+std::string EricErgebnis::alsBinaerformat() const
+{
+    std::string daten("ERICERG1");
+
+    const int32_t rc = ergebnisRc;
+    daten.append(reinterpret_cast<const char *>(&rc), sizeof(rc));
+
+    haengeZahlAn(daten, static_cast<uint32_t>(telenummerListe.size()));
+    for (size_t i = 0; i < telenummerListe.size(); ++i)
+        haengeTextAn(daten, telenummerListe[i]);
+    haengeZahlAn(daten, static_cast<uint32_t>(ordnungsbegriffListe.size()));
+    for (size_t i = 0; i < ordnungsbegriffListe.size(); ++i)
+        haengeTextAn(daten, ordnungsbegriffListe[i]);
+
+    haengeTextAn(daten, ticket);
+    haengeTextAn(daten, returncodeTransferheader);
+    haengeTextAn(daten, fehlertextTransferheader);
+
+    haengeZahlAn(daten, static_cast<uint32_t>(meldungsListe.size()));
+    for (std::vector<Meldung>::const_iterator meldung = meldungsListe.begin(); meldung != meldungsListe.end(); ++meldung)
+    {
+        daten += static_cast<char>(meldung->art);
+        for (size_t f = 0; f < sizeof(AUSGABEFELDER) / sizeof(AUSGABEFELDER[0]); ++f)
+            haengeTextAn(daten, (*meldung).*AUSGABEFELDER[f].feld);
+    }
+
+    haengeZahlAn(daten, static_cast<uint32_t>(serverfehlerListe.size()));
+    for (size_t i = 0; i < serverfehlerListe.size(); ++i)
+    {
+        haengeTextAn(daten, serverfehlerListe[i].code);
+        haengeTextAn(daten, serverfehlerListe[i].meldung);
+    }
+    return daten;
+}
@@ -0,0 +1,130 @@
+#ifndef _ERICERGEBNIS_H_
+#define _ERICERGEBNIS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xmltagleser.h"
+
+// Vorwaertsdeklarationen
+class Eric;
+class EricPuffer;
+
+
+/** @brief Strukturiertes Ergebnis eines Vorgangs aus Ergebnis-XML und Serverantwort
+ *
+ * Das Ergebnis-XML von EricBearbeiteVorgang() wird in einem Durchgang in
+ * Fehler, Hinweise und Erfolgsangaben zerlegt. Die Serverantwort wertet
+ * EricGetErrormessagesFromXMLAnswer() aus; dessen Rueckgabepuffer gehoeren
+ * dem Objekt. Alle Felder sind Ausschnitte in die gelesenen Puffer, es wird
+ * kein Text kopiert. Entitaeten werden erst bei der Ausgabe als JSON oder im
+ * Binaerformat aufgeloest.
+ */
+class EricErgebnis
+{
+public:
+    enum Meldungsart
+    {
+        FEHLER,     // <FehlerRegelpruefung>
+        HINWEIS     // <Hinweis>
+    };
+
+    /** @brief Fehler der Plausibilitaetspruefung oder Hinweis */
+    struct Meldung
+    {
+        Meldungsart    art;
+        Textausschnitt nutzdatenticket;
+        Textausschnitt feldidentifikator;
+        Textausschnitt mehrfachzeilenindex;
+        Textausschnitt lfdNrVordruck;
+        Textausschnitt vordruckZeilennummer;
+        Textausschnitt semantischerIndex;
+        Textausschnitt untersachbereich;
+        Textausschnitt regelName;
+        Textausschnitt fachlicheId;         // <FachlicheFehlerId> bzw. <FachlicheHinweisId>
+        Textausschnitt text;
+    };
+
+    /** @brief Returncode und Fehlermeldung eines Nutzdatenheaders der Serverantwort */
+    struct Serverfehler
+    {
+        Textausschnitt code;
+        Textausschnitt meldung;
+    };
+
+    /** @brief Erzeugt ein leeres Ergebnis
+      *
+      * @param eric
+      *        Schnittstellenobjekt, das den ERiC kapselt.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricErgebnis, da diese eine Referenz darauf haelt!
+      */
+    explicit EricErgebnis(const Eric &eric);
+
+    virtual ~EricErgebnis();
+
+    /** @brief Zerlegt das Ergebnis-XML von EricBearbeiteVorgang()
+      *
+      * @param rueckgabewert Rueckgabewert von EricBearbeiteVorgang()
+      * @param xml           Inhalt des Ergebnispuffers, z. B. EricPuffer::inhalt().
+      *                      Der Text muss so lange leben wie dieses Objekt.
+      * @param laenge        Laenge des Inhalts in Bytes
+      */
+    void leseErgebnis(int rueckgabewert, const char *xml, size_t laenge);
+
+    /** @brief Wertet die Serverantwort mit EricGetErrormessagesFromXMLAnswer() aus
+      *
+      * @param antwort Antwort-XML des ELSTER-Servers
+      *
+      * @return Rueckgabewert von EricGetErrormessagesFromXMLAnswer()
+      */
+    int leseServerantwort(const std::string &antwort);
+
+    int                                rueckgabewert()   const { return ergebnisRc; }
+    const std::vector<Meldung>        &meldungen()       const { return meldungsListe; }
+    const std::vector<Textausschnitt> &telenummern()     const { return telenummerListe; }
+    const std::vector<Textausschnitt> &ordnungsbegriffe() const { return ordnungsbegriffListe; }
+    const Textausschnitt              &transferticket()  const { return ticket; }
+    const Textausschnitt              &returncodeTH()    const { return returncodeTransferheader; }
+    const Textausschnitt              &fehlertextTH()    const { return fehlertextTransferheader; }
+    const std::vector<Serverfehler>   &serverfehler()    const { return serverfehlerListe; }
+
+    /** @brief Liefert das Ergebnis als JSON-Objekt in UTF-8 */
+    std::string alsJson() const;
+
+    /** @brief Liefert das Ergebnis im Binaerformat
+      *
+      * Aufbau in der Bytefolge der Plattform: Kennung "ERICERG1", int32
+      * Rueckgabewert, dann Listen als uint32 Anzahl gefolgt von den
+      * Eintraegen. Texte sind als uint32 Laenge und UTF-8-Bytes abgelegt.
+      * Reihenfolge: Telenummern, Ordnungsbegriffe, Transferticket,
+      * Returncode und Fehlertext des Transferheaders, Meldungen (je ein
+      * Byte Meldungsart und die zehn Felder in Deklarationsreihenfolge),
+      * Serverfehler (Code, Meldung).
+      */
+    std::string alsBinaerformat() const;
+
+private:
+    EricErgebnis(const EricErgebnis &); // Kopien verboten
+    EricErgebnis &operator=(const EricErgebnis &); // Zuweisungen verboten
+
+    const Eric                   &eric;
+
+    int                           ergebnisRc;
+    std::vector<Meldung>          meldungsListe;
+    std::vector<Textausschnitt>   telenummerListe;
+    std::vector<Textausschnitt>   ordnungsbegriffListe;
+
+    std::unique_ptr<EricPuffer>   transferticketPuffer;
+    std::unique_ptr<EricPuffer>   returncodeTHPuffer;
+    std::unique_ptr<EricPuffer>   fehlertextTHPuffer;
+    std::unique_ptr<EricPuffer>   nutzdatenheaderPuffer;
+    Textausschnitt                ticket;
+    Textausschnitt                returncodeTransferheader;
+    Textausschnitt                fehlertextTransferheader;
+    std::vector<Serverfehler>     serverfehlerListe;
+};
+
+#endif
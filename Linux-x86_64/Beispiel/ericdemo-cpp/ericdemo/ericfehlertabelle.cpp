@@ -0,0 +1,362 @@
+#include "ericfehlertabelle.h"
+
+#include <algorithm>
+#include <eric_fehlercodes.h>
+
+#include "eric.h"
+#include "ericpuffer.h"
+
+
+namespace
+{
+
+#define FEHLERCODE(code, kategorie, wiederholbar) { code, #code, EricFehlertabelle::kategorie, wiederholbar }
+
+// Aus eric_fehlercodes.h, aufsteigend nach Code
+constexpr EricFehlertabelle::Eintrag EINTRAEGE[] =
+{
+    FEHLERCODE(ERIC_OK,                                                    ERFOLG,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNKNOWN,                                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_PRUEF_FEHLER,                                   GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_HINWEISE,                                       GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_FEHLERMELDUNG_NICHT_VORHANDEN,                  GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_KEINE_DATEN_VORHANDEN,                          GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NICHT_GENUEGEND_ARBEITSSPEICHER,                GLOBAL,  true),
+    FEHLERCODE(ERIC_GLOBAL_DATEI_NICHT_GEFUNDEN,                           GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_HERSTELLER_ID_NICHT_ERLAUBT,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ILLEGAL_STATE,                                  GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_FUNKTION_NICHT_ERLAUBT,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ECHTFALL_NICHT_ERLAUBT,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NO_VERSAND_IN_BETA_VERSION,                     GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_TESTMERKER_UNGUELTIG,                           GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_DATENSATZ_ZU_GROSS,                             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_VERSCHLUESSELUNGS_PARAMETER_NICHT_ERLAUBT,      GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NUR_PORTALZERTIFIKAT_ERLAUBT,                   GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ERROR_XML_CREATE,                               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_TEXTPUFFERGROESSE_FIX,                          GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_INTERNER_FEHLER,                                GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ARITHMETIKFEHLER,                               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_STEUERNUMMER_FALSCHE_LAENGE,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_STEUERNUMMER_NICHT_NUMERISCH,                   GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_LANDESNUMMER_UNBEKANNT,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_BUFANR_UNBEKANNT,                               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_LANDESNUMMER_BUFANR,                            GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_PUFFER_ZUGRIFFSKONFLIKT,                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_PUFFER_UEBERLAUF,                               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_DATENARTVERSION_UNBEKANNT,                      GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_DATENARTVERSION_XML_INKONSISTENT,               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_COMMONDATA_NICHT_VERFUEGBAR,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_LOG_EXCEPTION,                                  GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_TRANSPORTSCHLUESSEL_NICHT_ERLAUBT,              GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_OEFFENTLICHER_SCHLUESSEL_UNGUELTIG,             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_TRANSPORTSCHLUESSEL_TYP_FALSCH,                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_PUFFER_UNGLEICHER_INSTANZ,                      GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_VORSATZ_UNGUELTIG,                              GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_DATEIZUGRIFF_VERWEIGERT,                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNGUELTIGE_INSTANZ,                             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NICHT_INITIALISIERT,                            GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_MEHRFACHE_INITIALISIERUNG,                      GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_FEHLER_INITIALISIERUNG,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNKNOWN_PARAMETER_ERROR,                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_CHECK_CORRUPTED_NDS,                            GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_VERSCHLUESSELUNGS_PARAMETER_NICHT_ANGEGEBEN,    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_SEND_FLAG_MEHR_ALS_EINES,                       GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNGUELTIGE_FLAG_KOMBINATION,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNGUELTIGER_PARAMETER,                          GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_DRUCK_FUER_VERFAHREN_NICHT_ERLAUBT,             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_VERSAND_ART_NICHT_UNTERSTUETZT,                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UNGUELTIGE_PARAMETER_VERSION,                   GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_TRANSFERHANDLE,                                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_PLUGININITIALISIERUNG,                          GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_INKOMPATIBLE_VERSIONEN,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_VERSCHLUESSELUNGSVERFAHREN_NICHT_UNTERSTUETZT,  GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_MEHRFACHAUFRUFE_NICHT_UNTERSTUETZT,             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UTI_COUNTRY_NOT_SUPPORTED,                      GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_IBAN_FORMALER_FEHLER,                           GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_IBAN_LAENDERCODE_FEHLER,                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_IBAN_LANDESFORMAT_FEHLER,                       GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_IBAN_PRUEFZIFFER_FEHLER,                        GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_BIC_FORMALER_FEHLER,                            GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_BIC_LAENDERCODE_FEHLER,                         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ZULASSUNGSNUMMER_ZU_LANG,                       GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_IDNUMMER_UNGUELTIG,                             GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NULL_PARAMETER,                                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_EWAZ_UNGUELTIG,                                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_EWAZ_LANDESKUERZEL_UNBEKANNT,                   GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_UPDATE_NECESSARY,                               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_EINSTELLUNG_NAME_UNGUELTIG,                     GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_EINSTELLUNG_WERT_UNGUELTIG,                     GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ERR_DEKODIEREN,                                 GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_FUNKTION_NICHT_UNTERSTUETZT,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NUTZDATENTICKETS_NICHT_EINDEUTIG,               GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NUTZDATENHEADERVERSIONEN_UNEINHEITLICH,         GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_BUNDESLAENDER_UNEINHEITLICH,                    GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_ZEITRAEUME_UNEINHEITLICH,                       GLOBAL,  false),
+    FEHLERCODE(ERIC_GLOBAL_NUTZDATENHEADER_EMPFAENGER_NICHT_KORREKT,       GLOBAL,  false),
+    FEHLERCODE(ERIC_TRANSFER_COM_ERROR,                                    TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_VORGANG_NICHT_UNTERSTUETZT,                   TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_XML_THEADER,                              TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_PARAM,                                    TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_DATENTEILENDNOTFOUND,                     TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_BEGINDATENLIEFERANT,                      TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_ENDDATENLIEFERANT,                        TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_BEGINTRANSPORTSCHLUESSEL,                 TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_ENDTRANSPORTSCHLUESSEL,                   TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_BEGINDATENGROESSE,                        TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_ENDDATENGROESSE,                          TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_SEND,                                     TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_NOTENCRYPTED,                             TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_PROXYCONNECT,                             TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_CONNECTSERVER,                            TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_NORESPONSE,                               TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_PROXYAUTH,                                TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_SEND_INIT,                                TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_TIMEOUT,                                  TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_ERR_PROXYPORT_INVALID,                        TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_OTHER,                                    TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_XML_NHEADER,                              TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_XML_ENCODING,                             TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_ENDSIGUSER,                               TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_XMLTAG_NICHT_GEFUNDEN,                    TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_ERR_DATENTEILFEHLER,                          TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_ZERTIFIKATFEHLER,                         TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_KEINKONTO,                                TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_IDNRNICHTEINDEUTIG,                       TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_SERVERFEHLER,                             TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_EID_KEINCLIENT,                               TRANSFER, true),
+    FEHLERCODE(ERIC_TRANSFER_EID_CLIENTFEHLER,                             TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_FEHLENDEFELDER,                           TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_IDENTIFIKATIONABGEBROCHEN,                TRANSFER, false),
+    FEHLERCODE(ERIC_TRANSFER_EID_NPABLOCKIERT,                             TRANSFER, true),
+    FEHLERCODE(ERIC_CRYPT_ERROR_CREATE_KEY,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_INVALID_HANDLE,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_MAX_SESSION,                                   CRYPT,   true),
+    FEHLERCODE(ERIC_CRYPT_E_BUSY,                                          CRYPT,   true),
+    FEHLERCODE(ERIC_CRYPT_E_OUT_OF_MEM,                                    CRYPT,   true),
+    FEHLERCODE(ERIC_CRYPT_E_PSE_PATH,                                      CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_PIN_WRONG,                                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_PIN_LOCKED,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P7_READ,                                       CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P7_DECODE,                                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P7_RECIPIENT,                                  CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_READ,                                      CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_DECODE,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_SIG_KEY,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_ENC_KEY,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_SIG_KEY,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_ENC_KEY,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_XML_PARSE,                                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_XML_SIG_ADD,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_XML_SIG_TAG,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_XML_SIG_SIGN,                                  CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ENCODE_UNKNOWN,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ENCODE_ERROR,                                  CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_XML_INIT,                                      CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ENCRYPT,                                       CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_DECRYPT,                                       CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_SLOT_EMPTY,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_NO_SIG_ENC_KEY,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_LOAD_DLL,                                      CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_NO_SERVICE,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ESICL_EXCEPTION,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ESIGNER_NICHT_GELADEN,                         CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_INKOMPATIBLE_ESIGNER_VERSION,                  CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_VERALTETE_ESIGNER_VERSION,                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_TOKEN_TYPE_MISMATCH,                           CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_CREATE,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_VERIFY_CERT_CHAIN,                             CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_ENGINE_LOADED,                             CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_USER_CANCEL,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_ZERTIFIKAT,                                      CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_SIGNATUR,                                        CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_NICHT_UNTERSTUETZTES_PSE_FORMAT,                 CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_PIN_BENOETIGT,                                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_PIN_STAERKE_NICHT_AUSREICHEND,                   CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_INTERN,                                        CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_ZERTIFIKATSPFAD_KEIN_VERZEICHNIS,                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_ZERTIFIKATSDATEI_EXISTIERT_BEREITS,              CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_PIN_ENTHAELT_UNGUELTIGE_ZEICHEN,                 CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_CORRUPTED,                                       CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_EIDKARTE_NICHT_UNTERSTUETZT,                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_SLOT_EMPTY,                                 CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_NO_APPLET,                                  CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_SESSION,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_NO_SIG_CERT,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_INIT_FAILED,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P11_NO_ENC_CERT,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_NO_SIG_CERT,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_P12_NO_ENC_CERT,                               CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_ENC_KEY,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_NO_SIG_CERT,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_NO_ENC_CERT,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_INIT_FAILED,                                CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_SC_SIG_KEY,                                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_DATA_NOT_INITIALIZED,                          CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ASN1_READ_BUFFER_TOO_SMALL,                    CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ASN1_READ_DATA_INCOMPLETE,                     CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ASN1_NO_ENVELOPED_DATA,                        CRYPT,   false),
+    FEHLERCODE(ERIC_CRYPT_E_ASN1_NO_CONTENT_DATA,                          CRYPT,   false),
+    FEHLERCODE(ERIC_IO_FEHLER,                                             IO,      false),
+    FEHLERCODE(ERIC_IO_DATEI_INKORREKT,                                    IO,      false),
+    FEHLERCODE(ERIC_IO_PARSE_FEHLER,                                       IO,      false),
+    FEHLERCODE(ERIC_IO_NDS_GENERIERUNG_FEHLGESCHLAGEN,                     IO,      false),
+    FEHLERCODE(ERIC_IO_MASTERDATENSERVICE_NICHT_VERFUEGBAR,                IO,      false),
+    FEHLERCODE(ERIC_IO_STEUERZEICHEN_IM_NDS,                               IO,      false),
+    FEHLERCODE(ERIC_IO_VERSIONSINFORMATIONEN_NICHT_GEFUNDEN,               IO,      false),
+    FEHLERCODE(ERIC_IO_FALSCHES_VERFAHREN,                                 IO,      false),
+    FEHLERCODE(ERIC_IO_READER_MEHRFACHE_STEUERFAELLE,                      IO,      false),
+    FEHLERCODE(ERIC_IO_READER_UNERWARTETE_ELEMENTE,                        IO,      false),
+    FEHLERCODE(ERIC_IO_READER_FORMALE_FEHLER,                              IO,      false),
+    FEHLERCODE(ERIC_IO_READER_FALSCHES_ENCODING,                           IO,      false),
+    FEHLERCODE(ERIC_IO_READER_MEHRFACHE_NUTZDATEN_ELEMENTE,                IO,      false),
+    FEHLERCODE(ERIC_IO_READER_MEHRFACHE_NUTZDATENBLOCK_ELEMENTE,           IO,      false),
+    FEHLERCODE(ERIC_IO_UNBEKANNTE_DATENART,                                IO,      false),
+    FEHLERCODE(ERIC_IO_READER_UNTERSACHBEREICH_UNGUELTIG,                  IO,      false),
+    FEHLERCODE(ERIC_IO_READER_ZU_VIELE_NUTZDATENBLOCK_ELEMENTE,            IO,      false),
+    FEHLERCODE(ERIC_IO_READER_STEUERZEICHEN_IM_TRANSFERHEADER,             IO,      false),
+    FEHLERCODE(ERIC_IO_READER_STEUERZEICHEN_IM_NUTZDATENHEADER,            IO,      false),
+    FEHLERCODE(ERIC_IO_READER_STEUERZEICHEN_IN_DEN_NUTZDATEN,              IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABE_FEHLER,                                 IO,      false),
+    FEHLERCODE(ERIC_IO_READER_KEINE_RABEID,                                IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABEID_UNGUELTIG,                            IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABE_VERIFIKATIONSID_UNGUELTIG,              IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABE_REFERENZID_UNGUELTIG,                   IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABE_REFERENZID_NICHT_ERLAUBT,               IO,      false),
+    FEHLERCODE(ERIC_IO_READER_RABE_REFERENZIDS_NICHT_EINDEUTIG,            IO,      false),
+    FEHLERCODE(ERIC_IO_READER_ZU_VIELE_ANHAENGE,                           IO,      false),
+    FEHLERCODE(ERIC_IO_READER_ANHANG_ZU_GROSS,                             IO,      false),
+    FEHLERCODE(ERIC_IO_READER_ANHAENGE_ZU_GROSS,                           IO,      false),
+    FEHLERCODE(ERIC_IO_READER_ANHANG_ZU_KLEIN,                             IO,      false),
+    FEHLERCODE(ERIC_IO_READER_SCHEMA_VALIDIERUNGSFEHLER,                   IO,      false),
+    FEHLERCODE(ERIC_IO_READER_UNBEKANNTE_XML_ENTITY,                       IO,      false),
+    FEHLERCODE(ERIC_IO_TESTHERSTELLERID_GESPERRT,                          IO,      false),
+    FEHLERCODE(ERIC_IO_DATENTEILNOTFOUND,                                  IO,      false),
+    FEHLERCODE(ERIC_IO_DATENTEILENDNOTFOUND,                               IO,      false),
+    FEHLERCODE(ERIC_IO_UEBERGABEPARAMETER_FEHLERHAFT,                      IO,      false),
+    FEHLERCODE(ERIC_IO_UNGUELTIGE_UTF8_SEQUENZ,                            IO,      false),
+    FEHLERCODE(ERIC_IO_UNGUELTIGE_ZEICHEN_IN_PARAMETER,                    IO,      false),
+    FEHLERCODE(ERIC_PRINT_INTERNER_FEHLER,                                 PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_DRUCKVORLAGE_NICHT_GEFUNDEN,                     PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_UNGUELTIGER_DATEI_PFAD,                          PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_INITIALISIERUNG_FEHLERHAFT,                      PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_AUSGABEZIEL_UNBEKANNT,                           PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_ABBRUCH_DRUCKVORBEREITUNG,                       PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_ABBRUCH_GENERIERUNG,                             PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_STEUERFALL_NICHT_UNTERSTUETZT,                   PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_FUSSTEXT_ZU_LANG,                                PRINT,   false),
+    FEHLERCODE(ERIC_PRINT_PDFCALLBACK,                                     PRINT,   false)
+};
+
+#undef FEHLERCODE
+
+constexpr size_t ANZAHL_EINTRAEGE = sizeof(EINTRAEGE) / sizeof(EINTRAEGE[0]);
+
+// Die binaere Suche in suche() setzt eine aufsteigend sortierte Tabelle voraus
+constexpr bool istAufsteigend(size_t i)
+{
+    return i + 1 >= ANZAHL_EINTRAEGE || (EINTRAEGE[i].code < EINTRAEGE[i + 1].code && istAufsteigend(i + 1));
+}
+static_assert(istAufsteigend(0), "Die Tabelle der Fehlercodes muss aufsteigend sortiert sein");
+
+const std::string KEIN_FEHLERTEXT("<Kein Fehlertext verfügbar>");
+
+bool kleinererCode(const EricFehlertabelle::Eintrag &eintrag, int code)
+{
+    return eintrag.code < code;
+}
+
+} // anonymous namespace
+
+
+EricFehlertabelle::EricFehlertabelle(const Eric &eric_)
+    : eric(eric_),
+      texte(new std::atomic<const std::string *>[ANZAHL_EINTRAEGE])
+{
+    for (size_t i = 0; i < ANZAHL_EINTRAEGE; ++i)
+    {
+        texte[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+EricFehlertabelle::~EricFehlertabelle()
+{
+    for (size_t i = 0; i < ANZAHL_EINTRAEGE; ++i)
+    {
+        delete texte[i].load(std::memory_order_relaxed);
+    }
+}
+
+const EricFehlertabelle::Eintrag *EricFehlertabelle::suche(int code)
+{
+    const Eintrag *ende = EINTRAEGE + ANZAHL_EINTRAEGE;
+    const Eintrag *eintrag = std::lower_bound(EINTRAEGE, ende, code, kleinererCode);
+    return eintrag != ende && eintrag->code == code ? eintrag : nullptr;
+}
+
+const char *EricFehlertabelle::kategorieName(Kategorie kategorie)
+{
+    switch (kategorie)
+    {
+    case ERFOLG:   return "ERFOLG";
+    case GLOBAL:   return "GLOBAL";
+    case TRANSFER: return "TRANSFER";
+    case CRYPT:    return "CRYPT";
+    case IO:       return "IO";
+    case PRINT:    return "PRINT";
+    default:       return "UNBEKANNT";
+    }
+}
+
+const std::string &EricFehlertabelle::fehlertext(int code)
+{
+    const Eintrag *eintrag = suche(code);
+    if (nullptr == eintrag)
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        std::map<int, std::string>::const_iterator gefunden = unbekannteTexte.find(code);
+        if (gefunden == unbekannteTexte.end())
+        {
+            std::string text;
+            if (!holeFehlertext(code, text))
+            {
+                return KEIN_FEHLERTEXT;
+            }
+            gefunden = unbekannteTexte.insert(std::make_pair(code, text)).first;
+        }
+        return gefunden->second;
+    }
+
+    std::atomic<const std::string *> &platz = texte[eintrag - EINTRAEGE];
+    const std::string *text = platz.load(std::memory_order_acquire);
+    if (text != nullptr)
+    {
+        return *text;
+    }
+
+    std::unique_ptr<std::string> neuerText(new std::string());
+    if (!holeFehlertext(code, *neuerText))
+    {
+        // Nicht ablegen, ein spaeterer Aufruf kann erfolgreich sein
+        return KEIN_FEHLERTEXT;
+    }
+
+    // Haben zwei Threads den Text gleichzeitig geholt, gilt der zuerst abgelegte
+    const std::string *erwartet = nullptr;
+    if (platz.compare_exchange_strong(erwartet, neuerText.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        return *neuerText.release();
+    }
+    return *erwartet;
+}
+
+bool EricFehlertabelle::holeFehlertext(int code, std::string &text) const
+{
+    EricPuffer textPuffer(eric);
+    if (ERIC_OK != eric.EricHoleFehlerText(code, textPuffer.handle()))
+    {
+        return false;
+    }
+    text.assign(textPuffer.inhalt(), textPuffer.laenge());
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef _ERICFEHLERTABELLE_H_
+#define _ERICFEHLERTABELLE_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Vorwaertsdeklarationen
+class Eric;
+
+
+/** @brief Tabelle der ERiC-Fehlercodes mit Zwischenspeicher fuer die Klartexte
+ *
+ * Die Tabelle wird zur Uebersetzungszeit aus den Aufzaehlungswerten in
+ * eric_fehlercodes.h gebildet und ordnet jedem Fehlercode seinen
+ * symbolischen Namen, seine Kategorie und die Angabe zu, ob eine
+ * Wiederholung des Aufrufs sinnvoll sein kann.
+ *
+ * Die Klartexte liefert EricHoleFehlerText() erst beim ersten Bedarf. Jeder
+ * Text wird je Instanz nur einmal geholt und danach ohne Sperre gelesen.
+ * Nur Codes, die in eric_fehlercodes.h fehlen, werden unter einer Sperre
+ * abgelegt.
+ */
+class EricFehlertabelle
+{
+public:
+    /** @brief Kategorie eines Fehlercodes nach dem Praefix seines Namens */
+    enum Kategorie
+    {
+        ERFOLG,
+        GLOBAL,
+        TRANSFER,
+        CRYPT,
+        IO,
+        PRINT,
+        UNBEKANNT
+    };
+
+    /** @brief Tabelleneintrag zu einem Fehlercode */
+    struct Eintrag
+    {
+        int         code;
+        const char *name;           // Symbolischer Name aus eric_fehlercodes.h
+        Kategorie   kategorie;
+        bool        wiederholbar;   // Voruebergehender Fehler, z. B. Zeitueberschreitung oder Speichermangel
+    };
+
+    /** @brief Erzeugt eine Instanz der Klasse 'EricFehlertabelle'
+      *
+      * @param eric
+      *        Schnittstellenobjekt, das den ERiC kapselt.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricFehlertabelle, da diese eine Referenz darauf haelt!
+      */
+    explicit EricFehlertabelle(const Eric &eric);
+
+    virtual ~EricFehlertabelle();
+
+    /** @brief Sucht den Tabelleneintrag zu einem Fehlercode
+      *
+      * @return Eintrag oder nullptr, wenn der Code nicht in eric_fehlercodes.h steht
+      */
+    static const Eintrag *suche(int code);
+
+    /** @brief Liefert den Namen einer Kategorie */
+    static const char *kategorieName(Kategorie kategorie);
+
+    /** @brief Liefert den Klartext des ERiC zu einem Fehlercode
+      *
+      * Der Text wird beim ersten Bedarf mit EricHoleFehlerText() geholt.
+      * Die Referenz bleibt so lange gueltig wie diese Instanz.
+      */
+    const std::string &fehlertext(int code);
+
+private:
+    EricFehlertabelle(const EricFehlertabelle &); // Kopien verboten
+    EricFehlertabelle &operator=(const EricFehlertabelle &); // Zuweisungen verboten
+
+    bool holeFehlertext(int code, std::string &text) const;
+
+    const Eric                                          &eric;
+    std::unique_ptr<std::atomic<const std::string *>[]>  texte;            // Je Tabelleneintrag, nullptr bis zum ersten Bedarf
+    std::mutex                                           sperre;
+    std::map<int, std::string>                           unbekannteTexte;  // Codes ausserhalb der Tabelle
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "ericfeldpruefung.h"
+
+#include <eric_fehlercodes.h>
+
+#include "erictoolkitadapter.h"
+#include "xmltagleser.h"
+
+
+EricFeldpruefung::EricFeldpruefung(const EricToolkit &toolkit_) : toolkit(toolkit_), statistik()
+{
+    zuordnung["Steuernummer"] = STEUERNUMMER;
+    zuordnung["StNr"]         = STEUERNUMMER;
+    zuordnung["IdNr"]         = IDENTIFIKATIONSMERKMAL;
+    zuordnung["IBAN"]         = IBAN;
+    zuordnung["BIC"]          = BIC;
+}
+
+EricFeldpruefung::~EricFeldpruefung()
+{ }
+
+void EricFeldpruefung::ordneZu(const std::string &element, Pruefart pruefart)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    zuordnung[element] = pruefart;
+}
+
+int EricFeldpruefung::pruefe(const std::string &xml, Befund &befund)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.datensaetze;
+
+    XmlTagLeser leser(xml);
+    while (leser.weiter())
+    {
+        if (leser.istEndeTag() || leser.istLeeresElement())
+        {
+            continue;
+        }
+
+        const std::string element = leser.name();
+        Pruefart pruefart = STEUERNUMMER;
+        const std::map<std::string, Pruefart>::const_iterator eintrag = zuordnung.find(element);
+        if (eintrag != zuordnung.end())
+        {
+            pruefart = eintrag->second;
+        }
+        else if ("Empfaenger" == element)
+        {
+            std::string id;
+            if (!leser.attribut("id", id) || "F" != id)
+                continue;
+            pruefart = BUFANUMMER;
+        }
+        else
+        {
+            continue;
+        }
+
+        // Nur Elemente mit reinem Textinhalt pruefen
+        std::string wert;
+        if (!leser.textinhalt(wert))
+        {
+            continue;
+        }
+
+        ++statistik.felder;
+        const int rc = pruefeFeld(pruefart, wert);
+        if (rc != ERIC_OK)
+        {
+            ++statistik.abgewiesen;
+            befund.element = element;
+            befund.wert = wert;
+            befund.position = leser.position();
+            return rc;
+        }
+    }
+
+    return ERIC_OK;
+}
+
+EricFeldpruefung::Kennzahlen EricFeldpruefung::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    return statistik;
+}
+
+int EricFeldpruefung::pruefeFeld(Pruefart pruefart, const std::string &wert) const
+{
+    switch (pruefart)
+    {
+    case STEUERNUMMER:
+        return toolkit.EtkPruefeSteuernummer(wert.c_str());
+    case BUFANUMMER:
+        return toolkit.EtkPruefeBuFaNummer(wert.c_str());
+    case IDENTIFIKATIONSMERKMAL:
+        return toolkit.EtkPruefeIdentifikationsMerkmal(wert.c_str());
+    case IBAN:
+        return toolkit.EtkPruefeIBAN(wert.c_str());
+    case BIC:
+        return toolkit.EtkPruefeBIC(wert.c_str());
+    }
+    return ERIC_OK;
+}
@@ -0,0 +1,95 @@
+#ifndef _ERICFELDPRUEFUNG_H_
+#define _ERICFELDPRUEFUNG_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Vorwaertsdeklarationen
+class EricToolkit;
+
+
+/** @brief Schnelle Vorabpruefung einzelner Kennungen eines Datensatzes mit dem ERiC-Toolkit
+ *
+ * Steuernummer, Bundesfinanzamtsnummer, Identifikationsnummer, IBAN und BIC
+ * werden in einem einzigen Durchlauf ueber den XML-Text ohne Aufbau eines
+ * Dokumentbaums gefunden und mit den Funktionen des ERiC-Toolkits geprueft.
+ * Ein Datensatz mit einer ungueltigen Kennung kann so abgewiesen werden,
+ * bevor der ERiC geladen oder eine ERiC-Instanz belegt wird. Die
+ * Fehlercodes sind dieselben, die die entsprechenden ERiC-Pruefungen liefern,
+ * z. B. ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG oder ERIC_GLOBAL_IBAN_PRUEFZIFFER_FEHLER.
+ *
+ * Geprueft werden Elemente anhand ihres lokalen Namens, standardmaessig
+ * Steuernummer, StNr, IdNr, IBAN und BIC sowie die Bundesfinanzamtsnummer
+ * in einem Element Empfaenger mit dem Attribut id="F". Weitere Elemente,
+ * etwa die Kennzahlen einer Datenart, koennen mit ordneZu() ergaenzt werden.
+ */
+class EricFeldpruefung
+{
+public:
+    /** @brief Art der Pruefung eines Elements */
+    enum Pruefart
+    {
+        STEUERNUMMER,
+        BUFANUMMER,
+        IDENTIFIKATIONSMERKMAL,
+        IBAN,
+        BIC
+    };
+
+    /** @brief Erstes ungueltiges Feld eines Datensatzes */
+    struct Befund
+    {
+        std::string element;   // Lokaler Name des Elements
+        std::string wert;      // Inhalt des Elements
+        size_t      position;  // Byteposition des Elements im Datensatz
+    };
+
+    /** @brief Kennzahlen zur Feldpruefung */
+    struct Kennzahlen
+    {
+        uint64_t datensaetze;   // Gepruefte Datensaetze
+        uint64_t abgewiesen;    // Davon abgewiesene Datensaetze
+        uint64_t felder;        // Insgesamt gepruefte Felder
+    };
+
+    /** @brief Erzeugt eine Instanz der Klasse 'EricFeldpruefung' mit den Standardzuordnungen
+      *
+      * @param toolkit
+      *        Schnittstellenobjekt, das das ERiC-Toolkit kapselt.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricFeldpruefung, da diese eine Referenz darauf haelt!
+      */
+    explicit EricFeldpruefung(const EricToolkit &toolkit);
+
+    virtual ~EricFeldpruefung();
+
+    /** @brief Prueft den Inhalt aller Elemente mit dem lokalen Namen 'element' auf die angegebene Art */
+    void ordneZu(const std::string &element, Pruefart pruefart);
+
+    /** @brief Prueft alle zugeordneten Felder eines Datensatzes
+      *
+      * @param xml    Datensatz
+      * @param befund Erhaelt bei einem Fehler das erste ungueltige Feld
+      *
+      * @return ERIC_OK oder der Fehlercode der Toolkit-Pruefung des ersten ungueltigen Feldes
+      */
+    int pruefe(const std::string &xml, Befund &befund);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricFeldpruefung(const EricFeldpruefung &); // Kopien verboten
+    EricFeldpruefung &operator=(const EricFeldpruefung &); // Zuweisungen verboten
+
+    int pruefeFeld(Pruefart pruefart, const std::string &wert) const;
+
+    const EricToolkit                   &toolkit;
+    std::map<std::string, Pruefart>      zuordnung;
+    mutable std::mutex                   sperre;
+    Kennzahlen                           statistik;
+};
+
+#endif
@@ -0,0 +1,245 @@
+#include "ericfinanzamtsverzeichnis.h"
+
+#include <chrono>
+#include <cstdio>
+#include <eric_fehlercodes.h>
+
+#include "eric.h"
+#include "ericpuffer.h"
+
+
+namespace
+{
+
+// Bundesfinanzamtsnummern sind vierstellig
+const unsigned ANZAHL_BUFANUMMERN = 10000;
+
+/** @brief Lage eines Textes im Textblock des Verzeichnisses, solange dieser noch waechst */
+struct Abschnitt
+{
+    size_t anfang;
+    size_t laenge;
+};
+
+struct LandEintrag
+{
+    Abschnitt nummer;
+    Abschnitt name;
+    uint32_t  ersterFinanzamt;
+    uint32_t  anzahlFinanzaemter;
+};
+
+struct AnschriftEintrag
+{
+    Abschnitt strasse;
+    Abschnitt postfach;
+    Abschnitt plz;
+    Abschnitt ort;
+};
+
+struct BankEintrag
+{
+    Abschnitt bank;
+    Abschnitt iban;
+    Abschnitt bic;
+};
+
+struct FinanzamtEintrag
+{
+    uint16_t         bufaNummer;
+    uint16_t         land;
+    Abschnitt        name;
+    AnschriftEintrag hausanschrift;
+    AnschriftEintrag postanschrift;
+    Abschnitt        telefon;
+    Abschnitt        fax;
+    Abschnitt        mail;
+    uint32_t         ersteBankverbindung;
+    uint32_t         anzahlBankverbindungen;
+};
+
+Abschnitt haengeAn(std::string &text, const std::string &wert)
+{
+    const Abschnitt abschnitt = { text.size(), wert.size() };
+    text += wert;
+    return abschnitt;
+}
+
+Textausschnitt ausschnitt(const std::string &text, const Abschnitt &abschnitt)
+{
+    return Textausschnitt(text.data() + abschnitt.anfang, abschnitt.laenge);
+}
+
+EricFinanzamtsverzeichnis::Anschrift anschrift(const std::string &text, const AnschriftEintrag &eintrag)
+{
+    EricFinanzamtsverzeichnis::Anschrift anschrift;
+    anschrift.strasse = ausschnitt(text, eintrag.strasse);
+    anschrift.postfach = ausschnitt(text, eintrag.postfach);
+    anschrift.plz = ausschnitt(text, eintrag.plz);
+    anschrift.ort = ausschnitt(text, eintrag.ort);
+    return anschrift;
+}
+
+/** @brief Liest Anschriften, Kontaktdaten und Bankverbindungen aus dem Ergebnis-XML von EricHoleFinanzamtsdaten()
+ *
+ * Die Texte werden an den Textblock, die Bankverbindungen an 'banken'
+ * angehaengt. Der Name des Finanzamts wird nur uebernommen, wenn der
+ * Eintrag noch keinen hat. Jede Angabe wird nur unter dem einen Elementnamen
+ * gelesen, den EricHoleFinanzamtsdaten.xsd dafuer vorsieht.
+ */
+void leseFinanzamtsdaten(const EricPuffer &puffer, std::string &text, FinanzamtEintrag &finanzamt,
+                         std::vector<BankEintrag> &banken)
+{
+    enum Bereich { SONSTIGES, HAUSANSCHRIFT, POSTANSCHRIFT, BANKVERBINDUNG };
+
+    finanzamt.ersteBankverbindung = static_cast<uint32_t>(banken.size());
+    finanzamt.anzahlBankverbindungen = 0;
+
+    XmlTagLeser leser(puffer.inhalt(), puffer.laenge());
+    Textausschnitt wert;
+    Bereich bereich = SONSTIGES;
+    while (leser.weiter())
+    {
+        const bool hausanschrift = leser.hatName("Hausanschrift");
+        const bool postanschrift = leser.hatName("Postanschrift");
+        const bool bankverbindung = leser.hatName("Bankverbindung");
+        if (hausanschrift || postanschrift || bankverbindung)
+        {
+            bereich = (leser.istEndeTag() || leser.istLeeresElement()) ? SONSTIGES
+                    : hausanschrift ? HAUSANSCHRIFT : postanschrift ? POSTANSCHRIFT : BANKVERBINDUNG;
+            if (bereich == BANKVERBINDUNG)
+            {
+                banken.push_back(BankEintrag());
+                ++finanzamt.anzahlBankverbindungen;
+            }
+            continue;
+        }
+        if (leser.istEndeTag() || !leser.textinhalt(wert))
+            continue;
+
+        Abschnitt *ziel = nullptr;
+        if (bereich == BANKVERBINDUNG)
+        {
+            BankEintrag &bank = banken.back();
+            if (leser.hatName("IBAN"))
+                ziel = &bank.iban;
+            else if (leser.hatName("BIC"))
+                ziel = &bank.bic;
+            else if (leser.hatName("Bankbezeichnung"))
+                ziel = &bank.bank;
+        }
+        else if (bereich != SONSTIGES)
+        {
+            AnschriftEintrag &eintrag = bereich == HAUSANSCHRIFT ? finanzamt.hausanschrift : finanzamt.postanschrift;
+            if (leser.hatName("Strasse"))
+                ziel = &eintrag.strasse;
+            else if (leser.hatName("Postfach"))
+                ziel = &eintrag.postfach;
+            else if (leser.hatName("PLZ"))
+                ziel = &eintrag.plz;
+            else if (leser.hatName("Ort"))
+                ziel = &eintrag.ort;
+        }
+        else if (leser.hatName("Name") && finanzamt.name.laenge == 0)
+            ziel = &finanzamt.name;
+        else if (leser.hatName("Telefon"))
+            ziel = &finanzamt.telefon;
+        else if (leser.hatName("Fax"))
+            ziel = &finanzamt.fax;
+        else if (leser.hatName("Mail"))
+            ziel = &finanzamt.mail;
+
+        if (ziel != nullptr)
+            *ziel = haengeAn(text, XmlTagLeser::dekodiere(wert));
+    }
+}
+
+} // anonymous namespace
+
+
+struct EricFinanzamtsverzeichnis::Rohdaten
+{
+    std::vector<LandEintrag>      laender;
+    std::vector<FinanzamtEintrag> finanzaemter;
+    std::vector<BankEintrag>      banken;
+};
+
+
+int EricFinanzamtsverzeichnis::frageEinzeln(const Eric &eric, unsigned bufaNummer, std::shared_ptr<const Stand> &einzeln)
+{
+    if (bufaNummer >= ANZAHL_BUFANUMMERN)
+    {
+        return ERIC_GLOBAL_PRUEF_FEHLER;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    char bufaNr[5];
+    std::snprintf(bufaNr, sizeof(bufaNr), "%04u", bufaNummer);
+    EricPuffer datenPuffer(eric);
+    const int rc = eric.EricHoleFinanzamtsdaten(bufaNr, datenPuffer.handle());
+    if (rc != ERIC_OK)
+    {
+        return rc;
+    }
+
+    std::shared_ptr<Stand> neu(new Stand());
+    Rohdaten roh;
+    LandEintrag land = LandEintrag();
+    land.nummer = haengeAn(neu->text, std::string(bufaNr, 2));
+    land.anzahlFinanzaemter = 1;
+    roh.laender.push_back(land);
+
+    FinanzamtEintrag finanzamt = FinanzamtEintrag();
+    finanzamt.bufaNummer = static_cast<uint16_t>(bufaNummer);
+    leseFinanzamtsdaten(datenPuffer, neu->text, finanzamt, roh.banken);
+    roh.finanzaemter.push_back(finanzamt);
+
+    uebernehme(*neu, roh);
+    neu->aufbauMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    einzeln = neu;
+    return ERIC_OK;
+}
+
+void EricFinanzamtsverzeichnis::uebernehme(Stand &neu, const Rohdaten &roh)
+{
+    // Erst jetzt waechst der Textblock nicht mehr, die Ausschnitte bleiben gueltig
+    neu.text.shrink_to_fit();
+    neu.landListe.reserve(roh.laender.size());
+    for (size_t l = 0; l < roh.laender.size(); ++l)
+    {
+        Land land;
+        land.nummer = ausschnitt(neu.text, roh.laender[l].nummer);
+        land.name = ausschnitt(neu.text, roh.laender[l].name);
+        land.ersterFinanzamt = roh.laender[l].ersterFinanzamt;
+        land.anzahlFinanzaemter = roh.laender[l].anzahlFinanzaemter;
+        neu.landListe.push_back(land);
+    }
+
+    neu.bankListe.reserve(roh.banken.size());
+    for (size_t b = 0; b < roh.banken.size(); ++b)
+    {
+        Bankverbindung bank;
+        bank.bank = ausschnitt(neu.text, roh.banken[b].bank);
+        bank.iban = ausschnitt(neu.text, roh.banken[b].iban);
+        bank.bic = ausschnitt(neu.text, roh.banken[b].bic);
+        neu.bankListe.push_back(bank);
+    }
+
+    neu.finanzamtListe.reserve(roh.finanzaemter.size());
+    for (size_t f = 0; f < roh.finanzaemter.size(); ++f)
+    {
+        const FinanzamtEintrag &eintrag = roh.finanzaemter[f];
+        Finanzamt finanzamt;
+        finanzamt.bufaNummer = eintrag.bufaNummer;
+        finanzamt.land = eintrag.land;
+        finanzamt.name = ausschnitt(neu.text, eintrag.name);
+        finanzamt.hausanschrift = anschrift(neu.text, eintrag.hausanschrift);
+        finanzamt.postanschrift = anschrift(neu.text, eintrag.postanschrift);
+        finanzamt.telefon = ausschnitt(neu.text, eintrag.telefon);
+        finanzamt.fax = ausschnitt(neu.text, eintrag.fax);
+        finanzamt.mail = ausschnitt(neu.text, eintrag.mail);
+        finanzamt.ersteBankverbindung = eintrag.ersteBankverbindung;
+        finanzamt.anzahlBankverbindungen = eintrag.anzahlBankverbindungen;
+        neu.finanzamtListe.push_back(finanzamt);
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef _ERICFINANZAMTSVERZEICHNIS_H_
+#define _ERICFINANZAMTSVERZEICHNIS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "xmltagleser.h"
+
+// Vorwaertsdeklarationen
+class Eric;
+
+
+/** @brief Finanzamtsdaten aus EricHoleFinanzamtsdaten(), einmal geparst
+ *
+ * frageEinzeln() liest Anschriften, Kontaktdaten und Bankverbindungen
+ * eines Finanzamts aus dem Ergebnis-XML. Alle Texte liegen in einem
+ * einzigen Textblock des Stands, auf den die Textausschnitte zeigen.
+ *
+ * Ein beim Start aufgebautes Verzeichnis aller Finanzaemter gibt es nicht:
+ * ericdemo beantwortet je Programmlauf hoechstens eine Abfrage, waehrend der
+ * Aufbau einen Aufruf von EricHoleFinanzamtsdaten() je Finanzamt kostet.
+ */
+class EricFinanzamtsverzeichnis
+{
+public:
+    /** @brief Bundesland mit den Indizes seiner Finanzaemter in Stand::finanzaemter() */
+    struct Land
+    {
+        Textausschnitt nummer;              // Finanzamtlandnummer, z. B. "28"
+        Textausschnitt name;
+        uint32_t       ersterFinanzamt;
+        uint32_t       anzahlFinanzaemter;
+    };
+
+    /** @brief Haus- oder Postanschrift; nicht gelieferte Angaben bleiben leer */
+    struct Anschrift
+    {
+        Textausschnitt strasse;
+        Textausschnitt postfach;
+        Textausschnitt plz;
+        Textausschnitt ort;
+    };
+
+    struct Bankverbindung
+    {
+        Textausschnitt bank;
+        Textausschnitt iban;
+        Textausschnitt bic;
+    };
+
+    /** @brief Finanzamt; die Angaben aus EricHoleFinanzamtsdaten() sind bei Testfinanzaemtern leer */
+    struct Finanzamt
+    {
+        uint16_t       bufaNummer;
+        uint16_t       land;                    // Index in Stand::laender()
+        Textausschnitt name;
+        Anschrift      hausanschrift;
+        Anschrift      postanschrift;
+        Textausschnitt telefon;
+        Textausschnitt fax;
+        Textausschnitt mail;
+        uint32_t       ersteBankverbindung;     // Index in Stand::bankverbindungen()
+        uint32_t       anzahlBankverbindungen;
+    };
+
+    /** @brief Unveraenderliches Ergebnis einer Abfrage
+      *
+      * Die Textausschnitte zeigen in den Textblock des Stands, deshalb darf er nicht kopiert werden.
+      */
+    class Stand
+    {
+    public:
+        const std::vector<Land>           &laender()          const { return landListe; }
+        const std::vector<Finanzamt>      &finanzaemter()     const { return finanzamtListe; }
+        const std::vector<Bankverbindung> &bankverbindungen() const { return bankListe; }
+
+        /** @brief Dauer der Abfrage in Millisekunden */
+        double aufbauDauerMs() const { return aufbauMs; }
+
+    private:
+        friend class EricFinanzamtsverzeichnis;
+
+        Stand() : aufbauMs(0.0) { }
+        Stand(const Stand &); // Kopien verboten
+        Stand &operator=(const Stand &); // Zuweisungen verboten
+
+        std::string                 text;           // Alle Namen und Finanzamtsdaten hintereinander
+        std::vector<Land>           landListe;
+        std::vector<Finanzamt>      finanzamtListe;
+        std::vector<Bankverbindung> bankListe;
+        double                      aufbauMs;
+    };
+
+    /** @brief Fragt ein einzelnes Finanzamt mit einem Aufruf von EricHoleFinanzamtsdaten() ab
+      *
+      * @param einzeln Erhaelt bei ERIC_OK einen Stand mit genau diesem Finanzamt. Sein Land traegt nur die
+      *        Finanzamtlandnummer aus den ersten beiden Ziffern der Bundesfinanzamtsnummer, der Name
+      *        stammt aus den Finanzamtsdaten.
+      *
+      * @return
+      *         - ERIC_OK
+      *         - ERIC_GLOBAL_KEINE_DATEN_VORHANDEN bei Testfinanzaemtern
+      *         - ERIC_GLOBAL_PRUEF_FEHLER, wenn die Nummer nicht vierstellig ist
+      *         - weitere Fehlercodes von EricHoleFinanzamtsdaten()
+      */
+    static int frageEinzeln(const Eric &eric, unsigned bufaNummer, std::shared_ptr<const Stand> &einzeln);
+
+private:
+    EricFinanzamtsverzeichnis(); // Nur statische Funktionen
+
+    struct Rohdaten; // Eintraege waehrend des Aufbaus, siehe ericfinanzamtsverzeichnis.cpp
+
+    /** @brief Legt die Eintraege im Stand ab, nachdem sein Textblock fertig ist */
+    static void uebernehme(Stand &neu, const Rohdaten &roh);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "erickosten.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "ericmetriken.h"
+#include "system.h"
+
+
+namespace
+{
+
+// Wird nur vom eigenen Thread veraendert und braucht daher keine Synchronisierung
+thread_local uint64_t allokiertBytes = 0;
+
+} // anonymous namespace
+
+
+// Die Array- und nothrow-Varianten rufen diese Operatoren auf
+void *operator new(std::size_t groesse)
+{
+    allokiertBytes += groesse;
+    for (;;)
+    {
+        void *const speicher = std::malloc(groesse > 0 ? groesse : 1);
+        if (speicher != nullptr)
+        {
+            return speicher;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void operator delete(void *speicher) noexcept
+{
+    std::free(speicher);
+}
+
+
+EricKosten::EricKosten(const char *anfrage_, const std::string &datenartVersion_, const std::string &mandant_)
+    : labels(EricMetriken::label("anfrage", anfrage_) + "," + EricMetriken::label("mandant", mandant_) + ","
+             + EricMetriken::label("datenartVersion", datenartVersion_)),
+      start(std::chrono::steady_clock::now()),
+      cpuStartUs(System::threadCpuZeitUs()),
+      allokiertStart(allokiertBytes),
+      pufferBytes(0)
+{ }
+
+EricKosten::~EricKosten()
+{
+    const uint64_t cpuUs = System::threadCpuZeitUs() - cpuStartUs;
+    const uint64_t allokiertAnfrage = allokiertBytes - allokiertStart;
+    try
+    {
+        EricMetriken &metriken = EricMetriken::instanz();
+        metriken.zaehle("eric_anfragen_total", labels);
+        metriken.messe("eric_anfrage_cpu_seconds", labels, cpuUs / 1000.0);
+        metriken.messe("eric_anfrage_dauer_seconds", labels,
+                       std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        metriken.zaehle("eric_anfrage_allokiert_bytes_total", labels, allokiertAnfrage);
+        metriken.zaehle("eric_anfrage_puffer_bytes_total", labels, pufferBytes);
+    }
+    catch (...)
+    {
+        // Eine verlorene Kostenerfassung darf die Anfrage nicht abbrechen
+    }
+}
+
+uint64_t EricKosten::allokiert()
+{
+    return allokiertBytes;
+}
@@ -0,0 +1,65 @@
+#ifndef _ERICKOSTEN_H_
+#define _ERICKOSTEN_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+/** @brief Erfasst die Kosten einer Anfrage und meldet sie an EricMetriken
+ *
+ * Eine Instanz begleitet eine Anfrage (Vorgang, Nachdruck oder Vorschau)
+ * vom Konstruktor bis zum Destruktor und haelt im ausfuehrenden Thread fest:
+ *
+ *  - die CPU-Zeit des Threads (clock_gettime(CLOCK_THREAD_CPUTIME_ID) bzw.
+ *    GetThreadTimes()) und die verstrichene Zeit
+ *  - die Bytes, die der Thread ueber den Operator new angefordert hat; dafuer
+ *    ersetzt erickosten.cpp die globalen Operatoren new und delete durch
+ *    Varianten, die je Thread mitzaehlen
+ *  - die Groessen der ERiC-Rueckgabepuffer, die erfassePuffer() meldet
+ *
+ * Arbeit in fremden Threads, etwa in Threads des ERiC, und Speicher, den der
+ * ERiC selbst anfordert, sind nicht enthalten; letzterer zeigt sich nur in
+ * den Puffergroessen.
+ *
+ * Im Destruktor werden die Kosten je Mandant und Datenartversion in
+ * eric_anfragen_total, eric_anfrage_cpu_seconds, eric_anfrage_dauer_seconds,
+ * eric_anfrage_allokiert_bytes_total und eric_anfrage_puffer_bytes_total
+ * eingetragen. Den Mandanten uebergibt der Aufrufer je Anfrage, etwa aus dem
+ * Auftrag eines Nachdrucks; so teilt ein Prozess, der Anfragen mehrerer
+ * Mandanten bearbeitet, deren Kosten auf. Inhalte des Datensatzes wie der
+ * Datenlieferant eignen sich wegen personenbezogener und unbegrenzt vieler
+ * Werte nicht als Label.
+ */
+class EricKosten
+{
+public:
+    /**
+     * @param anfrage
+     *        Art der Anfrage, z.B. "vorgang"
+     * @param mandant
+     *        Mandant, dem die Anfrage zugerechnet wird; eine kleine, feste Menge von Werten
+     */
+    EricKosten(const char *anfrage, const std::string &datenartVersion, const std::string &mandant);
+
+    /** @brief Meldet die Kosten an EricMetriken */
+    ~EricKosten();
+
+    /** @brief Rechnet einen ERiC-Rueckgabepuffer der Anfrage zu */
+    void erfassePuffer(uint64_t bytes) { pufferBytes += bytes; }
+
+    /** @brief Bytes, die der aufrufende Thread bisher ueber den Operator new angefordert hat */
+    static uint64_t allokiert();
+
+private:
+    EricKosten(const EricKosten &); // Kopien verboten
+    EricKosten &operator=(const EricKosten &); // Zuweisungen verboten
+
+    const std::string                           labels;
+    const std::chrono::steady_clock::time_point start;
+    const uint64_t                              cpuStartUs;
+    const uint64_t                              allokiertStart;
+    uint64_t                                    pufferBytes;
+};
+
+#endif
@@ -0,0 +1,350 @@
+#include "ericlogprotokoll.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <eric_fehlercodes.h>
+
+#include "anwendungsfehler.h"
+#include "ericmt.h"
+#include "jsontext.h"
+
+
+namespace
+{
+
+// So oft leert der Hintergrundthread die Ringe
+const long LEERINTERVALL_MS = 50;
+
+const char *ebenenName(eric_log_level_t ebene)
+{
+    switch (ebene)
+    {
+    case ERIC_LOG_ERROR:
+        return "ERROR";
+    case ERIC_LOG_WARN:
+        return "WARN";
+    case ERIC_LOG_INFO:
+        return "INFO";
+    case ERIC_LOG_DEBUG:
+        return "DEBUG";
+    case ERIC_LOG_TRACE:
+        return "TRACE";
+    default:
+        return "UNBEKANNT";
+    }
+}
+
+void haengeZeitAn(std::string &json, int64_t zeitUs)
+{
+    const std::time_t sekunden = static_cast<std::time_t>(zeitUs / 1000000);
+    std::tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &sekunden);
+#else
+    gmtime_r(&sekunden, &utc);
+#endif
+    char text[40];
+    const size_t laenge = std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(text + laenge, sizeof(text) - laenge, ".%06dZ", static_cast<int>(zeitUs % 1000000));
+    json += "\"zeit\":\"";
+    json += text;
+    json += '"';
+}
+
+void haengeZeileAn(std::string &zeilen, int64_t zeitUs, unsigned instanz, eric_log_level_t ebene,
+                   const char *kategorie, size_t kategorieLaenge, const char *nachricht, size_t nachrichtLaenge)
+{
+    zeilen += '{';
+    haengeZeitAn(zeilen, zeitUs);
+    zeilen += ",\"instanz\":" + std::to_string(instanz) + ",\"ebene\":\"" + ebenenName(ebene) + "\",\"kategorie\":";
+    JsonText::haengeAn(zeilen, kategorie, kategorieLaenge);
+    zeilen += ",\"nachricht\":";
+    JsonText::haengeAn(zeilen, nachricht, nachrichtLaenge);
+    zeilen += "}\n";
+}
+
+int64_t jetztUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/** @brief Kopiert hoechstens groesse Zeichen, liefert die kopierte Laenge */
+uint32_t kopiere(char *ziel, size_t groesse, const char *quelle, bool &gekuerzt)
+{
+    if (quelle == nullptr)
+    {
+        return 0;
+    }
+    size_t laenge = 0;
+    while (laenge < groesse && quelle[laenge] != '\0')
+    {
+        ziel[laenge] = quelle[laenge];
+        ++laenge;
+    }
+    gekuerzt = gekuerzt || (laenge == groesse && quelle[laenge] != '\0');
+    return static_cast<uint32_t>(laenge);
+}
+
+} // anonymous namespace
+
+
+EricLogProtokoll::Ring::Ring(const EricLogProtokoll &protokoll_, EricInstanzHandle instanz_, unsigned nummer_)
+    : protokoll(protokoll_),
+      instanz(instanz_),
+      nummer(nummer_),
+      eintraege(KAPAZITAET),
+      gefiltert(0),
+      uebergelaufen(0),
+      gekuerzt(0),
+      abgemeldet(false),
+      sekunde(0),
+      inSekunde(0),
+      unterdrueckt(0)
+{
+}
+
+bool EricLogProtokoll::Ring::schreibe(const char *kategorie, eric_log_level_t ebene, const char *nachricht)
+{
+    bool abgeschnitten = false;
+    const bool geschrieben = eintraege.schreibe([&](Eintrag &eintrag)
+    {
+        eintrag.zeitUs = jetztUs();
+        eintrag.ebene = ebene;
+        eintrag.kategorieLaenge = kopiere(eintrag.kategorie, MAX_KATEGORIE, kategorie, abgeschnitten);
+        eintrag.nachrichtLaenge = kopiere(eintrag.nachricht, MAX_NACHRICHT, nachricht, abgeschnitten);
+    });
+    if (abgeschnitten)
+    {
+        gekuerzt.fetch_add(1, std::memory_order_relaxed);
+    }
+    return geschrieben;
+}
+
+
+EricLogProtokoll::EricLogProtokoll(const std::string &ausgabeDatei, eric_log_level_t mindestEbene_, unsigned maxProSekunde_)
+    : mindestEbene(mindestEbene_),
+      maxProSekunde(maxProSekunde_),
+      ausgabe(ausgabeDatei.c_str(), std::ios::binary | std::ios::app),
+      beenden(false),
+      naechsteNummer(1),
+      statistik()
+{
+    if (!ausgabe)
+    {
+        throw Anwendungsfehler("Die Logdatei \"" + ausgabeDatei + "\" konnte nicht geoeffnet werden.");
+    }
+    thread = std::thread(&EricLogProtokoll::arbeite, this);
+}
+
+EricLogProtokoll::~EricLogProtokoll()
+{
+    beende();
+}
+
+void EricLogProtokoll::beende()
+{
+    if (!thread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    beendet.notify_all();
+    thread.join();
+
+    // Nachzuegler seit dem letzten Durchlauf; der Thread ist beendet, es gibt also weiter nur einen Leser
+    leere();
+}
+
+void EricLogProtokoll::meldeAn(const EricMtInstanz &instanz)
+{
+    std::shared_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ring = std::make_shared<Ring>(*this, instanz.handle(), naechsteNummer++);
+    }
+
+    // 0: Solange der Callback registriert ist, schreibt der ERiC nicht nach eric.log
+    if (instanz.api().EricMtRegistriereLogCallback(instanz.handle(), logCallback, 0, ring.get()) != ERIC_OK)
+    {
+        std::cerr << "Warnung: Log-Callback konnte nicht registriert werden, die Instanz schreibt weiter nach eric.log." << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    ringe.push_back(ring);
+}
+
+void EricLogProtokoll::meldeAb(const EricMtInstanz &instanz)
+{
+    std::shared_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        for (size_t i = 0; i < ringe.size(); ++i)
+        {
+            if (ringe[i]->instanz == instanz.handle() && !ringe[i]->abgemeldet)
+            {
+                ring = ringe[i];
+                break;
+            }
+        }
+    }
+    if (!ring)
+    {
+        return;
+    }
+
+    // Danach ruft der ERiC den Callback nicht mehr auf; der Hintergrundthread leert den Ring und entfernt ihn
+    instanz.api().EricMtRegistriereLogCallback(instanz.handle(), nullptr, 0, nullptr);
+    ring->abgemeldet = true;
+}
+
+EricLogProtokoll::Kennzahlen EricLogProtokoll::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen summe = statistik;
+    for (size_t i = 0; i < ringe.size(); ++i)
+    {
+        summe.gefiltert += ringe[i]->gefiltert.load(std::memory_order_relaxed);
+        summe.uebergelaufen += ringe[i]->uebergelaufen.load(std::memory_order_relaxed);
+        summe.gekuerzt += ringe[i]->gekuerzt.load(std::memory_order_relaxed);
+    }
+    return summe;
+}
+
+bool EricLogProtokoll::leseEbene(const std::string &text, eric_log_level_t &ebene)
+{
+    static const struct { const char *name; eric_log_level_t ebene; } EBENEN[] = {
+        { "trace", ERIC_LOG_TRACE },
+        { "debug", ERIC_LOG_DEBUG },
+        { "info", ERIC_LOG_INFO },
+        { "warn", ERIC_LOG_WARN },
+        { "error", ERIC_LOG_ERROR }
+    };
+    for (size_t i = 0; i < sizeof(EBENEN) / sizeof(EBENEN[0]); ++i)
+    {
+        if (text == EBENEN[i].name)
+        {
+            ebene = EBENEN[i].ebene;
+            return true;
+        }
+    }
+    return false;
+}
+
+void STDCALL EricLogProtokoll::logCallback(const char *kategorie, eric_log_level_t ebene, const char *nachricht, void *benutzerdaten)
+{
+    // Laeuft im Thread des ERiC-Aufrufs: weder Sperren noch Speicheranforderungen
+    Ring &ring = *static_cast<Ring *>(benutzerdaten);
+    if (ebene < ring.protokoll.mindestEbene)
+    {
+        ring.gefiltert.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (!ring.schreibe(kategorie, ebene, nachricht))
+    {
+        ring.uebergelaufen.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EricLogProtokoll::leere()
+{
+    std::vector<std::shared_ptr<Ring> > aktuell;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        aktuell = ringe;
+    }
+
+    std::string zeilen;
+    std::vector<uint64_t> geschrieben(aktuell.size(), 0);
+    std::vector<bool> entfernen(aktuell.size(), false);
+    for (size_t i = 0; i < aktuell.size(); ++i)
+    {
+        // Erst lesen, dann leeren: war die Instanz schon abgemeldet, kommt danach nichts mehr nach
+        entfernen[i] = aktuell[i]->abgemeldet.load();
+        geschrieben[i] = leere(*aktuell[i], zeilen);
+        if (entfernen[i])
+        {
+            meldeUnterdrueckte(*aktuell[i], zeilen);
+        }
+    }
+    if (!zeilen.empty())
+    {
+        ausgabe.write(zeilen.data(), static_cast<std::streamsize>(zeilen.size()));
+        ausgabe.flush();
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    for (size_t i = 0; i < aktuell.size(); ++i)
+    {
+        statistik.geschrieben += geschrieben[i];
+        if (entfernen[i])
+        {
+            statistik.gefiltert += aktuell[i]->gefiltert.load();
+            statistik.uebergelaufen += aktuell[i]->uebergelaufen.load();
+            statistik.gekuerzt += aktuell[i]->gekuerzt.load();
+            ringe.erase(std::find(ringe.begin(), ringe.end(), aktuell[i]));
+        }
+    }
+}
+
+size_t EricLogProtokoll::leere(Ring &ring, std::string &zeilen)
+{
+    size_t geschrieben = 0;
+    ring.eintraege.leere([&](const Eintrag &eintrag)
+    {
+        const int64_t sekunde = eintrag.zeitUs / 1000000;
+        if (sekunde != ring.sekunde)
+        {
+            meldeUnterdrueckte(ring, zeilen);
+            ring.sekunde = sekunde;
+            ring.inSekunde = 0;
+        }
+        if (maxProSekunde == 0 || ring.inSekunde < maxProSekunde || eintrag.ebene >= ERIC_LOG_ERROR)
+        {
+            haengeZeileAn(zeilen, eintrag.zeitUs, ring.nummer, eintrag.ebene,
+                          eintrag.kategorie, eintrag.kategorieLaenge, eintrag.nachricht, eintrag.nachrichtLaenge);
+            ++ring.inSekunde;
+            ++geschrieben;
+        }
+        else
+        {
+            ++ring.unterdrueckt;
+        }
+    });
+    return geschrieben;
+}
+
+void EricLogProtokoll::meldeUnterdrueckte(Ring &ring, std::string &zeilen)
+{
+    if (ring.unterdrueckt == 0)
+    {
+        return;
+    }
+    const std::string nachricht = std::to_string(ring.unterdrueckt) + " Nachrichten wegen mehr als "
+                                + std::to_string(maxProSekunde) + " Nachrichten pro Sekunde nicht geschrieben";
+    const char kategorie[] = "ericdemo.drosselung";
+    haengeZeileAn(zeilen, (ring.sekunde + 1) * 1000000, ring.nummer, ERIC_LOG_WARN,
+                  kategorie, sizeof(kategorie) - 1, nachricht.data(), nachricht.size());
+
+    std::lock_guard<std::mutex> lock(sperre);
+    statistik.gedrosselt += ring.unterdrueckt;
+    ring.unterdrueckt = 0;
+}
+
+void EricLogProtokoll::arbeite()
+{
+    std::unique_lock<std::mutex> lock(sperre);
+    while (!beenden)
+    {
+        beendet.wait_for(lock, std::chrono::milliseconds(LEERINTERVALL_MS));
+        lock.unlock();
+        leere();
+        lock.lock();
+    }
+}
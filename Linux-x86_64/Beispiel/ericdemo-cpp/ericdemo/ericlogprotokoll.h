@@ -0,0 +1,146 @@
+#ifndef _ERICLOGPROTOKOLL_H_
+#define _ERICLOGPROTOKOLL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <eric_types.h>
+
+#include "ringpuffer.h"
+
+// Vorwaertsdeklarationen
+class EricMtInstanz;
+
+
+/** @brief Schreibt die Lognachrichten der ERiC-Instanzen als JSON-Zeilen statt nach eric.log
+ *
+ * Jede angemeldete Instanz erhaelt einen eigenen, bei der Anmeldung angelegten
+ * Ringpuffer fester Groesse, in den ihr Log-Callback die Nachricht sperrfrei
+ * kopiert. Nachrichten unterhalb der Mindestebene verwirft bereits der Callback,
+ * bei vollem Ring geht die Nachricht verloren und wird gezaehlt. Der aufrufende
+ * Thread wartet also nie auf die Festplatte.
+ *
+ * Ein Hintergrundthread leert die Ringe alle 50 ms und schreibt je Nachricht
+ * eine Zeile wie
+ *     {"zeit":"2026-10-18T10:00:00.123456Z","instanz":1,"ebene":"WARN","kategorie":"eric.ctrl2","nachricht":"..."}
+ * Pro Instanz und Sekunde werden hoechstens maxProSekunde Nachrichten
+ * geschrieben; Fehlermeldungen sind davon ausgenommen. Die gedrosselten
+ * Nachrichten werden am Ende der Sekunde in einer eigenen Zeile gemeldet.
+ */
+class EricLogProtokoll
+{
+public:
+    /** @brief Anzahl der Nachrichten, die ein Ring aufnehmen kann */
+    static const size_t KAPAZITAET = 512;
+    /** @brief Laengere Kategorien und Nachrichten werden gekuerzt */
+    static const size_t MAX_KATEGORIE = 64;
+    static const size_t MAX_NACHRICHT = 1024;
+
+    struct Kennzahlen
+    {
+        uint64_t geschrieben;       // In die Ausgabedatei geschriebene Nachrichten
+        uint64_t gefiltert;         // Unterhalb der Mindestebene verworfen
+        uint64_t uebergelaufen;     // Bei vollem Ring verloren
+        uint64_t gedrosselt;        // Wegen maxProSekunde nicht geschrieben
+        uint64_t gekuerzt;          // Kategorie oder Nachricht abgeschnitten
+    };
+
+    /**
+     * @param ausgabeDatei
+     *        Datei, an die die JSON-Zeilen angehaengt werden
+     * @param mindestEbene
+     *        Nachrichten unterhalb dieser Ebene werden verworfen
+     * @param maxProSekunde
+     *        Hoechstzahl geschriebener Nachrichten je Instanz und Sekunde, 0 ohne Begrenzung
+     *
+     * @throw Anwendungsfehler, wenn die Ausgabedatei nicht geoeffnet werden kann
+     */
+    EricLogProtokoll(const std::string &ausgabeDatei, eric_log_level_t mindestEbene, unsigned maxProSekunde);
+
+    /** @brief Siehe beende() */
+    virtual ~EricLogProtokoll();
+
+    /** @brief Registriert den Log-Callback der Instanz, eric.log wird fuer sie nicht mehr geschrieben
+     *
+     * Schlaegt die Registrierung fehl, schreibt die Instanz weiter nach eric.log.
+     */
+    void meldeAn(const EricMtInstanz &instanz);
+
+    /** @brief Deregistriert den Log-Callback, muss vor dem Freigeben der Instanz aufgerufen werden */
+    void meldeAb(const EricMtInstanz &instanz);
+
+    /** @brief Beendet den Hintergrundthread und leert alle Ringe ein letztes Mal
+     *
+     * Danach angemeldete oder noch angemeldete Instanzen werden nicht mehr geschrieben.
+     */
+    void beende();
+
+    /** @brief Stand des letzten Durchlaufs, nach beende() vollstaendig */
+    Kennzahlen kennzahlen() const;
+
+    /** @brief Ebene zu "trace", "debug", "info", "warn" oder "error" */
+    static bool leseEbene(const std::string &text, eric_log_level_t &ebene);
+
+private:
+    EricLogProtokoll(const EricLogProtokoll &); // Kopien verboten
+    EricLogProtokoll &operator=(const EricLogProtokoll &); // Zuweisungen verboten
+
+    struct Eintrag
+    {
+        int64_t             zeitUs;    // Mikrosekunden seit 1970 (UTC)
+        eric_log_level_t    ebene;
+        uint32_t            kategorieLaenge;
+        uint32_t            nachrichtLaenge;
+        char                kategorie[MAX_KATEGORIE];
+        char                nachricht[MAX_NACHRICHT];
+    };
+
+    /** @brief Ring einer Instanz, beliebig viele Schreiber und genau ein Leser */
+    struct Ring
+    {
+        Ring(const EricLogProtokoll &protokoll, EricInstanzHandle instanz, unsigned nummer);
+
+        bool schreibe(const char *kategorie, eric_log_level_t ebene, const char *nachricht);
+
+        const EricLogProtokoll &protokoll;
+        const EricInstanzHandle instanz;
+        const unsigned          nummer;
+        Ringpuffer<Eintrag>     eintraege;          // Gelesen nur vom Hintergrundthread
+        std::atomic<uint64_t>   gefiltert;
+        std::atomic<uint64_t>   uebergelaufen;
+        std::atomic<uint64_t>   gekuerzt;
+        std::atomic<bool>       abgemeldet;
+
+        // Drosselung, nur der Hintergrundthread
+        int64_t                 sekunde;
+        unsigned                inSekunde;
+        uint64_t                unterdrueckt;
+    };
+
+    static void STDCALL logCallback(const char *kategorie, eric_log_level_t ebene, const char *nachricht, void *benutzerdaten);
+
+    void leere();
+    size_t leere(Ring &ring, std::string &zeilen);
+    void meldeUnterdrueckte(Ring &ring, std::string &zeilen);
+    void arbeite();
+
+    const eric_log_level_t             mindestEbene;
+    const unsigned                     maxProSekunde;
+    std::ofstream                      ausgabe;
+
+    mutable std::mutex                 sperre;
+    std::condition_variable            beendet;
+    bool                               beenden;
+    std::vector<std::shared_ptr<Ring> > ringe;
+    unsigned                           naechsteNummer;
+    Kennzahlen                         statistik;
+    std::thread                        thread;
+};
+
+#endif
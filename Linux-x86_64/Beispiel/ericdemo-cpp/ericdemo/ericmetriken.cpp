@@ -0,0 +1,32 @@
+#include "ericmetriken.h"
+
+#include "ericspuren.h"
+
+
+EricMetriken::Aufruf::Aufruf(const char *funktion_)
+    : funktion(funktion_),
+      start(std::chrono::steady_clock::now())
+{ }
+
+int EricMetriken::Aufruf::ende(int rc) const
+{
+    const std::chrono::steady_clock::time_point jetzt = std::chrono::steady_clock::now();
+    EricSpuren::zeichneAuf(funktion, start, jetzt);
+    EricMetriken &metriken = EricMetriken::instanz();
+    const std::string labels = label("funktion", funktion);
+    metriken.zaehle("eric_api_aufrufe_total", labels + "," + label("rc", std::to_string(rc)));
+    metriken.messe("eric_api_dauer_seconds", labels, jetzt - start);
+    return rc;
+}
+
+
+EricMetriken &EricMetriken::instanz()
+{
+    // Wird nie zerstoert, damit Threads bis zuletzt zaehlen koennen
+    static EricMetriken *const metriken = new EricMetriken();
+    return *metriken;
+}
+
+EricMetriken::EricMetriken()
+    : Metriken("eric")
+{ }
@@ -0,0 +1,44 @@
+#ifndef _ERICMETRIKEN_H_
+#define _ERICMETRIKEN_H_
+
+#include <chrono>
+
+#include "metriken.h"
+
+
+/** @brief Metriken der ERiC-Klassen
+ *
+ * Registry und Export liegen in ../gemeinsam und werden mit ottodemo geteilt,
+ * siehe Metriken und MetrikExport. Hier kommen nur die Instanz des Prozesses
+ * und die Zaehlung der ERiC API-Aufrufe hinzu.
+ */
+class EricMetriken : public Metriken
+{
+public:
+    /** @brief Zaehlt einen Aufruf einer ERiC API-Funktion mit Rueckgabewert und Dauer
+     *
+     * Die Instanz wird vor dem Aufruf erzeugt, damit die Dauer den ganzen Aufruf umfasst:
+     *     const EricMetriken::Aufruf aufruf("EricCheckXML");
+     *     return aufruf.ende(EricCheckXMLPtr(xml, datenartVersion, fehlertextPuffer));
+     */
+    class Aufruf
+    {
+    public:
+        explicit Aufruf(const char *funktion);
+
+        /** @brief Zaehlt eric_api_aufrufe_total und misst eric_api_dauer_seconds, liefert rc unveraendert */
+        int ende(int rc) const;
+
+    private:
+        const char *const                           funktion;
+        const std::chrono::steady_clock::time_point start;
+    };
+
+    /** @brief Die Instanz des Prozesses */
+    static EricMetriken &instanz();
+
+private:
+    EricMetriken();
+};
+
+#endif
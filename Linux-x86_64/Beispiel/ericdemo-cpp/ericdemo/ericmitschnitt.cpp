@@ -0,0 +1,267 @@
+#include "ericmitschnitt.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+#include "anwendungsfehler.h"
+#include "ericmetriken.h"
+#include "jsontext.h"
+#include "system.h"
+
+#ifndef _WIN32
+#   include <sys/stat.h>
+#endif
+
+
+namespace
+{
+
+const char INDEXDATEI[] = "mitschnitt.naechster";
+
+#ifdef _WIN32
+const char SKRIPTENDUNG[] = ".cmd";
+#else
+const char SKRIPTENDUNG[] = ".sh";
+#endif
+
+/** @brief FNV-1a ueber den Datensatz, identifiziert ihn auch nach dem Schwaerzen */
+uint64_t fnv1a(const std::string &text)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::string utcJetzt()
+{
+    const std::time_t sekunden = std::time(nullptr);
+    std::tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &sekunden);
+#else
+    gmtime_r(&sekunden, &utc);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return text;
+}
+
+std::string dezimal(double wert)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", wert);
+    return text;
+}
+
+#ifndef _WIN32
+/** @brief Setzt einen Text fuer die POSIX-Shell in einfache Anfuehrungszeichen */
+std::string shellText(const std::string &text)
+{
+    std::string ergebnis("'");
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '\'')
+        {
+            ergebnis += "'\\''";
+        }
+        else
+        {
+            ergebnis += text[i];
+        }
+    }
+    return ergebnis + "'";
+}
+#endif
+
+} // anonymous namespace
+
+
+void EricMitschnitt::Vorgang::uebernehmePhasen(const EricPhasenzeiten::Messung &messung)
+{
+    for (int phase = 0; phase < EricPhasenzeiten::ANZAHL_PHASEN; ++phase)
+    {
+        phasenMs[phase] = messung.phasendauerMs(static_cast<EricPhasenzeiten::Phase>(phase));
+    }
+}
+
+
+EricMitschnitt::EricMitschnitt(const std::string &verzeichnis_, double schwelleMs_, size_t anzahl_, bool schwaerzen_,
+                               const std::string &ericdemoPfad_, const std::string &homeDir_, const std::string &logDir_)
+    : verzeichnis(verzeichnis_),
+      schwelleMs(schwelleMs_),
+      anzahl(std::max<size_t>(1, anzahl_)),
+      schwaerzen(schwaerzen_),
+      ericdemoPfad(ericdemoPfad_),
+      homeDir(homeDir_),
+      logDir(logDir_),
+      naechster(0),
+      statistik()
+{
+    if (!System::erzeugeGeschuetztesVerzeichnis(verzeichnis))
+    {
+        throw Anwendungsfehler("Das Mitschnittverzeichnis \"" + verzeichnis + "\" konnte nicht angelegt werden");
+    }
+
+    // Nach einem Neustart mit dem aeltesten Mitschnitt fortfahren
+    std::ifstream index(System::dateiPfad(verzeichnis, INDEXDATEI).c_str());
+    if (index >> naechster)
+    {
+        naechster %= anzahl;
+    }
+    else
+    {
+        naechster = 0;
+    }
+}
+
+EricMitschnitt::~EricMitschnitt()
+{ }
+
+std::string EricMitschnitt::erfasse(const Vorgang &vorgang, const std::string &xmlDaten)
+{
+    const double gesamtMs = vorgang.phasenMs[EricPhasenzeiten::GESAMT];
+    if (gesamtMs <= schwelleMs)
+    {
+        return std::string();
+    }
+
+    // Alles ausser dem Schreiben entsteht ausserhalb der Sperre
+    const uint64_t hash = fnv1a(xmlDaten);
+    char hashText[20];
+    std::snprintf(hashText, sizeof(hashText), "%016llx", static_cast<unsigned long long>(hash));
+
+    std::string json("{\"zeit\":\"" + utcJetzt() + "\",\"dauerMs\":" + dezimal(gesamtMs) + ",\"schwelleMs\":" + dezimal(schwelleMs));
+    json += ",\"datenartVersion\":";
+    JsonText::haengeAn(json, vorgang.datenartVersion);
+    json += ",\"bearbeitungsFlags\":" + std::to_string(vorgang.bearbeitungsFlags);
+    json += ",\"rc\":" + std::to_string(vorgang.rc);
+    json += ",\"datensatz\":{\"fnv1a\":\"" + std::string(hashText) + "\",\"bytes\":" + std::to_string(xmlDaten.size())
+          + ",\"geschwaerzt\":" + (schwaerzen ? "true" : "false") + "}";
+    json += ",\"phasenMs\":{";
+    bool erste = true;
+    for (int phase = 0; phase < EricPhasenzeiten::ANZAHL_PHASEN; ++phase)
+    {
+        if (vorgang.phasenMs[phase] >= 0.0)
+        {
+            json += erste ? "\"" : ",\"";
+            erste = false;
+            json += EricPhasenzeiten::bezeichnung(static_cast<EricPhasenzeiten::Phase>(phase));
+            json += "\":" + dezimal(vorgang.phasenMs[phase]);
+        }
+    }
+    json += "},\"instanz\":";
+    JsonText::haengeAn(json, vorgang.instanz);
+    json += ",\"vorgaengeDerInstanz\":" + std::to_string(vorgang.vorgaengeDerInstanz);
+    json += ",\"arbeitsspeicherBytes\":" + std::to_string(System::belegterArbeitsspeicher());
+
+    const std::string datensatz = schwaerzen ? schwaerze(xmlDaten) : std::string();
+    const std::string labels = EricMetriken::label("datenartVersion", vorgang.datenartVersion);
+    EricMetriken::instanz().zaehle("eric_langsame_vorgaenge_total", labels);
+
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.langsam;
+    const std::string basis = System::dateiPfad(verzeichnis, "mitschnitt-" + std::to_string(naechster));
+    const std::string jsonDatei = basis + ".json";
+    const std::string xmlDatei = basis + ".xml";
+    const std::string skriptDatei = basis + SKRIPTENDUNG;
+    json += ",\"wiederholung\":";
+    JsonText::haengeAn(json, skriptDatei);
+    json += "}\n";
+
+    // Die alte JSON-Datei zuerst entfernen, damit kein Mitschnitt aus alten und neuen Dateien entsteht
+    std::remove(jsonDatei.c_str());
+    const bool geschrieben = System::schreibeDatei(schwaerzen ? datensatz : xmlDaten, xmlDatei)
+                          && System::schreibeDatei(wiederholung(vorgang.datenartVersion, xmlDatei), skriptDatei)
+                          && System::schreibeDatei(json, jsonDatei);
+    if (!geschrieben)
+    {
+        ++statistik.fehlgeschlagen;
+        return std::string();
+    }
+#ifndef _WIN32
+    ::chmod(skriptDatei.c_str(), S_IRWXU);
+#endif
+
+    naechster = (naechster + 1) % anzahl;
+    System::schreibeDatei(std::to_string(naechster) + "\n", System::dateiPfad(verzeichnis, INDEXDATEI));
+    ++statistik.gespeichert;
+    return jsonDatei;
+}
+
+EricMitschnitt::Kennzahlen EricMitschnitt::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    return statistik;
+}
+
+std::string EricMitschnitt::schwaerze(const std::string &xmlDaten)
+{
+    std::string ergebnis(xmlDaten);
+    // Der Transferheader bleibt lesbar, damit der ERiC Verfahren und Datenart erkennt
+    const std::string kopfEnde("</TransferHeader>");
+    const size_t kopf = ergebnis.find(kopfEnde);
+    bool imTag = false;
+    for (size_t i = kopf == std::string::npos ? 0 : kopf + kopfEnde.size(); i < ergebnis.size(); ++i)
+    {
+        const char zeichen = ergebnis[i];
+        if (zeichen == '<')
+        {
+            imTag = true;
+        }
+        else if (zeichen == '>')
+        {
+            imTag = false;
+        }
+        else if (!imTag)
+        {
+            if (zeichen >= '0' && zeichen <= '9')
+            {
+                ergebnis[i] = '0';
+            }
+            else if ((zeichen >= 'a' && zeichen <= 'z') || (zeichen >= 'A' && zeichen <= 'Z')
+                     || (static_cast<unsigned char>(zeichen) >= 0x80))
+            {   // Bytes von UTF-8-Folgen gleich mit, damit keine Umlaute uebrig bleiben
+                ergebnis[i] = 'X';
+            }
+        }
+    }
+    return ergebnis;
+}
+
+std::string EricMitschnitt::wiederholung(const std::string &datenartVersion, const std::string &xmlDatei) const
+{
+    const std::string xmlName = xmlDatei.substr(xmlDatei.find_last_of(PFAD_SEPARATOR) + 1);
+    std::string skript;
+#ifdef _WIN32
+    skript += "@echo off\r\n"
+              "rem Wiederholt den Mitschnitt als reine Validierung\r\n"
+              "rem Aufruf: " + xmlName.substr(0, xmlName.size() - 4) + SKRIPTENDUNG + " [ericdemo [ERiC-Heimverzeichnis [Protokollverzeichnis]]]\r\n"
+              "set \"ERICDEMO=" + ericdemoPfad + "\"\r\n"
+              "set \"HOME_DIR=" + homeDir + "\"\r\n"
+              "set \"LOG_DIR=" + logDir + "\"\r\n"
+              "if not \"%~1\"==\"\" set \"ERICDEMO=%~1\"\r\n"
+              "if not \"%~2\"==\"\" set \"HOME_DIR=%~2\"\r\n"
+              "if not \"%~3\"==\"\" set \"LOG_DIR=%~3\"\r\n"
+              "\"%ERICDEMO%\" /d \"%HOME_DIR%\" /l \"%LOG_DIR%\" /v " + datenartVersion
+              + " /x \"%~dp0" + xmlName + "\" /c _NULL /p _NULL /n < nul\r\n";
+#else
+    skript += "#!/bin/sh\n"
+              "# Wiederholt den Mitschnitt als reine Validierung\n"
+              "# Aufruf: " + xmlName.substr(0, xmlName.size() - 4) + SKRIPTENDUNG + " [ericdemo [ERiC-Heimverzeichnis [Protokollverzeichnis]]]\n"
+              "ERICDEMO=" + shellText(ericdemoPfad) + "\n"
+              "HOME_DIR=" + shellText(homeDir) + "\n"
+              "LOG_DIR=" + shellText(logDir) + "\n"
+              "[ -n \"$1\" ] && ERICDEMO=$1\n"
+              "[ -n \"$2\" ] && HOME_DIR=$2\n"
+              "[ -n \"$3\" ] && LOG_DIR=$3\n"
+              "exec \"$ERICDEMO\" -d \"$HOME_DIR\" -l \"$LOG_DIR\" -v " + shellText(datenartVersion)
+              + " -x \"$(dirname \"$0\")/" + xmlName + "\" -c _NULL -p _NULL -n < /dev/null\n";
+#endif
+    return skript;
+}
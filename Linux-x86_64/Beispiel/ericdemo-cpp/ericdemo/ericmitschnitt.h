@@ -0,0 +1,113 @@
+#ifndef _ERICMITSCHNITT_H_
+#define _ERICMITSCHNITT_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "ericphasenzeiten.h"
+
+
+/** @brief Schneidet langsame Vorgaenge mit, damit sie sich nachtraeglich wiederholen lassen
+ *
+ * Dauert ein Vorgang laenger als die Schwelle, legt erfasse() im
+ * Spoolverzeichnis einen Mitschnitt aus drei Dateien an:
+ *
+ *  - mitschnitt-<n>.json: Zeitpunkt, Datenartversion, Bearbeitungsflags,
+ *    Rueckgabewert, FNV-1a-Hash und Laenge des Datensatzes, Dauer jeder
+ *    durchlaufenen Phase, ERiC-Instanz, Anzahl ihrer bisherigen Vorgaenge
+ *    und belegter Arbeitsspeicher des Prozesses
+ *  - mitschnitt-<n>.xml: der Datensatz, auf Wunsch geschwaerzt
+ *  - mitschnitt-<n>.sh bzw. .cmd: Wiederholung mit einem waehlbaren
+ *    ericdemo und ERiC-Heimverzeichnis
+ *
+ * Die Wiederholung validiert nur, damit ein Mitschnitt nie erneut an
+ * ELSTER versendet wird. Geschwaerzte Datensaetze eignen sich fuer
+ * Laufzeitanalysen, ihre Plausibilitaetspruefung kann aber abweichen.
+ *
+ * Das Verzeichnis fasst hoechstens 'anzahl' Mitschnitte; die Nummer des
+ * naechsten steht in mitschnitt.naechster, der aelteste wird ueberschrieben.
+ * Die JSON-Datei wird zuletzt geschrieben und zeigt so einen vollstaendigen
+ * Mitschnitt an. Eine Instanz darf von mehreren Threads benutzt werden,
+ * ein Verzeichnis aber nur von einem Prozess.
+ */
+class EricMitschnitt
+{
+public:
+    /** @brief Beschreibung eines abgeschlossenen Vorgangs */
+    struct Vorgang
+    {
+        std::string datenartVersion;
+        uint32_t    bearbeitungsFlags;
+        int         rc;
+        std::string instanz;                                // "Singlethreading-API" oder Handle der Multithreading-Instanz
+        uint64_t    vorgaengeDerInstanz;                    // Einschliesslich dieses Vorgangs
+        double      phasenMs[EricPhasenzeiten::ANZAHL_PHASEN]; // Negativ fuer nicht durchlaufene Phasen
+
+        /** @brief Uebernimmt die Phasendauern einer abgeschlossenen Messung */
+        void uebernehmePhasen(const EricPhasenzeiten::Messung &messung);
+    };
+
+    /** @brief Kennzahlen seit Erzeugung der Instanz */
+    struct Kennzahlen
+    {
+        uint64_t langsam;           // Vorgaenge ueber der Schwelle
+        uint64_t gespeichert;
+        uint64_t fehlgeschlagen;    // Mitschnitte, die nicht geschrieben werden konnten
+    };
+
+    /**
+     * @param verzeichnis
+     *        Spoolverzeichnis, wird bei Bedarf nur fuer den aktuellen Benutzer angelegt
+     * @param schwelleMs
+     *        Vorgaenge mit einer Gesamtdauer darueber werden mitgeschnitten
+     * @param anzahl
+     *        Hoechstzahl der Mitschnitte im Verzeichnis, mindestens 1
+     * @param schwaerzen
+     *        Buchstaben und Ziffern im Text der Elemente nach dem Transferheader durch 'X' bzw. '0' ersetzen
+     * @param ericdemoPfad, homeDir, logDir
+     *        Voreinstellungen der Wiederholung
+     *
+     * @throw Anwendungsfehler, wenn das Verzeichnis nicht angelegt werden kann
+     */
+    EricMitschnitt(const std::string &verzeichnis, double schwelleMs, size_t anzahl, bool schwaerzen,
+                   const std::string &ericdemoPfad, const std::string &homeDir, const std::string &logDir);
+
+    virtual ~EricMitschnitt();
+
+    /** @brief Schneidet den Vorgang mit, falls seine Gesamtdauer die Schwelle ueberschreitet
+      *
+      * @return Pfad der JSON-Datei oder leer, falls nichts gespeichert wurde
+      */
+    std::string erfasse(const Vorgang &vorgang, const std::string &xmlDaten);
+
+    Kennzahlen kennzahlen() const;
+
+    const std::string &getVerzeichnis() const { return verzeichnis; }
+
+    /** @brief Ersetzt Buchstaben und Ziffern im Text der Elemente nach dem Transferheader
+      *
+      * Tags und Attribute bleiben erhalten.
+      */
+    static std::string schwaerze(const std::string &xmlDaten);
+
+private:
+    EricMitschnitt(const EricMitschnitt &); // Kopien verboten
+    EricMitschnitt &operator=(const EricMitschnitt &); // Zuweisungen verboten
+
+    std::string wiederholung(const std::string &datenartVersion, const std::string &xmlDatei) const;
+
+    const std::string  verzeichnis;
+    const double       schwelleMs;
+    const size_t       anzahl;
+    const bool         schwaerzen;
+    const std::string  ericdemoPfad;
+    const std::string  homeDir;
+    const std::string  logDir;
+
+    mutable std::mutex sperre;
+    size_t             naechster;
+    Kennzahlen         statistik;
+};
+
+#endif
@@ -0,0 +1,369 @@
+#include "ericmt.h"
+
+#include <iostream>
+
+#include "anwendungsfehler.h"
+#include "eric.h"
+#include "ericlogprotokoll.h"
+#include "ericmetriken.h"
+#include "ericspuren.h"
+#include "resolve.h"
+#include "system.h"
+
+namespace {
+
+    /** @brief Lade eine Funktion aus einer Bibliothek */
+    template<class Funktionstyp>
+    Funktionstyp ladeFunktion(const char* funktionsName, Resolve::Library lib)
+    {
+        Funktionstyp f = Resolve::function<Funktionstyp>(lib, funktionsName);
+        if (f == nullptr)
+        {
+            throw Anwendungsfehler(std::string(funktionsName) + ": konnte nicht geladen werden.");
+        }
+        return f;
+    }
+
+    // Ein typedef und ein Funktionszeiger je ERiC API-Funktion
+    typedef EricInstanzHandle (STDCALL *EricMtInstanzErzeugenFun)(const char *pluginPfad, const char *logPfad);
+    EricMtInstanzErzeugenFun EricMtInstanzErzeugenPtr;
+
+    typedef int (STDCALL *EricMtInstanzFreigebenFun)(EricInstanzHandle instanz);
+    EricMtInstanzFreigebenFun EricMtInstanzFreigebenPtr;
+
+    typedef int (STDCALL *EricMtCreateKeyFun)(
+        EricInstanzHandle instanz,
+        const char *pin,
+        const char *pfad,
+        const eric_zertifikat_parameter_t *zertifikatInfo);
+    EricMtCreateKeyFun EricMtCreateKeyPtr;
+
+    typedef int (STDCALL *EricMtChangePasswordFun)(
+        EricInstanzHandle instanz,
+        const char *psePath,
+        const char *oldPin,
+        const char *newPin);
+    EricMtChangePasswordFun EricMtChangePasswordPtr;
+
+    typedef int (STDCALL *EricMtGetAuswahlListenFun)(
+        EricInstanzHandle instanz,
+        const char *datenartVersion,
+        const char *feldkennung,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricMtGetAuswahlListenFun EricMtGetAuswahlListenPtr;
+
+    typedef int (STDCALL *EricMtBearbeiteVorgangFun)(
+        EricInstanzHandle instanz,
+        const char *datenpuffer,
+        const char *datenartVersion,
+        uint32_t bearbeitungsFlags,
+        const eric_druck_parameter_t *druckParameter,
+        const eric_verschluesselungs_parameter_t *cryptoParameter,
+        EricTransferHandle *transferHandle,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer,
+        EricRueckgabepufferHandle serverantwortXmlPuffer);
+    EricMtBearbeiteVorgangFun EricMtBearbeiteVorgangPtr;
+
+    typedef int (STDCALL *EricMtRegistriereFortschrittCallbackFun)(
+        EricInstanzHandle instanz,
+        EricFortschrittCallback funktion,
+        void *benutzerdaten);
+    EricMtRegistriereFortschrittCallbackFun EricMtRegistriereFortschrittCallbackPtr;
+
+    typedef int (STDCALL *EricMtRegistriereLogCallbackFun)(
+        EricInstanzHandle instanz,
+        EricLogCallback funktion,
+        uint32_t schreibeEricLogDatei,
+        void *benutzerdaten);
+    EricMtRegistriereLogCallbackFun EricMtRegistriereLogCallbackPtr;
+
+    typedef int (STDCALL *EricMtVersionFun)(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer);
+    EricMtVersionFun EricMtVersionPtr;
+
+    typedef int (STDCALL *EricMtMakeElsterStnrFun)(
+        EricInstanzHandle instanz,
+        const char *steuernrBescheid,
+        const char landesnr[2+1],
+        const char bundesfinanzamtsnr[4+1],
+        EricRueckgabepufferHandle steuernrPuffer);
+    EricMtMakeElsterStnrFun EricMtMakeElsterStnrPtr;
+
+    typedef int (STDCALL *EricMtFormatStNrFun)(
+        EricInstanzHandle instanz,
+        const char *eingabeSteuernummer,
+        EricRueckgabepufferHandle rueckgabePuffer);
+    EricMtFormatStNrFun EricMtFormatStNrPtr;
+
+    typedef int (STDCALL *EricMtPruefeSteuernummerFun)(EricInstanzHandle instanz, const char *steuernummer);
+    EricMtPruefeSteuernummerFun EricMtPruefeSteuernummerPtr;
+
+    typedef EricRueckgabepufferHandle (STDCALL *EricMtRueckgabepufferErzeugenFun)(EricInstanzHandle instanz);
+    EricMtRueckgabepufferErzeugenFun EricMtRueckgabepufferErzeugenPtr;
+
+    typedef const char* (STDCALL *EricMtRueckgabepufferInhaltFun)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+    EricMtRueckgabepufferInhaltFun EricMtRueckgabepufferInhaltPtr;
+
+    typedef uint32_t (STDCALL *EricMtRueckgabepufferLaengeFun)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+    EricMtRueckgabepufferLaengeFun EricMtRueckgabepufferLaengePtr;
+
+    typedef int (STDCALL *EricMtRueckgabepufferFreigebenFun)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+    EricMtRueckgabepufferFreigebenFun EricMtRueckgabepufferFreigebenPtr;
+}
+
+EricMt::EricMt(const std::string &argHomeDir, const std::string &argLogDir, EricLogProtokoll *logProtokoll_)
+    : homeDir(Eric::ermittleHeimverzeichnis(argHomeDir)),
+      logDir(Eric::ermittleLogverzeichnis(argLogDir)),
+      logProtokoll(logProtokoll_),
+      libEricApi(nullptr)
+{
+    static const std::string ericapiDateiname = System::getBibliotheksDateiname("ericapi");
+
+    libEricApi = Resolve::library<>(
+#ifdef WINDOWS_MSVC
+        System::kod::toUtf16(System::dateiPfad(homeDir, ericapiDateiname))
+#else
+        System::dateiPfad(homeDir, ericapiDateiname)
+#endif
+        .c_str());
+    if (nullptr == libEricApi)
+    {
+        throw Anwendungsfehler("Die Programmbibliothek ericapi konnte nicht geladen werden.");
+    }
+
+    try
+    {
+        EricMtInstanzErzeugenPtr = ladeFunktion<EricMtInstanzErzeugenFun>("EricMtInstanzErzeugen", libEricApi);
+        EricMtInstanzFreigebenPtr = ladeFunktion<EricMtInstanzFreigebenFun>("EricMtInstanzFreigeben", libEricApi);
+        EricMtCreateKeyPtr        = ladeFunktion<EricMtCreateKeyFun>("EricMtCreateKey", libEricApi);
+        EricMtChangePasswordPtr   = ladeFunktion<EricMtChangePasswordFun>("EricMtChangePassword", libEricApi);
+        EricMtGetAuswahlListenPtr = ladeFunktion<EricMtGetAuswahlListenFun>("EricMtGetAuswahlListen", libEricApi);
+        EricMtBearbeiteVorgangPtr = ladeFunktion<EricMtBearbeiteVorgangFun>("EricMtBearbeiteVorgang", libEricApi);
+        EricMtRegistriereFortschrittCallbackPtr = ladeFunktion<EricMtRegistriereFortschrittCallbackFun>("EricMtRegistriereFortschrittCallback", libEricApi);
+        EricMtRegistriereLogCallbackPtr = ladeFunktion<EricMtRegistriereLogCallbackFun>("EricMtRegistriereLogCallback", libEricApi);
+        EricMtVersionPtr          = ladeFunktion<EricMtVersionFun>("EricMtVersion", libEricApi);
+        EricMtMakeElsterStnrPtr   = ladeFunktion<EricMtMakeElsterStnrFun>("EricMtMakeElsterStnr", libEricApi);
+        EricMtFormatStNrPtr       = ladeFunktion<EricMtFormatStNrFun>("EricMtFormatStNr", libEricApi);
+        EricMtPruefeSteuernummerPtr = ladeFunktion<EricMtPruefeSteuernummerFun>("EricMtPruefeSteuernummer", libEricApi);
+        EricMtRueckgabepufferErzeugenPtr  = ladeFunktion<EricMtRueckgabepufferErzeugenFun>("EricMtRueckgabepufferErzeugen", libEricApi);
+        EricMtRueckgabepufferInhaltPtr    = ladeFunktion<EricMtRueckgabepufferInhaltFun>("EricMtRueckgabepufferInhalt", libEricApi);
+        EricMtRueckgabepufferLaengePtr    = ladeFunktion<EricMtRueckgabepufferLaengeFun>("EricMtRueckgabepufferLaenge", libEricApi);
+        EricMtRueckgabepufferFreigebenPtr = ladeFunktion<EricMtRueckgabepufferFreigebenFun>("EricMtRueckgabepufferFreigeben", libEricApi);
+    }
+    catch (const Anwendungsfehler &)
+    {
+        entladeEricApi();
+        throw;
+    }
+}
+
+EricMt::~EricMt()
+{
+    entladeEricApi();
+}
+
+void EricMt::entladeEricApi()
+{
+    if (nullptr != libEricApi)
+    {
+        Resolve::free_library(libEricApi);
+        libEricApi = nullptr;
+    }
+}
+
+
+// Implementierungen der Proxy-Methoden fuer Funktionen der Multithreading-API
+
+EricInstanzHandle EricMt::EricMtInstanzErzeugen(const char *pluginPfad, const char *logPfad) const
+{
+    return EricMtInstanzErzeugenPtr(pluginPfad, logPfad);
+}
+
+int EricMt::EricMtInstanzFreigeben(EricInstanzHandle instanz) const
+{
+    return EricMtInstanzFreigebenPtr(instanz);
+}
+
+int EricMt::EricMtCreateKey(EricInstanzHandle instanz,
+                            const char *pin,
+                            const char *pfad,
+                            const eric_zertifikat_parameter_t *zertifikatInfo) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtCreateKey");
+    return aufruf.ende(EricMtCreateKeyPtr(instanz, pin, pfad, zertifikatInfo));
+}
+
+int EricMt::EricMtChangePassword(EricInstanzHandle instanz,
+                                 const char *psePath,
+                                 const char *oldPin,
+                                 const char *newPin) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtChangePassword");
+    return aufruf.ende(EricMtChangePasswordPtr(instanz, psePath, oldPin, newPin));
+}
+
+int EricMt::EricMtGetAuswahlListen(EricInstanzHandle instanz,
+                                   const char *datenartVersion,
+                                   const char *feldkennung,
+                                   EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtGetAuswahlListen");
+    return aufruf.ende(EricMtGetAuswahlListenPtr(instanz, datenartVersion, feldkennung, rueckgabeXmlPuffer));
+}
+
+int EricMt::EricMtBearbeiteVorgang(EricInstanzHandle instanz,
+                                   const char *datenpuffer,
+                                   const char *datenartVersion,
+                                   uint32_t bearbeitungsFlags,
+                                   const eric_druck_parameter_t *druckParameter,
+                                   const eric_verschluesselungs_parameter_t *cryptoParameter,
+                                   EricTransferHandle *transferHandle,
+                                   EricRueckgabepufferHandle rueckgabeXmlPuffer,
+                                   EricRueckgabepufferHandle serverantwortXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtBearbeiteVorgang");
+    return aufruf.ende(EricMtBearbeiteVorgangPtr(instanz, datenpuffer, datenartVersion, bearbeitungsFlags, druckParameter,
+                                     cryptoParameter, transferHandle, rueckgabeXmlPuffer, serverantwortXmlPuffer));
+}
+
+int EricMt::EricMtRegistriereFortschrittCallback(EricInstanzHandle instanz,
+                                                 EricFortschrittCallback funktion,
+                                                 void *benutzerdaten) const
+{
+    return EricMtRegistriereFortschrittCallbackPtr(instanz, funktion, benutzerdaten);
+}
+
+int EricMt::EricMtRegistriereLogCallback(EricInstanzHandle instanz,
+                                         EricLogCallback funktion,
+                                         uint32_t schreibeEricLogDatei,
+                                         void *benutzerdaten) const
+{
+    return EricMtRegistriereLogCallbackPtr(instanz, funktion, schreibeEricLogDatei, benutzerdaten);
+}
+
+int EricMt::EricMtVersion(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtVersion");
+    return aufruf.ende(EricMtVersionPtr(instanz, rueckgabeXmlPuffer));
+}
+
+int EricMt::EricMtMakeElsterStnr(EricInstanzHandle instanz,
+                                 const char *steuernrBescheid,
+                                 const char landesnr[2+1],
+                                 const char bundesfinanzamtsnr[4+1],
+                                 EricRueckgabepufferHandle steuernrPuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtMakeElsterStnr");
+    return aufruf.ende(EricMtMakeElsterStnrPtr(instanz, steuernrBescheid, landesnr, bundesfinanzamtsnr, steuernrPuffer));
+}
+
+int EricMt::EricMtFormatStNr(EricInstanzHandle instanz,
+                             const char *eingabeSteuernummer,
+                             EricRueckgabepufferHandle rueckgabePuffer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtFormatStNr");
+    return aufruf.ende(EricMtFormatStNrPtr(instanz, eingabeSteuernummer, rueckgabePuffer));
+}
+
+int EricMt::EricMtPruefeSteuernummer(EricInstanzHandle instanz, const char *steuernummer) const
+{
+    const EricMetriken::Aufruf aufruf("EricMtPruefeSteuernummer");
+    return aufruf.ende(EricMtPruefeSteuernummerPtr(instanz, steuernummer));
+}
+
+EricRueckgabepufferHandle EricMt::EricMtRueckgabepufferErzeugen(EricInstanzHandle instanz) const
+{
+    return EricMtRueckgabepufferErzeugenPtr(instanz);
+}
+
+const char* EricMt::EricMtRueckgabepufferInhalt(EricInstanzHandle instanz, EricRueckgabepufferHandle handle) const
+{
+    return EricMtRueckgabepufferInhaltPtr(instanz, handle);
+}
+
+uint32_t EricMt::EricMtRueckgabepufferLaenge(EricInstanzHandle instanz, EricRueckgabepufferHandle handle) const
+{
+    return EricMtRueckgabepufferLaengePtr(instanz, handle);
+}
+
+int EricMt::EricMtRueckgabepufferFreigeben(EricInstanzHandle instanz, EricRueckgabepufferHandle handle) const
+{
+    return EricMtRueckgabepufferFreigebenPtr(instanz, handle);
+}
+
+
+EricMtInstanz::EricMtInstanz(const EricMt &ericMt_) : ericMt(ericMt_), instanz(nullptr)
+{
+    const EricSpuren::Spanne spanne("EricMtInstanzErzeugen");
+    instanz = ericMt.EricMtInstanzErzeugen(
+#ifdef WINDOWS_MSVC
+        System::kod::toWindowsZeichenKodierung(ericMt.getHomeDir()).c_str(), System::kod::toWindowsZeichenKodierung(ericMt.getLogDir()).c_str()
+#else
+        ericMt.getHomeDir().c_str(), ericMt.getLogDir().c_str()
+#endif
+    );
+    if (nullptr == instanz)
+    {
+        throw Anwendungsfehler("Die ERiC-Instanz konnte nicht erzeugt werden, siehe eric.log.");
+    }
+    if (ericMt.getLogProtokoll() != nullptr)
+    {
+        try
+        {
+            ericMt.getLogProtokoll()->meldeAn(*this);
+        }
+        catch (...)
+        {
+            ericMt.EricMtInstanzFreigeben(instanz);
+            throw;
+        }
+    }
+    EricMetriken::instanz().veraendere("eric_mt_instanzen_belegt", "", 1);
+}
+
+EricMtInstanz::~EricMtInstanz()
+{
+    if (ericMt.getLogProtokoll() != nullptr)
+    {
+        ericMt.getLogProtokoll()->meldeAb(*this);
+    }
+    if (ericMt.EricMtInstanzFreigeben(instanz) != 0)
+    {
+        std::cerr << "Freigeben der ERiC-Instanz fehlgeschlagen." << std::endl;
+    }
+    EricMetriken::instanz().veraendere("eric_mt_instanzen_belegt", "", -1);
+}
+
+
+EricMtPuffer::EricMtPuffer(const EricMtInstanz &instanz_) : instanz(instanz_), puffer(nullptr)
+{
+    puffer = instanz.api().EricMtRueckgabepufferErzeugen(instanz.handle());
+    if (nullptr == puffer)
+    {
+        throw Anwendungsfehler("Erzeugung des Rueckgabepuffers fehlgeschlagen.");
+    }
+    EricMetriken::instanz().veraendere("eric_rueckgabepuffer_belegt", "api=\"mt\"", 1);
+}
+
+EricMtPuffer::~EricMtPuffer()
+{
+    if (instanz.api().EricMtRueckgabepufferFreigeben(instanz.handle(), puffer) != 0)
+    {
+        std::cerr << "Freigeben des Rueckgabepuffers fehlgeschlagen." << std::endl;
+    }
+    EricMetriken::instanz().veraendere("eric_rueckgabepuffer_belegt", "api=\"mt\"", -1);
+}
+
+const char *EricMtPuffer::inhalt() const
+{
+    const char *antwort = instanz.api().EricMtRueckgabepufferInhalt(instanz.handle(), puffer);
+    if (nullptr == antwort)
+    {
+        throw Anwendungsfehler("Zugriff auf Inhalt des Rueckgabepuffers fehlgeschlagen.");
+    }
+    return antwort;
+}
+
+uint32_t EricMtPuffer::laenge() const
+{
+    return instanz.api().EricMtRueckgabepufferLaenge(instanz.handle(), puffer);
+}
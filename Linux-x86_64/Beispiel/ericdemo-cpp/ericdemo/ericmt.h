@@ -0,0 +1,227 @@
+#ifndef _ERIC_ERICMT_H_
+#define _ERIC_ERICMT_H_
+
+#include <string>
+#include <ericdef.h>
+#include <eric_types.h>
+#include <ericmtapi.h>
+
+#include "resolve.h"
+
+// Vorwaertsdeklarationen
+class EricLogProtokoll;
+
+
+/** @brief Die Klasse 'EricMt' kapselt die Multithreading-Schnittstelle des ERiC.
+ *
+ *         Sie laedt die dynamische Bibliothek 'ericapi', ermittelt die Adressen
+ *         der benoetigten EricMt-Schnittstellenfunktionen und stellt
+ *         Wrapper-Methoden zu deren Aufruf zur Verfuegung. Jeder Thread, der
+ *         ERiC-Funktionen aufruft, arbeitet auf einer eigenen ERiC-Instanz,
+ *         siehe 'EricMtInstanz'. Die Singlethreading-API der Klasse 'Eric' bleibt
+ *         davon unberuehrt; Rueckgabepuffer duerfen nicht zwischen den APIs
+ *         ausgetauscht werden.
+ */
+class EricMt
+{
+public:
+    /**
+     * @brief Laedt die ericapi fuer die Verwendung mit der Multithreading-API.
+     *
+     * @param argHomeDir Verzeichnis der ERiC-Bibliotheken, siehe Eric::ermittleHeimverzeichnis()
+     * @param argLogDir  Verzeichnis fuer die Protokolldateien der Instanzen, siehe Eric::ermittleLogverzeichnis()
+     * @param logProtokoll
+     *        Nimmt die Lognachrichten aller Instanzen statt eric.log auf, nullptr fuer eric.log.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricMt, da diese einen Zeiger darauf haelt!
+     *
+     * @throw Anwendungsfehler
+     *        Die ericapi konnte nicht geladen werden.
+     */
+    explicit EricMt(const std::string &argHomeDir, const std::string &argLogDir, EricLogProtokoll *logProtokoll = nullptr);
+    virtual ~EricMt();
+
+    const std::string &getHomeDir() const { return homeDir; }
+    const std::string &getLogDir()  const { return logDir; }
+    EricLogProtokoll *getLogProtokoll() const { return logProtokoll; }
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    EricInstanzHandle EricMtInstanzErzeugen(
+        const char *pluginPfad,
+        const char *logPfad) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtInstanzFreigeben(
+        EricInstanzHandle instanz) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtCreateKey(
+        EricInstanzHandle instanz,
+        const char *pin,
+        const char *pfad,
+        const eric_zertifikat_parameter_t *zertifikatInfo) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtChangePassword(
+        EricInstanzHandle instanz,
+        const char *psePath,
+        const char *oldPin,
+        const char *newPin) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtGetAuswahlListen(
+        EricInstanzHandle instanz,
+        const char *datenartVersion,
+        const char *feldkennung,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtBearbeiteVorgang(
+        EricInstanzHandle instanz,
+        const char *datenpuffer,
+        const char *datenartVersion,
+        uint32_t bearbeitungsFlags,
+        const eric_druck_parameter_t *druckParameter,
+        const eric_verschluesselungs_parameter_t *cryptoParameter,
+        EricTransferHandle *transferHandle,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer,
+        EricRueckgabepufferHandle serverantwortXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtRegistriereFortschrittCallback(
+        EricInstanzHandle instanz,
+        EricFortschrittCallback funktion,
+        void *benutzerdaten) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtRegistriereLogCallback(
+        EricInstanzHandle instanz,
+        EricLogCallback funktion,
+        uint32_t schreibeEricLogDatei,
+        void *benutzerdaten) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtVersion(
+        EricInstanzHandle instanz,
+        EricRueckgabepufferHandle rueckgabeXmlPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtMakeElsterStnr(
+        EricInstanzHandle instanz,
+        const char *steuernrBescheid,
+        const char landesnr[2+1],
+        const char bundesfinanzamtsnr[4+1],
+        EricRueckgabepufferHandle steuernrPuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtFormatStNr(
+        EricInstanzHandle instanz,
+        const char *eingabeSteuernummer,
+        EricRueckgabepufferHandle rueckgabePuffer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtPruefeSteuernummer(
+        EricInstanzHandle instanz,
+        const char *steuernummer) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    EricRueckgabepufferHandle EricMtRueckgabepufferErzeugen(
+        EricInstanzHandle instanz) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    const char* EricMtRueckgabepufferInhalt(
+        EricInstanzHandle instanz,
+        EricRueckgabepufferHandle handle) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    uint32_t EricMtRueckgabepufferLaenge(
+        EricInstanzHandle instanz,
+        EricRueckgabepufferHandle handle) const;
+
+    /** @brief Wrapper fuer die gleichnamige ERiC API-Funktion. Siehe API-Referenz in der ERiC Dokumentation. */
+    int EricMtRueckgabepufferFreigeben(
+        EricInstanzHandle instanz,
+        EricRueckgabepufferHandle handle) const;
+
+private:
+    EricMt(const EricMt &);
+    EricMt & operator= (const EricMt &);
+
+    void entladeEricApi();
+
+    std::string      homeDir;
+    std::string      logDir;
+    EricLogProtokoll *logProtokoll;
+    Resolve::Library libEricApi;
+};
+
+
+/** @brief Verwaltet eine ERiC-Instanz der Multithreading-API.
+ *
+ *         Der Konstruktor erzeugt die Instanz, der Destruktor gibt sie wieder frei.
+ *         Eine Instanz darf zu jedem Zeitpunkt nur von einem Thread verwendet werden.
+ */
+class EricMtInstanz
+{
+public:
+    /**
+     * @param ericMt
+     *        Schnittstellenobjekt der Multithreading-API.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricMtInstanz, da diese eine Referenz darauf haelt!
+     *
+     * @throw Anwendungsfehler
+     *        Die ERiC-Instanz konnte nicht erzeugt werden.
+     */
+    explicit EricMtInstanz(const EricMt &ericMt);
+    ~EricMtInstanz();
+
+    EricInstanzHandle handle() const { return instanz; }
+    const EricMt &api() const { return ericMt; }
+
+private:
+    EricMtInstanz(const EricMtInstanz &); // Kopien verboten
+    EricMtInstanz &operator=(const EricMtInstanz &); // Zuweisungen verboten
+
+    const EricMt     &ericMt;
+    EricInstanzHandle instanz;
+};
+
+
+/** @brief Verwaltet einen Rueckgabepuffer einer ERiC-Instanz der Multithreading-API.
+ *
+ *         Entspricht 'EricPuffer' fuer die Singlethreading-API. Der Puffer darf
+ *         nur mit der Instanz verwendet werden, mit der er erzeugt wurde.
+ */
+class EricMtPuffer
+{
+public:
+    /**
+     * @param instanz
+     *        ERiC-Instanz, in der der Puffer erzeugt wird.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricMtPuffer, da diese eine Referenz darauf haelt!
+     *
+     * @throw Anwendungsfehler
+     *        Der Rueckgabepuffer konnte nicht erzeugt werden.
+     */
+    explicit EricMtPuffer(const EricMtInstanz &instanz);
+    ~EricMtPuffer();
+
+    EricRueckgabepufferHandle handle() const { return puffer; }
+
+    /** @brief Hole Zeiger auf den Inhalt des Rueckgabepuffers */
+    const char *inhalt() const;
+
+    /** @brief Hole Anzahl der in den Rueckgabepuffer geschriebenen Bytes */
+    uint32_t laenge() const;
+
+private:
+    EricMtPuffer(const EricMtPuffer &); // Kopien verboten
+    EricMtPuffer &operator=(const EricMtPuffer &); // Zuweisungen verboten
+
+    const EricMtInstanz      &instanz;
+    EricRueckgabepufferHandle puffer;
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include "ericnachdruck.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <utility>
+#include <eric_fehlercodes.h>
+
+#include "anwendungsfehler.h"
+#include "erickosten.h"
+#include "ericmetriken.h"
+#include "ericmitschnitt.h"
+#include "ericmt.h"
+#include "ericphasenzeiten.h"
+#include "ericspuren.h"
+#include "system.h"
+#include "xmltagleser.h"
+
+
+EricNachdruck::EricNachdruck(const EricMt &ericMt_, size_t anzahlArbeiter_, EricPhasenzeiten *phasenzeiten_,
+                             EricMitschnitt *mitschnitt_)
+    : ericMt(ericMt_),
+      phasenzeiten(phasenzeiten_),
+      mitschnitt(mitschnitt_),
+      statistik(),
+      beenden(false)
+{
+    for (size_t i = 0; i < std::max<size_t>(1, anzahlArbeiter_); ++i)
+    {
+        arbeiter.push_back(std::thread(&EricNachdruck::arbeite, this));
+    }
+}
+
+EricNachdruck::~EricNachdruck()
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    auftragVorhanden.notify_all();
+    for (size_t i = 0; i < arbeiter.size(); ++i)
+    {
+        arbeiter[i].join();
+    }
+}
+
+bool EricNachdruck::beauftrage(const std::string &transferticket, const std::string &xmlDaten, const std::string &datenartVersion,
+                               const std::string &mandant)
+{
+    Auftrag auftrag;
+    auftrag.transferticket = transferticket;
+    auftrag.xmlDaten = mitTransferticket(xmlDaten, transferticket);
+    auftrag.datenartVersion = datenartVersion;
+    auftrag.mandant = mandant;
+    auftrag.erteilt = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        Eintrag eintrag = { WARTEND, std::shared_ptr<const Beleg>() };
+        if (!eintraege.insert(std::make_pair(transferticket, eintrag)).second)
+        {
+            return false;
+        }
+        warteschlange.push_back(std::move(auftrag));
+        ++statistik.beauftragt;
+    }
+    auftragVorhanden.notify_one();
+    return true;
+}
+
+EricNachdruck::Status EricNachdruck::abfrage(const std::string &transferticket, std::shared_ptr<const Beleg> &beleg) const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    const std::map<std::string, Eintrag>::const_iterator fund = eintraege.find(transferticket);
+    if (fund == eintraege.end())
+    {
+        return UNBEKANNT;
+    }
+    beleg = fund->second.beleg;
+    return fund->second.status;
+}
+
+EricNachdruck::Status EricNachdruck::warte(const std::string &transferticket, std::shared_ptr<const Beleg> &beleg) const
+{
+    std::unique_lock<std::mutex> lock(sperre);
+    for (;;)
+    {
+        const std::map<std::string, Eintrag>::const_iterator fund = eintraege.find(transferticket);
+        if (fund == eintraege.end())
+        {
+            return UNBEKANNT;
+        }
+        if (fund->second.status == FERTIG || fund->second.status == FEHLGESCHLAGEN)
+        {
+            beleg = fund->second.beleg;
+            return fund->second.status;
+        }
+        auftragBeendet.wait(lock);
+    }
+}
+
+void EricNachdruck::entferne(const std::string &transferticket)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    const std::map<std::string, Eintrag>::iterator fund = eintraege.find(transferticket);
+    if (fund != eintraege.end() && (fund->second.status == FERTIG || fund->second.status == FEHLGESCHLAGEN))
+    {
+        eintraege.erase(fund);
+    }
+}
+
+EricNachdruck::Kennzahlen EricNachdruck::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.wartend = warteschlange.size();
+    return momentaufnahme;
+}
+
+std::string EricNachdruck::mitTransferticket(const std::string &xmlDaten, const std::string &transferticket)
+{
+    const size_t NICHT_GEFUNDEN = std::string::npos;
+    size_t ticketAnfang = NICHT_GEFUNDEN;
+    size_t ticketEnde = NICHT_GEFUNDEN;
+    size_t vorgangEnde = NICHT_GEFUNDEN;
+    std::string praefix;
+    bool imKopf = false;
+    bool kopfGefunden = false;
+
+    XmlTagLeser leser(xmlDaten);
+    while (leser.weiter())
+    {
+        if (leser.hatName("TransferHeader"))
+        {
+            if (leser.istEndeTag())
+            {
+                break;
+            }
+            imKopf = kopfGefunden = true;
+            praefix = leser.praefix();
+        }
+        else if (!imKopf)
+        {
+            continue;
+        }
+        else if (leser.hatName("TransferTicket"))
+        {
+            if (!leser.istEndeTag())
+            {
+                ticketAnfang = leser.position();
+            }
+            if (leser.istEndeTag() || leser.istLeeresElement())
+            {
+                ticketEnde = leser.endePosition();
+            }
+        }
+        else if (leser.hatName("Vorgang") && leser.istEndeTag() && vorgangEnde == NICHT_GEFUNDEN)
+        {
+            vorgangEnde = leser.endePosition();
+        }
+    }
+    if (!kopfGefunden)
+    {
+        throw Anwendungsfehler("Der Datensatz enthaelt keinen Transferheader.");
+    }
+
+    // Die Kinder des Transferheaders stehen in seinem Namensraum
+    std::string element = "<" + praefix + "TransferTicket>";
+    for (size_t i = 0; i < transferticket.size(); ++i)
+    {
+        switch (transferticket[i])
+        {
+            case '&':  element += "&amp;";  break;
+            case '<':  element += "&lt;";   break;
+            case '>':  element += "&gt;";   break;
+            case '"':  element += "&quot;"; break;
+            case '\'': element += "&apos;"; break;
+            default:   element += transferticket[i];
+        }
+    }
+    element += "</" + praefix + "TransferTicket>";
+
+    std::string ergebnis(xmlDaten);
+    if (ticketAnfang != NICHT_GEFUNDEN && ticketEnde != NICHT_GEFUNDEN)
+    {
+        return ergebnis.replace(ticketAnfang, ticketEnde - ticketAnfang, element);
+    }
+    if (vorgangEnde == NICHT_GEFUNDEN)
+    {
+        throw Anwendungsfehler("Der Transferheader des Datensatzes enthaelt kein Element Vorgang.");
+    }
+    return ergebnis.insert(vorgangEnde, element);
+}
+
+void EricNachdruck::arbeite()
+{
+    System::senkeThreadPrioritaet();
+
+    // Die ERiC-Instanz wird erst mit dem ersten Auftrag erzeugt
+    std::unique_ptr<EricMtInstanz> instanz;
+    uint64_t vorgaengeDerInstanz = 0;
+    for (;;)
+    {
+        Auftrag auftrag;
+        {
+            std::unique_lock<std::mutex> lock(sperre);
+            while (warteschlange.empty() && !beenden)
+            {
+                auftragVorhanden.wait(lock);
+            }
+            if (warteschlange.empty())
+            {
+                return;
+            }
+            auftrag = std::move(warteschlange.front());
+            warteschlange.pop_front();
+            eintraege[auftrag.transferticket].status = IN_ARBEIT;
+        }
+
+        std::shared_ptr<const Beleg> beleg;
+        try
+        {
+            const EricSpuren::Anfrage anfrage("Nachdruck", auftrag.datenartVersion);
+            if (!instanz)
+            {
+                instanz.reset(new EricMtInstanz(ericMt));
+            }
+            beleg = drucke(*instanz, ++vorgaengeDerInstanz, auftrag, phasenzeiten, mitschnitt);
+        }
+        catch (const std::exception &fehler)
+        {
+            std::shared_ptr<Beleg> fehlerBeleg(new Beleg());
+            fehlerBeleg->rc = ERIC_GLOBAL_UNKNOWN;
+            fehlerBeleg->ergebnis = fehler.what();
+            fehlerBeleg->dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - auftrag.erteilt).count();
+            beleg = fehlerBeleg;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sperre);
+            Eintrag &eintrag = eintraege[auftrag.transferticket];
+            eintrag.status = beleg->rc == ERIC_OK ? FERTIG : FEHLGESCHLAGEN;
+            eintrag.beleg = beleg;
+            ++(beleg->rc == ERIC_OK ? statistik.fertig : statistik.fehlgeschlagen);
+        }
+        auftragBeendet.notify_all();
+    }
+}
+
+std::shared_ptr<const EricNachdruck::Beleg> EricNachdruck::drucke(const EricMtInstanz &instanz, uint64_t vorgaengeDerInstanz, const Auftrag &auftrag,
+                                                                  EricPhasenzeiten *phasenzeiten, EricMitschnitt *mitschnitt)
+{
+    std::shared_ptr<Beleg> beleg(new Beleg());
+    EricKosten kosten("nachdruck", auftrag.datenartVersion, auftrag.mandant);
+    std::unique_ptr<EricPhasenzeiten::Messung> messung(
+        phasenzeiten ? new EricPhasenzeiten::Messung(*phasenzeiten, auftrag.datenartVersion, instanz) : nullptr);
+
+    EricPdfSammler pdfSammler;
+    const eric_druck_parameter_t druckEinstellungen = pdfSammler.holeDruckeinstellungen(false);
+    EricMtPuffer ergebnisPuffer(instanz);
+    EricMtPuffer serverantwortPuffer(instanz);
+    beleg->rc = instanz.api().EricMtBearbeiteVorgang(
+        instanz.handle(), auftrag.xmlDaten.c_str(), auftrag.datenartVersion.c_str(),
+        ERIC_VALIDIERE | ERIC_DRUCKE, &druckEinstellungen, nullptr, nullptr,
+        ergebnisPuffer.handle(), serverantwortPuffer.handle());
+    const uint64_t pufferBytes = static_cast<uint64_t>(ergebnisPuffer.laenge()) + serverantwortPuffer.laenge();
+    EricMetriken::instanz().zaehle("eric_rueckgabepuffer_bytes_total", "api=\"mt\"", pufferBytes);
+    kosten.erfassePuffer(pufferBytes);
+    if (messung && mitschnitt)
+    {
+        messung->abschliessen();
+        EricMitschnitt::Vorgang vorgang;
+        vorgang.datenartVersion = auftrag.datenartVersion;
+        vorgang.bearbeitungsFlags = ERIC_VALIDIERE | ERIC_DRUCKE;
+        vorgang.rc = beleg->rc;
+        char handle[32];
+        std::snprintf(handle, sizeof(handle), "%p", static_cast<const void *>(instanz.handle()));
+        vorgang.instanz = handle;
+        vorgang.vorgaengeDerInstanz = vorgaengeDerInstanz;
+        vorgang.uebernehmePhasen(*messung);
+        mitschnitt->erfasse(vorgang, auftrag.xmlDaten);
+    }
+    messung.reset();
+    {
+        const EricSpuren::Spanne spanne("Ergebnis kopieren");
+        beleg->ergebnis.assign(ergebnisPuffer.inhalt(), ergebnisPuffer.laenge());
+        beleg->pdfs = pdfSammler.pdfs();
+    }
+    beleg->dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - auftrag.erteilt).count();
+    return beleg;
+}
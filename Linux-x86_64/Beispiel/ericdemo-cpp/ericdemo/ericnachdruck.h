@@ -0,0 +1,153 @@
+#ifndef _ERICNACHDRUCK_H_
+#define _ERICNACHDRUCK_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ericpdfsammler.h"
+
+// Vorwaertsdeklarationen
+class EricMitschnitt;
+class EricMt;
+class EricMtInstanz;
+class EricPhasenzeiten;
+
+
+/** @brief Erzeugt die PDFs versendeter Datensaetze nachgelagert im Hintergrund
+ *
+ * Wird ohne ERIC_DRUCKE versendet, enthaelt die Antwortzeit nur Validierung
+ * und Versand. Die PDFs entstehen danach in einem eigenen Druckdurchlauf mit
+ * ERIC_VALIDIERE | ERIC_DRUCKE auf dem gespeicherten Datensatz, in dessen
+ * Transferheader das Transferticket des Versands eingetragen ist.
+ *
+ * Die Druckauftraege arbeiten Threads mit gesenkter Prioritaet und jeweils
+ * eigener ERiC-Instanz der Multithreading-API ab. Die Ergebnisse werden ueber
+ * das Transferticket abgefragt und bleiben bis zu entferne() im Speicher.
+ */
+class EricNachdruck
+{
+public:
+    enum Status
+    {
+        UNBEKANNT,      // Kein Auftrag zu diesem Transferticket
+        WARTEND,
+        IN_ARBEIT,
+        FERTIG,         // Beleg mit rc == ERIC_OK
+        FEHLGESCHLAGEN  // Beleg mit Fehlercode
+    };
+
+    /** @brief Ergebnis eines Druckauftrags */
+    struct Beleg
+    {
+        int                               rc;
+        std::string                       ergebnis;     // Ergebnis-XML des Druckdurchlaufs
+        std::vector<EricPdfSammler::Pdf>  pdfs;
+        double                            dauerMs;      // Vom Auftrag bis zum fertigen Beleg
+    };
+
+    /** @brief Kennzahlen seit Erzeugung der Instanz */
+    struct Kennzahlen
+    {
+        uint64_t beauftragt;
+        uint64_t fertig;
+        uint64_t fehlgeschlagen;
+        size_t   wartend;
+    };
+
+    /**
+     * @param ericMt
+     *        Schnittstellenobjekt der Multithreading-API.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricNachdruck, da diese eine Referenz darauf haelt!
+     * @param anzahlArbeiter
+     *        Anzahl der Druckthreads, mindestens 1
+     * @param phasenzeiten
+     *        Nimmt, falls angegeben, die Phasendauern der Druckdurchlaeufe auf.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricNachdruck, da diese eine Referenz darauf haelt!
+     * @param mitschnitt
+     *        Schneidet, falls angegeben, langsame Druckdurchlaeufe mit; wirkt nur zusammen mit phasenzeiten.
+     *        Fuer die Lebensdauer gilt dasselbe wie fuer phasenzeiten.
+     */
+    EricNachdruck(const EricMt &ericMt, size_t anzahlArbeiter, EricPhasenzeiten *phasenzeiten = nullptr,
+                  EricMitschnitt *mitschnitt = nullptr);
+
+    /** @brief Arbeitet alle erteilten Auftraege ab und beendet die Druckthreads */
+    virtual ~EricNachdruck();
+
+    /** @brief Stellt den Druck eines versendeten Datensatzes in die Warteschlange
+      *
+      * @param mandant Mandant, dem EricKosten den Druck zurechnet
+      *
+      * @return false, wenn zu diesem Transferticket bereits ein Auftrag besteht
+      */
+    bool beauftrage(const std::string &transferticket, const std::string &xmlDaten, const std::string &datenartVersion,
+                    const std::string &mandant);
+
+    /** @brief Liefert den Status und, falls vorhanden, den Beleg, ohne zu warten */
+    Status abfrage(const std::string &transferticket, std::shared_ptr<const Beleg> &beleg) const;
+
+    /** @brief Wartet, bis der Auftrag zum Transferticket abgeschlossen ist */
+    Status warte(const std::string &transferticket, std::shared_ptr<const Beleg> &beleg) const;
+
+    /** @brief Gibt den Beleg eines abgeschlossenen Auftrags frei */
+    void entferne(const std::string &transferticket);
+
+    Kennzahlen kennzahlen() const;
+
+    /** @brief Traegt das Transferticket in den Transferheader des Datensatzes ein
+      *
+      * Ein vorhandenes Element TransferTicket wird ersetzt, sonst wird es
+      * nach dem Element Vorgang eingefuegt. Das Element erhaelt das
+      * Namensraumpraefix des Transferheaders, das Ticket wird XML-maskiert.
+      *
+      * @throw Anwendungsfehler, wenn der Datensatz keinen Transferheader mit Vorgang enthaelt
+      */
+    static std::string mitTransferticket(const std::string &xmlDaten, const std::string &transferticket);
+
+private:
+    EricNachdruck(const EricNachdruck &); // Kopien verboten
+    EricNachdruck &operator=(const EricNachdruck &); // Zuweisungen verboten
+
+    struct Auftrag
+    {
+        std::string                           transferticket;
+        std::string                           xmlDaten;
+        std::string                           datenartVersion;
+        std::string                           mandant;
+        std::chrono::steady_clock::time_point erteilt;
+    };
+
+    struct Eintrag
+    {
+        Status                       status;
+        std::shared_ptr<const Beleg> beleg;
+    };
+
+    void arbeite();
+    static std::shared_ptr<const Beleg> drucke(const EricMtInstanz &instanz, uint64_t vorgaengeDerInstanz, const Auftrag &auftrag,
+                                               EricPhasenzeiten *phasenzeiten, EricMitschnitt *mitschnitt);
+
+    const EricMt &                   ericMt;
+    EricPhasenzeiten *const          phasenzeiten;
+    EricMitschnitt *const            mitschnitt;
+
+    mutable std::mutex               sperre;
+    std::condition_variable          auftragVorhanden;
+    mutable std::condition_variable  auftragBeendet;
+    std::deque<Auftrag>              warteschlange;
+    std::map<std::string, Eintrag>   eintraege;
+    Kennzahlen                       statistik;
+    bool                             beenden;
+    std::vector<std::thread>         arbeiter;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "ericpdfsammler.h"
+
+
+EricPdfSammler::EricPdfSammler()
+    : empfangen(0), empfangenBytes(0)
+{ }
+
+EricPdfSammler::EricPdfSammler(const Senke &senke_)
+    : senke(senke_), empfangen(0), empfangenBytes(0)
+{ }
+
+EricPdfSammler::~EricPdfSammler()
+{ }
+
+void EricPdfSammler::trageEin(eric_druck_parameter_t &druckEinstellungen)
+{
+    druckEinstellungen.pdfName = nullptr;
+    druckEinstellungen.pdfCallback = &EricPdfSammler::pdfCallback;
+    druckEinstellungen.pdfCallbackBenutzerdaten = this;
+}
+
+eric_druck_parameter_t EricPdfSammler::holeDruckeinstellungen(bool vorschau)
+{
+    eric_druck_parameter_t druckEinstellungen = {};
+    druckEinstellungen.version     = 4;
+    druckEinstellungen.vorschau    = vorschau ? 1 : 0;
+    druckEinstellungen.duplexDruck = 0;
+    druckEinstellungen.fussText    = nullptr;
+    trageEin(druckEinstellungen);
+    return druckEinstellungen;
+}
+
+int STDCALL EricPdfSammler::pdfCallback(const char *pdfBezeichner, const BYTE *pdfDaten,
+                                        uint32_t pdfGroesse, void *benutzerDaten)
+{
+    EricPdfSammler *sammler = static_cast<EricPdfSammler *>(benutzerDaten);
+    if (nullptr == sammler || (nullptr == pdfDaten && pdfGroesse > 0))
+    {
+        return 1;
+    }
+
+    // Ausnahmen duerfen nicht in den ERiC gelangen; der Rueckgabewert wird dort protokolliert
+    try
+    {
+        const std::string bezeichner(pdfBezeichner != nullptr ? pdfBezeichner : "");
+        const char *daten = reinterpret_cast<const char *>(pdfDaten);
+
+        ++sammler->empfangen;
+        sammler->empfangenBytes += pdfGroesse;
+        if (sammler->senke)
+        {
+            return sammler->senke(bezeichner, daten, pdfGroesse);
+        }
+
+        sammler->gesammelt.push_back(Pdf());
+        sammler->gesammelt.back().bezeichner = bezeichner;
+        sammler->gesammelt.back().daten.assign(daten, pdfGroesse);
+        return 0;
+    }
+    catch (...)
+    {
+        return 2;
+    }
+}
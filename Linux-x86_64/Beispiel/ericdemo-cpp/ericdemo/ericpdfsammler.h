@@ -0,0 +1,80 @@
+#ifndef _ERICPDFSAMMLER_H_
+#define _ERICPDFSAMMLER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <ericapi.h>
+
+
+/** @brief Nimmt die PDFs eines Vorgangs im Speicher entgegen, statt sie vom ERiC in Dateien schreiben zu lassen
+ *
+ * trageEin() setzt in den Druckparametern einen pdfCallback, der auf diese
+ * Instanz verweist, und entfernt den pdfName. Jeder Vorgang erhaelt seinen
+ * eigenen Sammler; gleichzeitige Vorgaenge schreiben damit weder in dieselbe
+ * Datei im Log-Verzeichnis noch ueberhaupt auf die Festplatte.
+ *
+ * Ohne Senke werden die PDFs in der Reihenfolge ihres Eintreffens gesammelt,
+ * mit Senke unmittelbar an diese weitergereicht und nicht zwischengespeichert.
+ */
+class EricPdfSammler
+{
+public:
+    /** @brief Ein vom ERiC erzeugtes PDF */
+    struct Pdf
+    {
+        std::string bezeichner;     // Nutzdatenticket oder "Uebertragungsprotokoll"
+        std::string daten;          // Binaerdaten des PDFs
+    };
+
+    /** @brief Empfaengt ein PDF direkt aus dem pdfCallback; liefert 0 bei Erfolg */
+    typedef std::function<int(const std::string &bezeichner, const char *daten, uint32_t groesse)> Senke;
+
+    /** @brief Sammelt die PDFs im Speicher */
+    EricPdfSammler();
+
+    /** @brief Reicht die PDFs an die Senke weiter */
+    explicit EricPdfSammler(const Senke &senke);
+
+    virtual ~EricPdfSammler();
+
+    /** @brief Leitet die PDF-Ausgabe der Druckparameter auf diese Instanz um
+      *
+      * Die Instanz muss mindestens so lange leben, wie die Druckparameter
+      * an den ERiC uebergeben werden, da der ERiC einen Zeiger darauf erhaelt!
+      */
+    void trageEin(eric_druck_parameter_t &druckEinstellungen);
+
+    /** @brief Die Druckeinstellungen des Beispiels, mit der PDF-Ausgabe an diese Instanz
+      *
+      * Alle Vorgaenge, Nachdrucke und Vorschauen drucken einseitig und ohne
+      * Fusstext; fuer trageEin() gilt derselbe Hinweis zur Lebensdauer.
+      *
+      * @param vorschau Als Vorschau mit Wasserzeichen drucken
+      */
+    eric_druck_parameter_t holeDruckeinstellungen(bool vorschau);
+
+    /** @brief Die gesammelten PDFs; bei einer Senke immer leer */
+    const std::vector<Pdf> &pdfs() const { return gesammelt; }
+
+    /** @brief Anzahl der empfangenen PDFs, auch der an die Senke weitergereichten */
+    size_t anzahl() const { return empfangen; }
+
+    /** @brief Summe der Groessen aller empfangenen PDFs in Bytes */
+    uint64_t bytes() const { return empfangenBytes; }
+
+private:
+    EricPdfSammler(const EricPdfSammler &); // Kopien verboten
+    EricPdfSammler &operator=(const EricPdfSammler &); // Zuweisungen verboten
+
+    static int STDCALL pdfCallback(const char *pdfBezeichner, const BYTE *pdfDaten,
+                                   uint32_t pdfGroesse, void *benutzerDaten);
+
+    const Senke      senke;
+    std::vector<Pdf> gesammelt;
+    size_t           empfangen;
+    uint64_t         empfangenBytes;
+};
+
+#endif
@@ -0,0 +1,230 @@
+#include "ericphasenzeiten.h"
+
+#include <algorithm>
+
+#include "ericmt.h"
+#include "ericspuren.h"
+
+
+namespace
+{
+
+/** @brief Phase zur ID eines Fortschrittcallbacks, -1 fuer unbekannte IDs */
+int phaseZurId(uint32_t id)
+{
+    switch (id)
+    {
+    case ERIC_FORTSCHRITTCALLBACK_ID_EINLESEN:
+        return EricPhasenzeiten::EINLESEN;
+    case ERIC_FORTSCHRITTCALLBACK_ID_VORBEREITEN:
+        return EricPhasenzeiten::VORBEREITEN;
+    case ERIC_FORTSCHRITTCALLBACK_ID_VALIDIEREN:
+        return EricPhasenzeiten::VALIDIEREN;
+    case ERIC_FORTSCHRITTCALLBACK_ID_SENDEN:
+        return EricPhasenzeiten::SENDEN;
+    case ERIC_FORTSCHRITTCALLBACK_ID_DRUCKEN:
+        return EricPhasenzeiten::DRUCKEN;
+    default:
+        return -1;
+    }
+}
+
+double millisekunden(std::chrono::steady_clock::duration dauer)
+{
+    return std::chrono::duration<double, std::milli>(dauer).count();
+}
+
+} // anonymous namespace
+
+
+void EricPhasenzeiten::Histogramm::trageEin(double dauerMs)
+{
+    size_t klasse = 0;
+    for (double grenzeUs = 2.0; klasse + 1 < ANZAHL_KLASSEN && dauerMs * 1000.0 >= grenzeUs; grenzeUs *= 2.0)
+    {
+        ++klasse;
+    }
+    ++klassen[klasse];
+    ++anzahl;
+    summeMs += dauerMs;
+    maxMs = std::max(maxMs, dauerMs);
+}
+
+double EricPhasenzeiten::Histogramm::quantilMs(double q) const
+{
+    if (anzahl == 0)
+    {
+        return 0.0;
+    }
+    const uint64_t rang = std::max<uint64_t>(1, static_cast<uint64_t>(q * anzahl + 0.5));
+    uint64_t kumuliert = 0;
+    double obergrenzeMs = 0.002;
+    for (size_t klasse = 0; klasse < ANZAHL_KLASSEN; ++klasse, obergrenzeMs *= 2.0)
+    {
+        kumuliert += klassen[klasse];
+        if (kumuliert >= rang)
+        {
+            break;
+        }
+    }
+    return std::min(obergrenzeMs, maxMs);
+}
+
+
+EricPhasenzeiten::Messung::Messung(EricPhasenzeiten &phasenzeiten_, const std::string &datenartVersion_)
+    : phasenzeiten(phasenzeiten_),
+      datenart(EricPhasenzeiten::datenart(datenartVersion_)),
+      instanz(nullptr),
+      start(std::chrono::steady_clock::now()),
+      phasenStart(start),
+      aktivePhase(-1),
+      durchlaufen(),
+      dauerMs(),
+      unbekannteIds(0),
+      abgeschlossen(false)
+{ }
+
+EricPhasenzeiten::Messung::Messung(EricPhasenzeiten &phasenzeiten_, const std::string &datenartVersion_, const EricMtInstanz &instanz_)
+    : phasenzeiten(phasenzeiten_),
+      datenart(EricPhasenzeiten::datenart(datenartVersion_)),
+      instanz(&instanz_),
+      start(std::chrono::steady_clock::now()),
+      phasenStart(start),
+      aktivePhase(-1),
+      durchlaufen(),
+      dauerMs(),
+      unbekannteIds(0),
+      abgeschlossen(false)
+{
+    instanz->api().EricMtRegistriereFortschrittCallback(instanz->handle(), fortschrittCallback, this);
+}
+
+EricPhasenzeiten::Messung::~Messung()
+{
+    if (instanz)
+    {
+        instanz->api().EricMtRegistriereFortschrittCallback(instanz->handle(), nullptr, nullptr);
+    }
+    try
+    {
+        abschliessen();
+    }
+    catch (...)
+    {
+        // Eine verlorene Messung darf den Vorgang nicht abbrechen
+    }
+}
+
+void EricPhasenzeiten::Messung::fortschritt(uint32_t id, uint32_t pos, uint32_t max)
+{
+    if (abgeschlossen)
+    {
+        return;
+    }
+    const std::chrono::steady_clock::time_point jetzt = std::chrono::steady_clock::now();
+    const int phase = phaseZurId(id);
+    if (phase < 0)
+    {
+        ++unbekannteIds;
+        return;
+    }
+
+    if (phase != aktivePhase)
+    {
+        beendePhase(jetzt);
+        aktivePhase = phase;
+        phasenStart = jetzt;
+        durchlaufen[phase] = true;
+    }
+    if (pos >= max)
+    {
+        beendePhase(jetzt);
+    }
+}
+
+void EricPhasenzeiten::Messung::abschliessen()
+{
+    if (abgeschlossen)
+    {
+        return;
+    }
+    const std::chrono::steady_clock::time_point jetzt = std::chrono::steady_clock::now();
+    beendePhase(jetzt);
+    abgeschlossen = true;
+    durchlaufen[GESAMT] = true;
+    dauerMs[GESAMT] = millisekunden(jetzt - start);
+
+    std::lock_guard<std::mutex> lock(phasenzeiten.sperre);
+    Verteilung &verteilung = phasenzeiten.statistik.datenarten[datenart];
+    for (int phase = EINLESEN; phase < GESAMT; ++phase)
+    {
+        if (durchlaufen[phase])
+        {
+            verteilung.phasen[phase].trageEin(dauerMs[phase]);
+        }
+    }
+    verteilung.phasen[GESAMT].trageEin(dauerMs[GESAMT]);
+    ++phasenzeiten.statistik.messungen;
+    phasenzeiten.statistik.unbekannteIds += unbekannteIds;
+}
+
+double EricPhasenzeiten::Messung::phasendauerMs(Phase phase) const
+{
+    return abgeschlossen && durchlaufen[phase] ? dauerMs[phase] : -1.0;
+}
+
+void STDCALL EricPhasenzeiten::Messung::fortschrittCallback(uint32_t id, uint32_t pos, uint32_t max, void *benutzerdaten)
+{
+    static_cast<Messung *>(benutzerdaten)->fortschritt(id, pos, max);
+}
+
+void EricPhasenzeiten::Messung::beendePhase(std::chrono::steady_clock::time_point jetzt)
+{
+    if (aktivePhase >= 0)
+    {
+        // Wiederholte Phasen, etwa mehrere Validierungen, werden addiert
+        dauerMs[aktivePhase] += millisekunden(jetzt - phasenStart);
+        EricSpuren::zeichneAuf(bezeichnung(static_cast<Phase>(aktivePhase)), phasenStart, jetzt);
+        aktivePhase = -1;
+    }
+}
+
+
+EricPhasenzeiten::EricPhasenzeiten()
+    : statistik()
+{ }
+
+EricPhasenzeiten::~EricPhasenzeiten()
+{ }
+
+EricPhasenzeiten::Kennzahlen EricPhasenzeiten::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    return statistik;
+}
+
+std::string EricPhasenzeiten::datenart(const std::string &datenartVersion)
+{
+    return datenartVersion.substr(0, datenartVersion.find('_'));
+}
+
+const char *EricPhasenzeiten::bezeichnung(Phase phase)
+{
+    switch (phase)
+    {
+    case EINLESEN:
+        return "XML einlesen";
+    case VORBEREITEN:
+        return "Versand vorbereiten";
+    case VALIDIEREN:
+        return "Validieren";
+    case SENDEN:
+        return "Versenden";
+    case DRUCKEN:
+        return "Drucken";
+    case GESAMT:
+        return "Gesamt";
+    default:
+        return "";
+    }
+}
@@ -0,0 +1,149 @@
+#ifndef _ERICPHASENZEITEN_H_
+#define _ERICPHASENZEITEN_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <eric_types.h>
+
+// Vorwaertsdeklarationen
+class EricMtInstanz;
+
+
+/** @brief Misst die Bearbeitungsphasen von Vorgaengen anhand der Fortschrittcallbacks des ERiC
+ *
+ * Eine Messung begleitet einen Aufruf von EricBearbeiteVorgang() oder
+ * EricMtBearbeiteVorgang() und haelt jeden Fortschrittcallback mit einer
+ * monotonen Uhr fest. Eine Phase beginnt mit ihrem ersten Callback und endet
+ * mit pos == max oder dem ersten Callback einer anderen Phase. Beim Abschluss
+ * traegt die Messung die Dauer jeder durchlaufenen Phase und die Gesamtdauer
+ * in die Histogramme ihrer Datenart ein.
+ *
+ * Nur die Phase SENDEN enthaelt die Wartezeit auf die ELSTER-Annahmeserver,
+ * alle anderen Phasen laufen auf dem eigenen Rechner.
+ */
+class EricPhasenzeiten
+{
+public:
+    enum Phase
+    {
+        EINLESEN,
+        VORBEREITEN,
+        VALIDIEREN,
+        SENDEN,
+        DRUCKEN,
+        GESAMT,         // Von der Erzeugung bis zum Abschluss der Messung
+        ANZAHL_PHASEN
+    };
+
+    /** @brief Histogramm mit Klassen von 2^k bis unter 2^(k+1) Mikrosekunden */
+    struct Histogramm
+    {
+        static const size_t ANZAHL_KLASSEN = 28;    // Die letzte Klasse ist nach oben offen
+
+        uint64_t anzahl;
+        double   summeMs;
+        double   maxMs;
+        uint64_t klassen[ANZAHL_KLASSEN];
+
+        void trageEin(double dauerMs);
+
+        /** @brief Obergrenze der Klasse, in die das Quantil q faellt, hoechstens maxMs */
+        double quantilMs(double q) const;
+
+        double mittelMs() const { return anzahl > 0 ? summeMs / anzahl : 0.0; }
+    };
+
+    /** @brief Histogramme aller Phasen einer Datenart */
+    struct Verteilung
+    {
+        Histogramm phasen[ANZAHL_PHASEN];
+    };
+
+    /** @brief Kennzahlen seit Erzeugung der Instanz */
+    struct Kennzahlen
+    {
+        uint64_t                          messungen;
+        uint64_t                          unbekannteIds;    // Callbacks mit einer nicht zugeordneten ID
+        std::map<std::string, Verteilung> datenarten;
+    };
+
+    /** @brief Messung eines einzelnen Vorgangs
+     *
+     * Die Messung wird nur von dem Thread benutzt, der den Vorgang ausfuehrt.
+     * Ohne Instanz muss der Aufrufer die Callbacks an fortschritt() weiterreichen,
+     * etwa weil der CallbackHandler den Fortschrittcallback der Singlethreading-API
+     * schon belegt.
+     */
+    class Messung
+    {
+    public:
+        /**
+         * @param phasenzeiten
+         *        Das uebergebene Objekt muss mindestens so lange leben, wie
+         *        die erzeugte Instanz der Klasse Messung, da diese eine Referenz darauf haelt!
+         */
+        Messung(EricPhasenzeiten &phasenzeiten, const std::string &datenartVersion);
+
+        /** @brief Meldet fortschrittCallback() fuer die Instanz an und im Destruktor wieder ab
+          *
+          * @param instanz
+          *        Das uebergebene Objekt muss mindestens so lange leben, wie
+          *        die erzeugte Instanz der Klasse Messung, da diese eine Referenz darauf haelt!
+          */
+        Messung(EricPhasenzeiten &phasenzeiten, const std::string &datenartVersion, const EricMtInstanz &instanz);
+
+        /** @brief Schliesst die Messung ab, falls das noch nicht geschehen ist */
+        virtual ~Messung();
+
+        void fortschritt(uint32_t id, uint32_t pos, uint32_t max);
+
+        /** @brief Traegt die Dauern ein, weitere Callbacks werden ignoriert */
+        void abschliessen();
+
+        /** @brief Dauer einer Phase nach abschliessen(), negativ fuer eine nicht durchlaufene Phase */
+        double phasendauerMs(Phase phase) const;
+
+        /** @brief Fortschrittcallback, benutzerdaten zeigt auf die Messung */
+        static void STDCALL fortschrittCallback(uint32_t id, uint32_t pos, uint32_t max, void *benutzerdaten);
+
+    private:
+        Messung(const Messung &); // Kopien verboten
+        Messung &operator=(const Messung &); // Zuweisungen verboten
+
+        void beendePhase(std::chrono::steady_clock::time_point jetzt);
+
+        EricPhasenzeiten &                          phasenzeiten;
+        const std::string                           datenart;
+        const EricMtInstanz *                       instanz;
+        const std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point       phasenStart;
+        int                                         aktivePhase;  // -1 ausserhalb einer Phase
+        bool                                        durchlaufen[ANZAHL_PHASEN];
+        double                                      dauerMs[ANZAHL_PHASEN];
+        uint64_t                                    unbekannteIds;
+        bool                                        abgeschlossen;
+    };
+
+    EricPhasenzeiten();
+
+    virtual ~EricPhasenzeiten();
+
+    Kennzahlen kennzahlen() const;
+
+    /** @brief Datenart ohne Version, z.B. "ESt" zu "ESt_2020" */
+    static std::string datenart(const std::string &datenartVersion);
+
+    static const char *bezeichnung(Phase phase);
+
+private:
+    EricPhasenzeiten(const EricPhasenzeiten &); // Kopien verboten
+    EricPhasenzeiten &operator=(const EricPhasenzeiten &); // Zuweisungen verboten
+
+    mutable std::mutex sperre;
+    Kennzahlen         statistik;
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include "ericpruefsummen.h"
+
+#include <algorithm>
+#include <cstring>
+#include <eric_fehlercodes.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PRUEFSUMMEN_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+
+// Zeilen je Block; acht 16-Bit-Werte fuellen ein SSE2-Register
+const size_t SPUREN = 8;
+
+const size_t IBAN_MIN_LAENGE = 15;
+const size_t IBAN_MAX_LAENGE = 34;
+
+/** @brief Laenderkennzeichen und Laenge der IBAN nach dem IBAN-Register, aufsteigend sortiert */
+struct IbanLand
+{
+    char     land[3];
+    unsigned laenge;
+};
+
+const IbanLand IBAN_LAENDER[] =
+{
+    { "AD", 24 }, { "AE", 23 }, { "AL", 28 }, { "AT", 20 }, { "AZ", 28 }, { "BA", 20 }, { "BE", 16 }, { "BG", 22 },
+    { "BH", 22 }, { "BR", 29 }, { "BY", 28 }, { "CH", 21 }, { "CR", 22 }, { "CY", 28 }, { "CZ", 24 }, { "DE", 22 },
+    { "DK", 18 }, { "DO", 28 }, { "EE", 20 }, { "EG", 29 }, { "ES", 24 }, { "FI", 18 }, { "FO", 18 }, { "FR", 27 },
+    { "GB", 22 }, { "GE", 22 }, { "GI", 23 }, { "GL", 18 }, { "GR", 27 }, { "GT", 28 }, { "HR", 21 }, { "HU", 28 },
+    { "IE", 22 }, { "IL", 23 }, { "IQ", 23 }, { "IS", 26 }, { "IT", 27 }, { "JO", 30 }, { "KW", 30 }, { "KZ", 20 },
+    { "LB", 28 }, { "LC", 32 }, { "LI", 21 }, { "LT", 20 }, { "LU", 20 }, { "LV", 21 }, { "MC", 27 }, { "MD", 24 },
+    { "ME", 22 }, { "MK", 19 }, { "MR", 27 }, { "MT", 31 }, { "MU", 30 }, { "NL", 18 }, { "NO", 15 }, { "PK", 24 },
+    { "PL", 28 }, { "PS", 29 }, { "PT", 25 }, { "QA", 29 }, { "RO", 24 }, { "RS", 22 }, { "SA", 24 }, { "SC", 31 },
+    { "SE", 24 }, { "SI", 19 }, { "SK", 24 }, { "SM", 27 }, { "ST", 25 }, { "SV", 28 }, { "TL", 23 }, { "TN", 24 },
+    { "TR", 26 }, { "UA", 29 }, { "VA", 22 }, { "VG", 24 }, { "XK", 20 }
+};
+
+/** @brief Erste zwei Stellen der 13-stelligen Steuernummer je Bundesland; NRW (5) und Bayern (9) sind einstellig */
+const uint16_t STEUERNUMMER_PRAEFIXE[] = { 10, 11, 21, 22, 23, 24, 26, 27, 28, 30, 31, 32, 40, 41 };
+
+bool istZiffer(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool istGrossbuchstabe(char c)
+{
+    return c >= 'A' && c <= 'Z';
+}
+
+bool kleinerLand(const IbanLand &eintrag, const char *land)
+{
+    return std::memcmp(eintrag.land, land, 2) < 0;
+}
+
+/** @brief Laenge der IBAN zum Laenderkennzeichen, 0 bei unbekanntem Land */
+unsigned ibanLaenge(const char *land)
+{
+    const IbanLand *ende = IBAN_LAENDER + sizeof(IBAN_LAENDER) / sizeof(IBAN_LAENDER[0]);
+    const IbanLand *fund = std::lower_bound(IBAN_LAENDER, ende, land, kleinerLand);
+    return fund != ende && 0 == std::memcmp(fund->land, land, 2) ? fund->laenge : 0;
+}
+
+/** @brief Rest modulo 97 einer IBAN, deren Stellen je Spur als Faktor und Summand vorliegen
+  *
+  * Jede Stelle fuehrt rest = (rest * faktor + summand) % 97 aus, mit Faktor 10
+  * fuer Ziffern, 100 fuer Buchstaben und 1 fuer Stellen hinter dem Ende der
+  * Zeile. Alle Zwischenwerte bleiben unter 9736 und passen in 16 Bit.
+  */
+void ibanRest(const uint16_t faktor[][SPUREN], const uint16_t summand[][SPUREN], size_t stellen, uint16_t rest[SPUREN])
+{
+#ifdef PRUEFSUMMEN_SSE2
+    const __m128i siebenundneunzig = _mm_set1_epi16(97);
+    // floor(x * 675 / 2^16) unterschaetzt x / 97 fuer x < 9736 um hoechstens 1
+    const __m128i kehrwert = _mm_set1_epi16(675);
+    __m128i r = _mm_setzero_si128();
+    for (size_t k = 0; k < stellen; ++k)
+    {
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(faktor[k]));
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(summand[k]));
+        const __m128i x = _mm_add_epi16(_mm_mullo_epi16(r, f), s);
+        const __m128i q = _mm_mulhi_epu16(x, kehrwert);
+        r = _mm_sub_epi16(x, _mm_mullo_epi16(q, siebenundneunzig));
+        r = _mm_sub_epi16(r, _mm_and_si128(_mm_cmpgt_epi16(r, _mm_set1_epi16(96)), siebenundneunzig));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(rest), r);
+#else
+    for (size_t spur = 0; spur < SPUREN; ++spur)
+    {
+        unsigned r = 0;
+        for (size_t k = 0; k < stellen; ++k)
+        {
+            r = (r * faktor[k][spur] + summand[k][spur]) % 97;
+        }
+        rest[spur] = static_cast<uint16_t>(r);
+    }
+#endif
+}
+
+/** @brief Pruefziffer der Identifikationsnummer nach ISO 7064, MOD 11,10 ueber die ersten zehn Ziffern je Spur */
+void idNrPruefziffer(const uint16_t ziffern[][SPUREN], uint16_t pruefziffer[SPUREN])
+{
+#ifdef PRUEFSUMMEN_SSE2
+    const __m128i zehn = _mm_set1_epi16(10);
+    const __m128i elf = _mm_set1_epi16(11);
+    const __m128i null = _mm_setzero_si128();
+    __m128i produkt = zehn;
+    for (size_t k = 0; k < 10; ++k)
+    {
+        __m128i summe = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ziffern[k])), produkt);
+        summe = _mm_sub_epi16(summe, _mm_and_si128(_mm_cmpgt_epi16(summe, _mm_set1_epi16(9)), zehn));
+        summe = _mm_or_si128(summe, _mm_and_si128(_mm_cmpeq_epi16(summe, null), zehn));
+        produkt = _mm_slli_epi16(summe, 1);
+        produkt = _mm_sub_epi16(produkt, _mm_and_si128(_mm_cmpgt_epi16(produkt, zehn), elf));
+    }
+    __m128i ziffer = _mm_sub_epi16(elf, produkt);
+    ziffer = _mm_andnot_si128(_mm_cmpeq_epi16(ziffer, zehn), ziffer);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pruefziffer), ziffer);
+#else
+    for (size_t spur = 0; spur < SPUREN; ++spur)
+    {
+        unsigned produkt = 10;
+        for (size_t k = 0; k < 10; ++k)
+        {
+            unsigned summe = (ziffern[k][spur] + produkt) % 10;
+            if (0 == summe)
+                summe = 10;
+            produkt = (summe * 2) % 11;
+        }
+        const unsigned ziffer = 11 - produkt;
+        pruefziffer[spur] = static_cast<uint16_t>(10 == ziffer ? 0 : ziffer);
+    }
+#endif
+}
+
+/** @brief Prueft je Spur Landespraefix und die fuenfte Stelle 0 einer Steuernummer */
+void steuernummerPraefix(const uint16_t ziffern[][SPUREN], uint16_t gueltig[SPUREN])
+{
+#ifdef PRUEFSUMMEN_SSE2
+    const __m128i erste = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ziffern[0]));
+    const __m128i praefix = _mm_add_epi16(_mm_mullo_epi16(erste, _mm_set1_epi16(10)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(ziffern[1])));
+    __m128i treffer = _mm_or_si128(_mm_cmpeq_epi16(erste, _mm_set1_epi16(5)), _mm_cmpeq_epi16(erste, _mm_set1_epi16(9)));
+    for (size_t i = 0; i < sizeof(STEUERNUMMER_PRAEFIXE) / sizeof(STEUERNUMMER_PRAEFIXE[0]); ++i)
+    {
+        treffer = _mm_or_si128(treffer, _mm_cmpeq_epi16(praefix, _mm_set1_epi16(static_cast<short>(STEUERNUMMER_PRAEFIXE[i]))));
+    }
+    const __m128i fuenfte = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ziffern[4]));
+    treffer = _mm_and_si128(treffer, _mm_cmpeq_epi16(fuenfte, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(gueltig), treffer);
+#else
+    const uint16_t *ende = STEUERNUMMER_PRAEFIXE + sizeof(STEUERNUMMER_PRAEFIXE) / sizeof(STEUERNUMMER_PRAEFIXE[0]);
+    for (size_t spur = 0; spur < SPUREN; ++spur)
+    {
+        const uint16_t praefix = static_cast<uint16_t>(ziffern[0][spur] * 10 + ziffern[1][spur]);
+        const bool land = 5 == ziffern[0][spur] || 9 == ziffern[0][spur] || std::find(STEUERNUMMER_PRAEFIXE, ende, praefix) != ende;
+        gueltig[spur] = land && 0 == ziffern[4][spur] ? 0xFFFF : 0;
+    }
+#endif
+}
+
+/** @brief Regeln zur Haeufigkeit der Ziffern in den ersten zehn Stellen der Identifikationsnummer
+  *
+  * Genau eine Ziffer kommt zwei- oder dreimal vor, alle anderen hoechstens
+  * einmal, und keine Ziffer steht dreimal unmittelbar hintereinander.
+  */
+bool idNrZiffernVerteilung(const char *idNr)
+{
+    unsigned anzahl[10] = { 0 };
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ++anzahl[idNr[i] - '0'];
+        if (i >= 2 && idNr[i] == idNr[i - 1] && idNr[i] == idNr[i - 2])
+            return false;
+    }
+
+    unsigned mehrfach = 0;
+    for (size_t z = 0; z < 10; ++z)
+    {
+        if (anzahl[z] > 3)
+            return false;
+        if (anzahl[z] > 1)
+            ++mehrfach;
+    }
+    return 1 == mehrfach;
+}
+
+} // anonymous namespace
+
+
+void EricPruefsummen::pruefeIBAN(const Spalte &spalte, int *rc)
+{
+    uint16_t faktor[IBAN_MAX_LAENGE][SPUREN];
+    uint16_t summand[IBAN_MAX_LAENGE][SPUREN];
+    uint16_t rest[SPUREN];
+
+    for (size_t anfang = 0; anfang < spalte.zeilen(); anfang += SPUREN)
+    {
+        const size_t anzahl = std::min(SPUREN, spalte.zeilen() - anfang);
+        size_t stellen = 0;
+
+        for (size_t spur = 0; spur < SPUREN; ++spur)
+        {
+            for (size_t k = 0; k < IBAN_MAX_LAENGE; ++k)
+            {
+                faktor[k][spur] = 1;
+                summand[k][spur] = 0;
+            }
+            if (spur >= anzahl)
+                continue;
+
+            const char *iban = spalte.zeile(anfang + spur);
+            const size_t laenge = spalte.laenge(anfang + spur);
+            int &ergebnis = rc[anfang + spur];
+            ergebnis = ERIC_OK;
+
+            if (laenge < IBAN_MIN_LAENGE || laenge > IBAN_MAX_LAENGE
+                || !istGrossbuchstabe(iban[0]) || !istGrossbuchstabe(iban[1]) || !istZiffer(iban[2]) || !istZiffer(iban[3]))
+            {
+                ergebnis = ERIC_GLOBAL_IBAN_FORMALER_FEHLER;
+                continue;
+            }
+            for (size_t i = 4; i < laenge && ERIC_OK == ergebnis; ++i)
+            {
+                if (!istZiffer(iban[i]) && !istGrossbuchstabe(iban[i]))
+                    ergebnis = ERIC_GLOBAL_IBAN_FORMALER_FEHLER;
+            }
+            if (ERIC_OK != ergebnis)
+                continue;
+
+            const unsigned landesLaenge = ibanLaenge(iban);
+            if (0 == landesLaenge)
+            {
+                ergebnis = ERIC_GLOBAL_IBAN_LAENDERCODE_FEHLER;
+                continue;
+            }
+            if (landesLaenge != laenge)
+            {
+                ergebnis = ERIC_GLOBAL_IBAN_LANDESFORMAT_FEHLER;
+                continue;
+            }
+
+            // Laenderkennzeichen und Pruefziffer wandern ans Ende
+            for (size_t k = 0; k < laenge; ++k)
+            {
+                const char c = iban[(k + 4) % laenge];
+                faktor[k][spur] = istZiffer(c) ? 10 : 100;
+                summand[k][spur] = static_cast<uint16_t>(istZiffer(c) ? c - '0' : c - 'A' + 10);
+            }
+            stellen = std::max(stellen, laenge);
+        }
+
+        ibanRest(faktor, summand, stellen, rest);
+        for (size_t spur = 0; spur < anzahl; ++spur)
+        {
+            if (ERIC_OK == rc[anfang + spur] && 1 != rest[spur])
+                rc[anfang + spur] = ERIC_GLOBAL_IBAN_PRUEFZIFFER_FEHLER;
+        }
+    }
+}
+
+void EricPruefsummen::pruefeIdentifikationsMerkmal(const Spalte &spalte, int *rc)
+{
+    uint16_t ziffern[11][SPUREN];
+    uint16_t pruefziffer[SPUREN];
+
+    for (size_t anfang = 0; anfang < spalte.zeilen(); anfang += SPUREN)
+    {
+        const size_t anzahl = std::min(SPUREN, spalte.zeilen() - anfang);
+
+        for (size_t spur = 0; spur < SPUREN; ++spur)
+        {
+            for (size_t k = 0; k < 11; ++k)
+                ziffern[k][spur] = 0;
+            if (spur >= anzahl)
+                continue;
+
+            const char *idNr = spalte.zeile(anfang + spur);
+            int &ergebnis = rc[anfang + spur];
+            ergebnis = 11 == spalte.laenge(anfang + spur) ? ERIC_OK : ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+            for (size_t k = 0; k < 11 && ERIC_OK == ergebnis; ++k)
+            {
+                if (!istZiffer(idNr[k]))
+                    ergebnis = ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+            }
+            if (ERIC_OK != ergebnis || !idNrZiffernVerteilung(idNr))
+            {
+                ergebnis = ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+                continue;
+            }
+
+            for (size_t k = 0; k < 11; ++k)
+                ziffern[k][spur] = static_cast<uint16_t>(idNr[k] - '0');
+        }
+
+        idNrPruefziffer(ziffern, pruefziffer);
+        for (size_t spur = 0; spur < anzahl; ++spur)
+        {
+            if (ERIC_OK == rc[anfang + spur] && pruefziffer[spur] != ziffern[10][spur])
+                rc[anfang + spur] = ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+        }
+    }
+}
+
+void EricPruefsummen::pruefeSteuernummer(const Spalte &spalte, int *rc)
+{
+    uint16_t ziffern[5][SPUREN];
+    uint16_t gueltig[SPUREN];
+
+    for (size_t anfang = 0; anfang < spalte.zeilen(); anfang += SPUREN)
+    {
+        const size_t anzahl = std::min(SPUREN, spalte.zeilen() - anfang);
+
+        for (size_t spur = 0; spur < SPUREN; ++spur)
+        {
+            for (size_t k = 0; k < 5; ++k)
+                ziffern[k][spur] = 0;
+            if (spur >= anzahl)
+                continue;
+
+            const char *steuernummer = spalte.zeile(anfang + spur);
+            int &ergebnis = rc[anfang + spur];
+            ergebnis = 13 == spalte.laenge(anfang + spur) ? ERIC_OK : ERIC_GLOBAL_STEUERNUMMER_FALSCHE_LAENGE;
+            for (size_t k = 0; k < 13 && ERIC_OK == ergebnis; ++k)
+            {
+                if (!istZiffer(steuernummer[k]))
+                    ergebnis = ERIC_GLOBAL_STEUERNUMMER_NICHT_NUMERISCH;
+            }
+            if (ERIC_OK != ergebnis)
+                continue;
+
+            for (size_t k = 0; k < 5; ++k)
+                ziffern[k][spur] = static_cast<uint16_t>(steuernummer[k] - '0');
+        }
+
+        steuernummerPraefix(ziffern, gueltig);
+        for (size_t spur = 0; spur < anzahl; ++spur)
+        {
+            if (ERIC_OK == rc[anfang + spur] && 0 == gueltig[spur])
+                rc[anfang + spur] = ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG;
+        }
+    }
+}
+
+EricPruefsummen::Vergleich EricPruefsummen::vergleiche(const std::vector<int> &hier, const std::vector<int> &toolkit)
+{
+    Vergleich vergleich = Vergleich();
+    vergleich.zeilen = std::min(hier.size(), toolkit.size());
+    vergleich.ersteAbweichung = static_cast<size_t>(vergleich.zeilen);
+
+    for (size_t i = 0; i < vergleich.zeilen; ++i)
+    {
+        if (hier[i] == toolkit[i])
+        {
+            ++vergleich.uebereinstimmend;
+        }
+        else if (ERIC_OK == hier[i])
+        {
+            ++vergleich.nurToolkitAbgewiesen;
+        }
+        else if (ERIC_OK == toolkit[i])
+        {
+            ++vergleich.nurHierAbgewiesen;
+            vergleich.ersteAbweichung = std::min(vergleich.ersteAbweichung, i);
+        }
+        else
+        {
+            ++vergleich.andererFehlercode;
+        }
+    }
+    return vergleich;
+}
@@ -0,0 +1,92 @@
+#ifndef _ERICPRUEFSUMMEN_H_
+#define _ERICPRUEFSUMMEN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/** @brief Pruefung ganzer Spalten von IBAN, Identifikationsnummern und Steuernummern ohne ERiC-Toolkit
+ *
+ * Die Pruefungen entsprechen EtkPruefeIBAN(), EtkPruefeIdentifikationsMerkmal()
+ * und den formalen Regeln von EtkPruefeSteuernummer() und liefern deren
+ * Fehlercodes: fuer Steuernummern mit falscher Laenge oder anderen Zeichen als
+ * Ziffern die spezifischen Codes ERIC_GLOBAL_STEUERNUMMER_FALSCHE_LAENGE und
+ * ERIC_GLOBAL_STEUERNUMMER_NICHT_NUMERISCH, fuer ein ungueltiges Landespraefix
+ * ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG. Sie arbeiten auf Bloecken von acht Zeilen: Zeichen und Laenge
+ * jeder Zeile werden einzeln geprueft, die Pruefziffernrechnung laeuft
+ * dagegen mit SSE2 fuer alle Zeilen eines Blocks gleichzeitig. Ohne SSE2
+ * wird dieselbe Rechnung Zeile fuer Zeile ausgefuehrt.
+ *
+ * Nicht abgedeckt sind die laenderspezifischen BBAN-Formate der IBAN und die
+ * landesspezifischen Pruefziffern der Steuernummer. Eine Zeile, die hier
+ * abgewiesen wird, weist auch das Toolkit ab; fuer die uebrigen Zeilen bleibt
+ * die Toolkit-Pruefung massgeblich, siehe EricPruefsummen::vergleiche().
+ */
+class EricPruefsummen
+{
+public:
+    /** @brief Spalte von Zeichenketten in einem zusammenhaengenden Textblock
+     *
+     * Zeile i umfasst daten[versatz[i]] bis ausschliesslich daten[versatz[i + 1]];
+     * versatz hat also zeilen() + 1 Eintraege.
+     */
+    class Spalte
+    {
+    public:
+        Spalte() : versatz(1, 0) { }
+
+        void haengeAn(const char *wert, size_t laenge)
+        {
+            daten.append(wert, laenge);
+            versatz.push_back(static_cast<uint32_t>(daten.size()));
+        }
+
+        size_t      zeilen()               const { return versatz.size() - 1; }
+        const char *zeile(size_t i)        const { return daten.data() + versatz[i]; }
+        size_t      laenge(size_t i)       const { return versatz[i + 1] - versatz[i]; }
+        std::string text(size_t i)         const { return std::string(zeile(i), laenge(i)); }
+
+    private:
+        std::string           daten;
+        std::vector<uint32_t> versatz;
+    };
+
+    /** @brief Prueft jede Zeile wie EtkPruefeIBAN(), ohne die laenderspezifischen BBAN-Formate
+      *
+      * @param rc Erhaelt je Zeile ERIC_OK oder ERIC_GLOBAL_IBAN_*; mindestens spalte.zeilen() Eintraege
+      */
+    static void pruefeIBAN(const Spalte &spalte, int *rc);
+
+    /** @brief Prueft jede Zeile wie EtkPruefeIdentifikationsMerkmal()
+      *
+      * @param rc Erhaelt je Zeile ERIC_OK oder ERIC_GLOBAL_IDNUMMER_UNGUELTIG
+      */
+    static void pruefeIdentifikationsMerkmal(const Spalte &spalte, int *rc);
+
+    /** @brief Prueft Laenge, Ziffern und Landespraefix 13-stelliger Steuernummern im ELSTER-Format
+      *
+      * Die Pruefziffer wird nicht geprueft.
+      *
+      * @param rc Erhaelt je Zeile ERIC_OK, ERIC_GLOBAL_STEUERNUMMER_FALSCHE_LAENGE,
+      *           ERIC_GLOBAL_STEUERNUMMER_NICHT_NUMERISCH oder ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG
+      */
+    static void pruefeSteuernummer(const Spalte &spalte, int *rc);
+
+    /** @brief Ergebnis des Vergleichs mit den Toolkit-Funktionen */
+    struct Vergleich
+    {
+        uint64_t zeilen;
+        uint64_t uebereinstimmend;      // Beide gueltig oder beide mit demselben Fehlercode
+        uint64_t andererFehlercode;     // Beide ungueltig, aber mit verschiedenen Fehlercodes
+        uint64_t nurToolkitAbgewiesen;  // Erwartet bei nicht abgedeckten Regeln
+        uint64_t nurHierAbgewiesen;     // Darf nicht vorkommen
+        size_t   ersteAbweichung;       // Zeile der ersten Abweichung nurHierAbgewiesen, sonst zeilen
+    };
+
+    /** @brief Vergleicht die Ergebnisse einer Spalte mit denen der Toolkit-Funktion */
+    static Vergleich vergleiche(const std::vector<int> &hier, const std::vector<int> &toolkit);
+};
+
+#endif
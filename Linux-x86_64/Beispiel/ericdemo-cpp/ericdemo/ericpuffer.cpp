@@ -1,5 +1,6 @@
 #include "ericpuffer.h"
 #include "anwendungsfehler.h"
+#include "ericmetriken.h"
 #include "system.h"
 
 #include <algorithm>
@@ -13,6 +14,7 @@ EricPuffer::EricPuffer(const Eric& eric) : mEricAdapter(eric)
     if(mPufferHandle == nullptr) {
         throw Anwendungsfehler("Erzeugung des Rueckgabepuffers fehlgeschlagen.");
     }
+    EricMetriken::instanz().veraendere("eric_rueckgabepuffer_belegt", "api=\"st\"", 1);
 }
 
 EricPuffer::~EricPuffer()
@@ -21,6 +23,7 @@ EricPuffer::~EricPuffer()
     if(rc != 0) {
         std::cerr << "Freigeben des Rueckgabepuffers fehlgeschlagen." << std::endl;
     }
+    EricMetriken::instanz().veraendere("eric_rueckgabepuffer_belegt", "api=\"st\"", -1);
 }
 
 EricRueckgabepufferHandle EricPuffer::handle() const
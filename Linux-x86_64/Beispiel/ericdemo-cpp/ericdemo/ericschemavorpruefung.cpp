@@ -0,0 +1,60 @@
+#include "ericschemavorpruefung.h"
+
+#include <chrono>
+#include <eric_fehlercodes.h>
+
+#include "eric.h"
+#include "ericpuffer.h"
+
+
+EricSchemaVorpruefung::EricSchemaVorpruefung(const Eric &eric_) : eric(eric_), statistik()
+{ }
+
+EricSchemaVorpruefung::~EricSchemaVorpruefung()
+{ }
+
+int EricSchemaVorpruefung::pruefe(const std::string &xml, const std::string &datenartVersion, std::string &fehlertext)
+{
+    EricPuffer fehlertextPuffer(eric);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int rc = eric.EricCheckXML(xml.c_str(), datenartVersion.c_str(), fehlertextPuffer.handle());
+    const double dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const bool abweisen = ERIC_IO_PARSE_FEHLER == rc || ERIC_IO_READER_SCHEMA_VALIDIERUNGSFEHLER == rc;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.vorpruefungen;
+        statistik.vorpruefungMs += dauerMs;
+        if (abweisen)
+        {
+            ++statistik.abgewiesen;
+        }
+        else if (ERIC_GLOBAL_FUNKTION_NICHT_UNTERSTUETZT == rc)
+        {
+            ++statistik.nichtUnterstuetzt;
+        }
+    }
+
+    if (!abweisen)
+    {
+        // Alle anderen Fehler meldet die vollstaendige Verarbeitung genauer
+        return ERIC_OK;
+    }
+
+    fehlertext.assign(fehlertextPuffer.inhalt(), fehlertextPuffer.laenge());
+    return rc;
+}
+
+void EricSchemaVorpruefung::erfasseVollverarbeitung(double dauerMs)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.vollverarbeitungen;
+    statistik.vollverarbeitungMs += dauerMs;
+}
+
+EricSchemaVorpruefung::Kennzahlen EricSchemaVorpruefung::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    return statistik;
+}
@@ -0,0 +1,86 @@
+#ifndef _ERICSCHEMAVORPRUEFUNG_H_
+#define _ERICSCHEMAVORPRUEFUNG_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Vorwaertsdeklarationen
+class Eric;
+
+
+/** @brief Vorgeschaltete, reine Schemapruefung eines Datensatzes
+ *
+ * EricCheckXML() prueft einen Datensatz nur gegen das XML-Schema der
+ * Datenartversion, ohne Plausibilitaetspruefung, Druck- oder
+ * Versandvorbereitung. Nicht wohlgeformte oder schemawidrige Datensaetze
+ * werden so abgewiesen, bevor EricBearbeiteVorgang() aufgerufen wird.
+ *
+ * Die Kennzahlen stellen die Dauer der Vorpruefungen der Dauer der
+ * vollstaendigen Verarbeitungen gegenueber. Daraus ergibt sich, wie viel
+ * Rechenzeit die Vorpruefung bei der tatsaechlichen Abweisungsquote spart.
+ */
+class EricSchemaVorpruefung
+{
+public:
+    /** @brief Kennzahlen zu Vorpruefung und vollstaendiger Verarbeitung */
+    struct Kennzahlen
+    {
+        uint64_t vorpruefungen;        // Aufrufe von EricCheckXML()
+        uint64_t abgewiesen;           // Davon wegen Parse- oder Schemafehler abgewiesen
+        uint64_t nichtUnterstuetzt;    // Datenartversionen ohne Schemavalidierung
+        double   vorpruefungMs;        // Gesamtdauer aller Vorpruefungen
+        uint64_t vollverarbeitungen;   // Aufrufe von EricBearbeiteVorgang() nach bestandener Vorpruefung
+        double   vollverarbeitungMs;   // Gesamtdauer dieser Aufrufe
+
+        /** @brief Geschaetzte eingesparte Rechenzeit: vermiedene Vollverarbeitungen abzueglich aller Vorpruefungen */
+        double geschaetzteErsparnisMs() const
+        {
+            if (0 == vollverarbeitungen)
+                return 0.0;
+            return abgewiesen * (vollverarbeitungMs / vollverarbeitungen) - vorpruefungMs;
+        }
+    };
+
+    /** @brief Erzeugt eine Instanz der Klasse 'EricSchemaVorpruefung'
+      *
+      * @param eric
+      *        Schnittstellenobjekt, das den ERiC kapselt.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricSchemaVorpruefung, da diese eine Referenz darauf haelt!
+      */
+    explicit EricSchemaVorpruefung(const Eric &eric);
+
+    virtual ~EricSchemaVorpruefung();
+
+    /** @brief Prueft den Datensatz gegen das Schema der Datenartversion
+      *
+      * @param xml             Datensatz
+      * @param datenartVersion Datenartversion des Datensatzes
+      * @param fehlertext      Erhaelt bei einer Abweisung die Fehlerbeschreibung aus dem fehlertextPuffer
+      *
+      * @return
+      *         - ERIC_OK, wenn der Datensatz vollstaendig verarbeitet werden soll. Das gilt auch,
+      *           wenn die Datenartversion keine Schemavalidierung unterstuetzt oder
+      *           EricCheckXML() aus einem anderen Grund scheitert.
+      *         - ERIC_IO_PARSE_FEHLER oder ERIC_IO_READER_SCHEMA_VALIDIERUNGSFEHLER, wenn der
+      *           Datensatz abgewiesen wird
+      */
+    int pruefe(const std::string &xml, const std::string &datenartVersion, std::string &fehlertext);
+
+    /** @brief Erfasst die Dauer einer vollstaendigen Verarbeitung nach bestandener Vorpruefung */
+    void erfasseVollverarbeitung(double dauerMs);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricSchemaVorpruefung(const EricSchemaVorpruefung &); // Kopien verboten
+    EricSchemaVorpruefung &operator=(const EricSchemaVorpruefung &); // Zuweisungen verboten
+
+    const Eric          &eric;
+    mutable std::mutex   sperre;
+    Kennzahlen           statistik;
+};
+
+#endif
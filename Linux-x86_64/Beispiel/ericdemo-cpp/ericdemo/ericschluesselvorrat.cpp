@@ -0,0 +1,289 @@
+#include "ericschluesselvorrat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <eric_fehlercodes.h>
+
+#include "anwendungsfehler.h"
+#include "system.h"
+
+
+namespace
+{
+
+// Dateien, die EricMtCreateKey() im angegebenen Verzeichnis anlegt
+const char *const CEZ_DATEIEN[] = { "eric_public.cer", "eric_private.p12", "eric.sfv" };
+
+/** @brief Erzeugt eine zufaellige PIN aus Buchstaben und Ziffern */
+std::string zufallsPin()
+{
+    static const char ZEICHEN[] = "ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz23456789";
+    std::random_device zufall;
+    std::uniform_int_distribution<size_t> verteilung(0, sizeof(ZEICHEN) - 2);
+
+    std::string pin(16, ' ');
+    for (size_t i = 0; i < pin.size(); ++i)
+    {
+        pin[i] = ZEICHEN[verteilung(zufall)];
+    }
+    return pin;
+}
+
+bool dateiExistiert(const std::string &pfad)
+{
+    return std::ifstream(pfad.c_str()).good();
+}
+
+} // anonymous namespace
+
+
+EricSchluesselvorrat::EricSchluesselvorrat(const EricMt &ericMt_, const std::string &vorratsVerzeichnis_,
+                                           const Zertifikatsvorlage &vorlage_, size_t zielBestand_, size_t anzahlArbeiter)
+    : ericMt(ericMt_),
+      vorratsVerzeichnis(vorratsVerzeichnis_),
+      vorlage(vorlage_),
+      zielBestand(zielBestand_),
+      entnahmeInstanz(ericMt_),
+      inArbeit(0),
+      zaehler(0),
+      beenden(false),
+      statistik()
+{
+    if (!System::erzeugeGeschuetztesVerzeichnis(vorratsVerzeichnis))
+    {
+        throw Anwendungsfehler("Das Vorratsverzeichnis \"" + vorratsVerzeichnis + "\" konnte nicht angelegt werden.");
+    }
+
+    // Ohne Zielbestand gibt es nichts nachzufuellen, Entnahmen erzeugen dann synchron
+    const size_t anzahl = 0 == zielBestand ? 0 : std::max<size_t>(1, std::min(anzahlArbeiter, zielBestand));
+    for (size_t i = 0; i < anzahl; ++i)
+    {
+        arbeiterThreads.push_back(std::thread(&EricSchluesselvorrat::arbeiter, this));
+    }
+}
+
+EricSchluesselvorrat::~EricSchluesselvorrat()
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    bedarf.notify_all();
+    nachschub.notify_all();
+
+    for (size_t i = 0; i < arbeiterThreads.size(); ++i)
+    {
+        arbeiterThreads[i].join();
+    }
+
+    for (size_t i = 0; i < vorrat.size(); ++i)
+    {
+        verwerfe(vorrat[i]);
+    }
+    System::loescheVerzeichnis(vorratsVerzeichnis);
+}
+
+int EricSchluesselvorrat::entnehmen(const std::string &zielVerzeichnis, const std::string &pin)
+{
+    for (size_t i = 0; i < sizeof(CEZ_DATEIEN) / sizeof(CEZ_DATEIEN[0]); ++i)
+    {
+        if (dateiExistiert(System::dateiPfad(zielVerzeichnis, CEZ_DATEIEN[i])))
+        {
+            return ERIC_CRYPT_ZERTIFIKATSDATEI_EXISTIERT_BEREITS;
+        }
+    }
+
+    Schluesselpaar paar;
+    bool ausVorrat = false;
+    {
+        std::unique_lock<std::mutex> lock(sperre);
+        // Auf eine laufende Erzeugung zu warten ist guenstiger als eine weitere zu starten
+        while (vorrat.empty() && inArbeit > 0 && !beenden)
+        {
+            nachschub.wait(lock);
+        }
+        if (!vorrat.empty())
+        {
+            paar = vorrat.front();
+            vorrat.pop_front();
+            ausVorrat = true;
+            ++statistik.entnommenVorrat;
+        }
+        else
+        {
+            ++statistik.entnommenSynchron;
+        }
+    }
+    if (zielBestand > 0)
+    {
+        bedarf.notify_one();
+    }
+
+    std::lock_guard<std::mutex> entnahmeLock(entnahmeSperre);
+
+    int rc = ERIC_OK;
+    if (!ausVorrat)
+    {
+        rc = erzeuge(entnahmeInstanz, paar);
+        if (rc != ERIC_OK)
+        {
+            return rc;
+        }
+    }
+
+    rc = ericMt.EricMtChangePassword(entnahmeInstanz.handle(), paar.verzeichnis.c_str(), paar.pin.c_str(), pin.c_str());
+    if (rc != ERIC_OK)
+    {
+        // Das Schluesselpaar ist unveraendert und kann spaeter noch entnommen werden
+        std::lock_guard<std::mutex> lock(sperre);
+        vorrat.push_front(paar);
+        return rc;
+    }
+
+    const size_t anzahlDateien = sizeof(CEZ_DATEIEN) / sizeof(CEZ_DATEIEN[0]);
+    for (size_t i = 0; i < anzahlDateien; ++i)
+    {
+        if (!System::verschiebeDatei(System::dateiPfad(paar.verzeichnis, CEZ_DATEIEN[i]),
+                                     System::dateiPfad(zielVerzeichnis, CEZ_DATEIEN[i])))
+        {
+            // Kein halbes Schluesselpaar im Zielverzeichnis zuruecklassen: Die bereits
+            // verschobenen Dateien stammen von uns, da das Ziel vorher keine enthielt
+            while (i-- > 0)
+            {
+                std::remove(System::dateiPfad(zielVerzeichnis, CEZ_DATEIEN[i]).c_str());
+            }
+            // Das Schluesselpaar traegt bereits die Ziel-PIN und wird daher nicht in den Vorrat zurueckgelegt
+            verwerfe(paar);
+            return ERIC_GLOBAL_DATEIZUGRIFF_VERWEIGERT;
+        }
+    }
+    System::loescheVerzeichnis(paar.verzeichnis);
+
+    return ERIC_OK;
+}
+
+EricSchluesselvorrat::Kennzahlen EricSchluesselvorrat::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.bestand = vorrat.size();
+    momentaufnahme.inArbeit = inArbeit;
+    momentaufnahme.warteschlange = zielBestand > vorrat.size() + inArbeit ? zielBestand - vorrat.size() - inArbeit : 0;
+    return momentaufnahme;
+}
+
+void EricSchluesselvorrat::arbeiter()
+{
+    try
+    {
+        EricMtInstanz instanz(ericMt);
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(sperre);
+                while (!beenden && vorrat.size() + inArbeit >= zielBestand)
+                {
+                    bedarf.wait(lock);
+                }
+                if (beenden)
+                {
+                    return;
+                }
+                ++inArbeit;
+            }
+
+            Schluesselpaar paar;
+            const int rc = erzeuge(instanz, paar);
+
+            {
+                std::lock_guard<std::mutex> lock(sperre);
+                --inArbeit;
+                if (rc == ERIC_OK)
+                {
+                    vorrat.push_back(paar);
+                }
+            }
+            nachschub.notify_all();
+
+            if (rc != ERIC_OK)
+            {
+                std::cerr << "Schluesselerzeugung fuer den CEZ-Vorrat fehlgeschlagen (Fehler " << rc << ")" << std::endl;
+                // Eine dauerhafte Stoerung soll die Arbeitsthreads nicht in eine Endlosschleife fuehren
+                std::unique_lock<std::mutex> lock(sperre);
+                bedarf.wait_for(lock, std::chrono::seconds(5), [this] { return beenden; });
+            }
+        }
+    }
+    catch (const std::exception &fehler)
+    {
+        std::cerr << "CEZ-Vorrat: " << fehler.what() << std::endl;
+        std::lock_guard<std::mutex> lock(sperre);
+        nachschub.notify_all();
+    }
+}
+
+int EricSchluesselvorrat::erzeuge(const EricMtInstanz &instanz, Schluesselpaar &paar)
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        paar.verzeichnis = System::dateiPfad(vorratsVerzeichnis, "cez-" + System::toString(++zaehler) + "-" + zufallsPin().substr(0, 8));
+    }
+    paar.pin = zufallsPin();
+
+    if (!System::erzeugeGeschuetztesVerzeichnis(paar.verzeichnis))
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.fehlgeschlagen;
+        return ERIC_CRYPT_ZERTIFIKATSPFAD_KEIN_VERZEICHNIS;
+    }
+
+    eric_zertifikat_parameter_t zertifikatInfo = {};
+    zertifikatInfo.version      = 1;
+    zertifikatInfo.name         = vorlage.name.c_str();
+    zertifikatInfo.land         = vorlage.land.empty() ? nullptr : vorlage.land.c_str();
+    zertifikatInfo.ort          = vorlage.ort.empty() ? nullptr : vorlage.ort.c_str();
+    zertifikatInfo.adresse      = vorlage.adresse.empty() ? nullptr : vorlage.adresse.c_str();
+    zertifikatInfo.email        = vorlage.email.empty() ? nullptr : vorlage.email.c_str();
+    zertifikatInfo.organisation = vorlage.organisation.empty() ? nullptr : vorlage.organisation.c_str();
+    zertifikatInfo.abteilung    = vorlage.abteilung.empty() ? nullptr : vorlage.abteilung.c_str();
+    zertifikatInfo.beschreibung = vorlage.beschreibung.empty() ? nullptr : vorlage.beschreibung.c_str();
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int rc = ericMt.EricMtCreateKey(instanz.handle(), paar.pin.c_str(), paar.verzeichnis.c_str(), &zertifikatInfo);
+    const double dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (rc == ERIC_OK)
+    {
+        erfasseDauer(dauerMs);
+    }
+    else
+    {
+        verwerfe(paar);
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.fehlgeschlagen;
+    }
+    return rc;
+}
+
+void EricSchluesselvorrat::erfasseDauer(double dauerMs)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.erzeugt;
+    statistik.letzteDauerMs = dauerMs;
+    statistik.maximaleDauerMs = std::max(statistik.maximaleDauerMs, dauerMs);
+    statistik.mittlereDauerMs += (dauerMs - statistik.mittlereDauerMs) / static_cast<double>(statistik.erzeugt);
+}
+
+void EricSchluesselvorrat::verwerfe(const Schluesselpaar &paar)
+{
+    for (size_t i = 0; i < sizeof(CEZ_DATEIEN) / sizeof(CEZ_DATEIEN[0]); ++i)
+    {
+        std::remove(System::dateiPfad(paar.verzeichnis, CEZ_DATEIEN[i]).c_str());
+    }
+    System::loescheVerzeichnis(paar.verzeichnis);
+}
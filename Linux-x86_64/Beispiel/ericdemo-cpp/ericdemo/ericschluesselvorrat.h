@@ -0,0 +1,137 @@
+#ifndef _ERICSCHLUESSELVORRAT_H_
+#define _ERICSCHLUESSELVORRAT_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ericmt.h"
+
+
+/** @brief Vorrat vorab erzeugter Schluesselpaare fuer clientseitig erzeugte Zertifikate (CEZ)
+ *
+ * EricMtCreateKey() ist eine rechenintensive Schluesselerzeugung. Diese Klasse
+ * erzeugt Schluesselpaare im Hintergrund auf einer begrenzten Anzahl von
+ * Arbeitsthreads mit jeweils eigener ERiC-Instanz und haelt einen kleinen
+ * Bestand in einem nur fuer den aktuellen Benutzer zugaenglichen Verzeichnis
+ * bereit. Die vorab erzeugten Schluesselpaare sind mit einer zufaelligen PIN
+ * geschuetzt, die nur im Hauptspeicher gehalten wird. Bei der Entnahme wird
+ * die PIN mit EricMtChangePassword() auf die gewuenschte PIN gesetzt und das
+ * Schluesselpaar in das Zielverzeichnis verschoben.
+ *
+ * Ein Prozess, der nur ein einziges Schluesselpaar benoetigt, uebergibt den
+ * Zielbestand 0: Dann laufen keine Arbeitsthreads, und die Entnahme erzeugt
+ * synchron, statt nach der Entnahme einen Nachschub anzustossen, auf den der
+ * Destruktor beim Beenden warten muesste.
+ *
+ * Nicht entnommene Schluesselpaare werden im Destruktor geloescht.
+ */
+class EricSchluesselvorrat
+{
+public:
+    /** @brief Angaben zum Schluesselinhaber, siehe eric_zertifikat_parameter_t */
+    struct Zertifikatsvorlage
+    {
+        std::string name;
+        std::string land;
+        std::string ort;
+        std::string adresse;
+        std::string email;
+        std::string organisation;
+        std::string abteilung;
+        std::string beschreibung;
+    };
+
+    /** @brief Kennzahlen zu Bestand und Erzeugungsdauer */
+    struct Kennzahlen
+    {
+        size_t   bestand;            // Fertige Schluesselpaare im Vorrat
+        size_t   inArbeit;           // Laufende Erzeugungen
+        size_t   warteschlange;      // Noch zu erzeugende Schluesselpaare bis zum Zielbestand
+        uint64_t erzeugt;            // Erfolgreiche Erzeugungen insgesamt
+        uint64_t fehlgeschlagen;     // Fehlgeschlagene Erzeugungen insgesamt
+        uint64_t entnommenVorrat;    // Entnahmen, die aus dem Vorrat bedient wurden
+        uint64_t entnommenSynchron;  // Entnahmen, fuer die synchron erzeugt werden musste
+        double   letzteDauerMs;      // Dauer der letzten Erzeugung
+        double   mittlereDauerMs;    // Mittlere Dauer aller erfolgreichen Erzeugungen
+        double   maximaleDauerMs;    // Laengste Dauer einer Erzeugung
+    };
+
+    /** @brief Erzeugt den Vorrat und startet die Arbeitsthreads
+      *
+      * @param ericMt
+      *        Schnittstellenobjekt der Multithreading-API.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricSchluesselvorrat, da diese eine Referenz darauf haelt!
+      * @param vorratsVerzeichnis Verzeichnis, in dem die vorab erzeugten Schluesselpaare abgelegt werden
+      * @param vorlage            Angaben zum Schluesselinhaber fuer die erzeugten Zertifikate
+      * @param zielBestand        Anzahl der bereitzuhaltenden Schluesselpaare, 0 fuer reine synchrone Erzeugung
+      * @param anzahlArbeiter     Anzahl der Arbeitsthreads, mindestens 1 bei einem Zielbestand groesser 0
+      *
+      * @throw Anwendungsfehler, wenn das Vorratsverzeichnis oder eine ERiC-Instanz nicht angelegt werden kann
+      */
+    EricSchluesselvorrat(const EricMt &ericMt, const std::string &vorratsVerzeichnis,
+                         const Zertifikatsvorlage &vorlage, size_t zielBestand, size_t anzahlArbeiter);
+
+    /** @brief Beendet die Arbeitsthreads, loescht nicht entnommene Schluesselpaare und das leere Vorratsverzeichnis */
+    virtual ~EricSchluesselvorrat();
+
+    /** @brief Entnimmt ein Schluesselpaar und legt es mit der angegebenen PIN im Zielverzeichnis ab
+      *
+      * Ist der Vorrat leer, wird auf eine laufende Erzeugung gewartet oder,
+      * falls keine laeuft, synchron ein Schluesselpaar erzeugt.
+      * Schlaegt das Verschieben einer Datei fehl, werden die bereits
+      * verschobenen Dateien wieder entfernt, sodass das Zielverzeichnis
+      * entweder das vollstaendige Schluesselpaar oder keine seiner Dateien enthaelt.
+      *
+      * @param zielVerzeichnis Existierendes, beschreibbares Verzeichnis
+      * @param pin             PIN fuer den privaten Schluessel
+      *
+      * @return ERIC_OK, ein Fehlercode von EricMtCreateKey() bzw. EricMtChangePassword()
+      *         oder ERIC_GLOBAL_DATEIZUGRIFF_VERWEIGERT, wenn das Verschieben fehlschlaegt
+      */
+    int entnehmen(const std::string &zielVerzeichnis, const std::string &pin);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricSchluesselvorrat(const EricSchluesselvorrat &); // Kopien verboten
+    EricSchluesselvorrat &operator=(const EricSchluesselvorrat &); // Zuweisungen verboten
+
+    struct Schluesselpaar
+    {
+        std::string verzeichnis;
+        std::string pin;
+    };
+
+    void arbeiter();
+    int erzeuge(const EricMtInstanz &instanz, Schluesselpaar &paar);
+    void erfasseDauer(double dauerMs);
+    static void verwerfe(const Schluesselpaar &paar);
+
+    const EricMt               &ericMt;
+    const std::string           vorratsVerzeichnis;
+    const Zertifikatsvorlage    vorlage;
+    const size_t                zielBestand;
+
+    EricMtInstanz               entnahmeInstanz;
+    std::mutex                  entnahmeSperre;
+
+    mutable std::mutex          sperre;
+    std::condition_variable     bedarf;       // Signalisiert den Arbeitsthreads Bedarf oder Beenden
+    std::condition_variable     nachschub;    // Signalisiert wartenden Entnahmen ein neues Schluesselpaar
+    std::deque<Schluesselpaar>  vorrat;
+    size_t                      inArbeit;
+    uint64_t                    zaehler;
+    bool                        beenden;
+    Kennzahlen                  statistik;
+
+    std::vector<std::thread>    arbeiterThreads;
+};
+
+#endif
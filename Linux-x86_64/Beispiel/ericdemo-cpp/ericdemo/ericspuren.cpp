@@ -0,0 +1,13 @@
+#include "ericspuren.h"
+
+
+EricSpuren &EricSpuren::instanz()
+{
+    // Wird nie zerstoert, damit Threads bis zuletzt aufzeichnen koennen
+    static EricSpuren *const spuren = new EricSpuren();
+    return *spuren;
+}
+
+EricSpuren::EricSpuren()
+    : Spuren("ericdemo")
+{ }
@@ -0,0 +1,25 @@
+#ifndef _ERICSPUREN_H_
+#define _ERICSPUREN_H_
+
+#include "spuren.h"
+
+
+/** @brief Spuren der ERiC-Klassen
+ *
+ * Aufzeichnung und Export liegen in ../gemeinsam und werden mit ottodemo
+ * geteilt, siehe Spuren. Eine Anfrage ist hier ein Vorgang, ein Nachdruck
+ * oder eine Vorschau; zu ihren Spannen zaehlen auch die ueber
+ * EricMetriken::Aufruf gezaehlten ERiC-Aufrufe und die Phasen aus den
+ * Fortschrittcallbacks.
+ */
+class EricSpuren : public Spuren
+{
+public:
+    /** @brief Die Instanz des Prozesses */
+    static EricSpuren &instanz();
+
+private:
+    EricSpuren();
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "ericsteuernummernstapel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <eric_fehlercodes.h>
+
+#include "anwendungsfehler.h"
+#include "ericmt.h"
+
+
+namespace
+{
+
+// Zeilen je Block; kleine Bloecke halten die Ausgabe fluessig, grosse sparen Synchronisation
+const size_t BLOCKGROESSE = 256;
+
+bool istElsterFormat(const std::string &steuernummer)
+{
+    if (steuernummer.size() != 13)
+        return false;
+    for (size_t i = 0; i < steuernummer.size(); ++i)
+    {
+        if (steuernummer[i] < '0' || steuernummer[i] > '9')
+            return false;
+    }
+    return true;
+}
+
+/** @brief Gemeinsamer Zustand der Arbeitsthreads eines Durchlaufs */
+struct Durchlauf
+{
+    explicit Durchlauf(size_t anzahlBloecke)
+        : naechsterBlock(0), aufrufe(0), aktiveArbeiter(0), bloecke(anzahlBloecke), blockFertig(anzahlBloecke, false)
+    { }
+
+    std::atomic<size_t>                                     naechsterBlock;
+    std::atomic<uint64_t>                                   aufrufe;
+
+    std::mutex                                              sperre;
+    std::condition_variable                                 blockBeendet;
+    size_t                                                  aktiveArbeiter;
+    std::exception_ptr                                      fehler;
+    std::vector<std::vector<EricSteuernummernStapel::Ergebnis> > bloecke;
+    std::vector<bool>                                       blockFertig;
+};
+
+} // anonymous namespace
+
+
+EricSteuernummernStapel::EricSteuernummernStapel(const EricMt &ericMt_, size_t anzahlArbeiter_)
+    : ericMt(ericMt_),
+      anzahlArbeiter(std::max<size_t>(1, anzahlArbeiter_))
+{ }
+
+EricSteuernummernStapel::~EricSteuernummernStapel()
+{ }
+
+EricSteuernummernStapel::Kennzahlen EricSteuernummernStapel::verarbeite(const std::vector<Zeile> &zeilen, const Ausgabe &ausgabe) const
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    const size_t anzahlBloecke = (zeilen.size() + BLOCKGROESSE - 1) / BLOCKGROESSE;
+    Durchlauf durchlauf(anzahlBloecke);
+
+    Kennzahlen kennzahlen = Kennzahlen();
+    kennzahlen.zeilen = zeilen.size();
+    kennzahlen.arbeiter = std::min(anzahlArbeiter, anzahlBloecke);
+    durchlauf.aktiveArbeiter = kennzahlen.arbeiter;
+
+    const EricMt &api = ericMt;
+    const std::function<void()> arbeiter = [&durchlauf, &zeilen, &api, anzahlBloecke]()
+    {
+        try
+        {
+            EricMtInstanz instanz(api);
+            EricMtPuffer puffer(instanz);
+
+            for (size_t block = durchlauf.naechsterBlock++; block < anzahlBloecke; block = durchlauf.naechsterBlock++)
+            {
+                const size_t ende = std::min(zeilen.size(), (block + 1) * BLOCKGROESSE);
+                std::vector<Ergebnis> ergebnisse(ende - block * BLOCKGROESSE);
+                uint64_t aufrufe = 0;
+                for (size_t i = 0; i < ergebnisse.size(); ++i)
+                {
+                    aufrufe += normalisiere(instanz, puffer, zeilen[block * BLOCKGROESSE + i], ergebnisse[i]);
+                }
+                durchlauf.aufrufe += aufrufe;
+
+                std::lock_guard<std::mutex> lock(durchlauf.sperre);
+                durchlauf.bloecke[block].swap(ergebnisse);
+                durchlauf.blockFertig[block] = true;
+                durchlauf.blockBeendet.notify_all();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(durchlauf.sperre);
+            if (!durchlauf.fehler)
+            {
+                durchlauf.fehler = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(durchlauf.sperre);
+        --durchlauf.aktiveArbeiter;
+        durchlauf.blockBeendet.notify_all();
+    };
+
+    std::vector<std::thread> arbeiterThreads;
+    for (size_t i = 0; i < kennzahlen.arbeiter; ++i)
+    {
+        arbeiterThreads.push_back(std::thread(arbeiter));
+    }
+
+    std::exception_ptr fehler;
+    try
+    {
+        for (size_t block = 0; block < anzahlBloecke; ++block)
+        {
+            {
+                std::unique_lock<std::mutex> lock(durchlauf.sperre);
+                while (!durchlauf.blockFertig[block] && durchlauf.aktiveArbeiter > 0)
+                {
+                    durchlauf.blockBeendet.wait(lock);
+                }
+                if (!durchlauf.blockFertig[block])
+                {
+                    if (durchlauf.fehler)
+                    {
+                        std::rethrow_exception(durchlauf.fehler);
+                    }
+                    throw Anwendungsfehler("Die Steuernummern konnten nicht vollstaendig verarbeitet werden.");
+                }
+            }
+
+            // Ein fertiger Block wird von den Arbeitsthreads nicht mehr beruehrt
+            const std::vector<Ergebnis> &ergebnisse = durchlauf.bloecke[block];
+            for (size_t i = 0; i < ergebnisse.size(); ++i)
+            {
+                if (ergebnisse[i].rc != ERIC_OK)
+                {
+                    ++kennzahlen.fehlerhaft;
+                }
+                if (ausgabe)
+                {
+                    const size_t index = block * BLOCKGROESSE + i;
+                    ausgabe(index, zeilen[index], ergebnisse[i]);
+                }
+            }
+            std::vector<Ergebnis>().swap(durchlauf.bloecke[block]);
+        }
+    }
+    catch (...)
+    {
+        // Verbleibende Bloecke werden nicht mehr vergeben
+        durchlauf.naechsterBlock = anzahlBloecke;
+        fehler = std::current_exception();
+    }
+
+    for (size_t i = 0; i < arbeiterThreads.size(); ++i)
+    {
+        arbeiterThreads[i].join();
+    }
+    if (fehler)
+    {
+        std::rethrow_exception(fehler);
+    }
+
+    kennzahlen.aufrufe = durchlauf.aufrufe;
+    kennzahlen.dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return kennzahlen;
+}
+
+unsigned EricSteuernummernStapel::normalisiere(const EricMtInstanz &instanz, const EricMtPuffer &puffer,
+                                               const Zeile &zeile, Ergebnis &ergebnis)
+{
+    const EricMt &api = instanz.api();
+    unsigned aufrufe = 0;
+
+    ergebnis.elster.clear();
+    ergebnis.bescheid.clear();
+
+    if (istElsterFormat(zeile.steuernummer))
+    {
+        ergebnis.rc = api.EricMtPruefeSteuernummer(instanz.handle(), zeile.steuernummer.c_str());
+        ++aufrufe;
+        if (ergebnis.rc == ERIC_OK)
+        {
+            ergebnis.elster = zeile.steuernummer;
+        }
+    }
+    else
+    {
+        // Die Landesnummer genuegt ausser bei bayerischen und Berliner Steuernummern
+        const char *landesnr = zeile.land.size() == 2 ? zeile.land.c_str() : nullptr;
+        const char *bufaNr = zeile.land.size() == 4 ? zeile.land.c_str() : nullptr;
+        if (!zeile.land.empty() && nullptr == landesnr && nullptr == bufaNr)
+        {
+            ergebnis.rc = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+            return aufrufe;
+        }
+
+        ergebnis.rc = api.EricMtMakeElsterStnr(instanz.handle(), zeile.steuernummer.c_str(), landesnr, bufaNr, puffer.handle());
+        ++aufrufe;
+        if (ergebnis.rc == ERIC_OK)
+        {
+            ergebnis.elster.assign(puffer.inhalt(), puffer.laenge());
+        }
+    }
+
+    if (ergebnis.rc == ERIC_OK)
+    {
+        ergebnis.rc = api.EricMtFormatStNr(instanz.handle(), ergebnis.elster.c_str(), puffer.handle());
+        ++aufrufe;
+        if (ergebnis.rc == ERIC_OK)
+        {
+            ergebnis.bescheid.assign(puffer.inhalt(), puffer.laenge());
+        }
+    }
+    return aufrufe;
+}
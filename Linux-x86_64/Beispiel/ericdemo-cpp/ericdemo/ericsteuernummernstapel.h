@@ -0,0 +1,94 @@
+#ifndef _ERICSTEUERNUMMERNSTAPEL_H_
+#define _ERICSTEUERNUMMERNSTAPEL_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Vorwaertsdeklarationen
+class EricMt;
+class EricMtInstanz;
+class EricMtPuffer;
+
+
+/** @brief Normalisiert viele Steuernummern parallel auf mehreren ERiC-Instanzen
+ *
+ * Jede Zeile enthaelt eine Steuernummer im Format des Steuerbescheids oder im
+ * 13-stelligen ELSTER-Steuernummerformat. Zu jeder Zeile werden beide Formate
+ * ermittelt: Bescheidformate ueber EricMtMakeElsterStnr(), ELSTER-Formate
+ * ueber EricMtPruefeSteuernummer(), anschliessend das Bescheidformat ueber
+ * EricMtFormatStNr().
+ *
+ * verarbeite() teilt die Zeilen in Bloecke auf, die Arbeitsthreads mit
+ * jeweils eigener ERiC-Instanz und eigenen Rueckgabepuffern abarbeiten. Die
+ * Ergebnisse werden in der Reihenfolge der Eingabe ausgegeben, sobald ein
+ * Block vollstaendig ist, und nicht bis zum Ende gesammelt.
+ */
+class EricSteuernummernStapel
+{
+public:
+    /** @brief Eingabezeile */
+    struct Zeile
+    {
+        std::string steuernummer;
+        std::string land;           // 2-stellige Landesnummer oder 4-stellige Bundesfinanzamtsnummer, entfaellt beim ELSTER-Format
+    };
+
+    /** @brief Ergebnis zu einer Eingabezeile */
+    struct Ergebnis
+    {
+        int         rc;             // ERIC_OK oder Fehlercode des ERiC
+        std::string elster;         // 13-stellige Steuernummer im ELSTER-Steuernummerformat
+        std::string bescheid;       // Steuernummer im Bescheidformat des Bundeslandes
+    };
+
+    /** @brief Kennzahlen eines Durchlaufs von verarbeite() */
+    struct Kennzahlen
+    {
+        uint64_t zeilen;
+        uint64_t fehlerhaft;        // Zeilen mit einem Fehlercode
+        uint64_t aufrufe;           // Aufrufe von ERiC-Funktionen
+        size_t   arbeiter;          // Tatsaechlich gestartete Arbeitsthreads
+        double   dauerMs;
+    };
+
+    /** @brief Wird je Zeile in der Reihenfolge der Eingabe aus dem aufrufenden Thread aufgerufen */
+    typedef std::function<void(size_t index, const Zeile &zeile, const Ergebnis &ergebnis)> Ausgabe;
+
+    /**
+     * @param ericMt
+     *        Schnittstellenobjekt der Multithreading-API.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricSteuernummernStapel, da diese eine Referenz darauf haelt!
+     * @param anzahlArbeiter
+     *        Hoechstzahl der Arbeitsthreads und damit der ERiC-Instanzen, mindestens 1
+     */
+    EricSteuernummernStapel(const EricMt &ericMt, size_t anzahlArbeiter);
+
+    virtual ~EricSteuernummernStapel();
+
+    /** @brief Normalisiert alle Zeilen und gibt die Ergebnisse geordnet aus
+      *
+      * @throw Anwendungsfehler, wenn keine ERiC-Instanz erzeugt werden kann
+      */
+    Kennzahlen verarbeite(const std::vector<Zeile> &zeilen, const Ausgabe &ausgabe) const;
+
+    /** @brief Normalisiert eine einzelne Zeile auf der angegebenen Instanz
+      *
+      * @param puffer Rueckgabepuffer der Instanz, wird wiederverwendet
+      *
+      * @return Anzahl der Aufrufe von ERiC-Funktionen
+      */
+    static unsigned normalisiere(const EricMtInstanz &instanz, const EricMtPuffer &puffer,
+                                 const Zeile &zeile, Ergebnis &ergebnis);
+
+private:
+    EricSteuernummernStapel(const EricSteuernummernStapel &); // Kopien verboten
+    EricSteuernummernStapel &operator=(const EricSteuernummernStapel &); // Zuweisungen verboten
+
+    const EricMt &ericMt;
+    const size_t  anzahlArbeiter;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "erictoolkitadapter.h"
+
+#include <platform.h>
+
+#include "anwendungsfehler.h"
+#include "eric.h"
+#include "system.h"
+
+namespace {
+
+    /** @brief Lade eine Funktion aus einer Bibliothek */
+    template<class Funktionstyp>
+    Funktionstyp ladeFunktion(const char* funktionsName, Resolve::Library lib)
+    {
+        Funktionstyp f = Resolve::function<Funktionstyp>(lib, funktionsName);
+        if (f == nullptr)
+        {
+            throw Anwendungsfehler(std::string(funktionsName) + ": konnte nicht geladen werden.");
+        }
+        return f;
+    }
+
+    // Ein typedef und ein Funktionszeiger je Toolkit-Funktion
+    typedef int (STDCALL *EtkPruefeFun)(const char *wert);
+    EtkPruefeFun EtkPruefeSteuernummerPtr;
+    EtkPruefeFun EtkPruefeBuFaNummerPtr;
+    EtkPruefeFun EtkPruefeIdentifikationsMerkmalPtr;
+    EtkPruefeFun EtkPruefeIBANPtr;
+    EtkPruefeFun EtkPruefeBICPtr;
+
+    typedef const char* (STDCALL *EtkHoleProduktVersionFun)();
+    EtkHoleProduktVersionFun EtkHoleProduktVersionPtr;
+}
+
+EricToolkit::EricToolkit(const std::string &argHomeDir) : libEricToolkit(nullptr)
+{
+    static const std::string toolkitDateiname = System::getBibliotheksDateiname("erictoolkit");
+    const std::string homeDir = Eric::ermittleHeimverzeichnis(argHomeDir);
+
+    libEricToolkit = Resolve::library<>(
+#ifdef WINDOWS_MSVC
+        System::kod::toUtf16(System::dateiPfad(homeDir, toolkitDateiname))
+#else
+        System::dateiPfad(homeDir, toolkitDateiname)
+#endif
+        .c_str());
+    if (nullptr == libEricToolkit)
+    {
+        throw Anwendungsfehler("Die Programmbibliothek erictoolkit konnte nicht geladen werden.");
+    }
+
+    try
+    {
+        EtkPruefeSteuernummerPtr           = ladeFunktion<EtkPruefeFun>("EtkPruefeSteuernummer", libEricToolkit);
+        EtkPruefeBuFaNummerPtr             = ladeFunktion<EtkPruefeFun>("EtkPruefeBuFaNummer", libEricToolkit);
+        EtkPruefeIdentifikationsMerkmalPtr = ladeFunktion<EtkPruefeFun>("EtkPruefeIdentifikationsMerkmal", libEricToolkit);
+        EtkPruefeIBANPtr                   = ladeFunktion<EtkPruefeFun>("EtkPruefeIBAN", libEricToolkit);
+        EtkPruefeBICPtr                    = ladeFunktion<EtkPruefeFun>("EtkPruefeBIC", libEricToolkit);
+        EtkHoleProduktVersionPtr           = ladeFunktion<EtkHoleProduktVersionFun>("EtkHoleProduktVersion", libEricToolkit);
+    }
+    catch (const Anwendungsfehler &)
+    {
+        Resolve::free_library(libEricToolkit);
+        throw;
+    }
+}
+
+EricToolkit::~EricToolkit()
+{
+    Resolve::free_library(libEricToolkit);
+}
+
+
+// Implementierungen der Proxy-Methoden fuer die Toolkit-Funktionen
+
+int EricToolkit::EtkPruefeSteuernummer(const char *steuernummer) const
+{
+    return EtkPruefeSteuernummerPtr(steuernummer);
+}
+
+int EricToolkit::EtkPruefeBuFaNummer(const char *steuernummer) const
+{
+    return EtkPruefeBuFaNummerPtr(steuernummer);
+}
+
+int EricToolkit::EtkPruefeIdentifikationsMerkmal(const char *steuerId) const
+{
+    return EtkPruefeIdentifikationsMerkmalPtr(steuerId);
+}
+
+int EricToolkit::EtkPruefeIBAN(const char *iban) const
+{
+    return EtkPruefeIBANPtr(iban);
+}
+
+int EricToolkit::EtkPruefeBIC(const char *bic) const
+{
+    return EtkPruefeBICPtr(bic);
+}
+
+const char *EricToolkit::EtkHoleProduktVersion() const
+{
+    return EtkHoleProduktVersionPtr();
+}
@@ -0,0 +1,56 @@
+#ifndef _ERICTOOLKITADAPTER_H_
+#define _ERICTOOLKITADAPTER_H_
+
+#include <string>
+
+#include "resolve.h"
+
+
+/** @brief Die Klasse 'EricToolkit' kapselt die Bibliothek 'erictoolkit'.
+ *
+ *         Das ERiC-Toolkit stellt Pruefungen fuer Steuernummer, Bundesfinanzamtsnummer,
+ *         Identifikationsnummer, IBAN und BIC ohne Abhaengigkeit zu anderen
+ *         ERiC-Bibliotheken bereit. Es muss weder initialisiert werden noch
+ *         wird eine ERiC-Instanz benoetigt. Die Rueckgabewerte entsprechen denen
+ *         der gleichnamigen ERiC API-Funktionen, siehe eric_fehlercodes.h.
+ */
+class EricToolkit
+{
+public:
+    /**
+     * @brief Laedt die erictoolkit aus dem Verzeichnis der ERiC-Bibliotheken.
+     *
+     * @param argHomeDir Verzeichnis der ERiC-Bibliotheken, siehe Eric::ermittleHeimverzeichnis()
+     *
+     * @throw Anwendungsfehler
+     *        Die erictoolkit konnte nicht geladen werden.
+     */
+    explicit EricToolkit(const std::string &argHomeDir);
+    virtual ~EricToolkit();
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    int EtkPruefeSteuernummer(const char *steuernummer) const;
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    int EtkPruefeBuFaNummer(const char *steuernummer) const;
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    int EtkPruefeIdentifikationsMerkmal(const char *steuerId) const;
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    int EtkPruefeIBAN(const char *iban) const;
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    int EtkPruefeBIC(const char *bic) const;
+
+    /** @brief Wrapper fuer die gleichnamige Toolkit-Funktion. Siehe erictoolkit.h. */
+    const char *EtkHoleProduktVersion() const;
+
+private:
+    EricToolkit(const EricToolkit &);
+    EricToolkit & operator= (const EricToolkit &);
+
+    Resolve::Library libEricToolkit;
+};
+
+#endif
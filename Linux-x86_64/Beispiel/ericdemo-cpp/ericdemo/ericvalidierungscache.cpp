@@ -0,0 +1,292 @@
+#include "ericvalidierungscache.h"
+
+#include <cstring>
+#include <fstream>
+#include <eric_fehlercodes.h>
+#include <eric_types.h>
+
+#include "anwendungsfehler.h"
+#include "system.h"
+
+
+namespace
+{
+
+// Kennung am Anfang der Cachedatei; bei Formataenderungen hochzaehlen
+const char DATEIKENNUNG[8] = { 'E', 'R', 'I', 'C', 'V', 'C', '0', '2' };
+
+// Satzkopf: Schluessel, Rueckgabewert, Laenge des Ergebnisses
+const size_t SATZKOPF_LAENGE = sizeof(EricValidierungsCache::Schluessel) + sizeof(int32_t) + sizeof(uint32_t);
+
+} // anonymous namespace
+
+
+EricValidierungsCache::EricValidierungsCache(const std::string &ericVersion_, const std::string &verzeichnis, size_t maxEintraege_)
+    : ericVersion(ericVersion_),
+      dateiName(verzeichnis.empty() ? std::string() : System::dateiPfad(verzeichnis, "validierungscache.dat")),
+      maxEintraege(maxEintraege_ > 0 ? maxEintraege_ : 1),
+      dateiLaenge(0),
+      statistik()
+{
+    if (!verzeichnis.empty())
+    {
+        if (!System::erzeugeGeschuetztesVerzeichnis(verzeichnis))
+        {
+            throw Anwendungsfehler("Das Cacheverzeichnis \"" + verzeichnis + "\" konnte nicht angelegt werden.");
+        }
+        oeffneDatei();
+    }
+}
+
+EricValidierungsCache::~EricValidierungsCache()
+{ }
+
+bool EricValidierungsCache::istZwischenspeicherbar(uint32_t bearbeitungsFlags)
+{
+    // Drucken und Senden haben Seiteneffekte, die der Cache nicht nachbilden kann
+    return ERIC_VALIDIERE == bearbeitungsFlags;
+}
+
+bool EricValidierungsCache::istErgebnisBestaendig(int rc)
+{
+    // Andere Fehler wie Speichermangel oder fehlende Plugins sind voruebergehend
+    return ERIC_OK == rc || ERIC_GLOBAL_PRUEF_FEHLER == rc || ERIC_GLOBAL_HINWEISE == rc;
+}
+
+EricValidierungsCache::Schluessel EricValidierungsCache::schluessel(const std::string &xml, const std::string &datenartVersion, uint32_t bearbeitungsFlags) const
+{
+    return berechneSchluessel(ericVersion, xml, datenartVersion, bearbeitungsFlags);
+}
+
+EricValidierungsCache::Schluessel EricValidierungsCache::berechneSchluessel(const std::string &ericVersion, const std::string &xml,
+                                                                            const std::string &datenartVersion, uint32_t bearbeitungsFlags)
+{
+    Sha256 hash;
+    hash.fuegeFeldHinzu(ericVersion);
+    hash.fuegeFeldHinzu(datenartVersion);
+    hash.fuegeZahlHinzu(bearbeitungsFlags);
+    hash.fuegeFeldHinzu(xml);
+    return hash.wert();
+}
+
+bool EricValidierungsCache::suche(const Schluessel &schluessel, int &rc, std::string &ergebnis)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+
+    if (finde(schluessel, rc, ergebnis))
+    {
+        return true;
+    }
+    ++statistik.fehlgriffe;
+    return false;
+}
+
+int EricValidierungsCache::validiere(const Schluessel &schluessel, std::string &ergebnis,
+                                     const std::function<int(std::string &)> &vorgang, Herkunft &herkunft)
+{
+    int rc = ERIC_OK;
+    if (suche(schluessel, rc, ergebnis))
+    {
+        herkunft = ZWISCHENSPEICHER;
+        return rc;
+    }
+
+    bool zwischenspeicher = false;
+    bool gebuendelt = false;
+    const Buendelung::Ergebnis gemeinsam = buendelung.ausfuehren(schluessel, [&]() -> Buendelung::Ergebnis
+    {
+        Buendelung::Ergebnis berechnet;
+        {
+            // Ein gerade beendeter Vorgang kann das Ergebnis seit der Suche abgelegt haben
+            std::lock_guard<std::mutex> lock(sperre);
+            if (finde(schluessel, berechnet.rc, berechnet.ergebnis))
+            {
+                zwischenspeicher = true;
+                return berechnet;
+            }
+        }
+        berechnet.rc = vorgang(berechnet.ergebnis);
+        if (istErgebnisBestaendig(berechnet.rc))
+        {
+            speichere(schluessel, berechnet.rc, berechnet.ergebnis);
+        }
+        return berechnet;
+    }, gebuendelt);
+
+    if (gebuendelt)
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.gebuendelt;
+    }
+
+    herkunft = gebuendelt ? GEBUENDELT : (zwischenspeicher ? ZWISCHENSPEICHER : BERECHNET);
+    ergebnis = gemeinsam.ergebnis;
+    return gemeinsam.rc;
+}
+
+bool EricValidierungsCache::finde(const Schluessel &schluessel, int &rc, std::string &ergebnis)
+{
+    const std::map<Schluessel, Verwendungsliste::iterator>::iterator imSpeicher = speicherIndex.find(schluessel);
+    if (imSpeicher != speicherIndex.end())
+    {
+        verwendung.splice(verwendung.begin(), verwendung, imSpeicher->second);
+        rc = imSpeicher->second->rc;
+        ergebnis = imSpeicher->second->ergebnis;
+        ++statistik.trefferSpeicher;
+        return true;
+    }
+
+    const std::map<Schluessel, uint64_t>::const_iterator inDatei = dateiIndex.find(schluessel);
+    if (inDatei != dateiIndex.end())
+    {
+        Eintrag eintrag;
+        eintrag.schluessel = schluessel;
+        if (leseAusDatei(inDatei->second, eintrag.rc, eintrag.ergebnis))
+        {
+            rc = eintrag.rc;
+            ergebnis = eintrag.ergebnis;
+            merke(eintrag);
+            ++statistik.trefferDatei;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void EricValidierungsCache::speichere(const Schluessel &schluessel, int rc, const std::string &ergebnis)
+{
+    Eintrag eintrag;
+    eintrag.schluessel = schluessel;
+    eintrag.rc = rc;
+    eintrag.ergebnis = ergebnis;
+
+    std::lock_guard<std::mutex> lock(sperre);
+    if (speicherIndex.count(schluessel) != 0)
+    {
+        return;
+    }
+    merke(eintrag);
+    ++statistik.gespeichert;
+
+    if (!dateiName.empty() && dateiIndex.count(schluessel) == 0)
+    {
+        haengeAnDatei(eintrag);
+    }
+}
+
+EricValidierungsCache::Kennzahlen EricValidierungsCache::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.eintraegeSpeicher = verwendung.size();
+    momentaufnahme.eintraegeDatei = dateiIndex.size();
+    return momentaufnahme;
+}
+
+void EricValidierungsCache::oeffneDatei()
+{
+    abbild.reset(new System::Dateiabbild(dateiName));
+
+    const char *daten = abbild->daten();
+    const size_t groesse = abbild->groesse();
+    size_t position = sizeof(DATEIKENNUNG);
+
+    if (groesse >= sizeof(DATEIKENNUNG) && 0 == std::memcmp(daten, DATEIKENNUNG, sizeof(DATEIKENNUNG)))
+    {
+        while (position + SATZKOPF_LAENGE <= groesse)
+        {
+            Schluessel schluessel;
+            uint32_t laenge = 0;
+            std::memcpy(&schluessel, daten + position, sizeof(schluessel));
+            std::memcpy(&laenge, daten + position + sizeof(schluessel) + sizeof(int32_t), sizeof(laenge));
+            if (position + SATZKOPF_LAENGE + laenge > groesse)
+            {
+                break;
+            }
+            dateiIndex[schluessel] = position;
+            position += SATZKOPF_LAENGE + laenge;
+        }
+        if (position == groesse)
+        {
+            dateiLaenge = groesse;
+            return;
+        }
+    }
+    else
+    {
+        // Unbekanntes Format oder neue Datei
+        position = 0;
+    }
+
+    // Die Datei endet mit einem unvollstaendigen Satz, z. B. nach einem Absturz
+    // beim Schreiben. Nur die vollstaendigen Saetze werden uebernommen.
+    const std::string gueltigeSaetze = position > 0 ? std::string(daten, position) : std::string(DATEIKENNUNG, sizeof(DATEIKENNUNG));
+    abbild.reset();
+    if (!System::schreibeDatei(gueltigeSaetze, dateiName))
+    {
+        throw Anwendungsfehler("Die Cachedatei \"" + dateiName + "\" konnte nicht geschrieben werden.");
+    }
+    dateiLaenge = gueltigeSaetze.size();
+    abbild.reset(new System::Dateiabbild(dateiName));
+}
+
+bool EricValidierungsCache::leseAusDatei(uint64_t position, int &rc, std::string &ergebnis)
+{
+    if (!abbild || position + SATZKOPF_LAENGE > abbild->groesse())
+    {
+        // Seit dem Einblenden angehaengt
+        abbild.reset(new System::Dateiabbild(dateiName));
+        if (position + SATZKOPF_LAENGE > abbild->groesse())
+        {
+            return false;
+        }
+    }
+
+    const char *satz = abbild->daten() + position;
+    int32_t satzRc = 0;
+    uint32_t laenge = 0;
+    std::memcpy(&satzRc, satz + sizeof(Schluessel), sizeof(satzRc));
+    std::memcpy(&laenge, satz + sizeof(Schluessel) + sizeof(satzRc), sizeof(laenge));
+    if (position + SATZKOPF_LAENGE + laenge > abbild->groesse())
+    {
+        return false;
+    }
+
+    rc = satzRc;
+    ergebnis.assign(satz + SATZKOPF_LAENGE, laenge);
+    return true;
+}
+
+void EricValidierungsCache::haengeAnDatei(const Eintrag &eintrag)
+{
+    const int32_t satzRc = eintrag.rc;
+    const uint32_t laenge = static_cast<uint32_t>(eintrag.ergebnis.size());
+
+    std::ofstream datei(dateiName.c_str(), std::ios_base::binary | std::ios_base::app);
+    datei.write(reinterpret_cast<const char *>(&eintrag.schluessel), sizeof(eintrag.schluessel));
+    datei.write(reinterpret_cast<const char *>(&satzRc), sizeof(satzRc));
+    datei.write(reinterpret_cast<const char *>(&laenge), sizeof(laenge));
+    datei.write(eintrag.ergebnis.data(), laenge);
+    datei.close();
+
+    // Ein Schreibfehler kostet nur den Eintrag in der Datei, der Hauptspeicher-Cache bleibt gueltig
+    if (datei)
+    {
+        dateiIndex[eintrag.schluessel] = dateiLaenge;
+        dateiLaenge += SATZKOPF_LAENGE + laenge;
+    }
+}
+
+void EricValidierungsCache::merke(const Eintrag &eintrag)
+{
+    verwendung.push_front(eintrag);
+    speicherIndex[eintrag.schluessel] = verwendung.begin();
+
+    while (verwendung.size() > maxEintraege)
+    {
+        speicherIndex.erase(verwendung.back().schluessel);
+        verwendung.pop_back();
+        ++statistik.verdraengt;
+    }
+}
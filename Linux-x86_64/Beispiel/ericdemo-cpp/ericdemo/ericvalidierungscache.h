@@ -0,0 +1,156 @@
+#ifndef _ERICVALIDIERUNGSCACHE_H_
+#define _ERICVALIDIERUNGSCACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "ericbuendelung.h"
+#include "sha256.h"
+
+// Vorwaertsdeklarationen
+namespace System { class Dateiabbild; }
+
+
+/** @brief Zwischenspeicher fuer Validierungsergebnisse von EricBearbeiteVorgang()
+ *
+ * Bei gleicher ERiC-Version, Datenartversion und gleichen Bearbeitungsflags
+ * liefert eine reine Validierung (ERIC_VALIDIERE) fuer denselben Datensatz
+ * stets dasselbe Ergebnis. Der Zwischenspeicher legt Rueckgabewert und
+ * Ergebnis-XML unter einem SHA-256 ueber diese Angaben ab. Da sich zu einem
+ * SHA-256 keine zweite Eingabe finden laesst, bedeutet ein gleicher
+ * Schluessel gleiche Angaben; ein Treffer gehoert also stets zum selben
+ * Datensatz und nie zu einer fremden Steuererklaerung.
+ *
+ * Die zuletzt verwendeten Ergebnisse werden im Hauptspeicher gehalten
+ * (LRU). Ist ein Verzeichnis angegeben, werden alle Ergebnisse zusaetzlich
+ * an eine Datei angehaengt, die beim Start in den Adressraum eingeblendet
+ * wird und so Programmneustarts ueberdauert. Ein Verzeichnis darf nur von
+ * einem Prozess gleichzeitig verwendet werden.
+ *
+ * validiere() verbindet Nachschlagen und Ablegen und buendelt dabei
+ * gleichzeitige Anfragen mit demselben Schluessel zu einem einzigen Aufruf,
+ * siehe EricBuendelung.
+ */
+class EricValidierungsCache
+{
+public:
+    /** @brief SHA-256 ueber ERiC-Version, Datenartversion, Bearbeitungsflags und Datensatz,
+      *        jedes Feld mit vorangestellter Laenge */
+    typedef Sha256::Wert Schluessel;
+
+    /** @brief Herkunft eines von validiere() gelieferten Ergebnisses */
+    enum Herkunft
+    {
+        BERECHNET,          // Der Vorgang wurde ausgefuehrt
+        ZWISCHENSPEICHER,   // Treffer im Hauptspeicher oder in der Cachedatei
+        GEBUENDELT          // Ergebnis eines gleichzeitig laufenden, inhaltsgleichen Vorgangs
+    };
+
+    /** @brief Kennzahlen zur Trefferquote */
+    struct Kennzahlen
+    {
+        uint64_t trefferSpeicher;     // Treffer im Hauptspeicher
+        uint64_t trefferDatei;        // Treffer in der Cachedatei
+        uint64_t fehlgriffe;          // Anfragen ohne Treffer
+        uint64_t gebuendelt;          // Fehlgriffe, die das Ergebnis eines laufenden Vorgangs uebernommen haben
+        uint64_t gespeichert;         // Neu abgelegte Ergebnisse
+        uint64_t verdraengt;          // Aus dem Hauptspeicher verdraengte Ergebnisse
+        size_t   eintraegeSpeicher;   // Ergebnisse im Hauptspeicher
+        size_t   eintraegeDatei;      // Ergebnisse in der Cachedatei
+    };
+
+    /** @brief Erzeugt den Zwischenspeicher
+      *
+      * @param ericVersion    Versionsangabe des ERiC, z. B. das Ergebnis von EricVersion().
+      *                       Ein Versionswechsel macht alle bisherigen Eintraege unerreichbar.
+      * @param verzeichnis    Verzeichnis fuer die Cachedatei, leer fuer einen reinen Hauptspeicher-Cache
+      * @param maxEintraege   Hoechstzahl der im Hauptspeicher gehaltenen Ergebnisse
+      *
+      * @throw Anwendungsfehler, wenn das Verzeichnis nicht angelegt werden kann
+      */
+    EricValidierungsCache(const std::string &ericVersion, const std::string &verzeichnis, size_t maxEintraege);
+
+    virtual ~EricValidierungsCache();
+
+    /** @brief Liefert true, wenn ein Vorgang mit diesen Flags zwischengespeichert werden darf */
+    static bool istZwischenspeicherbar(uint32_t bearbeitungsFlags);
+
+    /** @brief Liefert true, wenn ein Rueckgabewert vom Datensatz allein abhaengt und abgelegt werden darf */
+    static bool istErgebnisBestaendig(int rc);
+
+    /** @brief Berechnet den Schluessel fuer einen Vorgang */
+    Schluessel schluessel(const std::string &xml, const std::string &datenartVersion, uint32_t bearbeitungsFlags) const;
+
+    /** @brief Berechnet den Schluessel fuer einen Vorgang unter der angegebenen ERiC-Version */
+    static Schluessel berechneSchluessel(const std::string &ericVersion, const std::string &xml,
+                                         const std::string &datenartVersion, uint32_t bearbeitungsFlags);
+
+    /** @brief Sucht ein abgelegtes Ergebnis
+      *
+      * @return true bei einem Treffer; rc und ergebnis sind dann gesetzt
+      */
+    bool suche(const Schluessel &schluessel, int &rc, std::string &ergebnis);
+
+    /** @brief Legt ein Ergebnis ab */
+    void speichere(const Schluessel &schluessel, int rc, const std::string &ergebnis);
+
+    /** @brief Liefert ein abgelegtes Ergebnis oder fuehrt den Vorgang aus und legt dessen Ergebnis ab
+      *
+      * Laeuft bereits ein Vorgang mit demselben Schluessel, wird auf dessen
+      * Ergebnis gewartet, statt den Vorgang ein zweites Mal auszufuehren.
+      *
+      * @param schluessel Schluessel des Vorgangs, siehe schluessel()
+      * @param ergebnis   Erhaelt das Ergebnis-XML
+      * @param vorgang    Fuehrt den Vorgang aus, schreibt das Ergebnis-XML und liefert den Rueckgabewert
+      * @param herkunft   Erhaelt die Herkunft des Ergebnisses
+      *
+      * @return Rueckgabewert des Vorgangs
+      */
+    int validiere(const Schluessel &schluessel, std::string &ergebnis,
+                  const std::function<int(std::string &)> &vorgang, Herkunft &herkunft);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricValidierungsCache(const EricValidierungsCache &); // Kopien verboten
+    EricValidierungsCache &operator=(const EricValidierungsCache &); // Zuweisungen verboten
+
+    struct Eintrag
+    {
+        Schluessel  schluessel;
+        int         rc;
+        std::string ergebnis;
+    };
+
+    typedef std::list<Eintrag> Verwendungsliste;
+
+    typedef EricBuendelung<Schluessel> Buendelung;
+
+    bool finde(const Schluessel &schluessel, int &rc, std::string &ergebnis);
+    void oeffneDatei();
+    bool leseAusDatei(uint64_t position, int &rc, std::string &ergebnis);
+    void haengeAnDatei(const Eintrag &eintrag);
+    void merke(const Eintrag &eintrag);
+
+    const std::string                           ericVersion;
+    const std::string                           dateiName;
+    const size_t                                maxEintraege;
+
+    mutable std::mutex                          sperre;
+    Verwendungsliste                            verwendung;     // Vorne die zuletzt verwendeten Ergebnisse
+    std::map<Schluessel, Verwendungsliste::iterator> speicherIndex;
+    std::map<Schluessel, uint64_t>              dateiIndex;     // Position des Eintrags in der Cachedatei
+    uint64_t                                    dateiLaenge;
+    std::unique_ptr<System::Dateiabbild>        abbild;
+    Kennzahlen                                  statistik;
+
+    Buendelung                                  buendelung;
+};
+
+#endif
@@ -1,14 +1,22 @@
 #include "ericvorgang.h"
 
+#include <chrono>
 #include <memory>
 #include <list>
 #include <iostream>
 #include <sstream>
+#include <eric_fehlercodes.h>
 
 #include "anwendungsfehler.h"
 #include "datensatzleser.h"
 #include "eric.h"
+#include "erickosten.h"
+#include "ericmetriken.h"
+#include "ericpdfsammler.h"
 #include "ericpuffer.h"
+#include "ericschemavorpruefung.h"
+#include "ericspuren.h"
+#include "ericvalidierungscache.h"
 #include "ericzertifikat.h"
 #include "system.h"
 
@@ -16,31 +24,23 @@ using std::string;
 using std::list;
 
 
-namespace
-{
+EricVorgang::EricVorgang(const Eric& eric, EricValidierungsCache *validierungsCache_,
+                         EricSchemaVorpruefung *schemaVorpruefung_) :
+    ericAdapter(eric), validierungsCache(validierungsCache_), schemaVorpruefung(schemaVorpruefung_)
+{ }
 
-/** @brief Dies sind die Standardeinstellungen des Beispiels. */
-eric_druck_parameter_t holeDruckeinstellungen()
-{
-    eric_druck_parameter_t druckEinstellungen = {};
-    druckEinstellungen.version     = 4;
-    druckEinstellungen.vorschau    = 0;
-    druckEinstellungen.duplexDruck = 0;
-    druckEinstellungen.pdfName     = "ericprint.pdf";
-    druckEinstellungen.fussText    = nullptr;
-    druckEinstellungen.pdfCallback = nullptr;
-    druckEinstellungen.pdfCallbackBenutzerdaten = nullptr;
-    return druckEinstellungen;
-}
+EricVorgang::~EricVorgang()
+{ }
 
-uint32_t holeBearbeitungsFlags(const System::KommandozeilenParser &argParser)
+uint32_t EricVorgang::ermittleBearbeitungsFlags(const System::KommandozeilenParser &argParser)
 {
     uint32_t bearbeitung = ERIC_VALIDIERE;
     if (argParser.getDatensatzSenden())
     {
         bearbeitung |= ERIC_SENDE;
-        if (!argParser.getHatTransferHandle())
-        { // Ein Tranferhandle ist nur für die Datenabholung relevant, die keinen Druck bietet
+        if (!argParser.getHatTransferHandle() && !argParser.getDruckNachgelagert())
+        { // Ein Tranferhandle ist nur für die Datenabholung relevant, die keinen Druck bietet.
+          // Ein nachgelagerter Druck erfolgt erst nach dem Versand, siehe EricNachdruck.
             bearbeitung |= ERIC_DRUCKE;
         }
     }
@@ -48,15 +48,6 @@ uint32_t holeBearbeitungsFlags(const System::KommandozeilenParser &argParser)
     return bearbeitung;
 }
 
-} // anonymous namespace
-
-
-EricVorgang::EricVorgang(const Eric& eric) : ericAdapter(eric)
-{ }
-
-EricVorgang::~EricVorgang()
-{ }
-
 void EricVorgang::leseDatensatz(const std::string &dateiName)
 {
     Datensatzleser leser;
@@ -64,11 +55,14 @@ void EricVorgang::leseDatensatz(const std::string &dateiName)
 }
 
 int EricVorgang::ausfuehren( const System::KommandozeilenParser &argParser, const EricZertifikat *zertifikat,
-                             std::string &ergebnis, std::string &antwort, EricTransferHandle &transferHandle ) const
+                             std::string &ergebnis, std::string &antwort, EricTransferHandle &transferHandle,
+                             EricPdfSammler &pdfSammler ) const
 {
+    const std::chrono::steady_clock::time_point beginn = std::chrono::steady_clock::now();
+    EricKosten kosten("vorgang", argParser.getDatenartVersion(), argParser.getMandant());
     System::titelZeile("Lese die Datensatzdatei \"" + argParser.getDatensatzDatei() + "\" mit Datenartversion \"" + argParser.getDatenartVersion() + "\" ein");
 
-    const uint32_t bearbeitungsFlags = holeBearbeitungsFlags(argParser);
+    const uint32_t bearbeitungsFlags = EricVorgang::ermittleBearbeitungsFlags(argParser);
     const bool sende =  bearbeitungsFlags & ERIC_SENDE;
     const bool drucke =  bearbeitungsFlags & ERIC_DRUCKE;
 
@@ -94,22 +88,79 @@ int EricVorgang::ausfuehren( const System::KommandozeilenParser &argParser, cons
         }
     }
 
-    EricPuffer ergebnisPuffer(ericAdapter);
     EricPuffer serverantwortPuffer(ericAdapter);
-    eric_druck_parameter_t druckEinstellungen = ::holeDruckeinstellungen();
+    eric_druck_parameter_t druckEinstellungen = pdfSammler.holeDruckeinstellungen(false);
     transferHandle = argParser.getTransferHandle();
     const eric_verschluesselungs_parameter_t *verschluesselungsParameter =
         zertifikat && sende ? &(zertifikat->getVerschlusselungsParameter()) : nullptr;
 
-    const int rc = ericAdapter.EricBearbeiteVorgang(
-        xmlDaten.c_str(), argParser.getDatenartVersion().c_str(),
-        bearbeitungsFlags, &druckEinstellungen, verschluesselungsParameter,
-        argParser.getHatTransferHandle() ? &transferHandle : nullptr,
-        ergebnisPuffer.handle(), serverantwortPuffer.handle() );
+    const auto bearbeiteVorgang = [&](std::string &vorgangsErgebnis) -> int
+    {
+        // Schemawidrige Datensaetze werden ohne Plausibilitaetspruefung, Druck und Versand abgewiesen
+        if (schemaVorpruefung != nullptr)
+        {
+            const int vorpruefungRc = schemaVorpruefung->pruefe(xmlDaten, argParser.getDatenartVersion(), vorgangsErgebnis);
+            if (vorpruefungRc != ERIC_OK)
+            {
+                std::cout << "Der Datensatz wurde von der Schemavorpruefung abgewiesen" << std::endl;
+                return vorpruefungRc;
+            }
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        EricPuffer ergebnisPuffer(ericAdapter);
+        const int vorgangsRc = ericAdapter.EricBearbeiteVorgang(
+            xmlDaten.c_str(), argParser.getDatenartVersion().c_str(),
+            bearbeitungsFlags, &druckEinstellungen, verschluesselungsParameter,
+            argParser.getHatTransferHandle() ? &transferHandle : nullptr,
+            ergebnisPuffer.handle(), serverantwortPuffer.handle() );
+        {
+            const EricSpuren::Spanne spanne("Ergebnis kopieren");
+            vorgangsErgebnis.assign(ergebnisPuffer.inhalt(),ergebnisPuffer.laenge());
+        }
+        const uint64_t pufferBytes = static_cast<uint64_t>(ergebnisPuffer.laenge()) + serverantwortPuffer.laenge();
+        EricMetriken::instanz().zaehle("eric_rueckgabepuffer_bytes_total", "api=\"st\"", pufferBytes);
+        kosten.erfassePuffer(pufferBytes);
+        if (sende)
+        {
+            EricMetriken::instanz().zaehle("eric_gesendet_bytes_total",
+                                           EricMetriken::label("datenartVersion", argParser.getDatenartVersion()), xmlDaten.size());
+        }
+
+        if (schemaVorpruefung != nullptr)
+        {
+            schemaVorpruefung->erfasseVollverarbeitung(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return vorgangsRc;
+    };
+
+    int rc = ERIC_OK;
+    if (validierungsCache != nullptr && EricValidierungsCache::istZwischenspeicherbar(bearbeitungsFlags))
+    {
+        // Eine reine Validierung desselben Datensatzes liefert immer dasselbe Ergebnis,
+        // gleichzeitige inhaltsgleiche Anfragen warten auf einen einzigen Aufruf
+        EricValidierungsCache::Herkunft herkunft = EricValidierungsCache::BERECHNET;
+        rc = validierungsCache->validiere(
+            validierungsCache->schluessel(xmlDaten, argParser.getDatenartVersion(), bearbeitungsFlags),
+            ergebnis, bearbeiteVorgang, herkunft);
+        if (herkunft == EricValidierungsCache::ZWISCHENSPEICHER)
+        {
+            std::cout << "Ergebnis aus dem Validierungscache" << std::endl;
+        }
+        else if (herkunft == EricValidierungsCache::GEBUENDELT)
+        {
+            std::cout << "Ergebnis einer gleichzeitigen, inhaltsgleichen Validierung uebernommen" << std::endl;
+        }
+    }
+    else
+    {
+        rc = bearbeiteVorgang(ergebnis);
+    }
 
-    ergebnis.assign(ergebnisPuffer.inhalt(),ergebnisPuffer.laenge());
     if (sende)
     {
+        const EricSpuren::Spanne spanne("Serverantwort kopieren");
         antwort.assign(serverantwortPuffer.inhalt(),serverantwortPuffer.laenge());
     }
     else
@@ -117,5 +168,15 @@ int EricVorgang::ausfuehren( const System::KommandozeilenParser &argParser, cons
         antwort.clear();
     }
 
+    // Mit Zwischenspeicher und Schemavorpruefung, also die Dauer, die der Aufrufer erlebt
+    EricMetriken &metriken = EricMetriken::instanz();
+    const std::string labels = EricMetriken::label("datenartVersion", argParser.getDatenartVersion());
+    metriken.messe("eric_vorgang_dauer_seconds", labels + "," + EricMetriken::label("bearbeitung", sende ? "senden" : "validieren"),
+                   std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beginn).count());
+    if (sende)
+    {
+        metriken.zaehle("eric_empfangen_bytes_total", labels, antwort.size());
+    }
+
     return rc;
 }
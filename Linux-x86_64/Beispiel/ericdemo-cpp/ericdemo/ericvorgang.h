@@ -6,6 +6,9 @@
 
 // Vorwaertsdeklarationen
 class Eric;
+class EricSchemaVorpruefung;
+class EricPdfSammler;
+class EricValidierungsCache;
 class EricZertifikat;
 
 namespace System { class KommandozeilenParser; }
@@ -21,24 +24,43 @@ public:
       *        Validierung und/oder Versand durchgefuehrt werden.
       *        Das uebergebene Objekt muss mindestens so lange leben, wie
       *        die erzeugte Instanz der Klasse EricVorgang, da diese eine Referenz darauf haelt!
+      * @param validierungsCache
+      *        Zwischenspeicher fuer Ergebnisse reiner Validierungen oder nullptr.
+      *        Fuer die Lebensdauer gilt dasselbe wie fuer das Schnittstellenobjekt.
+      * @param schemaVorpruefung
+      *        Vorgeschaltete Schemapruefung oder nullptr.
+      *        Fuer die Lebensdauer gilt dasselbe wie fuer das Schnittstellenobjekt.
       */
-    explicit EricVorgang(const Eric &eric);
+    explicit EricVorgang(const Eric &eric, EricValidierungsCache *validierungsCache = nullptr,
+                         EricSchemaVorpruefung *schemaVorpruefung = nullptr);
 
     virtual ~EricVorgang();
 
     /** @brief Führt den Vorgang gemäß der übergebenen Argumente aus
       *        und liefert das Ergebnis sowie gegebenenfalls bei Versand die Serverantwort
       *        und bei einer Datenabholung das Transferhandle zurück
+      *
+      * @param pdfSammler
+      *        Nimmt die beim Druck erzeugten PDFs im Speicher entgegen.
       */
     int ausfuehren( const System::KommandozeilenParser &argParser, const EricZertifikat *zertifikat,
-                    std::string &ergebnis, std::string &antwort, EricTransferHandle &transferHandle ) const;
+                    std::string &ergebnis, std::string &antwort, EricTransferHandle &transferHandle,
+                    EricPdfSammler &pdfSammler ) const;
+
+    /** @brief Die Bearbeitungsflags fuer EricBearbeiteVorgang() gemaess der uebergebenen Argumente */
+    static uint32_t ermittleBearbeitungsFlags(const System::KommandozeilenParser &argParser);
 
     /** @brief Lese den Steuersatz aus einer Datei ein
       */
     void leseDatensatz(const std::string& dateiName);
 
+    /** @brief Der eingelesene Datensatz */
+    const std::string &datensatz() const { return xmlDaten; }
+
 private:
     const Eric &                    ericAdapter;
+    EricValidierungsCache *         validierungsCache;
+    EricSchemaVorpruefung *         schemaVorpruefung;
     std::string                     xmlDaten;
 };
 
@@ -0,0 +1,215 @@
+#include "ericvorschau.h"
+
+#include <algorithm>
+#include <chrono>
+#include <eric_fehlercodes.h>
+
+#include "erickosten.h"
+#include "ericmetriken.h"
+#include "ericmt.h"
+#include "ericspuren.h"
+
+
+namespace
+{
+
+// Die Vorschau druckt ohne zu senden
+const uint32_t VORSCHAU_FLAGS = ERIC_VALIDIERE | ERIC_DRUCKE;
+
+} // anonymous namespace
+
+
+EricVorschau::EricVorschau(const EricMt &ericMt_, const std::string &ericVersion_, size_t maxGleichzeitig_, size_t maxEintraege_)
+    : ericMt(ericMt_),
+      ericVersion(ericVersion_),
+      maxGleichzeitig(std::max<size_t>(1, maxGleichzeitig_)),
+      maxEintraege(std::max<size_t>(1, maxEintraege_)),
+      statistik()
+{ }
+
+EricVorschau::~EricVorschau()
+{ }
+
+int EricVorschau::erzeuge(const std::string &xml, const std::string &datenartVersion, const std::string &mandant,
+                          std::shared_ptr<const Vorschau> &vorschau, EricValidierungsCache::Herkunft &herkunft)
+{
+    const EricSpuren::Anfrage anfrage("Vorschau", datenartVersion);
+    EricKosten kosten("vorschau", datenartVersion, mandant);
+    const Schluessel schluessel = EricValidierungsCache::berechneSchluessel(ericVersion, xml, datenartVersion, VORSCHAU_FLAGS);
+    if (finde(schluessel, vorschau))
+    {
+        herkunft = EricValidierungsCache::ZWISCHENSPEICHER;
+        return vorschau->rc;
+    }
+
+    // Die Vorschau eines laufenden Aufrufs wird ueber diese Variable an die gebuendelten Anfragen weitergegeben
+    std::shared_ptr<const Vorschau> gedruckt;
+    bool gebuendelt = false;
+    const Buendelung::Ergebnis ergebnis = buendelung.ausfuehren(schluessel, [&]() -> Buendelung::Ergebnis
+    {
+        std::shared_ptr<const Vorschau> neu;
+        if (!finde(schluessel, neu))
+        {
+            neu = drucke(xml, datenartVersion);
+            merke(schluessel, neu);
+        }
+        gedruckt = neu;
+        Buendelung::Ergebnis aufruf = { neu->rc, std::string() };
+        return aufruf;
+    }, gebuendelt);
+
+    if (!gebuendelt)
+    {
+        // Nur die ausfuehrende Anfrage hat den Ergebnispuffer belegt
+        kosten.erfassePuffer(gedruckt->ergebnis.size());
+        herkunft = EricValidierungsCache::BERECHNET;
+        vorschau = gedruckt;
+        return vorschau->rc;
+    }
+
+    herkunft = EricValidierungsCache::GEBUENDELT;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        ++statistik.gebuendelt;
+    }
+    if (!finde(schluessel, vorschau, false))
+    {
+        // Nicht bestaendige Fehler werden nicht abgelegt, es bleibt der Rueckgabewert
+        std::shared_ptr<Vorschau> fehler(new Vorschau());
+        fehler->rc = ergebnis.rc;
+        fehler->dauerMs = 0.0;
+        vorschau = fehler;
+    }
+    return vorschau->rc;
+}
+
+EricVorschau::Kennzahlen EricVorschau::kennzahlen() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    Kennzahlen momentaufnahme = statistik;
+    momentaufnahme.eintraege = index.size();
+    return momentaufnahme;
+}
+
+bool EricVorschau::finde(const Schluessel &schluessel, std::shared_ptr<const Vorschau> &vorschau, bool treffer)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+    const std::map<Schluessel, Verwendungsliste::iterator>::const_iterator fund = index.find(schluessel);
+    if (fund == index.end())
+    {
+        return false;
+    }
+    verwendung.splice(verwendung.begin(), verwendung, fund->second);
+    vorschau = fund->second->second;
+    if (treffer)
+    {
+        ++statistik.treffer;
+    }
+    return true;
+}
+
+void EricVorschau::merke(const Schluessel &schluessel, const std::shared_ptr<const Vorschau> &vorschau)
+{
+    if (!EricValidierungsCache::istErgebnisBestaendig(vorschau->rc))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    if (index.count(schluessel) > 0)
+    {
+        return;
+    }
+    verwendung.push_front(std::make_pair(schluessel, vorschau));
+    index[schluessel] = verwendung.begin();
+    while (verwendung.size() > maxEintraege)
+    {
+        index.erase(verwendung.back().first);
+        verwendung.pop_back();
+        ++statistik.verdraengt;
+    }
+}
+
+std::shared_ptr<const EricVorschau::Vorschau> EricVorschau::drucke(const std::string &xml, const std::string &datenartVersion)
+{
+    std::unique_ptr<EricMtInstanz> instanz = belegeInstanz();
+    std::shared_ptr<Vorschau> vorschau(new Vorschau());
+    try
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        EricPdfSammler pdfSammler;
+        const eric_druck_parameter_t druckEinstellungen = pdfSammler.holeDruckeinstellungen(true);
+        EricMtPuffer ergebnisPuffer(*instanz);
+        EricMtPuffer serverantwortPuffer(*instanz);
+        vorschau->rc = ericMt.EricMtBearbeiteVorgang(
+            instanz->handle(), xml.c_str(), datenartVersion.c_str(), VORSCHAU_FLAGS,
+            &druckEinstellungen, nullptr, nullptr, ergebnisPuffer.handle(), serverantwortPuffer.handle());
+        EricMetriken::instanz().zaehle("eric_rueckgabepuffer_bytes_total", "api=\"mt\"",
+                                       static_cast<uint64_t>(ergebnisPuffer.laenge()) + serverantwortPuffer.laenge());
+        {
+            const EricSpuren::Spanne spanne("Ergebnis kopieren");
+            vorschau->ergebnis.assign(ergebnisPuffer.inhalt(), ergebnisPuffer.laenge());
+            vorschau->pdfs = pdfSammler.pdfs();
+        }
+
+        vorschau->dauerMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    catch (...)
+    {
+        gibFrei(instanz);
+        throw;
+    }
+    gibFrei(instanz);
+
+    std::lock_guard<std::mutex> lock(sperre);
+    ++statistik.erzeugt;
+    return vorschau;
+}
+
+std::unique_ptr<EricMtInstanz> EricVorschau::belegeInstanz()
+{
+    const EricSpuren::Spanne spanne("Instanz belegen");
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(sperre);
+    while (freieInstanzen.empty() && statistik.instanzen >= maxGleichzeitig)
+    {
+        instanzFrei.wait(lock);
+    }
+    statistik.wartezeitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::unique_ptr<EricMtInstanz> instanz;
+    if (!freieInstanzen.empty())
+    {
+        instanz.swap(freieInstanzen.back());
+        freieInstanzen.pop_back();
+        return instanz;
+    }
+
+    // Neue Instanzen werden ausserhalb der Sperre erzeugt, der Platz ist bereits belegt
+    ++statistik.instanzen;
+    lock.unlock();
+    try
+    {
+        instanz.reset(new EricMtInstanz(ericMt));
+    }
+    catch (...)
+    {
+        lock.lock();
+        --statistik.instanzen;
+        lock.unlock();
+        instanzFrei.notify_one();
+        throw;
+    }
+    return instanz;
+}
+
+void EricVorschau::gibFrei(std::unique_ptr<EricMtInstanz> &instanz)
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        freieInstanzen.push_back(std::move(instanz));
+    }
+    instanzFrei.notify_one();
+}
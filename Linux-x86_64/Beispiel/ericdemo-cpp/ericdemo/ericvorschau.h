@@ -0,0 +1,128 @@
+#ifndef _ERICVORSCHAU_H_
+#define _ERICVORSCHAU_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ericbuendelung.h"
+#include "ericpdfsammler.h"
+#include "ericvalidierungscache.h"
+
+// Vorwaertsdeklarationen
+class EricMt;
+class EricMtInstanz;
+
+
+/** @brief Erzeugt Vorschau-PDFs von Datensaetzen parallel und haelt sie zwischengespeichert
+ *
+ * Eine Vorschau ist ein Druck mit vorschau = 1 und ERIC_VALIDIERE | ERIC_DRUCKE,
+ * ohne ERIC_SENDE. Die PDFs werden ueber den pdfCallback im Speicher
+ * entgegengenommen, siehe EricPdfSammler.
+ *
+ * Die Vorschauen laufen auf einem eigenen Vorrat von ERiC-Instanzen der
+ * Multithreading-API, dessen Groesse die Zahl gleichzeitiger Vorschauen
+ * begrenzt; weitere Anfragen warten auf eine freie Instanz. Ergebnisse werden
+ * unter dem SHA-256 ueber ERiC-Version, Datenartversion und Datensatz
+ * abgelegt (LRU), so dass die Vorschau eines unveraenderten Entwurfs ohne
+ * ERiC-Aufruf geliefert wird, siehe EricValidierungsCache::Schluessel. Jeder
+ * Eintrag behaelt diesen SHA-256, und ein Treffer verlangt Gleichheit aller
+ * 32 Bytes. Ein anderer Entwurf erhaelt so nie das PDF und Ergebnis-XML
+ * einer fremden Steuererklaerung. Gleichzeitige Anfragen fuer denselben
+ * Entwurf werden zu einem Aufruf gebuendelt, siehe EricBuendelung.
+ */
+class EricVorschau
+{
+public:
+    /** @brief Ergebnis einer Vorschau */
+    struct Vorschau
+    {
+        int                               rc;
+        std::string                       ergebnis;     // Ergebnis-XML
+        std::vector<EricPdfSammler::Pdf>  pdfs;
+        double                            dauerMs;      // Dauer des ERiC-Aufrufs
+    };
+
+    /** @brief Kennzahlen seit Erzeugung der Instanz */
+    struct Kennzahlen
+    {
+        uint64_t treffer;           // Aus dem Zwischenspeicher geliefert
+        uint64_t erzeugt;           // Tatsaechlich gedruckte Vorschauen
+        uint64_t gebuendelt;        // Ergebnis einer gleichzeitigen, inhaltsgleichen Anfrage uebernommen
+        uint64_t verdraengt;        // Aus dem Zwischenspeicher verdraengte Vorschauen
+        double   wartezeitMs;       // Summe der Wartezeiten auf eine freie ERiC-Instanz
+        size_t   instanzen;         // Bisher erzeugte ERiC-Instanzen
+        size_t   eintraege;         // Zwischengespeicherte Vorschauen
+    };
+
+    /**
+     * @param ericMt
+     *        Schnittstellenobjekt der Multithreading-API.
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse EricVorschau, da diese eine Referenz darauf haelt!
+     * @param ericVersion
+     *        Versionsangabe des ERiC, Teil des Schluessels
+     * @param maxGleichzeitig
+     *        Hoechstzahl gleichzeitiger Vorschauen und damit der ERiC-Instanzen, mindestens 1
+     * @param maxEintraege
+     *        Hoechstzahl der zwischengespeicherten Vorschauen, mindestens 1
+     */
+    EricVorschau(const EricMt &ericMt, const std::string &ericVersion, size_t maxGleichzeitig, size_t maxEintraege);
+
+    virtual ~EricVorschau();
+
+    /** @brief Liefert die Vorschau eines Datensatzes
+      *
+      * Darf aus beliebig vielen Threads gleichzeitig aufgerufen werden.
+      *
+      * @param mandant  Mandant, dem EricKosten die Anfrage zurechnet
+      * @param vorschau Erhaelt die Vorschau, auch im Fehlerfall
+      * @param herkunft Erhaelt die Herkunft der Vorschau
+      *
+      * @return Rueckgabewert des ERiC
+      *
+      * @throw Anwendungsfehler, wenn keine ERiC-Instanz erzeugt werden kann
+      */
+    int erzeuge(const std::string &xml, const std::string &datenartVersion, const std::string &mandant,
+                std::shared_ptr<const Vorschau> &vorschau, EricValidierungsCache::Herkunft &herkunft);
+
+    /** @brief Liefert eine Momentaufnahme der Kennzahlen */
+    Kennzahlen kennzahlen() const;
+
+private:
+    EricVorschau(const EricVorschau &); // Kopien verboten
+    EricVorschau &operator=(const EricVorschau &); // Zuweisungen verboten
+
+    typedef EricValidierungsCache::Schluessel Schluessel;   // SHA-256 der Eingabe
+    typedef EricBuendelung<Schluessel> Buendelung;
+    typedef std::list<std::pair<Schluessel, std::shared_ptr<const Vorschau> > > Verwendungsliste;
+
+    // treffer: als Treffer zaehlen; nicht fuer gebuendelte Anfragen, die eigens gezaehlt werden
+    bool finde(const Schluessel &schluessel, std::shared_ptr<const Vorschau> &vorschau, bool treffer = true);
+    void merke(const Schluessel &schluessel, const std::shared_ptr<const Vorschau> &vorschau);
+    std::shared_ptr<const Vorschau> drucke(const std::string &xml, const std::string &datenartVersion);
+
+    std::unique_ptr<EricMtInstanz> belegeInstanz();
+    void gibFrei(std::unique_ptr<EricMtInstanz> &instanz);
+
+    const EricMt &                               ericMt;
+    const std::string                            ericVersion;
+    const size_t                                 maxGleichzeitig;
+    const size_t                                 maxEintraege;
+
+    mutable std::mutex                           sperre;
+    std::condition_variable                      instanzFrei;
+    std::vector<std::unique_ptr<EricMtInstanz> > freieInstanzen;
+    Verwendungsliste                             verwendung;     // Vorne die zuletzt verwendeten Vorschauen
+    std::map<Schluessel, Verwendungsliste::iterator> index;
+    Kennzahlen                                   statistik;
+
+    Buendelung                                   buendelung;
+};
+
+#endif
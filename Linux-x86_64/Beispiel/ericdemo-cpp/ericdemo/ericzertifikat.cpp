@@ -2,6 +2,7 @@
 #include "anwendungsfehler.h"
 #include "eric.h"
 #include "ericpuffer.h"
+#include "ericspuren.h"
 
 EricZertifikat::EricZertifikat(const Eric& eric_, const std::string& pfad_, const std::string& pin_)
 : eric(eric_),
@@ -12,6 +13,7 @@ pin(System::kod::toWindowsZeichenKodierung(pin_))
 pin(pin_)
 #endif // WINDOWS_MSVC
 {
+    const EricSpuren::Spanne spanne("Zertifikat oeffnen");
     verschlusselungsParameter.version = 3;
     verschlusselungsParameter.zertifikatHandle = 0;
     verschlusselungsParameter.pin = pin == "_NULL" ? nullptr : pin.c_str();
@@ -0,0 +1,222 @@
+#include "ericzertifikatspruefung.h"
+
+#include <cstdlib>
+#include <eric_fehlercodes.h>
+
+#include "anwendungsfehler.h"
+#include "eric.h"
+#include "ericzertifikat.h"
+
+
+namespace
+{
+
+/** @brief Schluesselart fuer EricPruefeZertifikatPin() und EricGetPinStatus(): Signaturschluessel */
+const uint32_t SIGNATUR_SCHLUESSEL = 0;
+
+/** @brief Rueckgabewerte von EricGetPinStatus() */
+const uint32_t PIN_STATUS_GESPERRT = 1;
+
+/** @brief Bei eID-Client-URLs und Tokens ohne PIN ist keine PIN-Pruefung moeglich */
+bool istPinPruefbar(const std::string &pfad, const char *pin)
+{
+    return (pin != nullptr) && (pfad.find("://") == std::string::npos);
+}
+
+/** @brief Anzahl der Tage seit 1970-01-01 fuer ein Datum im gregorianischen Kalender */
+long tageSeitEpoche(long jahr, unsigned monat, unsigned tag)
+{
+    jahr -= monat <= 2 ? 1 : 0;
+    const long aera = (jahr >= 0 ? jahr : jahr - 399) / 400;
+    const unsigned jahrDerAera = static_cast<unsigned>(jahr - aera * 400);
+    const unsigned tagDesJahres = (153 * (monat + (monat > 2 ? -3 : 9)) + 2) / 5 + tag - 1;
+    const unsigned tagDerAera = jahrDerAera * 365 + jahrDerAera / 4 - jahrDerAera / 100 + tagDesJahres;
+    return aera * 146097 + static_cast<long>(tagDerAera) - 719468;
+}
+
+/** @brief Liest eine Zahl aus 'anzahl' Ziffern, -1 bei ungueltigen Zeichen */
+long leseZiffern(const std::string &text, size_t position, size_t anzahl)
+{
+    long wert = 0;
+    for (size_t i = position; i < position + anzahl; ++i)
+    {
+        if (i >= text.size() || text[i] < '0' || text[i] > '9')
+        {
+            return -1;
+        }
+        wert = wert * 10 + (text[i] - '0');
+    }
+    return wert;
+}
+
+/** @brief Ermittelt das Ablaufdatum aus den Zertifikatseigenschaften
+ *
+ * Das Element 'GueltigBis' enthaelt eine UTCTime (JJMMTThhmmssZ) oder
+ * GeneralizedTime (JJJJMMTThhmmssZ). Es wird das Ablaufdatum des zuerst
+ * aufgefuehrten Signaturzertifikats verwendet.
+ *
+ * @return Ablaufdatum oder 0, falls es nicht ermittelt werden konnte
+ */
+std::time_t leseGueltigBis(const std::string &eigenschaften)
+{
+    static const std::string START("<GueltigBis>");
+    static const std::string ENDE("</GueltigBis>");
+
+    const size_t start = eigenschaften.find(START);
+    if (start == std::string::npos)
+    {
+        return 0;
+    }
+    const size_t wertStart = start + START.size();
+    const size_t ende = eigenschaften.find(ENDE, wertStart);
+    if (ende == std::string::npos)
+    {
+        return 0;
+    }
+    const std::string wert = eigenschaften.substr(wertStart, ende - wertStart);
+
+    long jahr = -1;
+    size_t position = 0;
+    if (wert.size() == 13)
+    {
+        jahr = leseZiffern(wert, 0, 2);
+        jahr += jahr < 50 ? 2000 : 1900;
+        position = 2;
+    }
+    else if (wert.size() == 15)
+    {
+        jahr = leseZiffern(wert, 0, 4);
+        position = 4;
+    }
+
+    const long monat   = leseZiffern(wert, position, 2);
+    const long tag     = leseZiffern(wert, position + 2, 2);
+    const long stunde  = leseZiffern(wert, position + 4, 2);
+    const long minute  = leseZiffern(wert, position + 6, 2);
+    const long sekunde = leseZiffern(wert, position + 8, 2);
+    if (jahr < 0 || monat < 1 || monat > 12 || tag < 1 || tag > 31 || stunde < 0 || minute < 0 || sekunde < 0)
+    {
+        return 0;
+    }
+
+    const long tage = tageSeitEpoche(jahr, static_cast<unsigned>(monat), static_cast<unsigned>(tag));
+    return static_cast<std::time_t>(tage * 86400L + stunde * 3600L + minute * 60L + sekunde);
+}
+
+std::string schluessel(const std::string &pfad, const std::string &pin)
+{
+    return pfad + '\n' + pin;
+}
+
+/** @brief Nur diese Ergebnisse aendern sich ohne Zutun des Anwenders nicht und werden zwischengespeichert
+ *
+ * Abgelaufene Zertifikate liefert ermittle() mit ERIC_OK und Ablaufdatum.
+ * Andere Fehler, etwa ein nicht lesbares Token oder ein nicht erreichbarer
+ * eID-Client, koennen voruebergehend sein und werden bei jeder Anfrage neu
+ * ermittelt.
+ */
+bool istEndgueltig(int fehlerkode)
+{
+    return fehlerkode == ERIC_OK || fehlerkode == ERIC_CRYPT_E_PIN_WRONG || fehlerkode == ERIC_CRYPT_E_PIN_LOCKED;
+}
+
+} // anonymous namespace
+
+
+EricZertifikatsPruefung::EricZertifikatsPruefung(const Eric &eric_) : eric(eric_)
+{ }
+
+EricZertifikatsPruefung::~EricZertifikatsPruefung()
+{
+    for (Zwischenspeicher::iterator iter = ergebnisse.begin(); iter != ergebnisse.end(); ++iter)
+    {
+        delete iter->second.zertifikat;
+    }
+}
+
+int EricZertifikatsPruefung::pruefe(const std::string &pfad, const std::string &pin, const EricZertifikat *&zertifikat)
+{
+    zertifikat = nullptr;
+
+    std::lock_guard<std::mutex> lock(sperre);
+
+    const std::string key = schluessel(pfad, pin);
+    Zwischenspeicher::iterator eintrag = ergebnisse.find(key);
+    if (eintrag == ergebnisse.end())
+    {
+        const Pruefergebnis neu = ermittle(pfad, pin);
+        if (!istEndgueltig(neu.fehlerkode))
+        {
+            return neu.fehlerkode;
+        }
+        eintrag = ergebnisse.insert(std::make_pair(key, neu)).first;
+    }
+
+    const Pruefergebnis &ergebnis = eintrag->second;
+    if (ergebnis.fehlerkode != ERIC_OK)
+    {
+        return ergebnis.fehlerkode;
+    }
+    if (ergebnis.gueltigBis != 0 && ergebnis.gueltigBis < std::time(nullptr))
+    {
+        return ERIC_CRYPT_ZERTIFIKAT;
+    }
+
+    zertifikat = ergebnis.zertifikat;
+    return ERIC_OK;
+}
+
+void EricZertifikatsPruefung::verwerfe(const std::string &pfad)
+{
+    std::lock_guard<std::mutex> lock(sperre);
+
+    const std::string praefix = pfad + '\n';
+    Zwischenspeicher::iterator iter = ergebnisse.lower_bound(praefix);
+    while (iter != ergebnisse.end() && iter->first.compare(0, praefix.size(), praefix) == 0)
+    {
+        delete iter->second.zertifikat;
+        ergebnisse.erase(iter++);
+    }
+}
+
+EricZertifikatsPruefung::Pruefergebnis EricZertifikatsPruefung::ermittle(const std::string &pfad, const std::string &pin) const
+{
+    Pruefergebnis ergebnis = { ERIC_OK, 0, nullptr };
+    const char *pinZeiger = pin == "_NULL" ? nullptr : pin.c_str();
+
+    // 1. PIN pruefen, bevor ein Zertifikatshandle geoeffnet wird (Empfehlung der API-Referenz)
+    if (istPinPruefbar(pfad, pinZeiger))
+    {
+        ergebnis.fehlerkode = eric.EricPruefeZertifikatPin(pfad.c_str(), pinZeiger, SIGNATUR_SCHLUESSEL);
+        if (ergebnis.fehlerkode != ERIC_OK)
+        {
+            return ergebnis;
+        }
+    }
+
+    // 2. Zertifikat oeffnen und Eigenschaften lesen
+    EricZertifikat *zertifikat = nullptr;
+    try
+    {
+        zertifikat = new EricZertifikat(eric, pfad, pin);
+    }
+    catch (const Anwendungsfehler &)
+    {
+        ergebnis.fehlerkode = ERIC_CRYPT_ZERTIFIKAT;
+        return ergebnis;
+    }
+
+    // 3. Gesperrte PINs erkennen, ohne einen weiteren Fehlversuch auszuloesen
+    uint32_t pinStatus = 0;
+    if (eric.EricGetPinStatus(zertifikat->getHandle(), &pinStatus, SIGNATUR_SCHLUESSEL) == ERIC_OK
+        && pinStatus == PIN_STATUS_GESPERRT)
+    {
+        delete zertifikat;
+        ergebnis.fehlerkode = ERIC_CRYPT_E_PIN_LOCKED;
+        return ergebnis;
+    }
+
+    ergebnis.gueltigBis = leseGueltigBis(zertifikat->getEigenschaften());
+    ergebnis.zertifikat = zertifikat;
+    return ergebnis;
+}
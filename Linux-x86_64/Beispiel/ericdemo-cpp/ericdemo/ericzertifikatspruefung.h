@@ -0,0 +1,80 @@
+#ifndef _ERICZERTIFIKATSPRUEFUNG_H_
+#define _ERICZERTIFIKATSPRUEFUNG_H_
+
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <ericapi.h>
+
+// Vorwaertsdeklarationen
+class Eric;
+class EricZertifikat;
+
+
+/** @brief Vorabpruefung von Zertifikat und PIN mit Zwischenspeicher
+ *
+ * Eine falsche PIN faellt bei EricBearbeiteVorgang() erst nach Einlesen,
+ * Validierung und Versandvorbereitung auf. Diese Klasse prueft PIN,
+ * PIN-Status und Gueltigkeit eines Zertifikats einmalig ueber
+ * EricPruefeZertifikatPin() und EricGetPinStatus() und merkt sich das
+ * Ergebnis zusammen mit dem geoeffneten Zertifikat. Folgeanfragen mit
+ * demselben Zertifikat und derselben PIN werden ohne weiteren ERiC-Aufruf
+ * beantwortet. Gemerkt werden nur endgueltige Ergebnisse: gueltiges oder
+ * abgelaufenes Zertifikat, falsche und gesperrte PIN. Andere Fehler werden
+ * bei der naechsten Anfrage erneut ermittelt.
+ */
+class EricZertifikatsPruefung
+{
+public:
+    /** @brief Erzeugt eine Instanz der Klasse 'EricZertifikatsPruefung'
+      *
+      * @param eric
+      *        Schnittstellenobjekt, das den ERiC kapselt.
+      *        Das uebergebene Objekt muss mindestens so lange leben, wie
+      *        die erzeugte Instanz der Klasse EricZertifikatsPruefung, da diese eine Referenz darauf haelt!
+      */
+    explicit EricZertifikatsPruefung(const Eric &eric);
+
+    /** @brief Schliesst alle zwischengespeicherten Zertifikate */
+    virtual ~EricZertifikatsPruefung();
+
+    /** @brief Prueft Zertifikat und PIN und liefert bei Erfolg das geoeffnete Zertifikat
+      *
+      * @param pfad Pfad des Zertifikats, wie er EricGetHandleToCertificate() uebergeben wird
+      * @param pin  PIN des Zertifikats, "_NULL" fuer keine PIN
+      * @param zertifikat Erhaelt bei ERIC_OK das geoeffnete Zertifikat, sonst nullptr.
+      *        Das Zertifikat gehoert dieser Instanz und bleibt bis zu ihrer Zerstoerung gueltig.
+      *
+      * @return
+      *         - ERIC_OK, wenn das Zertifikat verwendet werden kann
+      *         - ERIC_CRYPT_E_PIN_WRONG, ERIC_CRYPT_E_PIN_LOCKED oder ein anderer
+      *           Fehlercode von EricPruefeZertifikatPin() bzw. EricGetHandleToCertificate()
+      *         - ERIC_CRYPT_ZERTIFIKAT, wenn das Zertifikat abgelaufen ist
+      */
+    int pruefe(const std::string &pfad, const std::string &pin, const EricZertifikat *&zertifikat);
+
+    /** @brief Verwirft das zwischengespeicherte Ergebnis fuer ein Zertifikat, z. B. nach einer PIN-Aenderung */
+    void verwerfe(const std::string &pfad);
+
+private:
+    EricZertifikatsPruefung(const EricZertifikatsPruefung &); // Kopien verboten
+    EricZertifikatsPruefung &operator=(const EricZertifikatsPruefung &); // Zuweisungen verboten
+
+    struct Pruefergebnis
+    {
+        int             fehlerkode;
+        std::time_t     gueltigBis;   // 0, falls unbekannt
+        EricZertifikat *zertifikat;   // nur bei fehlerkode == ERIC_OK gesetzt
+    };
+
+    typedef std::map<std::string, Pruefergebnis> Zwischenspeicher;
+
+    Pruefergebnis ermittle(const std::string &pfad, const std::string &pin) const;
+
+    const Eric      &eric;
+    std::mutex       sperre;
+    Zwischenspeicher ergebnisse;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "sha256.h"
+
+#include <cstring>
+
+
+namespace
+{
+
+const uint32_t RUNDENKONSTANTEN[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotiere(uint32_t wert, unsigned int bits)
+{
+    return (wert >> bits) | (wert << (32 - bits));
+}
+
+} // anonymous namespace
+
+
+Sha256::Sha256()
+    : pufferLaenge(0),
+      gesamtLaenge(0)
+{
+    static const uint32_t startwerte[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    std::memcpy(zustand, startwerte, sizeof(zustand));
+}
+
+void Sha256::fuegeHinzu(const void *daten, size_t laenge)
+{
+    const unsigned char *zeichen = static_cast<const unsigned char *>(daten);
+    gesamtLaenge += laenge;
+
+    if (pufferLaenge > 0)
+    {
+        const size_t anzahl = laenge < sizeof(puffer) - pufferLaenge ? laenge : sizeof(puffer) - pufferLaenge;
+        std::memcpy(puffer + pufferLaenge, zeichen, anzahl);
+        pufferLaenge += anzahl;
+        zeichen += anzahl;
+        laenge -= anzahl;
+        if (pufferLaenge < sizeof(puffer))
+        {
+            return;
+        }
+        verarbeiteBlock(puffer);
+        pufferLaenge = 0;
+    }
+
+    // Ganze Bloecke werden ohne Umweg ueber den Puffer verarbeitet
+    for (; laenge >= sizeof(puffer); zeichen += sizeof(puffer), laenge -= sizeof(puffer))
+    {
+        verarbeiteBlock(zeichen);
+    }
+
+    std::memcpy(puffer, zeichen, laenge);
+    pufferLaenge = laenge;
+}
+
+void Sha256::fuegeFeldHinzu(const std::string &text)
+{
+    fuegeZahlHinzu(text.size());
+    fuegeHinzu(text.data(), text.size());
+}
+
+void Sha256::fuegeZahlHinzu(uint64_t zahl)
+{
+    unsigned char bytes[8];
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(zahl >> (56 - 8 * i));
+    }
+    fuegeHinzu(bytes, sizeof(bytes));
+}
+
+Sha256::Wert Sha256::wert()
+{
+    const uint64_t bits = gesamtLaenge * 8;
+
+    // Auffuellen mit 0x80 und Nullen bis 8 Bytes vor Blockende, dann die Laenge in Bits
+    static const unsigned char fuellung[64] = { 0x80 };
+    fuegeHinzu(fuellung, pufferLaenge < 56 ? 56 - pufferLaenge : 120 - pufferLaenge);
+    fuegeZahlHinzu(bits);
+
+    Wert ergebnis;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        ergebnis[4 * i]     = static_cast<unsigned char>(zustand[i] >> 24);
+        ergebnis[4 * i + 1] = static_cast<unsigned char>(zustand[i] >> 16);
+        ergebnis[4 * i + 2] = static_cast<unsigned char>(zustand[i] >> 8);
+        ergebnis[4 * i + 3] = static_cast<unsigned char>(zustand[i]);
+    }
+    return ergebnis;
+}
+
+void Sha256::verarbeiteBlock(const unsigned char *block)
+{
+    uint32_t w[64];
+    for (size_t i = 0; i < 16; ++i)
+    {
+        w[i] = (static_cast<uint32_t>(block[4 * i]) << 24) | (static_cast<uint32_t>(block[4 * i + 1]) << 16)
+             | (static_cast<uint32_t>(block[4 * i + 2]) << 8) | static_cast<uint32_t>(block[4 * i + 3]);
+    }
+    for (size_t i = 16; i < 64; ++i)
+    {
+        const uint32_t s0 = rotiere(w[i - 15], 7) ^ rotiere(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const uint32_t s1 = rotiere(w[i - 2], 17) ^ rotiere(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = zustand[0], b = zustand[1], c = zustand[2], d = zustand[3];
+    uint32_t e = zustand[4], f = zustand[5], g = zustand[6], h = zustand[7];
+    for (size_t i = 0; i < 64; ++i)
+    {
+        const uint32_t s1 = rotiere(e, 6) ^ rotiere(e, 11) ^ rotiere(e, 25);
+        const uint32_t ch = (e & f) ^ (~e & g);
+        const uint32_t t1 = h + s1 + ch + RUNDENKONSTANTEN[i] + w[i];
+        const uint32_t s0 = rotiere(a, 2) ^ rotiere(a, 13) ^ rotiere(a, 22);
+        const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t t2 = s0 + maj;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    zustand[0] += a;
+    zustand[1] += b;
+    zustand[2] += c;
+    zustand[3] += d;
+    zustand[4] += e;
+    zustand[5] += f;
+    zustand[6] += g;
+    zustand[7] += h;
+}
@@ -0,0 +1,43 @@
+#ifndef _SHA256_H_
+#define _SHA256_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/** @brief SHA-256 nach FIPS 180-4 ueber schrittweise hinzugefuegte Daten
+ *
+ * Dient als kollisionsresistenter Inhaltsschluessel fuer Zwischenspeicher,
+ * deren Treffer ohne Vergleich der Eingabe geliefert werden.
+ */
+class Sha256
+{
+public:
+    typedef std::array<unsigned char, 32> Wert;
+
+    Sha256();
+
+    /** @brief Fuegt einen Speicherbereich hinzu */
+    void fuegeHinzu(const void *daten, size_t laenge);
+
+    /** @brief Fuegt einen Text mit vorangestellter Laenge hinzu, damit Feldgrenzen eindeutig sind */
+    void fuegeFeldHinzu(const std::string &text);
+
+    /** @brief Fuegt eine Zahl in fester Byte-Reihenfolge hinzu */
+    void fuegeZahlHinzu(uint64_t zahl);
+
+    /** @brief Schliesst die Berechnung ab; danach duerfen keine Daten mehr hinzugefuegt werden */
+    Wert wert();
+
+private:
+    void verarbeiteBlock(const unsigned char *block);
+
+    uint32_t      zustand[8];
+    unsigned char puffer[64];
+    size_t        pufferLaenge;
+    uint64_t      gesamtLaenge;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <platform.h>
@@ -11,6 +12,7 @@
 
 #ifdef _WIN32
 #   include <direct.h>
+#   include <psapi.h>
 #   include <shlwapi.h>
 
 
@@ -18,6 +20,13 @@ namespace {
        bool istPfadseparator(const char c) { return (PFAD_SEPARATOR==c) || ('/'==c); }
 }
 #else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/resource.h>
+#   include <sys/stat.h>
+#   include <sys/syscall.h>
+#   include <time.h>
+#   include <unistd.h>
 extern char **environ;
 namespace {
     bool istPfadseparator(const char c) { return (PFAD_SEPARATOR==c); }
@@ -30,6 +39,7 @@ const std::string KommandozeilenParser::defaultZertifikatPfad("test-softidnr-pse
 const std::string KommandozeilenParser::defaultZertifikatPin("123456");
 const std::string KommandozeilenParser::defaultDatensatzDatei("ESt_2020.xml");
 const std::string KommandozeilenParser::defaultDatenartVersion("ESt_2020");
+const std::string KommandozeilenParser::defaultMandant("unbekannt");
 
 KommandozeilenParser::KommandozeilenParser() :
     parseOk(true),
@@ -43,7 +53,30 @@ KommandozeilenParser::KommandozeilenParser() :
     datensatzSenden(true),
     hilfeAnzeigen(false),
     datenEntschluesseln(false),
+    schemaVorpruefung(false),
+    feldpruefung(false),
+    auswahllistenAnzeigen(false),
+    druckNachgelagert(false),
+    vorschau(false),
     ausgabeDatei(),
+    cezVerzeichnis(),
+    cacheVerzeichnis(),
+    strukturDatei(),
+    bufaNummer(),
+    steuernummernDatei(),
+    spaltenDatei(),
+    archivVerzeichnis(),
+    metrikPort(0),
+    metrikDatei(),
+    logEbene(),
+    spurDatei(),
+    spurAnteil(1.0),
+    mitschnittVerzeichnis(),
+    mitschnittSchwelleMs(1000.0),
+    mitschnittAnzahl(20),
+    mitschnittSchwaerzen(true),
+    steuernummernVergleich(false),
+    mandant(),
     transferHandle(0),
     hatTransferHandle(false)
 { }
@@ -55,6 +88,7 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
 #endif
 {
     char letzteOption = 0;
+    std::string langeOption;
 
     for (auto iter(argumente.begin()); iter != argumente.end(); ++iter) {
         if (aufrufPfad.empty()) {
@@ -62,8 +96,29 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
             continue;
         }
 
+        if (2 < iter->size() && OPT_PRAEFIX == iter->at(0) && OPT_PRAEFIX == iter->at(1)) {
+            if (0 != letzteOption || !langeOption.empty()) {
+                parseOk = false;
+                throw Anwendungsfehler(std::string("Fehlender Parameter fuer Option ") + *PREVIOUS(iter));
+            }
+            const std::string name = iter->substr(2);
+            if ("mitschnitt-ungeschwaerzt" == name) {
+                mitschnittSchwaerzen = false;
+            } else if ("steuernummern-vergleich" == name) {
+                steuernummernVergleich = true;
+            } else if ("spuren" == name || "spuren-anteil" == name || "mitschnitt" == name
+                    || "mitschnitt-schwelle-ms" == name || "mitschnitt-anzahl" == name || "mandant" == name) {
+                // Lange Optionen, die einen nachfolgenden Parameter erwarten
+                langeOption = name;
+            } else {
+                parseOk = false;
+                throw Anwendungsfehler(std::string("Unbekannte Option ") + *iter);
+            }
+            continue;
+        }
+
         if (OPT_PRAEFIX == iter->at(0)) {
-            if (0 == letzteOption) {
+            if (0 == letzteOption && langeOption.empty()) {
                 letzteOption = std::tolower(iter->at(1), std::locale(""));
                 switch (letzteOption) {
                 case 'h':
@@ -76,6 +131,26 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
                     datensatzSenden = false;
                     letzteOption = 0;
                     break;
+                case 'f':
+                    schemaVorpruefung = true;
+                    letzteOption = 0;
+                    break;
+                case 'i':
+                    feldpruefung = true;
+                    letzteOption = 0;
+                    break;
+                case 'a':
+                    auswahllistenAnzeigen = true;
+                    letzteOption = 0;
+                    break;
+                case 'g':
+                    druckNachgelagert = true;
+                    letzteOption = 0;
+                    break;
+                case 'o':
+                    vorschau = true;
+                    letzteOption = 0;
+                    break;
                 case 'l': // Protokollverzeichnis (log_dir)
                 case 'd': // Heimverzeichnis (home_dir)
                 case 'c': // Pfad zum Zertifikat
@@ -84,6 +159,16 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
                 case 'x': // Datensatz.xml
                 case 's': // Rueckgabe speichern
                 case 't': // Transferhandle
+                case 'k': // CEZ-Schluesselverzeichnis
+                case 'z': // Verzeichnis des Validierungscaches
+                case 'j': // Strukturiertes Ergebnis speichern
+                case 'b': // Bundesfinanzamtsnummer
+                case 'r': // Steuernummerndatei
+                case 'm': // Spaltendatei fuer die Massenpruefung
+                case 'y': // Archivverzeichnis
+                case 'u': // Port des Metrik-Endpunkts
+                case 'w': // Ausgabedatei der Metriken
+                case 'q': // Mindestebene des JSON-Logs
                     // Optionen, die einen nachfolgenden Parameter erwarten
                     // Fuer solche Optionen ist hier noch nichts zu tun
                     break;
@@ -102,6 +187,9 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
                 parseOk = false;
                 throw Anwendungsfehler(std::string("Fehlender Parameter fuer Option ") + *PREVIOUS(iter));
             }
+        } else if (!langeOption.empty()) {
+            setzeLangeOption(langeOption, *iter);
+            langeOption.clear();
         } else {
             switch (letzteOption) {
             case 'l': // Protokollverzeichnis (log_dir)
@@ -132,6 +220,49 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
                     throw Anwendungsfehler(std::string("Ungueltiger Parameter fuer Option ") + *PREVIOUS(iter));
                 }
                 break;
+            case 'k': // CEZ-Schluesselverzeichnis
+                cezVerzeichnis.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'z': // Verzeichnis des Validierungscaches
+                cacheVerzeichnis.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'j': // Strukturiertes Ergebnis speichern
+                strukturDatei.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'b': // Bundesfinanzamtsnummer
+                bufaNummer.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'r': // Steuernummerndatei
+                steuernummernDatei.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'm': // Spaltendatei fuer die Massenpruefung
+                spaltenDatei.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'y': // Archivverzeichnis
+                archivVerzeichnis.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'u': // Port des Metrik-Endpunkts
+                try {
+#if defined(__xlC__) && !defined(__clang__)
+                    const unsigned long port = System::toUlong(*iter);
+#else
+                    const unsigned long port = std::stoul(*iter);
+#endif
+                    if (port == 0 || port > 65535) {
+                        throw std::invalid_argument(*iter);
+                    }
+                    metrikPort = static_cast<unsigned short>(port);
+                } catch (const std::logic_error &) { // invalid_argument oder out_of_range
+                    parseOk = false;
+                    throw Anwendungsfehler(std::string("Ungueltiger Parameter fuer Option ") + *PREVIOUS(iter));
+                }
+                break;
+            case 'w': // Ausgabedatei der Metriken
+                metrikDatei.assign(MOVE_NO_XLC(*iter));
+                break;
+            case 'q': // Mindestebene des JSON-Logs
+                logEbene.assign(MOVE_NO_XLC(*iter));
+                break;
             case 'v': // Datenartversion
                 datenartVersion.assign(MOVE_NO_XLC(*iter));
                 break;
@@ -152,10 +283,50 @@ void KommandozeilenParser::parseKommandozeile( std::vector<std::string> &&argume
         }
     }
 
+    if (!langeOption.empty()) {
+        parseOk = false;
+        throw Anwendungsfehler(std::string("Fehlender Parameter fuer Option ") + OPT_PRAEFIX + OPT_PRAEFIX + langeOption);
+    }
+
     if (datenEntschluesseln && !datenartVersion.empty()) {
         parseOk = false;
         throw Anwendungsfehler(std::string("Die Optionen ") + OPT_PRAEFIX + 'v' + " und " + OPT_PRAEFIX + "e schliessen sich gegenseitig aus.");
     }
+
+    if (datenEntschluesseln && !cezVerzeichnis.empty()) {
+        parseOk = false;
+        throw Anwendungsfehler(std::string("Die Optionen ") + OPT_PRAEFIX + 'k' + " und " + OPT_PRAEFIX + "e schliessen sich gegenseitig aus.");
+    }
+}
+
+void KommandozeilenParser::setzeLangeOption(const std::string& name, const std::string& wert) {
+    const char *const anfang = wert.c_str();
+    char *ende = nullptr;
+    bool gueltig = true;
+
+    if ("spuren" == name) {
+        spurDatei = wert;
+    } else if ("mitschnitt" == name) {
+        mitschnittVerzeichnis = wert;
+    } else if ("mandant" == name) {
+        mandant = wert;
+        gueltig = !wert.empty();
+    } else if ("spuren-anteil" == name) {
+        spurAnteil = std::strtod(anfang, &ende);
+        gueltig = ende != anfang && '\0' == *ende && 0.0 <= spurAnteil && spurAnteil <= 1.0;
+    } else if ("mitschnitt-schwelle-ms" == name) {
+        mitschnittSchwelleMs = std::strtod(anfang, &ende);
+        gueltig = ende != anfang && '\0' == *ende && 0.0 <= mitschnittSchwelleMs;
+    } else if ("mitschnitt-anzahl" == name) {
+        const unsigned long anzahl = std::strtoul(anfang, &ende, 10);
+        gueltig = ende != anfang && '\0' == *ende && 0 < anzahl && '-' != wert[0];
+        mitschnittAnzahl = static_cast<size_t>(anzahl);
+    }
+
+    if (!gueltig) {
+        parseOk = false;
+        throw Anwendungsfehler(std::string("Ungueltiger Parameter fuer Option ") + OPT_PRAEFIX + OPT_PRAEFIX + name);
+    }
 }
 
 void KommandozeilenParser::zeigeHilfe(std::ostream& ostream) {
@@ -165,7 +336,7 @@ void KommandozeilenParser::zeigeHilfe(std::ostream& ostream) {
         << "    " << OPT_PRAEFIX << 'h'
         << "                   Diese Hilfe ausgeben" << NEW_LINE
         << "    " << OPT_PRAEFIX << 'v' << " <datenartversion>"
-        << " Datenartversion" << NEW_LINE
+        << " Datenartversion, ohne Angabe wird sie aus dem Datensatz ermittelt" << NEW_LINE
         << "    " << OPT_PRAEFIX << 'x' << " <xml>"
         << "             Pfad zur Datensatzdatei" << NEW_LINE
         << "    " << OPT_PRAEFIX << 'c' << " <certificate>"
@@ -178,15 +349,50 @@ void KommandozeilenParser::zeigeHilfe(std::ostream& ostream) {
         << "             Pfad zum Verzeichnis, in dem die ERiC-Protokolldateien geschrieben werden" << NEW_LINE
         << "    " << OPT_PRAEFIX << 's' << " <dateipfad>"
         << "       Schreibt die Serverantwort oder - wenn nicht vorhanden - das Ergebnis in die angegebene Datei" << NEW_LINE
+        << "                         und beim Versand erzeugte PDFs nach <dateipfad>.<n>.pdf" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'j' << " <dateipfad>"
+        << "       Schreibt Fehler, Hinweise, Transferticket und Returncodes strukturiert als JSON, bei der Endung .bin im Binaerformat" << NEW_LINE
         << "    " << OPT_PRAEFIX << 't' << " <transferhandle>"
         << "  Transferhandle, das an die Server uebermittelt wird (nur bei Datenabholungen anzugeben)" << NEW_LINE
         << "    " << OPT_PRAEFIX << 'n'
         << "                   Der Datensatz soll nicht versendet, sondern nur validiert werden" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'f'
+        << "                   Den Datensatz vorab nur gegen das Schema pruefen und bei Schemafehlern sofort abweisen" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'i'
+        << "                   Steuernummer, IdNr, IBAN und BIC vorab mit dem ERiC-Toolkit pruefen, ohne den ERiC zu laden" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'g'
+        << "                   Ohne Druck versenden und die PDFs anschliessend im Hintergrund mit dem Transferticket erzeugen" << NEW_LINE
         << "    " << OPT_PRAEFIX << 'e'
         << "                   Der Datensatz soll nicht validiert oder versendet, sondern entschluesselt werden" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'k' << " <verzeichnis>"
+        << "     Erzeugt ein Schluesselpaar fuer ein clientseitig erzeugtes Zertifikat (CEZ) mit der PIN <pin> im angegebenen Verzeichnis" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'z' << " <verzeichnis>"
+        << "     Ergebnisse reiner Validierungen in diesem Verzeichnis zwischenspeichern und wiederverwenden" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'y' << " <verzeichnis>"
+        << "     Datensatz, Serverantwort, Ergebnis und PDFs eines Versands komprimiert und dedupliziert in diesem Verzeichnis archivieren" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'u' << " <port>"
+        << "            Stellt die Metriken im Prometheus-Textformat unter http://127.0.0.1:<port>/metrics bereit, bis das Programm endet" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'w' << " <datei>"
+        << "           Schreibt die Metriken im Prometheus-Textformat alle 10 Sekunden und bei Programmende in die Datei" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'q' << " <ebene>"
+        << "           Lognachrichten der ERiC-Instanzen ab trace, debug, info, warn oder error nach eric.jsonl statt eric.log schreiben" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'b' << " <bufanummer>"
+        << "      Fragt das Finanzamt zur vierstelligen Bundesfinanzamtsnummer direkt beim ERiC ab und gibt es aus" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'r' << " <datei>"
+        << "           Normalisiert die Steuernummern der Datei (je Zeile Steuernummer;Landesnummer oder Bundesfinanzamtsnummer) parallel;" << NEW_LINE
+        << "                         das Ergebnis geht an die Standardausgabe oder in die Datei der Option " << OPT_PRAEFIX << "s" << "," << NEW_LINE
+        << "                         die Statistik im ersten Fall an die Standardfehlerausgabe" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'm' << " <datei>"
+        << "           Prueft die Spalten IBAN, IdNr und StNr einer CSV-Datei mit Kopfzeile gesammelt, vergleicht mit dem ERiC-Toolkit" << NEW_LINE
+        << "                         und gibt den Durchsatz beider Pruefungen aus" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'a'
+        << "                   Gibt die Auswahllisten zur Datenartversion als JSON aus" << NEW_LINE
+        << "    " << OPT_PRAEFIX << 'o'
+        << "                   Erzeugt die Vorschau-PDFs des Datensatzes ohne Versand, mehrfach gleichzeitig und erneut aus dem Zwischenspeicher;" << NEW_LINE
+        << "                         mit " << OPT_PRAEFIX << "s werden die PDFs nach <dateipfad>.<n>.pdf geschrieben" << NEW_LINE
         << NEW_LINE
         << "Standardwerte:" << NEW_LINE
-        << "    <datenartversion>: ESt_2020" << NEW_LINE
+        << "    <datenartversion>: aus dem Datensatz ermittelt, sonst ESt_2020" << NEW_LINE
         << "    <xml>:             ESt_2020.xml" << NEW_LINE
         << "    <certificate>:     test-softidnr-pse.pfx" << NEW_LINE
         << "    <pin>:             123456" << NEW_LINE
@@ -197,6 +403,28 @@ void KommandozeilenParser::zeigeHilfe(std::ostream& ostream) {
 #endif
         << "    <log>:             <Arbeitsverzeichnis>" << NEW_LINE
         << NEW_LINE
+        << "Weitere Optionen:" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "spuren <datei>" << NEW_LINE
+        << "                         Zeichnet die Zeitspannen von Vorgaengen, Nachdrucken und Vorschauen auf und schreibt sie" << NEW_LINE
+        << "                         bei Programmende im Chrome-Trace-Format (chrome://tracing, Perfetto) in diese Datei" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "spuren-anteil <anteil>" << NEW_LINE
+        << "                         Aufgezeichneter Anteil der Anfragen zwischen 0 und 1, Standard 1" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "mitschnitt <verzeichnis>" << NEW_LINE
+        << "                         Schneidet langsame Vorgaenge und nachgelagerte Drucke mit geschwaerztem Datensatz, Phasendauern" << NEW_LINE
+        << "                         und Arbeitsspeicher in diesem Verzeichnis mit, samt Skript zur Wiederholung als Validierung" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "mitschnitt-schwelle-ms <ms>" << NEW_LINE
+        << "                         Gesamtdauer in Millisekunden, ab der mitgeschnitten wird, Standard 1000" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "mitschnitt-anzahl <anzahl>" << NEW_LINE
+        << "                         Hoechstzahl der Mitschnitte, danach wird der aelteste ersetzt, Standard 20" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "mitschnitt-ungeschwaerzt" << NEW_LINE
+        << "                         Den Datensatz im Klartext mitschneiden, statt Buchstaben und Ziffern durch X bzw. 0 zu ersetzen;" << NEW_LINE
+        << "                         der Mitschnitt enthaelt dann personenbezogene Steuerdaten" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "steuernummern-vergleich" << NEW_LINE
+        << "                         Steuernummern der Option " << OPT_PRAEFIX << "r zum Vergleich zusaetzlich auf einer einzelnen" << NEW_LINE
+        << "                         ERiC-Instanz normalisieren und die Beschleunigung ausgeben" << NEW_LINE
+        << "    " << OPT_PRAEFIX << OPT_PRAEFIX << "mandant <mandant>" << NEW_LINE
+        << "                         Mandant, dem die Kosten der Anfragen in den Metriken zugerechnet werden, Standard unbekannt" << NEW_LINE
+        << NEW_LINE
         << "Beispiele:" << NEW_LINE
         << "    " << aufrufPfad << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "?" << NEW_LINE
@@ -204,11 +432,22 @@ void KommandozeilenParser::zeigeHilfe(std::ostream& ostream) {
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2016 " << OPT_PRAEFIX << "x ESt_2016.xml " << OPT_PRAEFIX << "c _NULL " << OPT_PRAEFIX << "p _NULL" << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml "
                                        << OPT_PRAEFIX << "n" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml "
+                                       << OPT_PRAEFIX << "n " << OPT_PRAEFIX << "z validierungscache" << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml " << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml " << OPT_PRAEFIX << "g " << OPT_PRAEFIX << "s ESt_2020_antwort.xml" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml " << OPT_PRAEFIX << "u 9464 " << OPT_PRAEFIX << "w metriken.prom" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml " << OPT_PRAEFIX << "g " << OPT_PRAEFIX << "q warn" << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v Kontoinformation " << OPT_PRAEFIX << "x kontoinformation.xml "
         << OPT_PRAEFIX << "c \"http://127.0.0.1:24727/eID-Client?testmerker=520000000\" " << OPT_PRAEFIX << "p _NULL" << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v MitteilungAbholung " << OPT_PRAEFIX << "x MitteilungAbholungAnfrage.xml "
         << OPT_PRAEFIX << "c test-softidnr-pse.pfx " << OPT_PRAEFIX << "p 123456 " << OPT_PRAEFIX << "t 0" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "k cez " << OPT_PRAEFIX << "p 123456" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "b 9198" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "a" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "v ESt_2020 " << OPT_PRAEFIX << "x ESt_2020.xml " << OPT_PRAEFIX << "o " << OPT_PRAEFIX << "s vorschau" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "r steuernummern.csv " << OPT_PRAEFIX << "s steuernummern_elster.csv" << NEW_LINE
+        << "    " << aufrufPfad << " " << OPT_PRAEFIX << "m mandanten.csv" << NEW_LINE
         << "    " << aufrufPfad << " " << OPT_PRAEFIX << "e " << OPT_PRAEFIX << "x Abholdaten.b64 " << OPT_PRAEFIX << "s Abholdaten.xml" << std::endl;
 }
 
@@ -287,6 +526,163 @@ bool schreibeDatei(const std::string& daten, const std::string& dateiName)
 }
 
 
+bool erzeugeGeschuetztesVerzeichnis(const std::string& verzeichnisPfad)
+{
+#ifdef _WIN32
+    // Unter Windows erbt das Verzeichnis die Zugriffsrechte des Benutzerprofils
+    return 0 == _mkdir(verzeichnisPfad.c_str()) || EEXIST == errno;
+#else
+    return 0 == ::mkdir(verzeichnisPfad.c_str(), S_IRWXU) || EEXIST == errno;
+#endif
+}
+
+bool loescheVerzeichnis(const std::string& verzeichnisPfad)
+{
+#ifdef _WIN32
+    return 0 == _rmdir(verzeichnisPfad.c_str());
+#else
+    return 0 == ::rmdir(verzeichnisPfad.c_str());
+#endif
+}
+
+bool verschiebeDatei(const std::string& quellPfad, const std::string& zielPfad)
+{
+    return 0 == std::rename(quellPfad.c_str(), zielPfad.c_str());
+}
+
+bool kuerzeDatei(const std::string& dateiName, uint64_t laenge)
+{
+#ifdef _WIN32
+    const HANDLE datei = ::CreateFileA(dateiName.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == datei)
+        return false;
+
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(laenge);
+    const bool ok = FALSE != ::SetFilePointerEx(datei, position, nullptr, FILE_BEGIN) && FALSE != ::SetEndOfFile(datei);
+    ::CloseHandle(datei);
+    return ok;
+#else
+    return 0 == ::truncate(dateiName.c_str(), static_cast<off_t>(laenge));
+#endif
+}
+
+bool senkeThreadPrioritaet()
+{
+#ifdef _WIN32
+    return FALSE != ::SetThreadPriority(::GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+    // Unter Linux gilt der nice-Wert je Thread
+    return 0 == ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), 10);
+#else
+    return false;
+#endif
+}
+
+uint64_t belegterArbeitsspeicher()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS zaehler;
+    if (FALSE != ::GetProcessMemoryInfo(::GetCurrentProcess(), &zaehler, sizeof(zaehler)))
+    {
+        return zaehler.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    // Das zweite Feld ist die Anzahl der Seiten im Arbeitsspeicher
+    unsigned long long seiten = 0, resident = 0;
+    std::FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+    {
+        return 0;
+    }
+    const bool gelesen = std::fscanf(statm, "%llu %llu", &seiten, &resident) == 2;
+    std::fclose(statm);
+    return gelesen ? resident * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+uint64_t threadCpuZeitUs()
+{
+#ifdef _WIN32
+    // Kernel- und Benutzerzeit in Einheiten von 100 ns
+    FILETIME erzeugt, beendet, kernel, benutzer;
+    if (FALSE == ::GetThreadTimes(::GetCurrentThread(), &erzeugt, &beendet, &kernel, &benutzer))
+    {
+        return 0;
+    }
+    const uint64_t kernelZeit = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t benutzerZeit = (static_cast<uint64_t>(benutzer.dwHighDateTime) << 32) | benutzer.dwLowDateTime;
+    return (kernelZeit + benutzerZeit) / 10;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec zeit;
+    if (0 != ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &zeit))
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>(zeit.tv_sec) * 1000000 + static_cast<uint64_t>(zeit.tv_nsec) / 1000;
+#else
+    return 0;
+#endif
+}
+
+#ifdef _WIN32
+Dateiabbild::Dateiabbild(const std::string& dateiName) :
+    anfang(nullptr), laenge(0), datei(INVALID_HANDLE_VALUE), abbildung(nullptr)
+{
+    datei = ::CreateFileA(dateiName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER dateiGroesse;
+    if (INVALID_HANDLE_VALUE == datei || !::GetFileSizeEx(datei, &dateiGroesse) || 0 == dateiGroesse.QuadPart)
+        return;
+
+    abbildung = ::CreateFileMappingA(datei, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (nullptr == abbildung)
+        return;
+
+    anfang = static_cast<const char*>(::MapViewOfFile(abbildung, FILE_MAP_READ, 0, 0, 0));
+    if (nullptr != anfang)
+        laenge = static_cast<size_t>(dateiGroesse.QuadPart);
+}
+
+Dateiabbild::~Dateiabbild()
+{
+    if (nullptr != anfang)
+        ::UnmapViewOfFile(anfang);
+    if (nullptr != abbildung)
+        ::CloseHandle(abbildung);
+    if (INVALID_HANDLE_VALUE != datei)
+        ::CloseHandle(datei);
+}
+#else
+Dateiabbild::Dateiabbild(const std::string& dateiName) : anfang(nullptr), laenge(0)
+{
+    const int datei = ::open(dateiName.c_str(), O_RDONLY);
+    if (datei < 0)
+        return;
+
+    struct stat dateiStatus;
+    if (0 == ::fstat(datei, &dateiStatus) && dateiStatus.st_size > 0)
+    {
+        void *abbildung = ::mmap(nullptr, static_cast<size_t>(dateiStatus.st_size), PROT_READ, MAP_SHARED, datei, 0);
+        if (MAP_FAILED != abbildung)
+        {
+            anfang = static_cast<const char*>(abbildung);
+            laenge = static_cast<size_t>(dateiStatus.st_size);
+        }
+    }
+    // Die Abbildung bleibt auch nach dem Schliessen der Datei gueltig
+    ::close(datei);
+}
+
+Dateiabbild::~Dateiabbild()
+{
+    if (nullptr != anfang)
+        ::munmap(const_cast<char*>(anfang), laenge);
+}
+#endif
+
 #ifdef WINDOWS_MSVC
 
 namespace kod {
@@ -106,7 +106,30 @@
             bool                getDatensatzSenden()     const { return datensatzSenden; }
             bool                getHilfeAnzeigen()       const { return hilfeAnzeigen; }
             bool                getDatenEntschluesseln() const { return datenEntschluesseln; };
+            bool                getSchemaVorpruefung()   const { return schemaVorpruefung; }
+            bool                getFeldpruefung()        const { return feldpruefung; }
+            bool                getAuswahllistenAnzeigen() const { return auswahllistenAnzeigen; }
+            bool                getDruckNachgelagert()   const { return druckNachgelagert; }
+            bool                getVorschau()            const { return vorschau; }
             const std::string& getAusgabeDatei()        const { return ausgabeDatei; }
+            const std::string& getCezVerzeichnis()      const { return cezVerzeichnis; }
+            const std::string& getCacheVerzeichnis()    const { return cacheVerzeichnis; }
+            const std::string& getStrukturDatei()       const { return strukturDatei; }
+            const std::string& getBufaNummer()          const { return bufaNummer; }
+            const std::string& getSteuernummernDatei()  const { return steuernummernDatei; }
+            const std::string& getSpaltenDatei()        const { return spaltenDatei; }
+            const std::string& getArchivVerzeichnis()   const { return archivVerzeichnis; }
+            unsigned short      getMetrikPort()          const { return metrikPort; }
+            const std::string& getMetrikDatei()         const { return metrikDatei; }
+            const std::string& getLogEbene()            const { return logEbene; }
+            const std::string& getSpurDatei()           const { return spurDatei; }
+            double              getSpurAnteil()          const { return spurAnteil; }
+            const std::string& getMitschnittVerzeichnis() const { return mitschnittVerzeichnis; }
+            double              getMitschnittSchwelleMs() const { return mitschnittSchwelleMs; }
+            size_t              getMitschnittAnzahl()    const { return mitschnittAnzahl; }
+            bool                getMitschnittSchwaerzen() const { return mitschnittSchwaerzen; }
+            bool                getSteuernummernVergleich() const { return steuernummernVergleich; }
+            const std::string& getMandant()             const { return mandant.empty() ? KommandozeilenParser::defaultMandant : mandant; }
             EricTransferHandle  getTransferHandle()      const { return transferHandle; };
             bool                getHatTransferHandle()   const { return hatTransferHandle; }
 
@@ -115,8 +138,15 @@
             const std::string& getZertifikatPin()       const { return zertifikatPin.empty() ? KommandozeilenParser::defaultZertifikatPin : zertifikatPin; }
             const std::string& getDatensatzDatei()      const { return datensatzDatei.empty() ? KommandozeilenParser::defaultDatensatzDatei : datensatzDatei; }
             const std::string& getDatenartVersion()     const { return datenartVersion.empty() ? KommandozeilenParser::defaultDatenartVersion : datenartVersion; }
+            bool                getHatDatenartVersion()  const { return !datenartVersion.empty(); }
+
+            // Ergaenzt die aus dem Datensatz ermittelte Datenartversion, wenn keine angegeben wurde
+            void                setDatenartVersion(const std::string& version) { datenartVersion = version; }
 
         private:
+            /** @brief Uebernimmt den Parameter einer langen Option wie --spuren <datei> */
+            void setzeLangeOption(const std::string& name, const std::string& wert);
+
             bool                parseOk;
 
             // Kommandozeilenoptionen
@@ -130,7 +160,30 @@
             bool                datensatzSenden;
             bool                hilfeAnzeigen;
             bool                datenEntschluesseln;
+            bool                schemaVorpruefung;
+            bool                feldpruefung;
+            bool                auswahllistenAnzeigen;
+            bool                druckNachgelagert;
+            bool                vorschau;
             std::string         ausgabeDatei;
+            std::string         cezVerzeichnis;
+            std::string         cacheVerzeichnis;
+            std::string         strukturDatei;
+            std::string         bufaNummer;
+            std::string         steuernummernDatei;
+            std::string         spaltenDatei;
+            std::string         archivVerzeichnis;
+            unsigned short      metrikPort;
+            std::string         metrikDatei;
+            std::string         logEbene;
+            std::string         spurDatei;
+            double              spurAnteil;
+            std::string         mitschnittVerzeichnis;
+            double              mitschnittSchwelleMs;
+            size_t              mitschnittAnzahl;
+            bool                mitschnittSchwaerzen;
+            bool                steuernummernVergleich;
+            std::string         mandant;
             EricTransferHandle  transferHandle;
             bool                hatTransferHandle;
 
@@ -139,6 +192,7 @@
             static const std::string defaultZertifikatPin;
             static const std::string defaultDatensatzDatei;
             static const std::string defaultDatenartVersion;
+            static const std::string defaultMandant;
         };
 
 
@@ -161,9 +215,54 @@
         /** @brief Schreibt Daten in eine Datei */
         bool schreibeDatei(const std::string& daten, const std::string& dateiName);
 
+        /** @brief Legt ein Verzeichnis an, auf das nur der aktuelle Benutzer zugreifen darf */
+        bool erzeugeGeschuetztesVerzeichnis(const std::string& verzeichnisPfad);
+
+        /** @brief Loescht ein leeres Verzeichnis */
+        bool loescheVerzeichnis(const std::string& verzeichnisPfad);
+
+        /** @brief Verschiebt bzw. benennt eine Datei um */
+        bool verschiebeDatei(const std::string& quellPfad, const std::string& zielPfad);
+
+        /** @brief Kuerzt eine Datei auf die angegebene Laenge, z. B. auf den letzten vollstaendigen Satz */
+        bool kuerzeDatei(const std::string& dateiName, uint64_t laenge);
+
+        /** @brief Senkt die Prioritaet des aufrufenden Threads fuer Hintergrundarbeit */
+        bool senkeThreadPrioritaet();
+
+        /** @brief Liefert den belegten Arbeitsspeicher (Resident Set Size) des Prozesses in Bytes, 0 falls unbekannt */
+        uint64_t belegterArbeitsspeicher();
+
+        /** @brief Liefert die bisher verbrauchte CPU-Zeit des aufrufenden Threads in Mikrosekunden, 0 falls unbekannt */
+        uint64_t threadCpuZeitUs();
+
         /** @brief Gib eine Titelzeile aus */
         void titelZeile(const std::string& titel);
 
+        /** @brief Blendet eine Datei nur lesend in den Adressraum ein
+          *
+          * Eine fehlende oder leere Datei ergibt ein leeres Abbild.
+          */
+        class Dateiabbild {
+        public:
+            explicit Dateiabbild(const std::string& dateiName);
+            ~Dateiabbild();
+
+            const char* daten()  const { return anfang; }
+            size_t      groesse() const { return laenge; }
+
+        private:
+            Dateiabbild(const Dateiabbild &); // Kopien verboten
+            Dateiabbild &operator=(const Dateiabbild &); // Zuweisungen verboten
+
+            const char* anfang;
+            size_t      laenge;
+#ifdef _WIN32
+            HANDLE      datei;
+            HANDLE      abbildung;
+#endif
+        };
+
         /** @brief Konvertiert einen Datentyp in einen std::string
           *
           * @exception std::ios_base::failure, falls die Konvertierung fehl schlägt
@@ -0,0 +1,273 @@
+#include "xmltagleser.h"
+
+#include <cstdlib>
+#include <cstring>
+
+
+namespace
+{
+
+const size_t NICHT_GEFUNDEN = std::string::npos;
+
+bool istLeerzeichen(char c)
+{
+    return ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+}
+
+bool istNamensende(char c)
+{
+    return istLeerzeichen(c) || '>' == c || '/' == c;
+}
+
+void haengeUtf8An(std::string &ziel, unsigned long codepunkt)
+{
+    if (codepunkt < 0x80)
+    {
+        ziel += static_cast<char>(codepunkt);
+    }
+    else if (codepunkt < 0x800)
+    {
+        ziel += static_cast<char>(0xC0 | (codepunkt >> 6));
+        ziel += static_cast<char>(0x80 | (codepunkt & 0x3F));
+    }
+    else if (codepunkt < 0x10000)
+    {
+        ziel += static_cast<char>(0xE0 | (codepunkt >> 12));
+        ziel += static_cast<char>(0x80 | ((codepunkt >> 6) & 0x3F));
+        ziel += static_cast<char>(0x80 | (codepunkt & 0x3F));
+    }
+    else
+    {
+        ziel += static_cast<char>(0xF0 | (codepunkt >> 18));
+        ziel += static_cast<char>(0x80 | ((codepunkt >> 12) & 0x3F));
+        ziel += static_cast<char>(0x80 | ((codepunkt >> 6) & 0x3F));
+        ziel += static_cast<char>(0x80 | (codepunkt & 0x3F));
+    }
+}
+
+} // anonymous namespace
+
+
+XmlTagLeser::XmlTagLeser(const std::string &xml_)
+    : xml(xml_.data()),
+      xmlLaenge(xml_.size()),
+      naechstePosition(0),
+      tagAnfang(0),
+      tagEnde(0),
+      namensAnfang(0),
+      namensEnde(0),
+      endeTag(false),
+      leeresElement(false)
+{
+    naechstePosition = finde('<', 0);
+}
+
+XmlTagLeser::XmlTagLeser(const char *xml_, size_t laenge)
+    : xml(xml_),
+      xmlLaenge(xml_ != nullptr ? laenge : 0),
+      naechstePosition(0),
+      tagAnfang(0),
+      tagEnde(0),
+      namensAnfang(0),
+      namensEnde(0),
+      endeTag(false),
+      leeresElement(false)
+{
+    naechstePosition = finde('<', 0);
+}
+
+bool XmlTagLeser::weiter()
+{
+    while (naechstePosition != NICHT_GEFUNDEN)
+    {
+        const size_t anfang = naechstePosition;
+
+        // Kommentare und CDATA-Abschnitte koennen '<' und '>' enthalten
+        const char *abschlusszeichen = nullptr;
+        if (beginntMit(anfang, "<!--"))
+            abschlusszeichen = "-->";
+        else if (beginntMit(anfang, "<![CDATA["))
+            abschlusszeichen = "]]>";
+        if (abschlusszeichen != nullptr)
+        {
+            const size_t abschluss = finde(abschlusszeichen, anfang + 4);
+            naechstePosition = abschluss == NICHT_GEFUNDEN ? abschluss : finde('<', abschluss + 3);
+            continue;
+        }
+
+        const size_t ende = finde('>', anfang);
+        if (ende == NICHT_GEFUNDEN)
+        {
+            naechstePosition = ende;
+            break;
+        }
+        naechstePosition = finde('<', ende + 1);
+
+        const char erstesZeichen = anfang + 1 < ende ? xml[anfang + 1] : '\0';
+        if ('?' == erstesZeichen || '!' == erstesZeichen)
+            continue;
+
+        tagAnfang = anfang;
+        tagEnde = ende;
+        endeTag = '/' == erstesZeichen;
+        leeresElement = !endeTag && '/' == xml[ende - 1];
+
+        namensEnde = anfang + (endeTag ? 2 : 1);
+        namensAnfang = namensEnde;
+        while (namensEnde < ende && !istNamensende(xml[namensEnde]))
+        {
+            if (':' == xml[namensEnde])
+                namensAnfang = namensEnde + 1;
+            ++namensEnde;
+        }
+        return true;
+    }
+    return false;
+}
+
+std::string XmlTagLeser::name() const
+{
+    return std::string(xml + namensAnfang, namensEnde - namensAnfang);
+}
+
+std::string XmlTagLeser::praefix() const
+{
+    const size_t anfang = tagAnfang + (endeTag ? 2 : 1);
+    return std::string(xml + anfang, namensAnfang - anfang);
+}
+
+bool XmlTagLeser::hatName(const char *lokalerName) const
+{
+    const size_t laenge = std::strlen(lokalerName);
+    return laenge == namensEnde - namensAnfang && 0 == std::memcmp(xml + namensAnfang, lokalerName, laenge);
+}
+
+bool XmlTagLeser::attribut(const char *attributName, std::string &wert) const
+{
+    const size_t namensLaenge = std::strlen(attributName);
+    for (size_t i = namensEnde; i + namensLaenge < tagEnde; ++i)
+    {
+        if (!istLeerzeichen(xml[i]) || 0 != std::memcmp(xml + i + 1, attributName, namensLaenge))
+            continue;
+
+        size_t j = i + 1 + namensLaenge;
+        while (j < tagEnde && istLeerzeichen(xml[j]))
+            ++j;
+        if (j >= tagEnde || '=' != xml[j])
+            continue;
+        ++j;
+        while (j < tagEnde && istLeerzeichen(xml[j]))
+            ++j;
+        if (j >= tagEnde || ('"' != xml[j] && '\'' != xml[j]))
+            continue;
+
+        const size_t wertEnde = finde(xml[j], j + 1);
+        if (wertEnde == NICHT_GEFUNDEN || wertEnde > tagEnde)
+            return false;
+        wert.assign(xml + j + 1, wertEnde - j - 1);
+        return true;
+    }
+    return false;
+}
+
+bool XmlTagLeser::textinhalt(std::string &text) const
+{
+    Textausschnitt ausschnitt;
+    if (!textinhalt(ausschnitt))
+        return false;
+    text.assign(ausschnitt.anfang, ausschnitt.laenge);
+    return true;
+}
+
+bool XmlTagLeser::textinhalt(Textausschnitt &text) const
+{
+    if (endeTag || leeresElement)
+        return false;
+
+    size_t anfang = tagEnde + 1;
+    size_t ende = naechstePosition == NICHT_GEFUNDEN ? xmlLaenge : naechstePosition;
+    if (ende < xmlLaenge && !beginntMit(ende, "</"))
+        return false;
+
+    while (anfang < ende && istLeerzeichen(xml[anfang]))
+        ++anfang;
+    while (ende > anfang && istLeerzeichen(xml[ende - 1]))
+        --ende;
+    text = Textausschnitt(xml + anfang, ende - anfang);
+    return true;
+}
+
+size_t XmlTagLeser::finde(char zeichen, size_t ab) const
+{
+    if (ab >= xmlLaenge)
+        return NICHT_GEFUNDEN;
+    const void *fund = std::memchr(xml + ab, zeichen, xmlLaenge - ab);
+    return fund != nullptr ? static_cast<const char *>(fund) - xml : NICHT_GEFUNDEN;
+}
+
+size_t XmlTagLeser::finde(const char *muster, size_t ab) const
+{
+    for (size_t position = finde(muster[0], ab); position != NICHT_GEFUNDEN; position = finde(muster[0], position + 1))
+    {
+        if (beginntMit(position, muster))
+            return position;
+    }
+    return NICHT_GEFUNDEN;
+}
+
+bool XmlTagLeser::beginntMit(size_t position, const char *muster) const
+{
+    const size_t laenge = std::strlen(muster);
+    return position <= xmlLaenge && laenge <= xmlLaenge - position && 0 == std::memcmp(xml + position, muster, laenge);
+}
+
+std::string XmlTagLeser::dekodiere(const Textausschnitt &text)
+{
+    std::string ergebnis;
+    ergebnis.reserve(text.laenge);
+
+    static const struct { const char *name; char zeichen; } ENTITAETEN[] =
+    {
+        { "lt", '<' }, { "gt", '>' }, { "amp", '&' }, { "quot", '"' }, { "apos", '\'' }
+    };
+
+    for (size_t i = 0; i < text.laenge; ++i)
+    {
+        const char *ende = '&' == text.anfang[i]
+            ? static_cast<const char *>(std::memchr(text.anfang + i, ';', text.laenge - i)) : nullptr;
+        if (nullptr == ende)
+        {
+            ergebnis += text.anfang[i];
+            continue;
+        }
+
+        const std::string name(text.anfang + i + 1, ende);
+        bool bekannt = false;
+        if (name.size() > 1 && '#' == name[0])
+        {
+            const bool hexadezimal = 'x' == name[1] || 'X' == name[1];
+            const char *ziffern = name.c_str() + (hexadezimal ? 2 : 1);
+            char *zifferEnde = nullptr;
+            const unsigned long codepunkt = std::strtoul(ziffern, &zifferEnde, hexadezimal ? 16 : 10);
+            if (zifferEnde != ziffern && '\0' == *zifferEnde && codepunkt <= 0x10FFFF)
+            {
+                haengeUtf8An(ergebnis, codepunkt);
+                bekannt = true;
+            }
+        }
+        for (size_t e = 0; !bekannt && e < sizeof(ENTITAETEN) / sizeof(ENTITAETEN[0]); ++e)
+        {
+            if (name == ENTITAETEN[e].name)
+            {
+                ergebnis += ENTITAETEN[e].zeichen;
+                bekannt = true;
+            }
+        }
+
+        if (bekannt)
+            i = ende - text.anfang;
+        else
+            ergebnis += text.anfang[i];
+    }
+    return ergebnis;
+}
@@ -0,0 +1,104 @@
+#ifndef _XMLTAGLESER_H_
+#define _XMLTAGLESER_H_
+
+#include <cstddef>
+#include <string>
+
+
+/** @brief Unveraenderlicher Ausschnitt aus einem fremden Textpuffer
+ *
+ * Der Ausschnitt kopiert nichts und ist nur so lange gueltig wie der Puffer,
+ * in den er zeigt.
+ */
+struct Textausschnitt
+{
+    Textausschnitt() : anfang(nullptr), laenge(0) { }
+    Textausschnitt(const char *anfang_, size_t laenge_) : anfang(anfang_), laenge(laenge_) { }
+
+    bool        leer() const { return 0 == laenge; }
+    std::string text() const { return std::string(anfang, laenge); }
+
+    const char *anfang;
+    size_t      laenge;
+};
+
+
+/** @brief Liest die Tags eines XML-Textes nacheinander, ohne einen Dokumentbaum aufzubauen
+ *
+ * Der Leser kennt nur so viel XML, wie zum schnellen Auffinden einzelner
+ * Elemente noetig ist: Start-, End- und leere Element-Tags, Attribute und
+ * reiner Textinhalt. Kommentare, CDATA-Abschnitte, Verarbeitungsanweisungen
+ * und Deklarationen werden uebersprungen, Entitaeten erst durch dekodiere()
+ * aufgeloest.
+ * Der Text wird nicht kopiert und muss so lange leben wie der Leser.
+ */
+class XmlTagLeser
+{
+public:
+    explicit XmlTagLeser(const std::string &xml);
+
+    /** @brief Liest einen Puffer, der nicht nullterminiert sein muss, z. B. einen ERiC-Rueckgabepuffer */
+    XmlTagLeser(const char *xml, size_t laenge);
+
+    /** @brief Geht zum naechsten Start-, End- oder leeren Element-Tag
+      *
+      * @return false am Ende des Textes
+      */
+    bool weiter();
+
+    /** @brief true bei einem End-Tag */
+    bool istEndeTag() const { return endeTag; }
+
+    /** @brief true bei einem leeren Element-Tag wie <Element/> */
+    bool istLeeresElement() const { return leeresElement; }
+
+    /** @brief Lokaler Name des aktuellen Elements ohne Namensraumpraefix */
+    std::string name() const;
+
+    /** @brief Vergleicht den lokalen Namen des aktuellen Elements ohne Kopie */
+    bool hatName(const char *lokalerName) const;
+
+    /** @brief Sucht ein Attribut des aktuellen Start-Tags
+      *
+      * @return true, wenn das Attribut vorhanden ist
+      */
+    bool attribut(const char *attributName, std::string &wert) const;
+
+    /** @brief Liefert den von Leerraum befreiten Textinhalt des aktuellen Start-Tags
+      *
+      * @return false, wenn das Element keinen reinen Textinhalt hat
+      */
+    bool textinhalt(std::string &text) const;
+
+    /** @brief Wie textinhalt(std::string &), liefert aber einen Ausschnitt in den gelesenen Text */
+    bool textinhalt(Textausschnitt &text) const;
+
+    /** @brief Loest die vordefinierten XML-Entitaeten und Zeichenreferenzen in einem Textinhalt auf */
+    static std::string dekodiere(const Textausschnitt &text);
+
+    /** @brief Byteposition des aktuellen Tags im Text */
+    size_t position() const { return tagAnfang; }
+
+    /** @brief Byteposition unmittelbar hinter dem aktuellen Tag */
+    size_t endePosition() const { return tagEnde + 1; }
+
+    /** @brief Namensraumpraefix des aktuellen Elements einschliesslich ':', leer ohne Praefix */
+    std::string praefix() const;
+
+private:
+    size_t finde(char zeichen, size_t ab) const;
+    size_t finde(const char *muster, size_t ab) const;
+    bool   beginntMit(size_t position, const char *muster) const;
+
+    const char        *xml;
+    const size_t       xmlLaenge;
+    size_t             naechstePosition;
+    size_t             tagAnfang;
+    size_t             tagEnde;
+    size_t             namensAnfang;
+    size_t             namensEnde;
+    bool               endeTag;
+    bool               leeresElement;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#include "jsontext.h"
+
+#include <cstdio>
+
+
+void JsonText::haengeAn(std::string &json, const char *text, size_t laenge)
+{
+    json += '"';
+    for (size_t i = 0; i < laenge; ++i)
+    {
+        const unsigned char zeichen = static_cast<unsigned char>(text[i]);
+        switch (zeichen)
+        {
+        case '"':  json += "\\\""; break;
+        case '\\': json += "\\\\"; break;
+        case '\n': json += "\\n";  break;
+        case '\r': json += "\\r";  break;
+        case '\t': json += "\\t";  break;
+        default:
+            if (zeichen < 0x20)
+            {
+                char maskiert[8];
+                std::snprintf(maskiert, sizeof(maskiert), "\\u%04x", zeichen);
+                json += maskiert;
+            }
+            else
+            {
+                json += text[i];
+            }
+            break;
+        }
+    }
+    json += '"';
+}
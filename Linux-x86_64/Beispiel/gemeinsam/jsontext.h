@@ -0,0 +1,33 @@
+#ifndef _JSONTEXT_H_
+#define _JSONTEXT_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+
+/** @brief Maskierung von Texten als JSON-Zeichenketten, gemeinsam fuer ericdemo und ottodemo
+ *
+ * Anfuehrungszeichen und Backslash werden mit Backslash maskiert, Zeilenvorschub,
+ * Wagenruecklauf und Tabulator als \n, \r und \t, alle uebrigen Steuerzeichen
+ * als \u00XX. Alle anderen Bytes, also auch UTF-8-Folgen, bleiben unveraendert.
+ */
+namespace JsonText
+{
+    /** @brief Haengt den Text in Anfuehrungszeichen und maskiert an */
+    void haengeAn(std::string &json, const char *text, size_t laenge);
+
+    /** @brief Wie haengeAn(std::string &, const char *, size_t) */
+    inline void haengeAn(std::string &json, const std::string &text)
+    {
+        haengeAn(json, text.data(), text.size());
+    }
+
+    /** @brief Wie haengeAn(std::string &, const char *, size_t) fuer einen nullterminierten Text */
+    inline void haengeAn(std::string &json, const char *text)
+    {
+        haengeAn(json, text, std::strlen(text));
+    }
+}
+
+#endif
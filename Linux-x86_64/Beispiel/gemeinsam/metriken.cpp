@@ -0,0 +1,302 @@
+#include "metriken.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+namespace
+{
+
+// Grenzen der exportierten Histogrammklassen: 4^k Mikrosekunden
+const size_t ANZAHL_GRENZEN = 18;
+
+// Quantile, die zusaetzlich zu den Klassen je Histogramm exportiert werden
+const double QUANTILE[] = { 0.5, 0.9, 0.99 };
+
+std::string alsZahl(double wert)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", wert);
+    return text;
+}
+
+std::string mitLabels(const std::string &name, const std::string &labels, const std::string &weiteres = std::string())
+{
+    if (labels.empty() && weiteres.empty())
+    {
+        return name;
+    }
+    return name + "{" + labels + (labels.empty() || weiteres.empty() ? "" : ",") + weiteres + "}";
+}
+
+} // anonymous namespace
+
+
+Metriken::Faecher::Faecher()
+    : frei(false)
+{
+    for (size_t i = 0; i < MAX_ZAEHLER; ++i)
+    {
+        werte[i] = 0;
+    }
+    for (size_t i = 0; i < MAX_HISTOGRAMME; ++i)
+    {
+        histogramme[i].summeUs = 0;
+        for (size_t k = 0; k < ANZAHL_KLASSEN; ++k)
+        {
+            histogramme[i].klassen[k] = 0;
+        }
+    }
+}
+
+Metriken::FaecherHalter::~FaecherHalter()
+{
+    // Die Werte bleiben stehen und zaehlen in der Summe weiter mit
+    if (faecher)
+    {
+        faecher->frei = true;
+    }
+}
+
+
+Metriken::Metriken(const std::string &praefix)
+    : verworfenName(praefix + "_metriken_verworfen_total"),
+      belegteZaehler(0),
+      belegteHistogramme(0),
+      verworfen(0)
+{ }
+
+Metriken::~Metriken()
+{ }
+
+void Metriken::zaehle(const char *name, const std::string &labels, uint64_t anzahl)
+{
+    Faecher &faecher = eigeneFaecher();
+    const size_t index = fach(faecher, name, labels, ZAEHLER);
+    if (index != KEIN_FACH)
+    {
+        faecher.werte[index].fetch_add(static_cast<int64_t>(anzahl), std::memory_order_relaxed);
+    }
+}
+
+void Metriken::veraendere(const char *name, const std::string &labels, int64_t differenz)
+{
+    // Die Summe der Differenzen aller Threads ergibt den Messwert
+    Faecher &faecher = eigeneFaecher();
+    const size_t index = fach(faecher, name, labels, MESSWERT);
+    if (index != KEIN_FACH)
+    {
+        faecher.werte[index].fetch_add(differenz, std::memory_order_relaxed);
+    }
+}
+
+void Metriken::messe(const char *name, const std::string &labels, double dauerMs)
+{
+    Faecher &faecher = eigeneFaecher();
+    const size_t index = fach(faecher, name, labels, HISTOGRAMM);
+    if (index != KEIN_FACH)
+    {
+        const uint64_t dauerUs = dauerMs > 0.0 ? static_cast<uint64_t>(dauerMs * 1000.0) : 0;
+        Histogrammfach &histogramm = faecher.histogramme[index];
+        histogramm.klassen[klasse(dauerUs)].fetch_add(1, std::memory_order_relaxed);
+        histogramm.summeUs.fetch_add(dauerUs, std::memory_order_relaxed);
+    }
+}
+
+std::string Metriken::alsText() const
+{
+    std::lock_guard<std::mutex> lock(sperre);
+
+    // Zeitreihen gleichen Namens stehen im Textformat unter einer TYPE-Zeile
+    std::map<std::string, std::vector<size_t> > familien;
+    for (size_t i = 0; i < zeitreihen.size(); ++i)
+    {
+        familien[zeitreihen[i].name].push_back(i);
+    }
+
+    std::string text;
+    for (std::map<std::string, std::vector<size_t> >::const_iterator familie = familien.begin(); familie != familien.end(); ++familie)
+    {
+        const Art art = zeitreihen[familie->second.front()].art;
+        text += "# TYPE " + familie->first + (art == ZAEHLER ? " counter\n" : art == MESSWERT ? " gauge\n" : " histogram\n");
+
+        std::string quantile;
+        for (size_t i = 0; i < familie->second.size(); ++i)
+        {
+            const Zeitreihe &reihe = zeitreihen[familie->second[i]];
+            if (art != HISTOGRAMM)
+            {
+                int64_t summe = 0;
+                for (size_t f = 0; f < alleFaecher.size(); ++f)
+                {
+                    summe += alleFaecher[f]->werte[reihe.fach].load(std::memory_order_relaxed);
+                }
+                text += mitLabels(reihe.name, reihe.labels) + " " + std::to_string(summe) + "\n";
+                continue;
+            }
+
+            uint64_t klassen[ANZAHL_KLASSEN] = {};
+            uint64_t summeUs = 0;
+            for (size_t f = 0; f < alleFaecher.size(); ++f)
+            {
+                const Histogrammfach &fach = alleFaecher[f]->histogramme[reihe.fach];
+                for (size_t k = 0; k < ANZAHL_KLASSEN; ++k)
+                {
+                    klassen[k] += fach.klassen[k].load(std::memory_order_relaxed);
+                }
+                summeUs += fach.summeUs.load(std::memory_order_relaxed);
+            }
+
+            // Kumulierte Klassen bis 4^g Mikrosekunden, die Summe aller Klassen ist die Anzahl
+            uint64_t kumuliert = 0;
+            size_t k = 0;
+            for (size_t g = 0; g < ANZAHL_GRENZEN; ++g)
+            {
+                const uint64_t grenzeUs = static_cast<uint64_t>(1) << (2 * g);
+                for (; k < ANZAHL_KLASSEN - 1 && untergrenzeUs(k + 1) <= grenzeUs; ++k)
+                {
+                    kumuliert += klassen[k];
+                }
+                text += mitLabels(reihe.name + "_bucket", reihe.labels, "le=\"" + alsZahl(grenzeUs / 1e6) + "\"") + " " + std::to_string(kumuliert) + "\n";
+            }
+            for (; k < ANZAHL_KLASSEN; ++k)
+            {
+                kumuliert += klassen[k];
+            }
+            text += mitLabels(reihe.name + "_bucket", reihe.labels, "le=\"+Inf\"") + " " + std::to_string(kumuliert) + "\n"
+                  + mitLabels(reihe.name + "_sum", reihe.labels) + " " + alsZahl(summeUs / 1e6) + "\n"
+                  + mitLabels(reihe.name + "_count", reihe.labels) + " " + std::to_string(kumuliert) + "\n";
+
+            for (size_t q = 0; q < sizeof(QUANTILE) / sizeof(QUANTILE[0]) && kumuliert > 0; ++q)
+            {
+                const uint64_t rang = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(QUANTILE[q] * kumuliert)));
+                uint64_t bisher = 0;
+                size_t index = 0;
+                for (; index < ANZAHL_KLASSEN - 1; ++index)
+                {
+                    bisher += klassen[index];
+                    if (bisher >= rang)
+                        break;
+                }
+                // Obergrenze der Klasse, bei der offenen letzten Klasse deren Untergrenze
+                const uint64_t wertUs = untergrenzeUs(index < ANZAHL_KLASSEN - 1 ? index + 1 : index);
+                quantile += mitLabels(reihe.name + "_quantil", reihe.labels, "quantile=\"" + alsZahl(QUANTILE[q]) + "\"") + " " + alsZahl(wertUs / 1e6) + "\n";
+            }
+        }
+        if (!quantile.empty())
+        {
+            text += "# TYPE " + familie->first + "_quantil gauge\n" + quantile;
+        }
+    }
+
+    text += "# TYPE " + verworfenName + " counter\n"
+          + verworfenName + " " + std::to_string(verworfen.load()) + "\n";
+    return text;
+}
+
+std::string Metriken::label(const char *name, const std::string &wert)
+{
+    std::string text(name);
+    text += "=\"";
+    for (std::string::const_iterator it = wert.begin(); it != wert.end(); ++it)
+    {
+        if ('\\' == *it || '"' == *it)
+            text += '\\';
+        if ('\n' == *it)
+            text += "\\n";
+        else
+            text += *it;
+    }
+    text += '"';
+    return text;
+}
+
+size_t Metriken::klasse(uint64_t dauerUs)
+{
+    if (dauerUs < 4)
+    {
+        return static_cast<size_t>(dauerUs);
+    }
+    size_t exponent = 0;
+    for (uint64_t rest = dauerUs >> 1; rest != 0; rest >>= 1)
+    {
+        ++exponent;
+    }
+    const size_t index = (exponent - 1) * 4 + static_cast<size_t>((dauerUs >> (exponent - 2)) & 3);
+    return std::min(index, ANZAHL_KLASSEN - 1);
+}
+
+uint64_t Metriken::untergrenzeUs(size_t klasse)
+{
+    if (klasse < 4)
+    {
+        return klasse;
+    }
+    return static_cast<uint64_t>(4 + klasse % 4) << (klasse / 4 - 1);
+}
+
+Metriken::Faecher &Metriken::eigeneFaecher()
+{
+    static thread_local FaecherHalter halter;
+    if (halter.faecher)
+    {
+        return *halter.faecher;
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    for (size_t i = 0; i < alleFaecher.size(); ++i)
+    {
+        bool frei = true;
+        if (alleFaecher[i]->frei.compare_exchange_strong(frei, false))
+        {
+            halter.faecher = alleFaecher[i].get();
+            return *halter.faecher;
+        }
+    }
+    alleFaecher.push_back(std::unique_ptr<Faecher>(new Faecher()));
+    halter.faecher = alleFaecher.back().get();
+    return *halter.faecher;
+}
+
+size_t Metriken::fach(Faecher &faecher, const char *name, const std::string &labels, Art art)
+{
+    const std::string schluessel = mitLabels(name, labels);
+    const std::map<std::string, size_t>::const_iterator bekannt = faecher.bekannt.find(schluessel);
+    if (bekannt != faecher.bekannt.end())
+    {
+        return bekannt->second;
+    }
+
+    size_t index = KEIN_FACH;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        const std::map<std::string, size_t>::const_iterator fund = verzeichnis.find(schluessel);
+        if (fund != verzeichnis.end())
+        {
+            if (zeitreihen[fund->second].art == art)
+            {
+                index = zeitreihen[fund->second].fach;
+            }
+        }
+        else if (art == HISTOGRAMM ? belegteHistogramme < MAX_HISTOGRAMME : belegteZaehler < MAX_ZAEHLER)
+        {
+            Zeitreihe reihe;
+            reihe.name = name;
+            reihe.labels = labels;
+            reihe.art = art;
+            reihe.fach = art == HISTOGRAMM ? belegteHistogramme++ : belegteZaehler++;
+            verzeichnis[schluessel] = zeitreihen.size();
+            zeitreihen.push_back(reihe);
+            index = reihe.fach;
+        }
+    }
+    if (index == KEIN_FACH)
+    {
+        // Nicht im Thread merken, damit jeder verworfene Wert gezaehlt wird
+        ++verworfen;
+        return KEIN_FACH;
+    }
+    faecher.bekannt[schluessel] = index;
+    return index;
+}
@@ -0,0 +1,136 @@
+#ifndef _METRIKEN_H_
+#define _METRIKEN_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/** @brief Prozessweite Zaehler, Messwerte und Latenzhistogramme, gemeinsam fuer ericdemo und ottodemo
+ *
+ * Jeder Thread schreibt in einen eigenen Satz atomarer Faecher, der beim ersten
+ * Zugriff angelegt und nach dem Ende des Threads an den naechsten neuen Thread
+ * weitergegeben wird. Aktualisierungen sind damit sperrfrei; nur die erste
+ * Verwendung einer Zeitreihe in einem Thread sucht unter einer Sperre im
+ * gemeinsamen Verzeichnis. alsText() summiert die Faecher aller Threads.
+ *
+ * Eine Zeitreihe besteht aus Name und Labels im Prometheus-Format, z.B.
+ * zaehle("eric_api_aufrufe_total", "funktion=\"EricBearbeiteVorgang\",rc=\"0\"").
+ * Werden mehr Zeitreihen angelegt als Faecher vorhanden sind, werden die
+ * ueberzaehligen verworfen und in <praefix>_metriken_verworfen_total gezaehlt.
+ *
+ * Die Histogramme teilen jede Zweierpotenz von Mikrosekunden in vier Klassen
+ * (relativer Fehler hoechstens 25 %) und reichen bis etwa 33 Stunden.
+ *
+ * Ein Prozess hat genau eine Instanz, die eine abgeleitete Klasse wie
+ * EricMetriken oder OttoMetriken bereitstellt; die Faecher eines Threads
+ * gehoeren immer zu dieser Instanz.
+ */
+class Metriken
+{
+public:
+    static const size_t MAX_ZAEHLER = 512;
+    static const size_t MAX_HISTOGRAMME = 64;
+    static const size_t ANZAHL_KLASSEN = 144;
+
+    virtual ~Metriken();
+
+    /** @brief Erhoeht einen Zaehler (Prometheus-Typ counter) */
+    void zaehle(const char *name, const std::string &labels, uint64_t anzahl = 1);
+
+    /** @brief Veraendert einen Messwert (Prometheus-Typ gauge), z.B. die Anzahl belegter Instanzen */
+    void veraendere(const char *name, const std::string &labels, int64_t differenz);
+
+    /** @brief Traegt eine Dauer in ein Histogramm ein, der Name sollte auf _seconds enden */
+    void messe(const char *name, const std::string &labels, double dauerMs);
+
+    /** @brief Wie messe(const char *, const std::string &, double) fuer eine gemessene Dauer */
+    void messe(const char *name, const std::string &labels, std::chrono::steady_clock::duration dauer)
+    {
+        messe(name, labels, std::chrono::duration<double, std::milli>(dauer).count());
+    }
+
+    /** @brief Alle Zeitreihen im Textformat von Prometheus */
+    std::string alsText() const;
+
+    /** @brief Label-Text mit maskiertem Wert, z.B. label("rc", "0") ergibt rc="0" */
+    static std::string label(const char *name, const std::string &wert);
+
+    /** @brief Klasse einer Dauer in Mikrosekunden */
+    static size_t klasse(uint64_t dauerUs);
+
+    /** @brief Untergrenze der Klasse in Mikrosekunden */
+    static uint64_t untergrenzeUs(size_t klasse);
+
+protected:
+    /** @param praefix Praefix der eigenen Zeitreihen, z.B. "eric" */
+    explicit Metriken(const std::string &praefix);
+
+private:
+    Metriken(const Metriken &); // Kopien verboten
+    Metriken &operator=(const Metriken &); // Zuweisungen verboten
+
+    enum Art
+    {
+        ZAEHLER,
+        MESSWERT,
+        HISTOGRAMM
+    };
+
+    struct Zeitreihe
+    {
+        std::string name;
+        std::string labels;
+        Art         art;
+        size_t      fach;
+    };
+
+    struct Histogrammfach
+    {
+        std::atomic<uint64_t> summeUs;
+        std::atomic<uint64_t> klassen[ANZAHL_KLASSEN];
+    };
+
+    /** @brief Faecher eines Threads, nur dieser schreibt hinein */
+    struct Faecher
+    {
+        Faecher();
+
+        std::atomic<int64_t>           werte[MAX_ZAEHLER];
+        Histogrammfach                 histogramme[MAX_HISTOGRAMME];
+        std::map<std::string, size_t>  bekannt;     // Name{Labels} -> Fach, nur vom Besitzer benutzt
+        std::atomic<bool>              frei;
+    };
+
+    /** @brief Gibt die Faecher am Ende des Threads frei */
+    struct FaecherHalter
+    {
+        FaecherHalter() : faecher(nullptr) { }
+        ~FaecherHalter();
+
+        Faecher *faecher;
+    };
+
+    Faecher &eigeneFaecher();
+
+    static const size_t KEIN_FACH = static_cast<size_t>(-1);
+
+    /** @brief Liefert das Fach der Zeitreihe und legt sie bei Bedarf an; KEIN_FACH, wenn keines mehr frei ist */
+    size_t fach(Faecher &faecher, const char *name, const std::string &labels, Art art);
+
+    const std::string                      verworfenName;
+    mutable std::mutex                     sperre;
+    std::vector<std::unique_ptr<Faecher> > alleFaecher;
+    std::vector<Zeitreihe>                 zeitreihen;
+    std::map<std::string, size_t>          verzeichnis;
+    size_t                                 belegteZaehler;
+    size_t                                 belegteHistogramme;
+    std::atomic<uint64_t>                  verworfen;
+};
+
+#endif
@@ -0,0 +1,254 @@
+#ifdef _WIN32
+#   include <winsock2.h>
+#   include <ws2tcpip.h>
+#   ifdef _MSC_VER
+#       pragma comment(lib, "ws2_32.lib")
+#   endif
+#else
+#   include <arpa/inet.h>
+#   include <netinet/in.h>
+#   include <sys/select.h>
+#   include <sys/socket.h>
+#   include <sys/time.h>
+#   include <unistd.h>
+#endif
+
+#include "metrikexport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "metriken.h"
+
+
+namespace
+{
+
+#ifdef _WIN32
+typedef SOCKET Sockel;
+const Sockel KEIN_SOCKEL = INVALID_SOCKET;
+void schliesse(Sockel sockel) { ::closesocket(sockel); }
+#else
+typedef int Sockel;
+const Sockel KEIN_SOCKEL = -1;
+void schliesse(Sockel sockel) { ::close(sockel); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+const int SENDE_FLAGS = MSG_NOSIGNAL;   // Kein SIGPIPE, wenn der Client vorzeitig trennt
+#else
+const int SENDE_FLAGS = 0;
+#endif
+
+// Laengste angenommene Anfrage; /metrics braucht nur die erste Zeile
+const size_t MAX_ANFRAGE = 8192;
+
+// So oft prueft der Endpunkt, ob er beendet werden soll
+const long WARTEZEIT_MS = 250;
+
+void sende(Sockel sockel, const std::string &antwort)
+{
+    const char *daten = antwort.data();
+    size_t rest = antwort.size();
+    while (rest > 0)
+    {
+        const int gesendet = ::send(sockel, daten, static_cast<int>(std::min<size_t>(rest, 65536)), SENDE_FLAGS);
+        if (gesendet <= 0)
+        {
+            return;
+        }
+        daten += gesendet;
+        rest -= static_cast<size_t>(gesendet);
+    }
+}
+
+std::string antwort(const char *status, const std::string &inhalt)
+{
+    return std::string("HTTP/1.0 ") + status + "\r\n"
+           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+           "Content-Length: " + std::to_string(inhalt.size()) + "\r\n"
+           "Connection: close\r\n\r\n" + inhalt;
+}
+
+} // anonymous namespace
+
+
+struct MetrikExport::Endpunkt
+{
+    Endpunkt() : sockel(KEIN_SOCKEL) { }
+
+    ~Endpunkt()
+    {
+        if (sockel != KEIN_SOCKEL)
+        {
+            schliesse(sockel);
+        }
+#ifdef _WIN32
+        ::WSACleanup();
+#endif
+    }
+
+    Sockel sockel;
+};
+
+
+MetrikExport::MetrikExport(const Metriken &metriken_, unsigned short port_, const std::string &ausgabeDatei_, unsigned intervallSekunden_)
+    : metriken(metriken_),
+      ausgabeDatei(ausgabeDatei_),
+      intervallSekunden(std::max(1u, intervallSekunden_)),
+      beenden(false)
+{
+    if (port_ != 0)
+    {
+#ifdef _WIN32
+        WSADATA wsaDaten;
+        if (::WSAStartup(MAKEWORD(2, 2), &wsaDaten) != 0)
+        {
+            throw std::runtime_error("Winsock konnte nicht initialisiert werden.");
+        }
+#endif
+        endpunkt.reset(new Endpunkt());
+        endpunkt->sockel = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (endpunkt->sockel == KEIN_SOCKEL)
+        {
+            throw std::runtime_error("Fuer den Metrik-Endpunkt konnte kein Socket erzeugt werden.");
+        }
+
+        int wiederverwenden = 1;
+        ::setsockopt(endpunkt->sockel, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&wiederverwenden), sizeof(wiederverwenden));
+
+        // Nur lokal erreichbar, die Metriken enthalten Datenartversionen, Funktionsnamen und Fehlercodes
+        sockaddr_in adresse;
+        std::memset(&adresse, 0, sizeof(adresse));
+        adresse.sin_family = AF_INET;
+        adresse.sin_port = htons(port_);
+        adresse.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(endpunkt->sockel, reinterpret_cast<const sockaddr *>(&adresse), sizeof(adresse)) != 0
+            || ::listen(endpunkt->sockel, 8) != 0)
+        {
+            throw std::runtime_error("Der Metrik-Endpunkt konnte Port " + std::to_string(port_) + " nicht belegen.");
+        }
+        endpunktThread = std::thread(&MetrikExport::bediene, this);
+    }
+
+    if (!ausgabeDatei.empty())
+    {
+        ausgabeThread = std::thread(&MetrikExport::schreibePeriodisch, this);
+    }
+}
+
+MetrikExport::~MetrikExport()
+{
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    beendet.notify_all();
+    if (endpunktThread.joinable())
+    {
+        endpunktThread.join();
+    }
+    if (ausgabeThread.joinable())
+    {
+        ausgabeThread.join();
+    }
+    if (!ausgabeDatei.empty())
+    {
+        schreibe();
+    }
+}
+
+bool MetrikExport::schreibe() const
+{
+    const std::string temporaer = ausgabeDatei + ".tmp";
+    {
+        std::ofstream datei(temporaer.c_str(), std::ios::binary | std::ios::trunc);
+        datei << metriken.alsText();
+        if (!datei.flush())
+        {
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename ersetzt unter Windows keine vorhandene Datei
+    std::remove(ausgabeDatei.c_str());
+#endif
+    return std::rename(temporaer.c_str(), ausgabeDatei.c_str()) == 0;
+}
+
+void MetrikExport::bediene()
+{
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sperre);
+            if (beenden)
+            {
+                return;
+            }
+        }
+
+        fd_set bereit;
+        FD_ZERO(&bereit);
+        FD_SET(endpunkt->sockel, &bereit);
+        timeval wartezeit = { 0, WARTEZEIT_MS * 1000 };
+        if (::select(static_cast<int>(endpunkt->sockel) + 1, &bereit, nullptr, nullptr, &wartezeit) <= 0)
+        {
+            continue;
+        }
+        const Sockel verbindung = ::accept(endpunkt->sockel, nullptr, nullptr);
+        if (verbindung == KEIN_SOCKEL)
+        {
+            continue;
+        }
+
+        // Ein stummer Client darf den Endpunkt nicht blockieren
+#ifdef _WIN32
+        const DWORD empfangsfrist = 2000;
+#else
+        const timeval empfangsfrist = { 2, 0 };
+#endif
+        ::setsockopt(verbindung, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&empfangsfrist), sizeof(empfangsfrist));
+
+        std::string anfrage;
+        char puffer[1024];
+        while (anfrage.find("\r\n\r\n") == std::string::npos && anfrage.size() < MAX_ANFRAGE)
+        {
+            const int gelesen = ::recv(verbindung, puffer, sizeof(puffer), 0);
+            if (gelesen <= 0)
+            {
+                break;
+            }
+            anfrage.append(puffer, static_cast<size_t>(gelesen));
+        }
+
+        const std::string zeile = anfrage.substr(0, anfrage.find("\r\n"));
+        if (zeile.compare(0, 13, "GET /metrics ") == 0 || zeile == "GET /metrics")
+        {
+            sende(verbindung, antwort("200 OK", metriken.alsText()));
+        }
+        else
+        {
+            sende(verbindung, antwort("404 Not Found", "Nur GET /metrics wird unterstuetzt.\n"));
+        }
+        schliesse(verbindung);
+    }
+}
+
+void MetrikExport::schreibePeriodisch()
+{
+    std::unique_lock<std::mutex> lock(sperre);
+    while (!beenden)
+    {
+        if (beendet.wait_for(lock, std::chrono::seconds(intervallSekunden)) == std::cv_status::timeout)
+        {
+            lock.unlock();
+            schreibe();
+            lock.lock();
+        }
+    }
+}
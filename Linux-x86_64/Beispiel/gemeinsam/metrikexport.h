@@ -0,0 +1,67 @@
+#ifndef _METRIKEXPORT_H_
+#define _METRIKEXPORT_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Vorwaertsdeklarationen
+class Metriken;
+
+
+/** @brief Stellt die Metriken im Textformat von Prometheus bereit
+ *
+ * Mit Port beantwortet ein eigener Thread auf 127.0.0.1 die Anfrage
+ * GET /metrics mit Metriken::alsText(). Mit Ausgabedatei schreibt ein
+ * zweiter Thread den Text in festem Abstand und ein letztes Mal im Destruktor
+ * in diese Datei. Die Datei wird dabei ueber eine temporaere Datei ersetzt,
+ * ein Leser sieht also nie einen halb geschriebenen Stand.
+ */
+class MetrikExport
+{
+public:
+    /**
+     * @param metriken
+     *        Das uebergebene Objekt muss mindestens so lange leben, wie
+     *        die erzeugte Instanz der Klasse MetrikExport, da diese eine Referenz darauf haelt!
+     * @param port
+     *        Port des lokalen Endpunkts, 0 ohne Endpunkt
+     * @param ausgabeDatei
+     *        Pfad der Ausgabedatei, leer ohne Ausgabedatei
+     * @param intervallSekunden
+     *        Abstand zwischen zwei Ausgaben in die Datei, mindestens 1
+     *
+     * @throw std::runtime_error, wenn der Port nicht belegt werden kann
+     */
+    MetrikExport(const Metriken &metriken, unsigned short port, const std::string &ausgabeDatei, unsigned intervallSekunden);
+
+    /** @brief Beendet die Threads und schreibt die Ausgabedatei ein letztes Mal */
+    virtual ~MetrikExport();
+
+    /** @brief Schreibt den aktuellen Stand in die Ausgabedatei */
+    bool schreibe() const;
+
+private:
+    MetrikExport(const MetrikExport &); // Kopien verboten
+    MetrikExport &operator=(const MetrikExport &); // Zuweisungen verboten
+
+    struct Endpunkt;
+
+    void bediene();
+    void schreibePeriodisch();
+
+    const Metriken &        metriken;
+    const std::string           ausgabeDatei;
+    const unsigned              intervallSekunden;
+    std::unique_ptr<Endpunkt>   endpunkt;
+
+    std::mutex                  sperre;
+    std::condition_variable     beendet;
+    bool                        beenden;
+    std::thread                 endpunktThread;
+    std::thread                 ausgabeThread;
+};
+
+#endif
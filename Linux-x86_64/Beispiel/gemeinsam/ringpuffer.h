@@ -0,0 +1,114 @@
+#ifndef _RINGPUFFER_H_
+#define _RINGPUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+/** @brief Begrenzte Warteschlange nach D. Vyukov fuer beliebig viele Schreiber und genau einen Leser
+ *
+ * Alle Eintraege werden bei der Konstruktion angelegt. schreibe() sperrt nicht
+ * und fordert keinen Speicher an und darf daher auch aus Log-Callbacks der
+ * Bibliotheken aufgerufen werden. Ein Platz ist frei, wenn seine Folgenummer
+ * der Schreibposition entspricht, und lesbar, sobald sie um eins groesser ist.
+ * Ist der Ring voll, liefert schreibe() false und der Eintrag geht verloren.
+ *
+ * Gemeinsam fuer ericdemo und ottodemo.
+ */
+template <typename Eintrag>
+class Ringpuffer
+{
+public:
+    explicit Ringpuffer(size_t kapazitaet_)
+        : kapazitaet(kapazitaet_),
+          plaetze(new Platz[kapazitaet_]),
+          schreibPosition(0),
+          lesePosition(0)
+    {
+        for (size_t i = 0; i < kapazitaet; ++i)
+        {
+            plaetze[i].folge.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /** @brief Belegt einen freien Platz, laesst ihn von fuelle(Eintrag &) beschreiben und gibt ihn dem Leser frei
+     *
+     * @return false, wenn der Ring voll ist; fuelle wird dann nicht aufgerufen
+     */
+    template <typename Fuellen>
+    bool schreibe(Fuellen fuelle)
+    {
+        size_t position = schreibPosition.load(std::memory_order_relaxed);
+        Platz *platz = nullptr;
+        for (;;)
+        {
+            platz = &plaetze[position % kapazitaet];
+            const size_t folge = platz->folge.load(std::memory_order_acquire);
+            if (folge == position)
+            {
+                if (schreibPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (folge < position)
+            {
+                // Der Leser ist eine Runde zurueck, der Ring ist voll
+                return false;
+            }
+            else
+            {
+                position = schreibPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        fuelle(platz->eintrag);
+        platz->folge.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Uebergibt alle lesbaren Eintraege der Reihe nach an verarbeite(const Eintrag &) und gibt sie wieder frei
+     *
+     * Darf zu jedem Zeitpunkt nur von einem Thread aufgerufen werden.
+     *
+     * @return Anzahl der gelesenen Eintraege
+     */
+    template <typename Verarbeiten>
+    size_t leere(Verarbeiten verarbeite)
+    {
+        size_t anzahl = 0;
+        for (;;)
+        {
+            Platz &platz = plaetze[lesePosition % kapazitaet];
+            if (platz.folge.load(std::memory_order_acquire) != lesePosition + 1)
+            {
+                return anzahl;
+            }
+
+            verarbeite(static_cast<const Eintrag &>(platz.eintrag));
+            ++anzahl;
+
+            // Platz fuer die naechste Runde freigeben
+            platz.folge.store(lesePosition + kapazitaet, std::memory_order_release);
+            ++lesePosition;
+        }
+    }
+
+private:
+    Ringpuffer(const Ringpuffer &); // Kopien verboten
+    Ringpuffer &operator=(const Ringpuffer &); // Zuweisungen verboten
+
+    struct Platz
+    {
+        std::atomic<size_t> folge;
+        Eintrag             eintrag;
+    };
+
+    const size_t             kapazitaet;
+    std::unique_ptr<Platz[]> plaetze;
+    std::atomic<size_t>      schreibPosition;
+    size_t                   lesePosition;      // Nur der Leser
+};
+
+#endif
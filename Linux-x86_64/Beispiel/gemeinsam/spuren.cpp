@@ -0,0 +1,247 @@
+#include "spuren.h"
+
+#include <fstream>
+#include <random>
+
+#include "jsontext.h"
+
+
+namespace
+{
+
+int64_t mikrosekunden(std::chrono::steady_clock::duration dauer)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(dauer).count();
+}
+
+} // anonymous namespace
+
+
+std::atomic<Spuren *> Spuren::aktiveInstanz(nullptr);
+
+
+Spuren::Anfrage::Anfrage(const char *name_, const std::string &details_)
+    : name(name_),
+      anfrage(Spuren::aktuelleAnfrage()),
+      eigene(false),
+      start()
+{
+    if (anfrage != 0)
+    {
+        // Innerhalb einer ausgewaehlten Anfrage: als Spanne aufzeichnen
+        start = std::chrono::steady_clock::now();
+        return;
+    }
+
+    Spuren *const spuren = Spuren::aktive();
+    if (spuren == nullptr)
+    {
+        return;
+    }
+
+    // Zufaellig ausgewaehlt, damit auch Prozesse mit einer einzigen Anfrage im Mittel den Anteil treffen
+    static thread_local std::minstd_rand zufall(std::random_device{}());
+    spuren->anfragen.fetch_add(1, std::memory_order_relaxed);
+    if (std::uniform_real_distribution<double>(0.0, 1.0)(zufall) >= spuren->anteil)
+    {
+        return;
+    }
+
+    anfrage = spuren->ausgewaehlt.fetch_add(1, std::memory_order_relaxed) + 1;
+    eigene = true;
+    {
+        std::lock_guard<std::mutex> lock(spuren->sperre);
+        spuren->details[anfrage] = details_;
+    }
+    Spuren::aktuelleAnfrage() = anfrage;
+    start = std::chrono::steady_clock::now();
+}
+
+Spuren::Anfrage::~Anfrage()
+{
+    if (anfrage == 0)
+    {
+        return;
+    }
+    Spuren::aktive()->trageEin(name, anfrage, start, std::chrono::steady_clock::now());
+    if (eigene)
+    {
+        Spuren::aktuelleAnfrage() = 0;
+    }
+}
+
+
+Spuren::Spanne::Spanne(const char *name_)
+    : name(name_),
+      anfrage(Spuren::aktuelleAnfrage()),
+      start()
+{
+    if (anfrage != 0)
+    {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+Spuren::Spanne::~Spanne()
+{
+    if (anfrage != 0)
+    {
+        Spuren::aktive()->trageEin(name, anfrage, start, std::chrono::steady_clock::now());
+    }
+}
+
+
+Spuren::Puffer::Puffer(unsigned nummer_)
+    : nummer(nummer_),
+      ereignisse(new Ereignis[KAPAZITAET]),
+      anzahl(0),
+      verworfen(0),
+      frei(false)
+{ }
+
+Spuren::PufferHalter::~PufferHalter()
+{
+    // Die Spannen bleiben stehen, der naechste Thread schreibt dahinter weiter
+    if (puffer)
+    {
+        puffer->frei.store(true, std::memory_order_release);
+    }
+}
+
+
+Spuren::Spuren(const std::string &kategorie_)
+    : kategorie(kategorie_),
+      beginn(std::chrono::steady_clock::now()),
+      anteil(0.0),
+      anfragen(0),
+      ausgewaehlt(0)
+{ }
+
+Spuren::~Spuren()
+{ }
+
+void Spuren::aktiviere(double anteil_)
+{
+    anteil = anteil_ < 0.0 ? 0.0 : (anteil_ > 1.0 ? 1.0 : anteil_);
+    aktiveInstanz.store(this, std::memory_order_release);
+}
+
+void Spuren::zeichneAuf(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point ende)
+{
+    const uint64_t anfrage = aktuelleAnfrage();
+    if (anfrage != 0)
+    {
+        aktive()->trageEin(name, anfrage, start, ende);
+    }
+}
+
+bool Spuren::schreibe(const std::string &datei) const
+{
+    std::string json("{\"traceEvents\":[");
+    bool erstes = true;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        for (size_t i = 0; i < puffer.size(); ++i)
+        {
+            const Puffer &threadPuffer = *puffer[i];
+            const std::string tid = std::to_string(threadPuffer.nummer);
+            json += erstes ? "\n" : ",\n";
+            erstes = false;
+            json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid
+                  + ",\"args\":{\"name\":\"Thread " + tid + "\"}}";
+
+            const size_t anzahl = threadPuffer.anzahl.load(std::memory_order_acquire);
+            for (size_t j = 0; j < anzahl; ++j)
+            {
+                const Ereignis &ereignis = threadPuffer.ereignisse[j];
+                json += ",\n{\"name\":";
+                JsonText::haengeAn(json, ereignis.name);
+                json += ",\"cat\":";
+                JsonText::haengeAn(json, kategorie);
+                json += ",\"ph\":\"X\",\"ts\":" + std::to_string(ereignis.startUs)
+                      + ",\"dur\":" + std::to_string(ereignis.dauerUs)
+                      + ",\"pid\":1,\"tid\":" + tid
+                      + ",\"args\":{\"anfrage\":" + std::to_string(ereignis.anfrage);
+                const std::map<uint64_t, std::string>::const_iterator fund = details.find(ereignis.anfrage);
+                if (fund != details.end() && !fund->second.empty())
+                {
+                    json += ",\"details\":";
+                    JsonText::haengeAn(json, fund->second);
+                }
+                json += "}}";
+            }
+        }
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::ofstream ausgabe(datei.c_str(), std::ofstream::binary | std::ofstream::trunc);
+    ausgabe << json;
+    return static_cast<bool>(ausgabe.flush());
+}
+
+Spuren::Kennzahlen Spuren::kennzahlen() const
+{
+    Kennzahlen momentaufnahme = {};
+    momentaufnahme.anfragen = anfragen.load(std::memory_order_relaxed);
+    momentaufnahme.ausgewaehlt = ausgewaehlt.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(sperre);
+    for (size_t i = 0; i < puffer.size(); ++i)
+    {
+        momentaufnahme.spannen += puffer[i]->anzahl.load(std::memory_order_acquire);
+        momentaufnahme.verworfen += puffer[i]->verworfen.load(std::memory_order_relaxed);
+    }
+    return momentaufnahme;
+}
+
+Spuren *Spuren::aktive()
+{
+    return aktiveInstanz.load(std::memory_order_acquire);
+}
+
+uint64_t &Spuren::aktuelleAnfrage()
+{
+    static thread_local uint64_t anfrage = 0;
+    return anfrage;
+}
+
+Spuren::Puffer &Spuren::eigenerPuffer()
+{
+    // Der Puffer gehoert der Instanz und ueberlebt den Thread, damit seine Spannen exportiert werden koennen
+    static thread_local PufferHalter halter;
+    if (halter.puffer)
+    {
+        return *halter.puffer;
+    }
+
+    std::lock_guard<std::mutex> lock(sperre);
+    for (size_t i = 0; i < puffer.size(); ++i)
+    {
+        bool frei = true;
+        if (puffer[i]->frei.compare_exchange_strong(frei, false, std::memory_order_acquire))
+        {
+            halter.puffer = puffer[i].get();
+            return *halter.puffer;
+        }
+    }
+    puffer.push_back(std::unique_ptr<Puffer>(new Puffer(static_cast<unsigned>(puffer.size() + 1))));
+    halter.puffer = puffer.back().get();
+    return *halter.puffer;
+}
+
+void Spuren::trageEin(const char *name, uint64_t anfrage, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point ende)
+{
+    Puffer &threadPuffer = eigenerPuffer();
+    const size_t position = threadPuffer.anzahl.load(std::memory_order_relaxed);
+    if (position >= KAPAZITAET)
+    {
+        threadPuffer.verworfen.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ereignis &ereignis = threadPuffer.ereignisse[position];
+    ereignis.name = name;
+    ereignis.anfrage = anfrage;
+    ereignis.startUs = mikrosekunden(start - beginn);
+    ereignis.dauerUs = mikrosekunden(ende - start);
+    threadPuffer.anzahl.store(position + 1, std::memory_order_release);
+}
@@ -0,0 +1,179 @@
+#ifndef _SPUREN_H_
+#define _SPUREN_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+/** @brief Zeichnet die Zeitspannen ausgewaehlter Anfragen auf und exportiert sie im Chrome-Trace-Format,
+ *         gemeinsam fuer ericdemo und ottodemo
+ *
+ * Nach aktiviere() wird jede Anfrage mit dem angegebenen Anteil als
+ * Wahrscheinlichkeit ausgewaehlt; fuer diese haelt jede Spanne des
+ * ausfuehrenden Threads Beginn und Dauer fest. Jeder Thread schreibt sperrfrei
+ * in einen eigenen Puffer fester Groesse, der bei seiner ersten Aufzeichnung
+ * angelegt und nach dem Ende des Threads mit allen Spannen an den naechsten
+ * neuen Thread weitergegeben wird. Es gibt also hoechstens so viele Puffer wie
+ * gleichzeitig aufzeichnende Threads; im Export ist jeder Puffer eine Zeile.
+ * Ist ein Puffer voll, werden weitere Spannen verworfen und gezaehlt.
+ *
+ * Vor aktiviere() und ausserhalb ausgewaehlter Anfragen kostet eine Anfrage
+ * oder Spanne nur das Lesen einer atomaren bzw. thread-lokalen Variablen,
+ * die Uhr wird dann nicht gelesen.
+ *
+ * schreibe() exportiert alle Spannen im Trace-Event-Format (JSON), das
+ * chrome://tracing und Perfetto darstellen.
+ *
+ * Ein Prozess hat genau eine Instanz, die eine abgeleitete Klasse wie
+ * EricSpuren oder OttoSpuren bereitstellt; Anfrage, Spanne und zeichneAuf()
+ * zeichnen in die zuletzt aktivierte Instanz auf.
+ */
+class Spuren
+{
+public:
+    /** @brief Anzahl der Spannen, die ein Puffer aufnehmen kann */
+    static const size_t KAPAZITAET = 16384;
+
+    struct Kennzahlen
+    {
+        uint64_t anfragen;          // Seit der Aktivierung begonnene Anfragen
+        uint64_t ausgewaehlt;       // Davon aufgezeichnet
+        uint64_t spannen;           // Aufgezeichnete Spannen
+        uint64_t verworfen;         // Bei vollem Puffer verloren
+    };
+
+    /** @brief Begrenzt eine Anfrage im aktuellen Thread
+     *
+     * Beginnt der Thread innerhalb einer Anfrage eine weitere, zaehlt die
+     * innere nur als Spanne der aeusseren.
+     */
+    class Anfrage
+    {
+    public:
+        /**
+         * @param name
+         *        Muss bis zum Export gueltig bleiben, z.B. ein Zeichenkettenliteral
+         * @param details
+         *        Wird mit der Anfrage exportiert, z.B. die Datenartversion
+         */
+        Anfrage(const char *name, const std::string &details);
+        ~Anfrage();
+
+    private:
+        Anfrage(const Anfrage &); // Kopien verboten
+        Anfrage &operator=(const Anfrage &); // Zuweisungen verboten
+
+        const char *const                     name;
+        uint64_t                              anfrage;  // 0 ohne Aufzeichnung
+        bool                                  eigene;   // false innerhalb einer aeusseren Anfrage
+        std::chrono::steady_clock::time_point start;    // Nur mit Aufzeichnung gesetzt
+    };
+
+    /** @brief Zeichnet die Zeit zwischen Konstruktor und Destruktor auf, falls der Thread eine ausgewaehlte Anfrage bearbeitet */
+    class Spanne
+    {
+    public:
+        /**
+         * @param name
+         *        Muss bis zum Export gueltig bleiben, z.B. ein Zeichenkettenliteral
+         */
+        explicit Spanne(const char *name);
+        ~Spanne();
+
+    private:
+        Spanne(const Spanne &); // Kopien verboten
+        Spanne &operator=(const Spanne &); // Zuweisungen verboten
+
+        const char *const                     name;
+        const uint64_t                        anfrage;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    virtual ~Spuren();
+
+    /** @brief Beginnt die Auswahl von Anfragen
+     *
+     * @param anteil
+     *        Aufzuzeichnender Anteil der Anfragen zwischen 0 und 1; jede Anfrage
+     *        wird mit dieser Wahrscheinlichkeit ausgewaehlt
+     */
+    void aktiviere(double anteil);
+
+    /** @brief Zeichnet eine bereits gemessene Spanne auf, falls der Thread eine ausgewaehlte Anfrage bearbeitet
+     *
+     * @param name
+     *        Muss bis zum Export gueltig bleiben, z.B. ein Zeichenkettenliteral
+     */
+    static void zeichneAuf(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point ende);
+
+    /** @brief Schreibt alle bisher aufgezeichneten Spannen als Trace-Event-JSON in die Datei */
+    bool schreibe(const std::string &datei) const;
+
+    Kennzahlen kennzahlen() const;
+
+protected:
+    /** @param kategorie Wert des Felds "cat" der exportierten Spannen, z.B. "ericdemo" */
+    explicit Spuren(const std::string &kategorie);
+
+private:
+    Spuren(const Spuren &); // Kopien verboten
+    Spuren &operator=(const Spuren &); // Zuweisungen verboten
+
+    struct Ereignis
+    {
+        const char *name;
+        uint64_t    anfrage;
+        int64_t     startUs;    // Seit der Erzeugung der Instanz
+        int64_t     dauerUs;
+    };
+
+    /** @brief Spannen eines Threads, genau ein Schreiber */
+    struct Puffer
+    {
+        explicit Puffer(unsigned nummer);
+
+        const unsigned              nummer;
+        std::unique_ptr<Ereignis[]> ereignisse;
+        std::atomic<size_t>         anzahl;     // Die ersten anzahl Ereignisse sind vollstaendig
+        std::atomic<uint64_t>       verworfen;
+        std::atomic<bool>           frei;       // Der Thread ist beendet, der Puffer kann weitergegeben werden
+    };
+
+    /** @brief Gibt den Puffer am Ende des Threads frei */
+    struct PufferHalter
+    {
+        PufferHalter() : puffer(nullptr) { }
+        ~PufferHalter();
+
+        Puffer *puffer;
+    };
+
+    /** @brief Die aktivierte Instanz des Prozesses, vor aktiviere() nullptr */
+    static Spuren *aktive();
+
+    /** @brief Nummer der ausgewaehlten Anfrage, die der aktuelle Thread bearbeitet, sonst 0 */
+    static uint64_t &aktuelleAnfrage();
+
+    Puffer &eigenerPuffer();
+    void trageEin(const char *name, uint64_t anfrage, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point ende);
+
+    static std::atomic<Spuren *>                aktiveInstanz;
+
+    const std::string                           kategorie;
+    const std::chrono::steady_clock::time_point beginn;
+    double                                      anteil;
+    std::atomic<uint64_t>                       anfragen;
+    std::atomic<uint64_t>                       ausgewaehlt;
+
+    mutable std::mutex                          sperre;
+    std::vector<std::unique_ptr<Puffer> >       puffer;
+    std::map<uint64_t, std::string>             details;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Arguments.h"
+#include "OttoLogSenke.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -38,6 +39,43 @@ std::string askForHerstellerId() {
     return herstellerId;
 }
 
+unsigned short parsePort(const std::string &text) {
+    unsigned long port = 0u;
+    try {
+        size_t gelesen = 0u;
+        port = std::stoul(text, &gelesen);
+        if (gelesen != text.size())
+            port = 0u;
+    } catch (const std::logic_error &) {
+        port = 0u;
+    }
+    if ((0u == port) || (65535u < port))
+        throw std::invalid_argument("Ungueltiger Port \""s + text + "\"");
+    return static_cast<unsigned short>(port);
+}
+
+double parseRatio(const std::string &text) {
+    double anteil = -1.0;
+    try {
+        size_t gelesen = 0u;
+        anteil = std::stod(text, &gelesen);
+        if (gelesen != text.size())
+            anteil = -1.0;
+    } catch (const std::logic_error &) {
+        anteil = -1.0;
+    }
+    if ((anteil < 0.0) || (1.0 < anteil))
+        throw std::invalid_argument("Ungueltiger Anteil \""s + text + "\"");
+    return anteil;
+}
+
+std::string parseLogLevel(const std::string &text) {
+    OttoLogEbene ebene;
+    if (!OttoLogSenke::leseEbene(text, ebene))
+        throw std::invalid_argument("Ungueltige Logebene \""s + text + "\"");
+    return text;
+}
+
 } // anonymous namespace
 
 
@@ -51,6 +89,11 @@ Arguments::Arguments() : appPath("ottodemo"),
                          certPath(demoDirPath + "test-softidnr-pse.pfx"),
                          certPin("123456"),
                          herstellerId(),
+                         metricsFilePath(),
+                         logLevel(),
+                         traceFilePath(),
+                         metricsPort(0u),
+                         traceRatio(1.0),
                          showHelp(false),
                          sendData(false),
                          fetchData(false),
@@ -69,6 +112,11 @@ void Arguments::help() const {
     std::cout << "\t" << optionPrefix << 'c' << " <Pfad Zertifikat>    Pfad des Sicherheitstokens fuer die Authentifizierung" << std::endl;
     std::cout << "\t" << optionPrefix << 'p' << " <Passwort>           Passwort oder PIN des Sicherheitstokens" << std::endl;
     std::cout << "\t" << optionPrefix << 'i' << " <Hersteller-ID>      Individuelle ID des Softwareherstellers" << std::endl;
+    std::cout << "\t" << optionPrefix << 'u' << " <Port>               Stellt Metriken unter http://127.0.0.1:<Port>/metrics bereit" << std::endl;
+    std::cout << "\t" << optionPrefix << 'j' << " <Ebene>              Schreibt die Otto-Logmeldungen ab der Ebene debug, info, warn oder error nach otto.jsonl im Log-Verzeichnis" << std::endl;
+    std::cout << "\t" << optionPrefix << 't' << " <Pfad Spurdatei>     Schreibt die Zeitspannen des Transfers im Chrome-Trace-Format (chrome://tracing, Perfetto) in die Datei" << std::endl;
+    std::cout << "\t" << optionPrefix << 'r' << " <Anteil>             Wahrscheinlichkeit zwischen 0 und 1, mit der ein Transfer fuer " << optionPrefix << "t aufgezeichnet wird" << std::endl;
+    std::cout << "\t" << optionPrefix << 'w' << " <Pfad Metrikdatei>   Schreibt die Metriken alle 10 Sekunden und am Ende in die angegebene Datei" << std::endl;
 
     Arguments tmpArgs;
     tmpArgs.herstellerId = "kein Standardwert, Angabe ist zwingend erforderlich";
@@ -80,11 +128,15 @@ void Arguments::help() const {
     std::cout << "\t" << optionPrefix << 'c' << " <Pfad Zertifikat>    " << tmpArgs.certPath << std::endl;
     std::cout << "\t" << optionPrefix << 'p' << " <Passwort>           " << tmpArgs.certPin << std::endl;
     std::cout << "\t" << optionPrefix << 'i' << " <Hersteller-ID>      " << tmpArgs.herstellerId << std::endl;
+    std::cout << "\t" << optionPrefix << 'r' << " <Anteil>             " << tmpArgs.traceRatio << std::endl;
 
     std::cout << std::endl << "Beispiele:" << std::endl;
     std::cout << "\tottodemo " << optionPrefix << "h" << std::endl;
     std::cout << "\tottodemo " << optionPrefix << "e Download.file " << optionPrefix << "o 7090bc69-be5e-4fd0-b91a-2128021295d6 " << optionPrefix << "i <Hersteller-ID>" << std::endl;
     std::cout << "\tottodemo " << optionPrefix << "s Upload.file " << optionPrefix << "i <Hersteller-ID> " << optionPrefix << "c test-softidnr-pse.pfx " << optionPrefix << "p 123456" << std::endl;
+    std::cout << "\tottodemo " << optionPrefix << "s Upload.file " << optionPrefix << "i <Hersteller-ID> " << optionPrefix << "u 9465 " << optionPrefix << "w otto.prom" << std::endl;
+    std::cout << "\tottodemo " << optionPrefix << "e Download.file " << optionPrefix << "i <Hersteller-ID> " << optionPrefix << "j debug" << std::endl;
+    std::cout << "\tottodemo " << optionPrefix << "s Upload.file " << optionPrefix << "i <Hersteller-ID> " << optionPrefix << "t versand.trace.json" << std::endl;
     std::cout << "\tottodemo " << optionPrefix << "c \"http://127.0.0.1:24727/eID-Client?testmerker=520000000\" " << std::endl;
     std::cout << std::endl << "\tDer in den Beispielen angegebene Platzhalter \"<Hersteller-ID>\" muss durch die herstellereigene ID ersetzt werden." << std::endl;
 }
@@ -100,6 +152,11 @@ void Arguments::print() const {
     std::cout << "\tcertPath:              \"" << certPath << "\"" <<  std::endl;
     std::cout << "\tcertPin:               \"" << certPin << "\"" <<  std::endl;
     std::cout << "\therstellerId:          \"" << herstellerId << "\"" <<  std::endl;
+    std::cout << "\tmetricsFilePath:       \"" << metricsFilePath << "\"" <<  std::endl;
+    std::cout << "\tmetricsPort:           "   << metricsPort << std::endl;
+    std::cout << "\tlogLevel:              \"" << logLevel << "\"" <<  std::endl;
+    std::cout << "\ttraceFilePath:         \"" << traceFilePath << "\"" <<  std::endl;
+    std::cout << "\ttraceRatio:            "   << traceRatio << std::endl;
     std::cout << "\tshowHelp:              "   << (showHelp ? "true" : "false") << std::endl;
     std::cout << "\tsendData:              "   << (sendData ? "true" : "false") << std::endl;
     std::cout << "\tfetchData:             "   << (fetchData ? "true" : "false") << std::endl;
@@ -138,6 +195,11 @@ const Arguments parseArguments(int argc, char *argv[]) {
                             case 'i': // Hersteller-ID
                             case 'c': // Pfad zum Zertifikat
                             case 'p': // PIN
+                            case 'u': // Port des Metrik-Endpunkts
+                            case 'w': // Metrikdatei
+                            case 'j': // Ebene der Otto-Logmeldungen
+                            case 't': // Spurdatei
+                            case 'r': // Anteil aufgezeichneter Transfers
                                 // Optionen, die einen nachfolgenden Parameter erwarten
                                 // Fuer solche Optionen ist hier noch nichts zu tun
                                 break;
@@ -179,6 +241,21 @@ const Arguments parseArguments(int argc, char *argv[]) {
                         case 'p': // PIN
                             arguments.certPin = argv[argumentIndex];
                             break;
+                        case 'u': // Port des Metrik-Endpunkts
+                            arguments.metricsPort = parsePort(argv[argumentIndex]);
+                            break;
+                        case 'w': // Metrikdatei
+                            arguments.metricsFilePath = argv[argumentIndex];
+                            break;
+                        case 'j': // Ebene der Otto-Logmeldungen
+                            arguments.logLevel = parseLogLevel(argv[argumentIndex]);
+                            break;
+                        case 't': // Spurdatei
+                            arguments.traceFilePath = argv[argumentIndex];
+                            break;
+                        case 'r': // Anteil aufgezeichneter Transfers
+                            arguments.traceRatio = parseRatio(argv[argumentIndex]);
+                            break;
                         case 's': // In Dateiname speichern
                             arguments.inFilePath = argv[argumentIndex];
                             break;
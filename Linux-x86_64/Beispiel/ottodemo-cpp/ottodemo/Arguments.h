@@ -14,6 +14,12 @@ struct Arguments {
     std::string certPath;
     std::string certPin;
     std::string herstellerId;
+    std::string metricsFilePath;
+    std::string logLevel;
+    std::string traceFilePath;
+
+    unsigned short metricsPort;
+    double         traceRatio;
 
     bool        showHelp;
     bool        sendData;
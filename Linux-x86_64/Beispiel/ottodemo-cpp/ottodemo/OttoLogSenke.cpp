@@ -0,0 +1,163 @@
+#include "OttoLogSenke.h"
+
+#include "jsontext.h"
+
+#include <chrono>
+#include <stdexcept>
+
+
+namespace {
+    // Bezeichnung des Vorgangs, den der aktuelle Thread gerade ausführt
+    thread_local char aktuellerVorgang[OttoLogSenke::maxVorgang] = "";
+
+    // So oft leert der Hintergrundthread den Ring
+    constexpr auto leerintervall = std::chrono::milliseconds(50);
+
+    const char *ebenenName(OttoLogEbene ebene) {
+        switch (ebene) {
+            case OTTOLOG_FEHLERMELDUNGEN:
+                return "ERROR";
+            case OTTOLOG_WARNUNGEN:
+                return "WARN";
+            case OTTOLOG_INFORMATIONEN:
+                return "INFO";
+            case OTTOLOG_DEBUGMELDUNGEN:
+                return "DEBUG";
+            default:
+                return "UNBEKANNT";
+        }
+    }
+
+    // Kopiert höchstens groesse Zeichen und liefert die kopierte Länge
+    uint32_t kopiere(char *ziel, size_t groesse, const char *quelle) {
+        size_t laenge = 0u;
+        if (nullptr != quelle) {
+            for (; (laenge < groesse) && ('\0' != quelle[laenge]); ++laenge)
+                ziel[laenge] = quelle[laenge];
+        }
+        return static_cast<uint32_t>(laenge);
+    }
+} // anonymous namespace
+
+
+OttoLogSenke::Vorgang::Vorgang(const std::string &bezeichnung) {
+    vorher[kopiere(vorher, maxVorgang - 1u, aktuellerVorgang)] = '\0';
+    aktuellerVorgang[kopiere(aktuellerVorgang, maxVorgang - 1u, bezeichnung.c_str())] = '\0';
+}
+
+OttoLogSenke::Vorgang::~Vorgang() {
+    aktuellerVorgang[kopiere(aktuellerVorgang, maxVorgang - 1u, vorher)] = '\0';
+}
+
+
+OttoLogSenke::OttoLogSenke(const std::string &ausgabeDatei, OttoLogEbene mindestEbene)
+    : mindestEbene(mindestEbene),
+      ausgabe(ausgabeDatei, std::ofstream::binary | std::ofstream::app),
+      eintraege(kapazitaet),
+      gefiltert(0u),
+      uebergelaufen(0u),
+      beenden(false),
+      geschrieben(0u)
+{
+    if (!ausgabe)
+        throw std::runtime_error("Die Logdatei \"" + ausgabeDatei + "\" konnte nicht geoeffnet werden");
+    thread = std::thread(&OttoLogSenke::arbeite, this);
+}
+
+OttoLogSenke::~OttoLogSenke() {
+    beende();
+}
+
+void OttoLogSenke::beende() {
+    if (!thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        beenden = true;
+    }
+    beendet.notify_all();
+    thread.join();
+
+    // Der Thread ist beendet, es gibt also weiter nur einen Leser
+    leere();
+}
+
+OttoLogSenke::Kennzahlen OttoLogSenke::kennzahlen() const {
+    Kennzahlen kennzahlen;
+    {
+        std::lock_guard<std::mutex> lock(sperre);
+        kennzahlen.geschrieben = geschrieben;
+    }
+    kennzahlen.gefiltert = gefiltert.load(std::memory_order_relaxed);
+    kennzahlen.uebergelaufen = uebergelaufen.load(std::memory_order_relaxed);
+    return kennzahlen;
+}
+
+int OttoLogSenke::logCallback(const char *instanzId, const char *logZeitpunkt, OttoLogEbene logEbene, const char *logNachricht, void *benutzerdaten) {
+    // Läuft im Thread des Otto-Aufrufs: weder Sperren noch Speicheranforderungen
+    auto &senke = *static_cast<OttoLogSenke *>(benutzerdaten);
+    if (logEbene < senke.mindestEbene)
+        senke.gefiltert.fetch_add(1u, std::memory_order_relaxed);
+    else if (!senke.schreibe(instanzId, logZeitpunkt, logEbene, logNachricht))
+        senke.uebergelaufen.fetch_add(1u, std::memory_order_relaxed);
+    return 0;
+}
+
+bool OttoLogSenke::leseEbene(const std::string &text, OttoLogEbene &ebene) {
+    if ("debug" == text)
+        ebene = OTTOLOG_DEBUGMELDUNGEN;
+    else if ("info" == text)
+        ebene = OTTOLOG_INFORMATIONEN;
+    else if ("warn" == text)
+        ebene = OTTOLOG_WARNUNGEN;
+    else if ("error" == text)
+        ebene = OTTOLOG_FEHLERMELDUNGEN;
+    else
+        return false;
+    return true;
+}
+
+bool OttoLogSenke::schreibe(const char *instanzId, const char *logZeitpunkt, OttoLogEbene logEbene, const char *logNachricht) {
+    // Mehrere Instanzen dürfen in verschiedenen Threads gleichzeitig schreiben
+    return eintraege.schreibe([&](Eintrag &eintrag) {
+        eintrag.ebene = logEbene;
+        eintrag.zeitpunktLaenge = kopiere(eintrag.zeitpunkt, maxZeitpunkt, logZeitpunkt);
+        eintrag.instanzIdLaenge = kopiere(eintrag.instanzId, maxInstanzId, instanzId);
+        eintrag.vorgangLaenge = kopiere(eintrag.vorgang, maxVorgang, aktuellerVorgang);
+        eintrag.nachrichtLaenge = kopiere(eintrag.nachricht, maxNachricht, logNachricht);
+    });
+}
+
+void OttoLogSenke::leere() {
+    std::string zeilen;
+    const uint64_t anzahl = eintraege.leere([&zeilen](const Eintrag &eintrag) {
+        zeilen += "{\"zeit\":";
+        JsonText::haengeAn(zeilen, eintrag.zeitpunkt, eintrag.zeitpunktLaenge);
+        zeilen += ",\"ebene\":\"";
+        zeilen += ebenenName(eintrag.ebene);
+        zeilen += "\",\"instanz\":";
+        JsonText::haengeAn(zeilen, eintrag.instanzId, eintrag.instanzIdLaenge);
+        zeilen += ",\"vorgang\":";
+        JsonText::haengeAn(zeilen, eintrag.vorgang, eintrag.vorgangLaenge);
+        zeilen += ",\"nachricht\":";
+        JsonText::haengeAn(zeilen, eintrag.nachricht, eintrag.nachrichtLaenge);
+        zeilen += "}\n";
+    });
+
+    if (0u < anzahl) {
+        ausgabe.write(zeilen.data(), static_cast<std::streamsize>(zeilen.size()));
+        ausgabe.flush();
+        std::lock_guard<std::mutex> lock(sperre);
+        geschrieben += anzahl;
+    }
+}
+
+void OttoLogSenke::arbeite() {
+    std::unique_lock<std::mutex> lock(sperre);
+    while (!beenden) {
+        beendet.wait_for(lock, leerintervall);
+        lock.unlock();
+        leere();
+        lock.lock();
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <otto.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ringpuffer.h"
+
+
+/* Nimmt die Log-Meldungen der Otto-Instanzen über den OttoLogCallback entgegen und schreibt sie als JSON-Zeilen
+ *
+ * Der Callback kopiert Zeitpunkt, Ebene, Instanz-ID und Nachricht in einen bei der Konstruktion angelegten Ring
+ * fester Größe und kehrt sofort zurück; er sperrt nicht und fordert keinen Speicher an. Ist der Ring voll, geht
+ * die Meldung verloren und wird gezählt. Ein Hintergrundthread leert den Ring alle 50 ms in die Ausgabedatei:
+ *     {"zeit":"...","ebene":"INFO","instanz":"...","vorgang":"versand Upload.file","nachricht":"..."}
+ *
+ * Das Feld "vorgang" ordnet die Meldung einem Transfer zu, siehe OttoLogSenke::Vorgang.
+ * Die Senke muss alle Instanzen überleben, die mit ihrem Callback erzeugt wurden.
+ */
+
+class OttoLogSenke {
+    public:
+        static constexpr size_t kapazitaet = 1024u;        // Meldungen im Ring
+        static constexpr size_t maxZeitpunkt = 32u;         // Längere Felder werden gekürzt
+        static constexpr size_t maxInstanzId = 64u;
+        static constexpr size_t maxVorgang = 64u;
+        static constexpr size_t maxNachricht = 1024u;
+
+        struct Kennzahlen {
+            uint64_t geschrieben = 0u;      // In die Ausgabedatei geschriebene Meldungen
+            uint64_t gefiltert = 0u;        // Unterhalb der Mindestebene verworfen
+            uint64_t uebergelaufen = 0u;    // Bei vollem Ring verloren
+        };
+
+        // Kennzeichnet alle Meldungen, die der aktuelle Thread während der Lebensdauer des Objekts auslöst.
+        // Verschachtelte Vorgänge stellen beim Verlassen die äußere Bezeichnung wieder her.
+        class Vorgang {
+            public:
+                explicit Vorgang(const std::string &bezeichnung);
+                ~Vorgang();
+
+                Vorgang(const Vorgang &) = delete;
+                Vorgang &operator=(const Vorgang &) = delete;
+
+            private:
+                char vorher[maxVorgang];
+        };
+
+        // Wirft std::runtime_error, wenn die Ausgabedatei nicht geöffnet werden kann
+        OttoLogSenke(const std::string &ausgabeDatei, OttoLogEbene mindestEbene);
+
+        // Siehe beende()
+        ~OttoLogSenke();
+
+        OttoLogSenke(const OttoLogSenke &) = delete;
+        OttoLogSenke &operator=(const OttoLogSenke &) = delete;
+
+        // Beendet den Hintergrundthread und leert den Ring ein letztes Mal; danach eintreffende Meldungen
+        // bleiben im Ring liegen
+        void beende();
+
+        // Stand des letzten Durchlaufs, nach beende() vollständig
+        Kennzahlen kennzahlen() const;
+
+        // Callback für OttoInstanzErzeugen(), benutzerdaten ist die Senke
+        static int logCallback(const char *instanzId, const char *logZeitpunkt, OttoLogEbene logEbene, const char *logNachricht, void *benutzerdaten);
+
+        // Ebene zu "debug", "info", "warn" oder "error"
+        static bool leseEbene(const std::string &text, OttoLogEbene &ebene);
+
+    private:
+        struct Eintrag {
+            OttoLogEbene        ebene;
+            uint32_t            zeitpunktLaenge;
+            uint32_t            instanzIdLaenge;
+            uint32_t            vorgangLaenge;
+            uint32_t            nachrichtLaenge;
+            char                zeitpunkt[maxZeitpunkt];
+            char                instanzId[maxInstanzId];
+            char                vorgang[maxVorgang];
+            char                nachricht[maxNachricht];
+        };
+
+        bool schreibe(const char *instanzId, const char *logZeitpunkt, OttoLogEbene logEbene, const char *logNachricht);
+        void leere();
+        void arbeite();
+
+        const OttoLogEbene           mindestEbene;
+        std::ofstream                ausgabe;
+        Ringpuffer<Eintrag>          eintraege;         // Gelesen nur vom Hintergrundthread
+        std::atomic<uint64_t>        gefiltert;
+        std::atomic<uint64_t>        uebergelaufen;
+
+        mutable std::mutex           sperre;
+        std::condition_variable      beendet;
+        bool                         beenden;
+        uint64_t                     geschrieben;
+        std::thread                  thread;
+};
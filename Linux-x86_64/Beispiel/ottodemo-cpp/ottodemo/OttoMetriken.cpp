@@ -0,0 +1,24 @@
+#include "OttoMetriken.h"
+#include "OttoSpuren.h"
+
+
+OttoMetriken::Aufruf::Aufruf(const char *funktion) : funktion(funktion), start(std::chrono::steady_clock::now()) {}
+
+OttoStatusCode OttoMetriken::Aufruf::ende(OttoStatusCode statusCode) const {
+    const auto jetzt = std::chrono::steady_clock::now();
+    OttoSpuren::zeichneAuf(funktion, start, jetzt);
+    OttoMetriken &metriken = OttoMetriken::get();
+    const std::string labels = label("funktion", funktion);
+    metriken.zaehle("otto_api_aufrufe_total", labels + "," + label("statuscode", std::to_string(static_cast<int>(statusCode))));
+    metriken.messe("otto_api_dauer_seconds", labels, jetzt - start);
+    return statusCode;
+}
+
+
+OttoMetriken &OttoMetriken::get() {
+    // Wird nie zerstört, damit Threads und Handle-Destruktoren bis zuletzt zählen können
+    static OttoMetriken *const metriken = new OttoMetriken();
+    return *metriken;
+}
+
+OttoMetriken::OttoMetriken() : Metriken("otto") {}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <otto.h>
+
+#include <chrono>
+
+#include "metriken.h"
+
+
+/* Metriken des OttoWrappers
+ *
+ * Registry und Export liegen in ../gemeinsam und werden mit ericdemo geteilt, siehe Metriken und MetrikExport. Hier
+ * kommen nur die Instanz des Prozesses und die Zählung der Otto-Aufrufe hinzu.
+ */
+
+class OttoMetriken : public Metriken {
+    public:
+        // Zählt einen Aufruf einer Otto-Funktion mit Statuscode und Dauer. Die Instanz wird vor dem Aufruf erzeugt:
+        //     const OttoMetriken::Aufruf aufruf("OttoVersandBeginnen");
+        //     return aufruf.ende(ottoVersandBeginnen(...));
+        class Aufruf {
+            public:
+                explicit Aufruf(const char *funktion);
+
+                // Zählt otto_api_aufrufe_total und misst otto_api_dauer_seconds, liefert den Statuscode unverändert
+                OttoStatusCode ende(OttoStatusCode statusCode) const;
+
+            private:
+                const char *const                           funktion;
+                const std::chrono::steady_clock::time_point start;
+        };
+
+        static OttoMetriken &get();
+
+    private:
+        OttoMetriken();
+};
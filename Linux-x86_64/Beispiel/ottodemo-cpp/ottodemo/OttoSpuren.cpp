@@ -0,0 +1,10 @@
+#include "OttoSpuren.h"
+
+
+OttoSpuren &OttoSpuren::get() {
+    // Wird nie zerstört, damit Threads und Handle-Destruktoren bis zuletzt aufzeichnen können
+    static OttoSpuren *const spuren = new OttoSpuren();
+    return *spuren;
+}
+
+OttoSpuren::OttoSpuren() : Spuren("ottodemo") {}
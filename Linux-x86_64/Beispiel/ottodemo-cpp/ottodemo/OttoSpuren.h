@@ -0,0 +1,19 @@
+#pragma once
+
+#include "spuren.h"
+
+
+/* Spuren des OttoWrappers
+ *
+ * Aufzeichnung und Export liegen in ../gemeinsam und werden mit ericdemo geteilt, siehe Spuren. Eine Anfrage ist
+ * hier ein Versand oder eine Abholung; zu ihren Spannen zählt auch jeder über OttoMetriken::Aufruf gezählte
+ * Otto-Aufruf, also auch jeder Block von OttoVersandFortsetzen() und OttoEmpfangFortsetzen().
+ */
+
+class OttoSpuren : public Spuren {
+    public:
+        static OttoSpuren &get();
+
+    private:
+        OttoSpuren();
+};
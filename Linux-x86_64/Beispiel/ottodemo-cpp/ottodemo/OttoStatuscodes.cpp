@@ -0,0 +1,181 @@
+#include "OttoStatuscodes.h"
+#include "OttoWrapper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+
+namespace {
+    using Kategorie = OttoStatuscodes::Kategorie;
+
+#define STATUSCODE(code, kategorie, wiederholbar) { code, #code, Kategorie::kategorie, wiederholbar }
+
+    // Aus otto_statuscode.h, aufsteigend nach Code
+    constexpr OttoStatuscodes::Eintrag eintraege[] = {
+        STATUSCODE(OTTO_OK,                                      Erfolg,    false),
+        STATUSCODE(OTTO_INTERNER_FEHLER,                         Intern,    false),
+        STATUSCODE(OTTO_UNBEKANNTER_FEHLER,                      Intern,    false),
+        STATUSCODE(OTTO_NPA_ZERTIFIKATFEHLER,                    Intern,    false),
+        STATUSCODE(OTTO_TRANSFER_FEHLER,                         Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_INIT,                           Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_CONNECTSERVER,                  Transfer,  true),
+        STATUSCODE(OTTO_TRANSFER_CONNECTPROXY,                   Transfer,  true),
+        STATUSCODE(OTTO_TRANSFER_TIMEOUT,                        Transfer,  true),
+        STATUSCODE(OTTO_TRANSFER_PROXYAUTH,                      Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_UNAUTHORIZED,                   Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_NOT_FOUND,                      Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_SERVER_FEHLER,                  Transfer,  true),
+        STATUSCODE(OTTO_TRANSFER_DECODING,                       Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_EID_ZERTIFIKATFEHLER,           Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_EID_KEINCLIENT,                 Transfer,  true),
+        STATUSCODE(OTTO_TRANSFER_EID_KEINKONTO,                  Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_EID_CLIENTFEHLER,               Transfer,  false),
+        STATUSCODE(OTTO_TRANSFER_EID_NPABLOCKIERT,               Transfer,  true),
+        STATUSCODE(OTTO_UNGUELTIGER_PARAMETER,                   Anwendung, false),
+        STATUSCODE(OTTO_UNGUELTIGES_HANDLE,                      Anwendung, false),
+        STATUSCODE(OTTO_MEHRFACHAUFRUFE_NICHT_UNTERSTUETZT,      Anwendung, false),
+        STATUSCODE(OTTO_INSTANZEN_INKONSISTENT,                  Anwendung, false),
+        STATUSCODE(OTTO_INSTANZ_UNTEROBJEKTE_NICHT_FREIGEGEBEN,  Anwendung, false),
+        STATUSCODE(OTTO_LOG_FEHLER,                              Anwendung, false),
+        STATUSCODE(OTTO_FUNKTION_NICHT_UNTERSTUETZT,             Anwendung, false),
+        STATUSCODE(OTTO_ZERTIFIKAT_PIN_FALSCH,                   Anwendung, false),
+        STATUSCODE(OTTO_ZERTIFIKAT_PFAD_FALSCH,                  Anwendung, false),
+        STATUSCODE(OTTO_ZERTIFIKAT_NICHT_ERKANNT,                Anwendung, false),
+        STATUSCODE(OTTO_PRUEFSUMME_FINALISIERT,                  Anwendung, false),
+        STATUSCODE(OTTO_UNGUELTIGE_HERSTELLERID,                 Anwendung, false),
+        STATUSCODE(OTTO_EMPFANG_VORZEITIG_BEENDET,               Anwendung, true),
+        STATUSCODE(OTTO_VERSAND_GERINGE_DATENMENGE,              Anwendung, false),
+        STATUSCODE(OTTO_ESIGNER_NICHT_GELADEN,                   Anwendung, false),
+        STATUSCODE(OTTO_ESIGNER_VERALTET,                        Anwendung, false),
+        STATUSCODE(OTTO_ESIGNER_INKOMPATIBEL,                    Anwendung, false),
+        STATUSCODE(OTTO_PROXY_URL,                               Anwendung, false),
+        STATUSCODE(OTTO_PROXY_PORT,                              Anwendung, false),
+        STATUSCODE(OTTO_PROXY_AUTHSCHEMA,                        Anwendung, false),
+        STATUSCODE(OTTO_VERSAND_ABGESCHLOSSEN,                   Anwendung, false),
+        STATUSCODE(OTTO_VERSAND_ZU_GROSSE_DATENMENGE,            Anwendung, false),
+        STATUSCODE(OTTO_EINSTELLUNG_UNBEKANNT,                   Anwendung, false),
+        STATUSCODE(OTTO_EINSTELLUNG_WERT_UNGUELTIG,              Anwendung, false),
+        STATUSCODE(OTTO_ESIGNER_BUSY,                            ESigner,   true),
+        STATUSCODE(OTTO_ESIGNER_DECRYPT,                         ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ENCRYPT,                         ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ENCODE_ERROR,                    ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ENCODE_UNKNOWN,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ESICL_EXCEPTION,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_INVALID_HANDLE,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_LOAD_DLL,                        ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_MAX_SESSION,                     ESigner,   true),
+        STATUSCODE(OTTO_ESIGNER_NO_SERVICE,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_NO_SIG_ENC_KEY,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_OUT_OF_MEM,                      ESigner,   true),
+        STATUSCODE(OTTO_ESIGNER_P11_ENC_KEY,                     ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_ENGINE_LOADED,               ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_INIT_FAILED,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_NO_ENC_CERT,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_NO_SIG_CERT,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_SIG_KEY,                     ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P11_SLOT_EMPTY,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_CREATE,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_DECODE,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_ENC_KEY,                     ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_SIG_KEY,                     ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_NO_ENC_CERT,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_NO_SIG_CERT,                 ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P12_READ,                        ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P7_DECODE,                       ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P7_READ,                         ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_P7_RECIPIENT,                    ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_PIN_LOCKED,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_PIN_WRONG,                       ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_PSE_PATH,                        ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_ENC_KEY,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_INIT_FAILED,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_NO_APPLET,                    ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_NO_ENC_CERT,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_NO_SIG_CERT,                  ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_SESSION,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_SIG_KEY,                      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_SC_SLOT_EMPTY,                   ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_TOKEN_TYPE_MISMATCH,             ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_USER_CANCEL,                     ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_VERIFY_CERT_CHAIN,               ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_DATA_NOT_INITIALIZED,            ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ASN1_READ_BUFFER_TOO_SMALL,      ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ASN1_READ_DATA_INCOMPLETE,       ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ASN1_NO_ENVELOPED_DATA,          ESigner,   false),
+        STATUSCODE(OTTO_ESIGNER_ASN1_NO_CONTENT_DATA,            ESigner,   false),
+        STATUSCODE(OTTO_INIDATEI_LESEFEHLER,                     System,    false),
+        STATUSCODE(OTTO_ZERTIFIKAT_LESEFEHLER,                   System,    false),
+        STATUSCODE(OTTO_ZERTIFIKAT_DEFEKT,                       System,    false),
+        STATUSCODE(OTTO_ZERTIFIKAT_FINGERABDRUCK_FEHLER,         System,    false),
+        STATUSCODE(OTTO_SIGNIEREN_FEHLGESCHLAGEN,                System,    false),
+        STATUSCODE(OTTO_ENTSCHLUESSELN_FEHLGESCHLAGEN,           System,    false),
+        STATUSCODE(OTTO_DEKOMPRESSION_FEHLGESCHLAGEN,            System,    false),
+        STATUSCODE(OTTO_NICHT_GENUEGEND_ARBEITSSPEICHER,         System,    true)
+    };
+
+#undef STATUSCODE
+
+    constexpr size_t anzahlEintraege = sizeof(eintraege) / sizeof(eintraege[0]);
+
+    // Die binäre Suche in suche() setzt eine aufsteigend sortierte Tabelle voraus
+    constexpr bool istAufsteigend() {
+        for (size_t i = 1u; i < anzahlEintraege; ++i) {
+            if (eintraege[i - 1u].code >= eintraege[i].code)
+                return false;
+        }
+        return true;
+    }
+    static_assert(istAufsteigend(), "Die Tabelle der Otto-Statuscodes muss aufsteigend sortiert sein");
+
+    // Je Tabelleneintrag der Zeiger auf den Klartext, nullptr bis zum ersten Bedarf
+    std::atomic<const char *> texte[anzahlEintraege];
+
+    std::mutex                                    unbekannteTexteMutex;
+    std::map<OttoStatusCode, const char *>        unbekannteTexte;
+} // anonymous namespace
+
+const OttoStatuscodes::Eintrag *OttoStatuscodes::suche(OttoStatusCode statuscode) {
+    const auto ende = eintraege + anzahlEintraege;
+    const auto eintrag = std::lower_bound(eintraege, ende, statuscode,
+                                          [](const Eintrag &e, OttoStatusCode code) { return e.code < code; });
+    return ((ende != eintrag) && (statuscode == eintrag->code)) ? eintrag : nullptr;
+}
+
+const char *OttoStatuscodes::kategorieName(Kategorie kategorie) {
+    switch (kategorie) {
+        case Kategorie::Erfolg:    return "Erfolg";
+        case Kategorie::Intern:    return "Intern";
+        case Kategorie::Transfer:  return "Transfer";
+        case Kategorie::Anwendung: return "Anwendung";
+        case Kategorie::ESigner:   return "eSigner";
+        case Kategorie::System:    return "System";
+    }
+    return "Unbekannt";
+}
+
+const char *OttoStatuscodes::fehlertext(OttoStatusCode statuscode, const OttoWrapper &otto) {
+    const Eintrag *eintrag = suche(statuscode);
+    if (nullptr == eintrag) {
+        std::lock_guard<std::mutex> lock(unbekannteTexteMutex);
+        const auto gefunden = unbekannteTexte.find(statuscode);
+        if (unbekannteTexte.end() != gefunden)
+            return gefunden->second;
+        const char *text = otto.holeFehlertext(statuscode);
+        if (nullptr != text)
+            unbekannteTexte.emplace(statuscode, text);
+        return text;
+    }
+
+    // Der Zeiger verweist auf einen statischen Puffer der Bibliothek; holen ihn zwei Threads gleichzeitig,
+    // erhalten beide denselben Wert, daher genügt ein einfaches Speichern
+    std::atomic<const char *> &platz = texte[eintrag - eintraege];
+    const char *text = platz.load(std::memory_order_acquire);
+    if (nullptr == text) {
+        text = otto.holeFehlertext(statuscode);
+        if (nullptr != text)
+            platz.store(text, std::memory_order_release);
+    }
+    return text;
+}
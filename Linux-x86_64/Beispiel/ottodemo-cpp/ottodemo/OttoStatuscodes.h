@@ -0,0 +1,36 @@
+#pragma once
+
+#include <otto_statuscode.h>
+
+
+class OttoWrapper;
+
+/* Tabelle der Otto-Statuscodes mit Zwischenspeicher für die Klartexte */
+
+// Die Tabelle wird zur Übersetzungszeit aus den Aufzählungswerten in otto_statuscode.h gebildet und ordnet jedem
+// Statuscode seinen symbolischen Namen, seine Kategorie und die Angabe zu, ob eine Wiederholung sinnvoll sein kann.
+// Die Klartexte liefert OttoHoleFehlertext() als Zeiger auf statische Puffer der Otto-Bibliothek. Jeder Zeiger wird
+// beim ersten Bedarf einmal geholt und danach ohne Sperre gelesen; nur Codes, die in otto_statuscode.h fehlen,
+// werden unter einer Sperre abgelegt.
+class OttoStatuscodes {
+    public:
+        // Kategorie nach dem Nummernkreis des Statuscodes
+        enum class Kategorie { Erfolg, Intern, Transfer, Anwendung, ESigner, System };
+
+        struct Eintrag {
+            OttoStatusCode code;
+            const char    *name;            // Symbolischer Name aus otto_statuscode.h
+            Kategorie      kategorie;
+            bool           wiederholbar;    // Vorübergehender Fehler, z. B. Zeitüberschreitung oder Überlastung
+        };
+
+        OttoStatuscodes() = delete;
+
+        // Liefert den Tabelleneintrag zu einem Statuscode oder nullptr, wenn der Code nicht in otto_statuscode.h steht
+        static const Eintrag *suche(OttoStatusCode statuscode);
+
+        static const char *kategorieName(Kategorie kategorie);
+
+        // Liefert den Klartext der Otto-Bibliothek zu einem Statuscode oder nullptr, falls kein Text ermittelt werden konnte
+        static const char *fehlertext(OttoStatusCode statuscode, const OttoWrapper &otto);
+};
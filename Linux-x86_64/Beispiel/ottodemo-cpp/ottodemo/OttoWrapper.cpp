@@ -1,4 +1,6 @@
 #include "OttoWrapper.h"
+#include "OttoLogSenke.h"
+#include "OttoMetriken.h"
 #include "System.h"
 
 #include <iostream>
@@ -20,9 +22,12 @@ OttoWrapper &OttoWrapper::get() {
 
 OttoWrapper::OttoWrapper()
     : dylibHandle(nullptr),
+      logSenke(nullptr),
+      gemeinsameInstanzHandle(nullptr),
       ottoInstanzErzeugen(nullptr),
       ottoInstanzFreigeben(nullptr),
       ottoZertifikatOeffnen(nullptr),
+      ottoZertifikatOeffnenAusBytes(nullptr),
       ottoZertifikatSchliessen(nullptr),
       ottoRueckgabepufferErzeugen(nullptr),
       ottoRueckgabepufferGroesse(nullptr),
@@ -46,6 +51,7 @@ OttoWrapper::OttoWrapper()
 }
 
 OttoWrapper::~OttoWrapper() {
+    gemeinsameInstanzFreigeben();
     if (nullptr != dylibHandle)
         CLOSE_LIBRARY(static_cast<DYLIB_HANDLE>(dylibHandle));
 }
@@ -67,6 +73,9 @@ bool OttoWrapper::loadOtto(const std::string &libDirPath) {
         return false;
     }
 
+    // OttoZertifikatOeffnenAusBytes fehlt in älteren Bibliotheken und ist daher optional
+    ottoZertifikatOeffnenAusBytes = reinterpret_cast<OttoZertifikatOeffnenAusBytes>(GET_FUNCTION_ADDR(static_cast<DYLIB_HANDLE>(dylibHandle),"OttoZertifikatOeffnenAusBytes"));
+
     // Adressen der Schnittstellenfunktionen der otto-Bibliothek ermitteln
    return    (nullptr != (ottoInstanzErzeugen = reinterpret_cast<OttoInstanzErzeugen>(getFunctionAddr("OttoInstanzErzeugen",dylibHandle,libPath))))
           && (nullptr != (ottoInstanzFreigeben = reinterpret_cast<OttoInstanzFreigeben>(getFunctionAddr("OttoInstanzFreigeben",dylibHandle,libPath))))
@@ -93,27 +102,78 @@ bool OttoWrapper::loadOtto(const std::string &libDirPath) {
           && (nullptr != (ottoVersion = reinterpret_cast<OttoVersion>(getFunctionAddr("OttoVersion",dylibHandle,libPath))));
 }
 
+void OttoWrapper::setLogSenke(OttoLogSenke *logSenke) {
+    this->logSenke = logSenke;
+}
+
+OttoStatusCode OttoWrapper::gemeinsameInstanz(const byteChar * const logPfad,OttoInstanzHandle *instanz) {
+    if (nullptr == instanz)
+        return OTTO_UNGUELTIGER_PARAMETER;
+
+    std::lock_guard<std::mutex> sperre(gemeinsameInstanzMutex);
+    OttoStatusCode ottoStatusCode = OTTO_OK;
+    if (nullptr == gemeinsameInstanzHandle)
+        ottoStatusCode = instanzErzeugen(logPfad,nullptr,nullptr,&gemeinsameInstanzHandle);
+    *instanz = gemeinsameInstanzHandle;
+    return ottoStatusCode;
+}
+
+void OttoWrapper::gemeinsameInstanzFreigeben() {
+    std::lock_guard<std::mutex> sperre(gemeinsameInstanzMutex);
+    if (nullptr != gemeinsameInstanzHandle) {
+        instanzFreigeben(gemeinsameInstanzHandle);
+        gemeinsameInstanzHandle = nullptr;
+    }
+}
+
 
 // Kapselung der Otto API-Funktionen
 
 OttoStatusCode OttoWrapper::instanzErzeugen(const byteChar * const logPfad,OttoLogCallback logCallback,void *logCallbackBenutzerdaten,OttoInstanzHandle *instanz) const {
-    return ottoInstanzErzeugen(logPfad,logCallback,logCallbackBenutzerdaten,instanz);
+    const OttoMetriken::Aufruf aufruf("OttoInstanzErzeugen");
+    if ((nullptr == logCallback) && (nullptr != logSenke)) {
+        logCallback = &OttoLogSenke::logCallback;
+        logCallbackBenutzerdaten = logSenke;
+    }
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoInstanzErzeugen(logPfad,logCallback,logCallbackBenutzerdaten,instanz));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().veraendere("otto_instanzen_belegt", "", 1);
+    return ottoStatusCode;
 }
 
 OttoStatusCode OttoWrapper::instanzFreigeben(OttoInstanzHandle instanz) const {
-    return ottoInstanzFreigeben(instanz);
+    // Zertifikatsobjekte sind an die Instanz gebunden und müssen vor ihr geschlossen werden
+    zertifikatCacheLeeren(instanz);
+    const OttoMetriken::Aufruf aufruf("OttoInstanzFreigeben");
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoInstanzFreigeben(instanz));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().veraendere("otto_instanzen_belegt", "", -1);
+    return ottoStatusCode;
 }
 
 OttoStatusCode OttoWrapper::zertifikatOeffnen(OttoInstanzHandle instanz,const byteChar *zertifikatsPfad,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const {
-    return ottoZertifikatOeffnen(instanz,zertifikatsPfad,zertifikatsPasswort,zertifikat);
+    const OttoMetriken::Aufruf aufruf("OttoZertifikatOeffnen");
+    return aufruf.ende(ottoZertifikatOeffnen(instanz,zertifikatsPfad,zertifikatsPasswort,zertifikat));
+}
+
+OttoStatusCode OttoWrapper::zertifikatOeffnenAusBytes(OttoInstanzHandle instanz,const byteChar *pkcs12Container,uint32_t containerGroesse,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const {
+    if (!kannZertifikatAusBytesOeffnen())
+        return OTTO_FUNKTION_NICHT_UNTERSTUETZT;
+    const OttoMetriken::Aufruf aufruf("OttoZertifikatOeffnenAusBytes");
+    return aufruf.ende(ottoZertifikatOeffnenAusBytes(instanz,pkcs12Container,containerGroesse,zertifikatsPasswort,zertifikat));
 }
 
 OttoStatusCode OttoWrapper::zertifikatSchliessen(OttoZertifikatHandle zertifikat) const {
-    return ottoZertifikatSchliessen(zertifikat);
+    const OttoMetriken::Aufruf aufruf("OttoZertifikatSchliessen");
+    return aufruf.ende(ottoZertifikatSchliessen(zertifikat));
 }
 
 OttoStatusCode OttoWrapper::rueckgabepufferErzeugen(OttoInstanzHandle instanz,OttoRueckgabepufferHandle *rueckgabepuffer) const {
-    return ottoRueckgabepufferErzeugen(instanz,rueckgabepuffer);
+    const OttoMetriken::Aufruf aufruf("OttoRueckgabepufferErzeugen");
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoRueckgabepufferErzeugen(instanz,rueckgabepuffer));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().veraendere("otto_rueckgabepuffer_belegt", "", 1);
+    return ottoStatusCode;
 }
 
 uint64_t OttoWrapper::rueckgabepufferGroesse(OttoRueckgabepufferHandle rueckgabepuffer) const {
@@ -125,55 +185,77 @@ const byteChar *OttoWrapper::rueckgabepufferInhalt(OttoRueckgabepufferHandle rue
 }
 
 OttoStatusCode OttoWrapper::rueckgabepufferFreigeben(OttoRueckgabepufferHandle rueckgabepuffer) const {
-    return ottoRueckgabepufferFreigeben(rueckgabepuffer);
+    const OttoMetriken::Aufruf aufruf("OttoRueckgabepufferFreigeben");
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoRueckgabepufferFreigeben(rueckgabepuffer));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().veraendere("otto_rueckgabepuffer_belegt", "", -1);
+    return ottoStatusCode;
 }
 
 OttoStatusCode OttoWrapper::pruefsummeErzeugen(OttoInstanzHandle instanz,OttoPruefsummeHandle *pruefsumme) const {
-    return ottoPruefsummeErzeugen(instanz,pruefsumme);
+    const OttoMetriken::Aufruf aufruf("OttoPruefsummeErzeugen");
+    return aufruf.ende(ottoPruefsummeErzeugen(instanz,pruefsumme));
 }
 
 OttoStatusCode OttoWrapper::pruefsummeAktualisieren(OttoPruefsummeHandle pruefsumme,const byteChar *datenBlock,uint64_t datenBlockGroesse) const {
-    return ottoPruefsummeAktualisieren(pruefsumme,datenBlock,datenBlockGroesse);
+    const OttoMetriken::Aufruf aufruf("OttoPruefsummeAktualisieren");
+    return aufruf.ende(ottoPruefsummeAktualisieren(pruefsumme,datenBlock,datenBlockGroesse));
 }
 
 OttoStatusCode OttoWrapper::pruefsummeSignieren(OttoPruefsummeHandle pruefsumme,OttoZertifikatHandle zertifikat,OttoRueckgabepufferHandle rueckgabepuffer) const {
-    return ottoPruefsummeSignieren(pruefsumme,zertifikat,rueckgabepuffer);
+    const OttoMetriken::Aufruf aufruf("OttoPruefsummeSignieren");
+    return aufruf.ende(ottoPruefsummeSignieren(pruefsumme,zertifikat,rueckgabepuffer));
 }
 
 OttoStatusCode OttoWrapper::pruefsummeFreigeben(OttoPruefsummeHandle pruefsumme) const {
-    return ottoPruefsummeFreigeben(pruefsumme);
+    const OttoMetriken::Aufruf aufruf("OttoPruefsummeFreigeben");
+    return aufruf.ende(ottoPruefsummeFreigeben(pruefsumme));
 }
 
 OttoStatusCode OttoWrapper::versandBeginnen(OttoInstanzHandle instanz,const byteChar *signiertePruefsumme,const byteChar *herstellerId,OttoVersandHandle *versand) const {
-    return ottoVersandBeginnen(instanz,signiertePruefsumme,herstellerId,versand);
+    const OttoMetriken::Aufruf aufruf("OttoVersandBeginnen");
+    return aufruf.ende(ottoVersandBeginnen(instanz,signiertePruefsumme,herstellerId,versand));
 }
 
 OttoStatusCode OttoWrapper::versandFortsetzen(OttoVersandHandle versand,const byteChar *datenBlock,uint64_t datenBlockGroesse) const {
-    return ottoVersandFortsetzen(versand,datenBlock,datenBlockGroesse);
+    const OttoMetriken::Aufruf aufruf("OttoVersandFortsetzen");
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoVersandFortsetzen(versand,datenBlock,datenBlockGroesse));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().zaehle("otto_gesendet_bytes_total", "", datenBlockGroesse);
+    return ottoStatusCode;
 }
 
 OttoStatusCode OttoWrapper::versandAbschliessen(OttoVersandHandle versand,OttoRueckgabepufferHandle objektId) const {
-    return ottoVersandAbschliessen(versand,objektId);
+    const OttoMetriken::Aufruf aufruf("OttoVersandAbschliessen");
+    return aufruf.ende(ottoVersandAbschliessen(versand,objektId));
 }
 
 OttoStatusCode OttoWrapper::versandBeenden(OttoVersandHandle versand) const {
-    return ottoVersandBeenden(versand);
+    const OttoMetriken::Aufruf aufruf("OttoVersandBeenden");
+    return aufruf.ende(ottoVersandBeenden(versand));
 }
 
 OttoStatusCode OttoWrapper::empfangBeginnen(OttoInstanzHandle instanz,const byteChar *objektId,OttoZertifikatHandle zertifikat,const byteChar *herstellerId,OttoEmpfangHandle *empfang) const {
-    return ottoEmpfangBeginnen(instanz,objektId,zertifikat,herstellerId,empfang);
+    const OttoMetriken::Aufruf aufruf("OttoEmpfangBeginnen");
+    return aufruf.ende(ottoEmpfangBeginnen(instanz,objektId,zertifikat,herstellerId,empfang));
 }
 
 OttoStatusCode OttoWrapper::empfangBeginnenAbholzertifikat(OttoInstanzHandle instanz,const byteChar *objektId,OttoZertifikatHandle zertifikat,const byteChar *herstellerId,const byteChar *abholzertifikat,OttoEmpfangHandle *empfang) const {
-    return ottoEmpfangBeginnenAbholzertifikat(instanz,objektId,zertifikat,herstellerId,abholzertifikat,empfang);
+    const OttoMetriken::Aufruf aufruf("OttoEmpfangBeginnenAbholzertifikat");
+    return aufruf.ende(ottoEmpfangBeginnenAbholzertifikat(instanz,objektId,zertifikat,herstellerId,abholzertifikat,empfang));
 }
 
 OttoStatusCode OttoWrapper::empfangFortsetzen(OttoEmpfangHandle empfang,OttoRueckgabepufferHandle datenBlock) const {
-    return ottoEmpfangFortsetzen(empfang,datenBlock);
+    const OttoMetriken::Aufruf aufruf("OttoEmpfangFortsetzen");
+    const OttoStatusCode ottoStatusCode = aufruf.ende(ottoEmpfangFortsetzen(empfang,datenBlock));
+    if (OTTO_OK == ottoStatusCode)
+        OttoMetriken::get().zaehle("otto_empfangen_bytes_total", "", ottoRueckgabepufferGroesse(datenBlock));
+    return ottoStatusCode;
 }
 
 OttoStatusCode OttoWrapper::empfangBeenden(OttoEmpfangHandle empfang) const {
-    return ottoEmpfangBeenden(empfang);
+    const OttoMetriken::Aufruf aufruf("OttoEmpfangBeenden");
+    return aufruf.ende(ottoEmpfangBeenden(empfang));
 }
 
 const char* OttoWrapper::holeFehlertext(OttoStatusCode statuscode) const {
@@ -181,9 +263,92 @@ const char* OttoWrapper::holeFehlertext(OttoStatusCode statuscode) const {
 }
 
 OttoStatusCode OttoWrapper::proxyKonfigurationSetzen(OttoInstanzHandle instanz,const OttoProxyKonfiguration *proxyKonfiguration) const {
-    return ottoProxyKonfigurationSetzen(instanz,proxyKonfiguration);
+    const OttoMetriken::Aufruf aufruf("OttoProxyKonfigurationSetzen");
+    return aufruf.ende(ottoProxyKonfigurationSetzen(instanz,proxyKonfiguration));
 }
 
 OttoStatusCode OttoWrapper::version(OttoRueckgabepufferHandle rueckgabepuffer) const {
-    return ottoVersion(rueckgabepuffer);
+    const OttoMetriken::Aufruf aufruf("OttoVersion");
+    return aufruf.ende(ottoVersion(rueckgabepuffer));
+}
+
+
+// Zertifikatscache
+
+OttoStatusCode OttoWrapper::zertifikatAusCache(OttoInstanzHandle instanz,const byteChar *pkcs12Container,uint32_t containerGroesse,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const {
+    if ((nullptr == instanz) || (nullptr == pkcs12Container) || (nullptr == zertifikat) || !kannZertifikatAusBytesOeffnen())
+        return zertifikatOeffnenAusBytes(instanz,pkcs12Container,containerGroesse,zertifikatsPasswort,zertifikat);
+
+    const std::string passwort((nullptr == zertifikatsPasswort) ? "" : zertifikatsPasswort);
+
+    std::lock_guard<std::mutex> sperre(zertifikatCacheMutex);
+    ZertifikatCache &cache = zertifikatCaches[instanz];
+
+    // Treffer nur, wenn Container und Passwort übereinstimmen, damit eine falsche PIN nicht durch den Cache umgangen wird
+    for (auto eintrag = cache.begin(); eintrag != cache.end(); ++eintrag) {
+        if ((eintrag->container.size() == containerGroesse)
+            && (0 == eintrag->container.compare(0, containerGroesse, pkcs12Container, containerGroesse))
+            && (eintrag->passwort == passwort)) {
+            cache.splice(cache.begin(), cache, eintrag);
+            ++cache.front().nutzer;
+            *zertifikat = cache.front().zertifikat;
+            OttoMetriken::get().zaehle("otto_zertifikatcache_zugriffe_total", "ergebnis=\"treffer\"");
+            return OTTO_OK;
+        }
+    }
+
+    OttoMetriken::get().zaehle("otto_zertifikatcache_zugriffe_total", "ergebnis=\"fehlgriff\"");
+    OttoZertifikatHandle neuesZertifikat = nullptr;
+    const OttoStatusCode ottoStatusCode = zertifikatOeffnenAusBytes(instanz,pkcs12Container,containerGroesse,zertifikatsPasswort,&neuesZertifikat);
+    if (OTTO_OK == ottoStatusCode) {
+        cache.push_front(ZertifikatCacheEintrag{std::string(pkcs12Container, containerGroesse), passwort, neuesZertifikat, 1u});
+        OttoMetriken::get().veraendere("otto_zertifikatcache_belegt", "", 1);
+        zertifikatCacheKuerzen(cache);
+        *zertifikat = neuesZertifikat;
+    }
+    return ottoStatusCode;
+}
+
+void OttoWrapper::zertifikatZurueckgeben(OttoInstanzHandle instanz,OttoZertifikatHandle zertifikat) const {
+    std::lock_guard<std::mutex> sperre(zertifikatCacheMutex);
+    const auto cache = zertifikatCaches.find(instanz);
+    if (zertifikatCaches.end() == cache)
+        return;
+    for (auto &eintrag : cache->second) {
+        if ((eintrag.zertifikat == zertifikat) && (0u < eintrag.nutzer)) {
+            --eintrag.nutzer;
+            break;
+        }
+    }
+    // Solange alle Zertifikate festgehalten waren, kann der Cache über seine Größe gewachsen sein
+    zertifikatCacheKuerzen(cache->second);
+}
+
+void OttoWrapper::zertifikatCacheKuerzen(ZertifikatCache &cache) const {
+    // Das am längsten nicht benutzte, nicht festgehaltene Zertifikat zuerst verdrängen
+    for (auto eintrag = cache.end(); (ZERTIFIKATCACHE_GROESSE < cache.size()) && (cache.begin() != eintrag); ) {
+        --eintrag;
+        if (0u == eintrag->nutzer) {
+            zertifikatSchliessen(eintrag->zertifikat);
+            eintrag = cache.erase(eintrag);
+            OttoMetriken::get().veraendere("otto_zertifikatcache_belegt", "", -1);
+            OttoMetriken::get().zaehle("otto_zertifikatcache_verdraengt_total", "");
+        }
+    }
+}
+
+void OttoWrapper::zertifikatCacheLeeren(OttoInstanzHandle instanz) const {
+    ZertifikatCache cache;
+    {
+        std::lock_guard<std::mutex> sperre(zertifikatCacheMutex);
+        const auto eintrag = zertifikatCaches.find(instanz);
+        if (zertifikatCaches.end() == eintrag)
+            return;
+        cache.swap(eintrag->second);
+        zertifikatCaches.erase(eintrag);
+    }
+
+    OttoMetriken::get().veraendere("otto_zertifikatcache_belegt", "", -static_cast<int64_t>(cache.size()));
+    for (const auto &eintrag : cache)
+        zertifikatSchliessen(eintrag.zertifikat);
 }
@@ -2,8 +2,15 @@
 
 #include <otto.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
 #include <string>
 
+class OttoLogSenke;
+
 
 /* Signleton-Klasse zum Laden der Otto-Bibliothek und zur Kapselung der Otto-API */
 
@@ -18,10 +25,25 @@ class OttoWrapper {
 
         bool loadOtto(const std::string &libDirPath);
 
+        // Instanzen, die ohne eigenen Log-Callback erzeugt werden, melden ihre Log-Meldungen an diese Senke statt in die
+        // Logdateien. Die Senke muss alle damit erzeugten Instanzen überleben; nullptr schaltet wieder auf die Logdateien.
+        void setLogSenke(OttoLogSenke *logSenke);
+
+        // Liefert die Otto-Instanz, die sich alle Transfers dieses Prozesses teilen. Sie wird beim ersten Aufruf mit
+        // logPfad erzeugt und bleibt bis gemeinsameInstanzFreigeben() bestehen, damit der Zertifikatscache über
+        // mehrere Transfers hinweg wirkt. Die Instanz darf vom Aufrufer nicht mit instanzFreigeben() freigegeben werden.
+        OttoStatusCode  gemeinsameInstanz(const byteChar * const logPfad,OttoInstanzHandle *instanz);
+        void            gemeinsameInstanzFreigeben();
+
+        // Ältere Otto-Bibliotheken kennen OttoZertifikatOeffnenAusBytes() nicht. zertifikatOeffnenAusBytes() und
+        // zertifikatAusCache() liefern dann OTTO_FUNKTION_NICHT_UNTERSTUETZT; Zertifikate sind über ihren Pfad zu öffnen.
+        bool            kannZertifikatAusBytesOeffnen() const { return nullptr != ottoZertifikatOeffnenAusBytes; }
+
         // Gekapselte Funktionen der Otto-API.  Für eine Beschreibung der Funktionen siehe otto.h
         OttoStatusCode  instanzErzeugen(const byteChar * const logPfad,OttoLogCallback logCallback,void *logCallbackBenutzerdaten,OttoInstanzHandle *instanz) const;
         OttoStatusCode  instanzFreigeben(OttoInstanzHandle instanz) const;
         OttoStatusCode  zertifikatOeffnen(OttoInstanzHandle instanz,const byteChar *zertifikatsPfad,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const;
+        OttoStatusCode  zertifikatOeffnenAusBytes(OttoInstanzHandle instanz,const byteChar *pkcs12Container,uint32_t containerGroesse,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const;
         OttoStatusCode  zertifikatSchliessen(OttoZertifikatHandle zertifikat) const;
         OttoStatusCode  rueckgabepufferErzeugen(OttoInstanzHandle instanz,OttoRueckgabepufferHandle *rueckgabepuffer) const;
         uint64_t        rueckgabepufferGroesse(OttoRueckgabepufferHandle rueckgabepuffer) const;
@@ -43,11 +65,47 @@ class OttoWrapper {
         OttoStatusCode  proxyKonfigurationSetzen(OttoInstanzHandle instanz,const OttoProxyKonfiguration *proxyKonfiguration) const;
         OttoStatusCode  version(OttoRueckgabepufferHandle rueckgabepuffer) const;
 
+        // Zertifikatscache je Otto-Instanz
+        // Liefert ein geöffnetes Zertifikatsobjekt für den PKCS#12-Container im Hauptspeicher. Wurde derselbe Container
+        // mit demselben Passwort für diese Instanz bereits geöffnet, wird das vorhandene Zertifikatsobjekt wiederverwendet.
+        // Die Zertifikatsobjekte gehören dem Cache und dürfen vom Aufrufer nicht mit zertifikatSchliessen() geschlossen
+        // werden. Jeder erfolgreiche Aufruf hält das Zertifikat fest, bis der Aufrufer es mit zertifikatZurueckgeben()
+        // zurückgibt; erst dann darf es verdrängt werden. Gleichzeitige Transfers auf der gemeinsamen Instanz schließen
+        // einander so kein benutztes Zertifikat. Je Instanz werden höchstens acht nicht festgehaltene Zertifikate
+        // aufbewahrt; darüber hinaus wird das am längsten nicht benutzte geschlossen. Bei instanzFreigeben() werden alle
+        // Zertifikate der Instanz geschlossen, zu diesem Zeitpunkt darf keines mehr festgehalten sein.
+        OttoStatusCode  zertifikatAusCache(OttoInstanzHandle instanz,const byteChar *pkcs12Container,uint32_t containerGroesse,const byteChar *zertifikatsPasswort,OttoZertifikatHandle *zertifikat) const;
+        void            zertifikatZurueckgeben(OttoInstanzHandle instanz,OttoZertifikatHandle zertifikat) const;
+        void            zertifikatCacheLeeren(OttoInstanzHandle instanz) const;
+
     private:
         OttoWrapper();
 
+        static constexpr size_t ZERTIFIKATCACHE_GROESSE = 8u;
+
+        struct ZertifikatCacheEintrag {
+            std::string          container;
+            std::string          passwort;
+            OttoZertifikatHandle zertifikat;
+            size_t               nutzer;     // Noch nicht zurückgegebene Aufrufe von zertifikatAusCache()
+        };
+        // Zuletzt benutzte Einträge stehen vorne
+        using ZertifikatCache = std::list<ZertifikatCacheEintrag>;
+
+        // Schließt nicht festgehaltene Zertifikate, bis höchstens ZERTIFIKATCACHE_GROESSE übrig sind;
+        // nur mit gehaltenem zertifikatCacheMutex aufrufen
+        void zertifikatCacheKuerzen(ZertifikatCache &cache) const;
+
+        mutable std::mutex                                   zertifikatCacheMutex;
+        mutable std::map<OttoInstanzHandle, ZertifikatCache> zertifikatCaches;
+
         void *dylibHandle;
 
+        OttoLogSenke *logSenke;
+
+        std::mutex        gemeinsameInstanzMutex;
+        OttoInstanzHandle gemeinsameInstanzHandle;
+
         // Funktionstypen und -zeiger für Otto-Funktionen
         using OttoInstanzErzeugen = decltype(&::OttoInstanzErzeugen);
         OttoInstanzErzeugen ottoInstanzErzeugen;
@@ -58,6 +116,9 @@ class OttoWrapper {
         using OttoZertifikatOeffnen = decltype(&::OttoZertifikatOeffnen);
         OttoZertifikatOeffnen ottoZertifikatOeffnen;
 
+        using OttoZertifikatOeffnenAusBytes = decltype(&::OttoZertifikatOeffnenAusBytes);
+        OttoZertifikatOeffnenAusBytes ottoZertifikatOeffnenAusBytes;
+
         using OttoZertifikatSchliessen = decltype(&::OttoZertifikatSchliessen);
         OttoZertifikatSchliessen ottoZertifikatSchliessen;
 
@@ -1,9 +1,16 @@
 #include "Arguments.h"
+#include "OttoLogSenke.h"
+#include "OttoMetriken.h"
+#include "OttoSpuren.h"
+#include "OttoStatuscodes.h"
 #include "OttoWrapper.h"
+#include "metrikexport.h"
 
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <stdlib.h>
 #include <string>
 #include <utility>
@@ -43,12 +50,20 @@ class OttoHandle {
         const OttoWrapper &ottoWrapper;
 };
 
-const char* getOttoErrorText(OttoStatusCode rc, const OttoWrapper& otto) {
-    const char* errorText = otto.holeFehlertext(rc);
-    return errorText ? errorText : "<Kein Fehlertext vorhanden>";
+// Liefert Klartext, symbolischen Namen und Kategorie zu einem Statuscode. Der Klartext wird je Statuscode nur
+// einmal von der Otto-Bibliothek geholt.
+std::string getOttoErrorText(OttoStatusCode rc, const OttoWrapper& otto) {
+    const char* errorText = OttoStatuscodes::fehlertext(rc, otto);
+    std::string result(errorText ? errorText : "<Kein Fehlertext vorhanden>");
+
+    const OttoStatuscodes::Eintrag* entry = OttoStatuscodes::suche(rc);
+    if (nullptr != entry) {
+        result += std::string(" [") + entry->name + ", " + OttoStatuscodes::kategorieName(entry->kategorie)
+                + (entry->wiederholbar ? ", Wiederholung moeglich]" : "]");
+    }
+    return result;
 }
 
-template<> OttoHandle<OttoInstanzHandle>::~OttoHandle() { ottoWrapper.instanzFreigeben(handle); }
 template<> OttoHandle<OttoRueckgabepufferHandle>::~OttoHandle() { ottoWrapper.rueckgabepufferFreigeben(handle); }
 template<> OttoHandle<OttoZertifikatHandle>::~OttoHandle() { ottoWrapper.zertifikatSchliessen(handle); }
 template<> OttoHandle<OttoPruefsummeHandle>::~OttoHandle() { ottoWrapper.pruefsummeFreigeben(handle); }
@@ -56,6 +71,54 @@ template<> OttoHandle<OttoVersandHandle>::~OttoHandle() { ottoWrapper.versandBee
 template<> OttoHandle<OttoEmpfangHandle>::~OttoHandle() { ottoWrapper.empfangBeenden(handle); }
 
 
+// Diese Klasse gibt ein Zertifikat aus dem Zertifikatscache des OttoWrappers am Ende des Transfers zurück,
+// damit es erst danach verdrängt und geschlossen werden kann
+class CachedCertificate {
+    public:
+        CachedCertificate() : instance(nullptr), handle(nullptr) {}
+        ~CachedCertificate() { if (nullptr != handle) OttoWrapper::get().zertifikatZurueckgeben(instance, handle); }
+
+        CachedCertificate(const CachedCertificate &) = delete;
+        CachedCertificate &operator=(const CachedCertificate &) = delete;
+
+        OttoInstanzHandle    instance;
+        OttoZertifikatHandle handle;
+};
+
+
+// Diese Funktion öffnet das Zertifikat für eine Otto-Instanz.
+// Liegt das Sicherheitstoken als PKCS#12-Datei vor, wird es in den Hauptspeicher gelesen und über den Zertifikatscache
+// des OttoWrappers geöffnet, sodass weitere Transfers derselben Instanz das bereits geöffnete Token wiederverwenden;
+// ottoCertificateCached gibt es am Ende des Transfers an den Cache zurück. Da ottodemo je Aufruf nur einen Transfer
+// ausführt, trifft der Cache hier nie. Er wirkt erst in Prozessen, die wie ein Dienst mehrere Transfers über die
+// gemeinsame Instanz abwickeln.
+// Andere Tokens (z. B. eID-Client-URLs) und Bibliotheken ohne OttoZertifikatOeffnenAusBytes() öffnen das Zertifikat
+// wie bisher über seinen Pfad; es wird dann in ottoCertificateOwned verwaltet.
+OttoStatusCode openCertificate(const OttoWrapper &otto, OttoInstanzHandle ottoInstance, const Arguments &arguments,
+                               OttoHandle<OttoZertifikatHandle> &ottoCertificateOwned, CachedCertificate &ottoCertificateCached,
+                               OttoZertifikatHandle &ottoCertificate) {
+    if (otto.kannZertifikatAusBytesOeffnen() && (nullptr != arguments.getCertPath()) && (nullptr != arguments.getPin())) {
+        std::ifstream certFile(arguments.getCertPath(), std::ifstream::binary);
+        if (certFile) {
+            const std::string container((std::istreambuf_iterator<char>(certFile)), std::istreambuf_iterator<char>());
+            if (!container.empty() && (container.size() <= UINT32_MAX)) {
+                const OttoStatusCode ottoStatusCode = otto.zertifikatAusCache(ottoInstance, container.data(), static_cast<uint32_t>(container.size()),
+                                                                              arguments.getPin(), &ottoCertificate);
+                if (OTTO_OK == ottoStatusCode) {
+                    ottoCertificateCached.instance = ottoInstance;
+                    ottoCertificateCached.handle = ottoCertificate;
+                }
+                return ottoStatusCode;
+            }
+        }
+    }
+
+    const OttoStatusCode ottoStatusCode = otto.zertifikatOeffnen(ottoInstance, arguments.getCertPath(), arguments.getPin(), &ottoCertificateOwned);
+    ottoCertificate = ottoCertificateOwned;
+    return ottoStatusCode;
+}
+
+
 // Diese Funktion holt Daten zu einer gegebenen Objekt-ID blockweise von OTTER ab und speichert sie in einer Datei
 int fetchData(const Arguments &arguments) {
 
@@ -63,21 +126,29 @@ int fetchData(const Arguments &arguments) {
     std::cout << "Objekt-ID: " + arguments.objectId << std::endl;
     std::cout << "Speichere Daten in: " << arguments.outFilePath << std::endl;
 
+    // Ordnet die Otto-Logmeldungen dieses Threads in otto.jsonl der Abholung zu
+    const OttoLogSenke::Vorgang vorgang("empfang " + arguments.objectId);
+    const OttoSpuren::Anfrage anfrage("Abholung", arguments.objectId);
+
     OttoWrapper &otto(OttoWrapper::get());
     if (!otto.loadOtto(arguments.ottoDirPath))
         return EXIT_FAILURE;
 
-    OttoHandle<OttoInstanzHandle> ottoInstance;
-    OttoHandle<OttoZertifikatHandle> ottoCertificate;
+    OttoInstanzHandle ottoInstance = nullptr;
+    OttoHandle<OttoZertifikatHandle> ottoCertificateOwned;
+    CachedCertificate ottoCertificateCached;
+    OttoZertifikatHandle ottoCertificate = nullptr;
     OttoHandle<OttoRueckgabepufferHandle> ottoBuffer;
     OttoHandle<OttoEmpfangHandle> ottoFetch;
 
-    // 1. Otto-Instanz erzeugen
-    OttoStatusCode ottoStatusCode = otto.instanzErzeugen(arguments.logDirPath.c_str(),nullptr,nullptr,&ottoInstance);
+    // 1. Gemeinsame Otto-Instanz holen, sie bleibt mit ihrem Zertifikatscache bis zum Programmende bestehen
+    OttoStatusCode ottoStatusCode = otto.gemeinsameInstanz(arguments.logDirPath.c_str(),&ottoInstance);
 
     // 2. Zertifikat für die Authentifizierung öffnen
-    if (OTTO_OK == ottoStatusCode)
-        ottoStatusCode = otto.zertifikatOeffnen(ottoInstance,arguments.getCertPath(), arguments.getPin(), &ottoCertificate);
+    if (OTTO_OK == ottoStatusCode) {
+        const OttoSpuren::Spanne spanne("Zertifikat oeffnen");
+        ottoStatusCode = openCertificate(otto, ottoInstance, arguments, ottoCertificateOwned, ottoCertificateCached, ottoCertificate);
+    }
 
     // 3. Puffer für die Rückgabe der abgeholten Datenblöcke erzeugen
     if (OTTO_OK == ottoStatusCode)
@@ -98,8 +169,10 @@ int fetchData(const Arguments &arguments) {
             ottoStatusCode = otto.empfangFortsetzen(ottoFetch, ottoBuffer);
             if (OTTO_OK == ottoStatusCode) {
                 dataSize = otto.rueckgabepufferGroesse(ottoBuffer);
-                if (0u < dataSize)
+                if (0u < dataSize) {
+                    const OttoSpuren::Spanne spanne("Block schreiben");
                     targetFile.write(otto.rueckgabepufferInhalt(ottoBuffer), static_cast<std::streamsize>(dataSize));
+                }
             }
             empfangeneByte += dataSize;
         } while ((OTTO_OK == ottoStatusCode) && (0u < dataSize));
@@ -125,22 +198,30 @@ int sendData(const Arguments &arguments) {
 
     std::cout << "*** Sende Datei zum OTTER ***" << std::endl;
 
+    // Ordnet die Otto-Logmeldungen dieses Threads in otto.jsonl dem Versand zu
+    const OttoLogSenke::Vorgang vorgang("versand " + arguments.inFilePath);
+    const OttoSpuren::Anfrage anfrage("Versand", arguments.inFilePath);
+
     OttoWrapper &otto(OttoWrapper::get());
     if (!otto.loadOtto(arguments.ottoDirPath))
         return EXIT_FAILURE;
 
-    OttoHandle<OttoInstanzHandle> ottoInstance;
-    OttoHandle<OttoZertifikatHandle> ottoCertificate;
+    OttoInstanzHandle ottoInstance = nullptr;
+    OttoHandle<OttoZertifikatHandle> ottoCertificateOwned;
+    CachedCertificate ottoCertificateCached;
+    OttoZertifikatHandle ottoCertificate = nullptr;
     OttoHandle<OttoRueckgabepufferHandle> ottoBuffer;
     OttoHandle<OttoPruefsummeHandle> ottoHash;
     OttoHandle<OttoVersandHandle> ottoSend;
 
-    // 1. Otto-Instanz erzeugen
-    OttoStatusCode ottoStatusCode = otto.instanzErzeugen(arguments.logDirPath.c_str(),nullptr,nullptr,&ottoInstance);
+    // 1. Gemeinsame Otto-Instanz holen, sie bleibt mit ihrem Zertifikatscache bis zum Programmende bestehen
+    OttoStatusCode ottoStatusCode = otto.gemeinsameInstanz(arguments.logDirPath.c_str(),&ottoInstance);
 
     // 2. Zertifikat für die Signierung der Prüfsumme öffnen
-    if(OTTO_OK == ottoStatusCode)
-        ottoStatusCode = otto.zertifikatOeffnen(ottoInstance,arguments.getCertPath(),arguments.getPin(),&ottoCertificate);
+    if(OTTO_OK == ottoStatusCode) {
+        const OttoSpuren::Spanne spanne("Zertifikat oeffnen");
+        ottoStatusCode = openCertificate(otto,ottoInstance,arguments,ottoCertificateOwned,ottoCertificateCached,ottoCertificate);
+    }
 
     // 3. Puffer für die Rückgabe der signierten Prüfsumme erzeugen
     if(OTTO_OK == ottoStatusCode)
@@ -158,7 +239,10 @@ int sendData(const Arguments &arguments) {
         auto readBuffer = std::make_unique<char []>(dataSize);
         do {
             std::cout << '.';
-            sourceFile.read(readBuffer.get(), dataSize);
+            {
+                const OttoSpuren::Spanne spanne("Block lesen");
+                sourceFile.read(readBuffer.get(), dataSize);
+            }
             if (0u < sourceFile.gcount())
                 ottoStatusCode = otto.pruefsummeAktualisieren(ottoHash, readBuffer.get(), static_cast<uint64_t>(sourceFile.gcount()));
         } while ((OTTO_OK == ottoStatusCode) && !sourceFile.eof());
@@ -183,7 +267,10 @@ int sendData(const Arguments &arguments) {
         auto readBuffer = std::make_unique<char[]>(dataSize);
         do {
             std::cout << '.';
-            sourceFile.read(readBuffer.get(),dataSize);
+            {
+                const OttoSpuren::Spanne spanne("Block lesen");
+                sourceFile.read(readBuffer.get(),dataSize);
+            }
             if(0u < sourceFile.gcount())
                 ottoStatusCode = otto.versandFortsetzen(ottoSend, readBuffer.get(), static_cast<uint64_t>(sourceFile.gcount()));
         } while((OTTO_OK == ottoStatusCode) && !sourceFile.eof());
@@ -211,16 +298,74 @@ int sendData(const Arguments &arguments) {
 int main(int argc, char* argv[]) {
     const Arguments arguments(parseArguments(argc, argv));
 
+    // Der Export lebt bis nach der letzten Eingabe, damit die Metriken noch abgerufen werden können
+    std::unique_ptr<MetrikExport> metricsExport;
+    if (arguments.parseOk && !arguments.showHelp && ((0u != arguments.metricsPort) || !arguments.metricsFilePath.empty())) {
+        try {
+            metricsExport = std::make_unique<MetrikExport>(OttoMetriken::get(), arguments.metricsPort, arguments.metricsFilePath, 10u);
+        } catch (const std::runtime_error &fehler) {
+            std::cerr << "Fehler: " << fehler.what() << std::endl;
+            return waitForEnter(EXIT_FAILURE);
+        }
+        if (0u != arguments.metricsPort)
+            std::cout << "Metriken unter http://127.0.0.1:" << arguments.metricsPort << "/metrics" << std::endl;
+    }
+
+    // Die Log-Senke muss alle Otto-Instanzen überleben, die mit ihrem Callback erzeugt werden
+    std::unique_ptr<OttoLogSenke> logSenke;
+    if (arguments.parseOk && !arguments.showHelp && !arguments.logLevel.empty()) {
+        OttoLogEbene mindestEbene = OTTOLOG_INFORMATIONEN;
+        OttoLogSenke::leseEbene(arguments.logLevel, mindestEbene);
+        std::string logFilePath = arguments.logDirPath;
+        if (!logFilePath.empty() && (PATH_SEPARATOR != *logFilePath.rbegin()))
+            logFilePath += PATH_SEPARATOR;
+        logFilePath += "otto.jsonl";
+        try {
+            logSenke = std::make_unique<OttoLogSenke>(logFilePath, mindestEbene);
+        } catch (const std::runtime_error &fehler) {
+            std::cerr << "Fehler: " << fehler.what() << std::endl;
+            return waitForEnter(EXIT_FAILURE);
+        }
+        OttoWrapper::get().setLogSenke(logSenke.get());
+        std::cout << "Otto-Logmeldungen in " << logFilePath << std::endl;
+    }
+
+    if (arguments.parseOk && !arguments.showHelp && !arguments.traceFilePath.empty())
+        OttoSpuren::get().aktiviere(arguments.traceRatio);
+
+    int result = EXIT_FAILURE;
     if (!arguments.parseOk || arguments.showHelp) {
         arguments.help();
         return waitForEnter(arguments.parseOk ? EXIT_SUCCESS : EXIT_FAILURE);
     } else if (arguments.fetchData) {
-        return waitForEnter(fetchData(arguments));
+        result = fetchData(arguments);
     } else if (arguments.sendData) {
-        return waitForEnter(sendData(arguments));
+        result = sendData(arguments);
     } else {
         std::cerr << "Keine Aktion angegeben" << std::endl;
         arguments.help();
         return waitForEnter(EXIT_FAILURE);
     }
+
+    // Die gemeinsame Instanz meldet an die Log-Senke und wird daher vor ihr freigegeben
+    OttoWrapper::get().gemeinsameInstanzFreigeben();
+
+    if (logSenke) {
+        OttoWrapper::get().setLogSenke(nullptr);
+        logSenke->beende();
+        const OttoLogSenke::Kennzahlen kennzahlen = logSenke->kennzahlen();
+        std::cout << "Otto-Logmeldungen: " << kennzahlen.geschrieben << " geschrieben, " << kennzahlen.gefiltert << " gefiltert, "
+                  << kennzahlen.uebergelaufen << " uebergelaufen" << std::endl;
+    }
+
+    if (!arguments.traceFilePath.empty()) {
+        const OttoSpuren::Kennzahlen kennzahlen = OttoSpuren::get().kennzahlen();
+        if (OttoSpuren::get().schreibe(arguments.traceFilePath))
+            std::cout << "Spuren in " << arguments.traceFilePath << ": " << kennzahlen.ausgewaehlt << " von " << kennzahlen.anfragen << " Transfers, "
+                      << kennzahlen.spannen << " Spannen, " << kennzahlen.verworfen << " verworfen" << std::endl;
+        else
+            std::cerr << "Die Spuren konnten nicht nach " << arguments.traceFilePath << " geschrieben werden" << std::endl;
+    }
+
+    return waitForEnter(result);
 }